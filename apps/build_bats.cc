@@ -0,0 +1,57 @@
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include "core/bat_catalog.h"
+
+using home_run_derby::BatCatalog;
+using home_run_derby::BatModel;
+using home_run_derby::BatProfile;
+using home_run_derby::BatResponse;
+using std::vector;
+
+namespace {
+
+// Lengths and radii are in pixels and masses in the game's units, where the
+// plain bat weighs 5 with a radius of 15 and the ball weighs 10.
+const BatProfile kProfiles[] = {
+    // name, mass, length, handle radius, barrel radius, taper start,
+    // taper end, sweet spot, sweet spot width, peak and min restitution
+    {"Ash 34", 5, 300, 6, 15, 0.3f, 0.65f, 0.8f, 0.12f, 0.95f, 0.55f},
+    {"Maple 33", 5.5f, 290, 6, 15, 0.35f, 0.6f, 0.8f, 0.1f, 0.97f, 0.5f},
+    {"Aluminum 32", 4, 280, 6, 16, 0.25f, 0.55f, 0.75f, 0.2f, 1, 0.7f},
+    {"Fungo", 2.5f, 320, 5, 11, 0.2f, 0.7f, 0.85f, 0.08f, 0.85f, 0.45f},
+    {"Sledge", 7, 300, 7, 18, 0.35f, 0.6f, 0.8f, 0.1f, 0.95f, 0.5f},
+};
+
+}  // namespace
+
+/**
+ * Works out the response tables of every bat in the catalog and writes them
+ * as the game's bat catalog asset.
+ *
+ * Usage: build-bats [output_path]
+ */
+int main(int argc, char** argv) {
+  const char* output_path = argc > 1 ? argv[1] : "assets/bats.bin";
+
+  vector<BatModel> models;
+  try {
+    for (const BatProfile& profile : kProfiles) {
+      models.push_back(BatModel::Build(profile));
+      const BatModel& model = models.back();
+      BatResponse sweet_spot = model.GetResponse(model.GetSweetSpot());
+      std::cerr << model.GetName() << ": center of mass "
+                << model.GetCenterOfMass() << " px, sweet spot "
+                << model.GetSweetSpot() << " px with restitution "
+                << sweet_spot.restitution << " and effective mass "
+                << sweet_spot.effective_mass << std::endl;
+    }
+    BatCatalog(models).Save(output_path);
+  } catch (const std::exception& error) {
+    std::cerr << error.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,118 @@
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include "core/physics_calibrator.h"
+
+using glm::vec2;
+using home_run_derby::BattedBall;
+using home_run_derby::CalibrationError;
+using home_run_derby::CalibrationResult;
+using home_run_derby::CalibrationSettings;
+using home_run_derby::PhysicsCalibrator;
+using home_run_derby::PhysicsProfile;
+using std::vector;
+
+namespace {
+
+// These mirror the game's constants, which the calibration starts from and
+// holds fixed.
+const float kWindowSize = 1000;
+const float kStretchConstant = 16.0f / 9.0f;
+const float kGroundHeight = 70;
+const float kFrameRate = 144;
+const float kBallMass = 10;
+const float kBallRadius = 50;
+const float kBatMass = 5;
+const float kBatRadius = 15;
+const float kDistanceScaleConstant = 50;
+const float kBallVelocityBoostFactor = 1.5f;
+const float kGravity = 0.09f;
+const float kGroundFriction = 0.1f;
+const float kGroundRestitution = 0.4f;
+const float kBallTerminalVelocity = 1000;
+const float kMeanPitchSpeedX = 14;
+const float kMeanPitchSpeedY = 5.5f;
+const float kBallConsideredStoppedVelocity = 0.02f;
+const size_t kMaxTicks = 20000;
+
+// Real balls are met about belt high.
+const float kContactHeight = 3;
+const size_t kBatchSize = 16;
+
+const size_t kDefaultMaxEvaluations = 2000;
+
+void PrintError(const char* label, const CalibrationError& error) {
+  std::cerr << label << ": distances off by " << 100 * error.distance
+            << "% RMS, exit speeds by " << 100 * error.exit_speed << "% RMS"
+            << std::endl;
+}
+
+}  // namespace
+
+/**
+ * Fits the game's physical constants to measured batted balls and writes
+ * them as a physics profile the game loads in place of its own.
+ *
+ * Usage: calibrate-physics measurements_csv [output_profile] [max_evaluations]
+ */
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cerr << "Usage: calibrate-physics measurements_csv [output_profile]"
+              << " [max_evaluations]" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const char* output_path = argc > 2 ? argv[2] : "assets/physics.txt";
+  size_t max_evaluations = argc > 3 ? std::strtoul(argv[3], nullptr, 10)
+                                    : kDefaultMaxEvaluations;
+
+  CalibrationSettings settings;
+  settings.ball_mass = kBallMass;
+  settings.ball_radius = kBallRadius;
+  settings.bat_radius = kBatRadius;
+  settings.terminal_velocity = kBallTerminalVelocity;
+  settings.window_size = kWindowSize;
+  settings.ground_location = kWindowSize - kGroundHeight;
+  settings.frame_rate = kFrameRate;
+  settings.pitch_speed = vec2(kMeanPitchSpeedX, kMeanPitchSpeedY);
+  settings.contact_height = kContactHeight;
+  settings.flight.right_edge = kWindowSize * kStretchConstant + kBallRadius;
+  settings.flight.stopped_speed = kBallConsideredStoppedVelocity;
+  settings.flight.max_ticks = kMaxTicks;
+  settings.num_workers = 0;
+  settings.batch_size = kBatchSize;
+
+  PhysicsProfile start;
+  start.gravity = kGravity;
+  start.ball_velocity_boost_factor = kBallVelocityBoostFactor;
+  start.ground_friction = kGroundFriction;
+  start.ground_restitution = kGroundRestitution;
+  start.distance_scale = kDistanceScaleConstant;
+  start.bat_mass = kBatMass;
+
+  CalibrationResult result;
+  try {
+    vector<BattedBall> measurements =
+        PhysicsCalibrator::LoadMeasurements(argv[1]);
+    PhysicsCalibrator calibrator(settings, measurements);
+    result = calibrator.Fit(start, max_evaluations);
+    std::cerr << "Fitted " << measurements.size() << " balls in "
+              << result.num_evaluations << " evaluations." << std::endl;
+  } catch (const std::exception& error) {
+    std::cerr << error.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+  PrintError("Before", result.start_error);
+  PrintError("After", result.error);
+
+  std::ofstream output(output_path);
+  output << "# Generated by calibrate-physics from " << argv[1] << ".\n";
+  result.profile.Write(output);
+  if (!output) {
+    std::cerr << "Could not write " << output_path << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+
+#include "visualizer/session_host.h"
+
+using glm::vec2;
+using home_run_derby::visualizer::SessionHost;
+using home_run_derby::visualizer::SessionHostSettings;
+using home_run_derby::visualizer::SessionStats;
+using home_run_derby::visualizer::Simulator;
+
+namespace {
+
+// These mirror the game's constants.
+const float kPlayerRadius = 90;
+const float kWindowSize = 1000;
+const float kStretchConstant = 16.0f / 9.0f;
+const float kGroundHeight = 70;
+const float kBallMass = 10;
+const float kBallRadius = 50;
+const float kGravity = 0.09f;
+const float kGroundFriction = 0.1f;
+const float kGroundRestitution = 0.4f;
+const float kBallVelocityBoostFactor = 1.5f;
+const float kBallTerminalVelocity = 1000;
+const float kMinPitchSpeedX = 13;
+const float kMaxPitchSpeedX = 15;
+const float kMinPitchSpeedY = 4;
+const float kMaxPitchSpeedY = 7;
+const float kBatMass = 5;
+const float kBatRadius = 15;
+const size_t kMaxOuts = 10;
+const float kTickRate = 144;
+
+const size_t kFirstSessions = 64;
+const size_t kDefaultMaxSessions = 65536;
+const size_t kBatchSize = 64;
+const double kTickSloSeconds = 0.5 / kTickRate;
+// A load holds if this share of sessions had this share of ticks on time.
+const double kSessionSloTarget = 0.99;
+const double kHeldSessionsTarget = 0.99;
+// Ten seconds of play at each load.
+const size_t kTicksPerLoad = 1440;
+
+Simulator MakePrototype() {
+  return Simulator(kPlayerRadius, kWindowSize, kStretchConstant, kGroundHeight,
+                   kBallMass, kBallRadius, kGravity, kGroundFriction,
+                   kGroundRestitution, kBallVelocityBoostFactor,
+                   kBallTerminalVelocity, kMinPitchSpeedX, kMaxPitchSpeedX,
+                   kMinPitchSpeedY, kMaxPitchSpeedY, kBatMass, kBatRadius, 0,
+                   0, 0, 0);
+}
+
+/**
+ * Gets where a synthetic player holds the bat: sweeping up and down in front
+ * of the plate, each session out of step with the others.
+ */
+vec2 GetSweepPosition(size_t session, size_t tick) {
+  float phase = 0.05f * static_cast<float>(tick) +
+                0.7f * static_cast<float>(session);
+  return vec2(kStretchConstant * kWindowSize * 0.5f,
+              kWindowSize * (0.55f + 0.3f * std::sin(phase)));
+}
+
+/**
+ * Plays a number of sessions flat out for a while.
+ * @return true if the load held the objective.
+ */
+bool RunLoad(size_t num_sessions) {
+  SessionHostSettings settings;
+  settings.max_sessions = num_sessions;
+  settings.num_workers = 0;
+  settings.batch_size = kBatchSize;
+  settings.max_outs = kMaxOuts;
+  settings.tick_slo_seconds = kTickSloSeconds;
+  SessionHost host(MakePrototype(), settings);
+  for (size_t i = 0; i < num_sessions; ++i) {
+    host.OpenSession(i);
+    host.StartGame(i);
+  }
+
+  typedef std::chrono::steady_clock Clock;
+  double slowest_tick_seconds = 0;
+  Clock::time_point start = Clock::now();
+  for (size_t tick = 0; tick < kTicksPerLoad; ++tick) {
+    for (size_t i = 0; i < num_sessions; ++i) {
+      // Finished games start over, so every session keeps playing.
+      if (host.GetSimulator(i).GetCurrentGameState() != Simulator::kInGame) {
+        host.StartGame(i);
+      }
+      host.QueueInput(i, GetSweepPosition(i, tick));
+    }
+    Clock::time_point tick_start = Clock::now();
+    host.Tick();
+    slowest_tick_seconds = std::max(
+        slowest_tick_seconds,
+        std::chrono::duration<double>(Clock::now() - tick_start).count());
+  }
+  double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+  size_t num_held = 0;
+  for (size_t i = 0; i < num_sessions; ++i) {
+    const SessionStats& stats = host.GetStats(i);
+    if (static_cast<double>(stats.num_ticks - stats.num_slow_ticks) >=
+        kSessionSloTarget * static_cast<double>(stats.num_ticks)) {
+      ++num_held;
+    }
+  }
+  double held = static_cast<double>(num_held) / num_sessions;
+  double mean_tick_seconds = seconds / kTicksPerLoad;
+  bool is_held =
+      held >= kHeldSessionsTarget && mean_tick_seconds < 1 / kTickRate;
+  std::printf(
+      "%6zu sessions  %5.1f%% on time  tick mean %.3f ms, worst %.3f ms "
+      "of %.3f ms  %s\n",
+      num_sessions, 100 * held, 1000 * mean_tick_seconds,
+      1000 * slowest_tick_seconds, 1000 / kTickRate,
+      is_held ? "held" : "missed");
+  return is_held;
+}
+
+}  // namespace
+
+/**
+ * Finds how many derbies one machine can host at the game's tick rate. Runs
+ * a session host flat out with synthetic players, doubling the sessions until
+ * the tick latency objective is missed.
+ *
+ * Usage: derby-load [max_sessions]
+ */
+int main(int argc, char** argv) {
+  size_t max_sessions =
+      argc > 1 ? std::strtoul(argv[1], nullptr, 10) : kDefaultMaxSessions;
+  size_t num_held = 0;
+  try {
+    for (size_t num_sessions = kFirstSessions; num_sessions <= max_sessions;
+         num_sessions *= 2) {
+      if (!RunLoad(num_sessions)) {
+        break;
+      }
+      num_held = num_sessions;
+    }
+  } catch (const std::exception& error) {
+    std::cerr << error.what() << std::endl;
+    return 1;
+  }
+  if (num_held == 0) {
+    std::printf("Not even %zu sessions held the objective\n", kFirstSessions);
+    return 1;
+  }
+  std::printf("Held %zu sessions at %.0f ticks per second\n", num_held,
+              static_cast<double>(kTickRate));
+  return 0;
+}
@@ -0,0 +1,336 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/datagram_socket.h"
+#include "core/metrics.h"
+#include "core/session_protocol.h"
+#include "visualizer/session_host.h"
+
+using home_run_derby::DatagramSocket;
+using home_run_derby::EncodeCommand;
+using home_run_derby::EncodeStatus;
+using home_run_derby::Histogram;
+using home_run_derby::HitStatistics;
+using home_run_derby::kHitDistance;
+using home_run_derby::QuantileSketch;
+using home_run_derby::SessionCommand;
+using home_run_derby::SessionMessage;
+using home_run_derby::SessionStatus;
+using home_run_derby::SocketAddress;
+using home_run_derby::visualizer::SessionHost;
+using home_run_derby::visualizer::SessionHostSettings;
+using home_run_derby::visualizer::SessionStats;
+using home_run_derby::visualizer::Simulator;
+using std::string;
+using std::vector;
+
+namespace {
+
+// These mirror the game's constants.
+const float kPlayerRadius = 90;
+const float kWindowSize = 1000;
+const float kStretchConstant = 16.0f / 9.0f;
+const float kGroundHeight = 70;
+const float kBallMass = 10;
+const float kBallRadius = 50;
+const float kGravity = 0.09f;
+const float kGroundFriction = 0.1f;
+const float kGroundRestitution = 0.4f;
+const float kBallVelocityBoostFactor = 1.5f;
+const float kBallTerminalVelocity = 1000;
+const float kMinPitchSpeedX = 13;
+const float kMaxPitchSpeedX = 15;
+const float kMinPitchSpeedY = 4;
+const float kMaxPitchSpeedY = 7;
+const float kBatMass = 5;
+const float kBatRadius = 15;
+const size_t kMaxOuts = 10;
+const float kTickRate = 144;
+
+const uint16_t kDefaultPort = 47900;
+const size_t kDefaultMaxSessions = 4096;
+// Sessions are ticked 64 at a time, about a hundred kilobytes of games.
+const size_t kBatchSize = 64;
+// Every session should be ticked within half a frame of the tick starting.
+const double kTickSloSeconds = 0.5 / kTickRate;
+// A session meets its objective if this share of its ticks are on time.
+const double kSessionSloTarget = 0.99;
+const size_t kStatusEveryTicks = 12;
+const size_t kReportEveryTicks = 1440;
+// A script that never ends its games stops after this many ticks.
+const size_t kMaxScriptTicks = 1000000;
+
+Simulator MakePrototype() {
+  // Nobody draws a headless game, so it has no stars or dirt.
+  return Simulator(kPlayerRadius, kWindowSize, kStretchConstant, kGroundHeight,
+                   kBallMass, kBallRadius, kGravity, kGroundFriction,
+                   kGroundRestitution, kBallVelocityBoostFactor,
+                   kBallTerminalVelocity, kMinPitchSpeedX, kMaxPitchSpeedX,
+                   kMinPitchSpeedY, kMaxPitchSpeedY, kBatMass, kBatRadius, 0,
+                   0, 0, 0);
+}
+
+/**
+ * Prints how the tick latencies measure up against the objective, and how
+ * far the hits have gone.
+ */
+void Report(const SessionHost& host, size_t tick) {
+  Histogram latencies(SessionHost::kTickLatencyBuckets);
+  host.CollectTickLatencies(&latencies);
+  size_t num_missing = 0;
+  for (size_t i = 0; i < host.GetMaxSessions(); ++i) {
+    const SessionStats& stats = host.GetStats(i);
+    if (host.IsOpen(i) && stats.num_ticks > 0 &&
+        static_cast<double>(stats.num_ticks - stats.num_slow_ticks) <
+            kSessionSloTarget * static_cast<double>(stats.num_ticks)) {
+      ++num_missing;
+    }
+  }
+  std::printf(
+      "tick %zu  %zu sessions  latency p50 %.3f ms, p99 %.3f ms  "
+      "%zu sessions missing the %.2f ms objective\n",
+      tick, host.GetNumOpenSessions(), 1000 * latencies.EstimateQuantile(0.5),
+      1000 * latencies.EstimateQuantile(0.99), num_missing,
+      1000 * kTickSloSeconds);
+
+  HitStatistics hits;
+  host.CollectHitStatistics(&hits);
+  const QuantileSketch& distances = hits.GetSketch(kHitDistance);
+  std::printf("  %llu hits  distance p50 %.0f px, p99 %.0f px\n",
+              static_cast<unsigned long long>(hits.GetNumHits()),
+              distances.EstimateQuantile(0.5),
+              distances.EstimateQuantile(0.99));
+}
+
+/**
+ * Carries out a client's command.
+ * @param owners The client each session belongs to.
+ * @param sender The client the command came from.
+ * @param answer Receives the server's answer to an open.
+ * @return true if there is an answer to send back.
+ */
+bool Dispatch(SessionHost* host, vector<SocketAddress>* owners,
+              const SessionCommand& command, const SocketAddress& sender,
+              uint64_t* next_seed, SessionCommand* answer) {
+  if (command.type == SessionMessage::kOpen) {
+    answer->session = 0;
+    try {
+      answer->session =
+          static_cast<uint32_t>(host->OpenSession((*next_seed)++));
+      answer->type = SessionMessage::kOpened;
+      (*owners)[answer->session] = sender;
+    } catch (const std::runtime_error&) {
+      answer->type = SessionMessage::kRejected;
+    }
+    return true;
+  }
+  // Clients can only drive their own sessions.
+  if (!host->IsOpen(command.session) ||
+      !((*owners)[command.session] == sender)) {
+    return false;
+  }
+  switch (command.type) {
+    case SessionMessage::kStart:
+      host->StartGame(command.session);
+      break;
+    case SessionMessage::kInput:
+      host->QueueInput(command.session, command.bat_position);
+      break;
+    case SessionMessage::kClose:
+      host->CloseSession(command.session);
+      break;
+    default:
+      break;
+  }
+  return false;
+}
+
+SessionStatus MakeStatus(const SessionHost& host, size_t session) {
+  const Simulator& simulator = host.GetSimulator(session);
+  SessionStatus status;
+  status.session = static_cast<uint32_t>(session);
+  status.tick = static_cast<uint32_t>(host.GetStats(session).num_ticks);
+  status.game_state = static_cast<uint32_t>(simulator.GetCurrentGameState());
+  status.outs = static_cast<uint32_t>(simulator.GetOuts());
+  status.score = static_cast<uint32_t>(simulator.GetScore());
+  return status;
+}
+
+/**
+ * Plays out a script of client commands, one per line as "tick command",
+ * e.g. "0 open" or "12 input 0 850 420", as fast as the host can tick.
+ */
+int RunScript(const char* path, SessionHost* host) {
+  std::ifstream script(path);
+  if (!script) {
+    std::cerr << "Could not open the script " << path << std::endl;
+    return 1;
+  }
+  vector<SocketAddress> owners(host->GetMaxSessions());
+  SocketAddress client = {0, 0};
+  uint64_t next_seed = 0;
+  string line;
+  size_t line_number = 0;
+  size_t tick = 0;
+  bool has_line = false;
+  size_t line_tick = 0;
+  SessionCommand command;
+  while (tick < kMaxScriptTicks) {
+    // Carry out every command for this tick, then tick.
+    while (has_line || std::getline(script, line)) {
+      if (!has_line) {
+        ++line_number;
+        if (line.empty() || line[0] == '#') {
+          continue;
+        }
+        std::istringstream fields(line);
+        string rest;
+        if (!(fields >> line_tick) || !std::getline(fields, rest) ||
+            !home_run_derby::ParseCommand(rest, &command)) {
+          std::cerr << path << ":" << line_number << ": not a command"
+                    << std::endl;
+          return 1;
+        }
+        has_line = true;
+      }
+      if (line_tick > tick) {
+        break;
+      }
+      has_line = false;
+      SessionCommand answer;
+      if (Dispatch(host, &owners, command, client, &next_seed, &answer) &&
+          answer.type == SessionMessage::kRejected) {
+        std::cerr << path << ":" << line_number << ": no room to open"
+                  << std::endl;
+      }
+    }
+    host->Tick();
+    ++tick;
+
+    // Stop once the script is done and every game has ended.
+    bool is_playing = false;
+    for (size_t i = 0; i < host->GetMaxSessions(); ++i) {
+      is_playing = is_playing ||
+                   (host->IsOpen(i) &&
+                    host->GetSimulator(i).GetCurrentGameState() ==
+                        Simulator::kInGame);
+    }
+    if (!has_line && !script && !is_playing) {
+      break;
+    }
+  }
+
+  for (size_t i = 0; i < host->GetMaxSessions(); ++i) {
+    if (host->IsOpen(i)) {
+      SessionStatus status = MakeStatus(*host, i);
+      std::printf("session %u  %u ticks  outs %u  score %u px\n",
+                  static_cast<unsigned>(status.session),
+                  static_cast<unsigned>(status.tick),
+                  static_cast<unsigned>(status.outs),
+                  static_cast<unsigned>(status.score));
+    }
+  }
+  Report(*host, tick);
+  return 0;
+}
+
+/**
+ * Serves clients on a loopback port at the game's tick rate, forever.
+ */
+int Serve(uint16_t port, SessionHost* host) {
+  DatagramSocket socket;
+  try {
+    socket.Open(port);
+  } catch (const std::runtime_error& error) {
+    std::cerr << error.what() << std::endl;
+    return 1;
+  }
+  std::printf("Hosting up to %zu derbies on port %u\n", host->GetMaxSessions(),
+              static_cast<unsigned>(socket.GetPort()));
+
+  typedef std::chrono::steady_clock Clock;
+  const Clock::duration tick_period =
+      std::chrono::duration_cast<Clock::duration>(
+          std::chrono::duration<double>(1 / kTickRate));
+  vector<SocketAddress> owners(host->GetMaxSessions());
+  uint64_t next_seed = 0;
+  uint8_t message[home_run_derby::kMaxSessionMessageSize];
+  Clock::time_point next_tick = Clock::now();
+  for (size_t tick = 1;; ++tick) {
+    SocketAddress sender;
+    size_t size;
+    while ((size = socket.Receive(message, sizeof(message), &sender)) > 0) {
+      SessionCommand command;
+      SessionCommand answer;
+      if (home_run_derby::DecodeCommand(message, size, &command) &&
+          Dispatch(host, &owners, command, sender, &next_seed, &answer)) {
+        socket.SendTo(sender, message, EncodeCommand(answer, message));
+      }
+    }
+
+    host->Tick();
+
+    if (tick % kStatusEveryTicks == 0) {
+      for (size_t i = 0; i < host->GetMaxSessions(); ++i) {
+        if (host->IsOpen(i)) {
+          socket.SendTo(owners[i], message,
+                        EncodeStatus(MakeStatus(*host, i), message));
+        }
+      }
+    }
+    if (tick % kReportEveryTicks == 0) {
+      Report(*host, tick);
+    }
+
+    // Never try to catch up on ticks missed while falling behind.
+    next_tick = std::max(next_tick + tick_period, Clock::now());
+    std::this_thread::sleep_until(next_tick);
+  }
+}
+
+}  // namespace
+
+/**
+ * Hosts many headless derbies at once for clients on the same machine, each
+ * client driving its own session. With --script, plays out a file of client
+ * commands instead, as a stand-in for clients.
+ *
+ * Usage: derby-server [port] [max_sessions]
+ *        derby-server --script path [max_sessions]
+ */
+int main(int argc, char** argv) {
+  bool is_script = argc > 2 && std::strcmp(argv[1], "--script") == 0;
+  int max_sessions_arg = is_script ? 3 : 2;
+  SessionHostSettings settings;
+  settings.max_sessions =
+      argc > max_sessions_arg
+          ? std::strtoul(argv[max_sessions_arg], nullptr, 10)
+          : kDefaultMaxSessions;
+  settings.num_workers = 0;
+  settings.batch_size = kBatchSize;
+  settings.max_outs = kMaxOuts;
+  settings.tick_slo_seconds = kTickSloSeconds;
+
+  try {
+    SessionHost host(MakePrototype(), settings);
+    if (is_script) {
+      return RunScript(argv[2], &host);
+    }
+    return Serve(argc > 1 ? static_cast<uint16_t>(std::atoi(argv[1]))
+                          : kDefaultPort,
+                 &host);
+  } catch (const std::exception& error) {
+    std::cerr << error.what() << std::endl;
+    return 1;
+  }
+}
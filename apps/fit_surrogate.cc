@@ -0,0 +1,133 @@
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+#include "cinder/Rand.h"
+#include "core/surrogate_fitter.h"
+
+using glm::vec2;
+using home_run_derby::Ball;
+using home_run_derby::Bat;
+using home_run_derby::DistanceSurrogate;
+using home_run_derby::SurrogateFit;
+using home_run_derby::SurrogateFitter;
+using home_run_derby::SwingLimits;
+
+namespace {
+
+// These mirror the game's constants, which the shipped fit is only valid for.
+const float kWindowSize = 1000;
+const float kStretchConstant = 16.0f / 9.0f;
+const float kGroundHeight = 70;
+const float kBallMass = 10;
+const float kBallRadius = 50;
+const float kBatMass = 5;
+const float kBatRadius = 15;
+const float kBatXLimitFactor = 3;
+const float kBallVelocityBoostFactor = 1.5f;
+const float kGravity = 0.09f;
+const float kGroundFriction = 0.1f;
+const float kGroundRestitution = 0.4f;
+const float kBallTerminalVelocity = 1000;
+const float kMinPitchSpeedX = 13;
+const float kMaxPitchSpeedX = 15;
+const float kMinPitchSpeedY = 4;
+const float kMaxPitchSpeedY = 7;
+const float kBallConsideredStoppedVelocity = 0.02f;
+const float kMaxBatSpeed = 100;
+const size_t kMaxTicks = 20000;
+
+// Each pitch is hit this many times before a new one is thrown.
+const size_t kContactsPerPitch = 1000;
+
+const size_t kDefaultNumContacts = 1000000;
+
+void WriteCoefficients(std::ostream& output, const char* name,
+                       const float* coefficients) {
+  output << "constexpr float " << name << "["
+         << DistanceSurrogate::kNumTerms << "] = {";
+  for (size_t i = 0; i < DistanceSurrogate::kNumTerms; ++i) {
+    output << (i % 4 == 0 ? "\n    " : " ") << std::setprecision(9)
+           << coefficients[i] << "f" << (i + 1 < DistanceSurrogate::kNumTerms
+                                            ? ","
+                                            : "");
+  }
+  output << "};\n";
+}
+
+}  // namespace
+
+/**
+ * Fits the distance surrogate to simulated contacts and writes its
+ * coefficients as a header.
+ *
+ * Usage: fit-surrogate [num_contacts] [output_header]
+ */
+int main(int argc, char** argv) {
+  size_t num_contacts =
+      argc > 1 ? std::strtoul(argv[1], nullptr, 10) : kDefaultNumContacts;
+  const char* output_path =
+      argc > 2 ? argv[2] : "include/core/surrogate_coefficients.h";
+
+  float ground_location = kWindowSize - kGroundHeight;
+  SwingLimits limits;
+  limits.min_bat_position =
+      vec2(kWindowSize * kStretchConstant / kBatXLimitFactor, kBatRadius);
+  limits.max_bat_position = vec2(kWindowSize * kStretchConstant,
+                                 ground_location - kBatRadius);
+  limits.max_bat_speed = kMaxBatSpeed;
+  limits.flight.right_edge = kWindowSize * kStretchConstant + kBallRadius;
+  limits.flight.stopped_speed = kBallConsideredStoppedVelocity;
+  limits.flight.max_ticks = kMaxTicks;
+
+  ci::randSeed(0);
+  Ball pitch(kBallMass, kBallRadius, kGravity, kGroundFriction,
+             kGroundRestitution, kBallVelocityBoostFactor,
+             kBallTerminalVelocity, kMinPitchSpeedX, kMaxPitchSpeedX,
+             kMinPitchSpeedY, kMaxPitchSpeedY, kWindowSize);
+  pitch.SetGroundLocation(ground_location);
+  Bat bat(kBatMass, kBatRadius);
+
+  SurrogateFitter fitter(limits, ground_location, kGravity);
+  for (unsigned seed = 0; fitter.GetNumSamples() < num_contacts; ++seed) {
+    pitch.ResetState();
+    size_t num_to_add =
+        std::min(kContactsPerPitch, num_contacts - fitter.GetNumSamples());
+    if (fitter.SampleContacts(pitch, bat, num_to_add, seed) == 0) {
+      std::cerr << "A pitch could not be hit at all." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  SurrogateFit fit;
+  try {
+    fit = fitter.Fit();
+  } catch (const std::runtime_error& error) {
+    std::cerr << error.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cerr << "Fitted " << fit.num_samples << " contacts, RMS error "
+            << fit.rms_error << " px." << std::endl;
+
+  std::ofstream output(output_path);
+  output << "#ifndef HOME_RUN_DERBY_SURROGATE_COEFFICIENTS_H\n"
+         << "#define HOME_RUN_DERBY_SURROGATE_COEFFICIENTS_H\n\n"
+         << "// Generated by fit-surrogate from " << fit.num_samples
+         << " contacts, with an RMS\n// error of " << fit.rms_error
+         << " px. Do not edit by hand; refit instead.\n\n"
+         << "namespace home_run_derby {\n\n";
+  WriteCoefficients(output, "kSurrogateMeanCoefficients",
+                    fit.mean_coefficients);
+  output << "\n";
+  WriteCoefficients(output, "kSurrogateErrorCoefficients",
+                    fit.error_coefficients);
+  output << "\n}  // namespace home_run_derby\n\n"
+         << "#endif  // HOME_RUN_DERBY_SURROGATE_COEFFICIENTS_H\n";
+  if (!output) {
+    std::cerr << "Could not write " << output_path << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
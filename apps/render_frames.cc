@@ -0,0 +1,215 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "core/ai_batter.h"
+#include "core/frame_sink.h"
+#include "visualizer/frame_exporter.h"
+
+using ci::Color;
+using glm::vec2;
+using home_run_derby::AiBatter;
+using home_run_derby::FrameSink;
+using home_run_derby::PpmSequenceWriter;
+using home_run_derby::SwingLimits;
+using home_run_derby::Y4mWriter;
+using home_run_derby::visualizer::FrameExporter;
+using home_run_derby::visualizer::FrameStyle;
+using home_run_derby::visualizer::Simulator;
+using home_run_derby::visualizer::SimulatorSnapshot;
+using std::string;
+using std::vector;
+
+namespace {
+
+// These mirror the game's constants.
+const float kPlayerRadius = 90;
+const float kWindowSize = 1000;
+const float kStretchConstant = 16.0f / 9.0f;
+const float kFrameRate = 144;
+const float kGroundHeight = 70;
+const float kBallMass = 10;
+const float kBallRadius = 50;
+const float kGravity = 0.09f;
+const float kGroundFriction = 0.1f;
+const float kGroundRestitution = 0.4f;
+const float kBallVelocityBoostFactor = 1.5f;
+const float kBallTerminalVelocity = 1000;
+const float kMinPitchSpeedX = 13;
+const float kMaxPitchSpeedX = 15;
+const float kMinPitchSpeedY = 4;
+const float kMaxPitchSpeedY = 7;
+const float kBatMass = 5;
+const float kBatRadius = 15;
+const float kBatXLimitFactor = 3;
+const size_t kNumStars = 150;
+const size_t kNumDirtParticles = 100;
+const float kStarRadius = 3;
+const float kDirtParticleRadius = 2;
+const float kColorChangePerDist = 100000;
+const float kStadiumLineWidth = 6;
+const float kStatisticsFontSize = 50;
+const float kStatisticsLocation = 20;
+const float kDistanceScaleConstant = 50;
+const size_t kMaxOuts = 10;
+const float kAiMaxBatSpeed = 100;
+const size_t kAiMaxTicks = 20000;
+const double kAiPlanningTime = 0.5 / kFrameRate;
+const float kBallConsideredStoppedVelocity = 0.02f;
+
+const uint64_t kDefaultSeed = 1;
+const double kDefaultSeconds = 20;
+const float kDefaultScale = 0.5f;
+
+Simulator MakeSimulator() {
+  return Simulator(kPlayerRadius, kWindowSize, kStretchConstant, kGroundHeight,
+                   kBallMass, kBallRadius, kGravity, kGroundFriction,
+                   kGroundRestitution, kBallVelocityBoostFactor,
+                   kBallTerminalVelocity, kMinPitchSpeedX, kMaxPitchSpeedX,
+                   kMinPitchSpeedY, kMaxPitchSpeedY, kBatMass, kBatRadius,
+                   kNumStars, kNumDirtParticles, kStarRadius,
+                   kDirtParticleRadius);
+}
+
+/**
+ * Builds the style the game draws with, its named colors spelled out.
+ */
+FrameStyle MakeStyle() {
+  FrameStyle style;
+  style.window_size = kWindowSize;
+  style.stretch_constant = kStretchConstant;
+  style.ground_height = kGroundHeight;
+  style.player_radius = kPlayerRadius;
+  style.star_radius = kStarRadius;
+  style.dirt_particle_radius = kDirtParticleRadius;
+  style.ball_radius = kBallRadius;
+  style.gravity = kGravity;
+  style.color_change_per_dist = kColorChangePerDist;
+  style.stadium_line_width = kStadiumLineWidth;
+  style.statistics_font_size = kStatisticsFontSize;
+  style.statistics_location = kStatisticsLocation;
+  style.distance_scale = kDistanceScaleConstant;
+  style.background_color = Color(173.0f / 255, 216.0f / 255, 230.0f / 255);
+  style.star_color = Color(1, 1, 1);
+  style.ground_color = Color(0, 128.0f / 255, 0);
+  style.dirt_color = Color(152.0f / 255, 76.0f / 255, 25.0f / 255);
+  style.dirt_particle_color = Color(223.0f / 255, 169.0f / 255, 93.0f / 255);
+  style.player_color = Color(1, 165.0f / 255, 0);
+  style.ball_color = Color(1, 1, 1);
+  style.bat_color = Color(152.0f / 255, 76.0f / 255, 25.0f / 255);
+  style.stadium_color = Color(0, 100.0f / 255, 0);
+  style.foul_pole_color = Color(1, 1, 0);
+  style.statistics_text_color = Color(0, 0, 0);
+  return style;
+}
+
+SwingLimits MakeSwingLimits() {
+  SwingLimits limits;
+  limits.min_bat_position =
+      vec2(kWindowSize * kStretchConstant / kBatXLimitFactor, kBatRadius);
+  limits.max_bat_position = vec2(kWindowSize * kStretchConstant,
+                                 kWindowSize - kBatRadius - kGroundHeight);
+  limits.max_bat_speed = kAiMaxBatSpeed;
+  limits.flight.right_edge = kWindowSize * kStretchConstant + kBallRadius;
+  limits.flight.stopped_speed = kBallConsideredStoppedVelocity;
+  limits.flight.max_ticks = kAiMaxTicks;
+  return limits;
+}
+
+/**
+ * Plays a game with the computer batting, saving every tick, until the game
+ * is over or long enough.
+ */
+vector<SimulatorSnapshot> PlayGame(Simulator* simulator, size_t max_ticks) {
+  AiBatter ai_batter(MakeSwingLimits(), kAiPlanningTime);
+  vector<SimulatorSnapshot> frames;
+  frames.reserve(max_ticks);
+  while (frames.size() < max_ticks && simulator->GetOuts() < kMaxOuts) {
+    simulator->UpdateOffset();
+    if (simulator->GetPitchTick() == 0) {
+      ai_batter.PlanSwing(simulator->GetBall(), simulator->GetBat());
+    }
+    simulator->UpdateBatStates(
+        ai_batter.GetBatPosition(simulator->GetPitchTick() + 1));
+    simulator->UpdateBallStates();
+    frames.emplace_back();
+    simulator->SaveSnapshot(&frames.back());
+  }
+  return frames;
+}
+
+bool EndsWith(const string& text, const string& suffix) {
+  return text.size() >= suffix.size() &&
+         text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+}  // namespace
+
+/**
+ * Plays a seeded game headless, with the computer batting, and renders it on
+ * the CPU into a YUV4MPEG2 video, if the output ends in .y4m, or a numbered
+ * PPM screenshot per frame otherwise. Needs no GPU, so highlight videos and
+ * visual regression screenshots can be made on a server.
+ *
+ * Usage: render-frames output [seed] [seconds] [scale] [num_workers]
+ */
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cerr << "Usage: render-frames output [seed] [seconds] [scale]"
+              << " [num_workers]" << std::endl;
+    return EXIT_FAILURE;
+  }
+  string output_path = argv[1];
+  uint64_t seed = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : kDefaultSeed;
+  double seconds = argc > 3 ? std::strtod(argv[3], nullptr) : kDefaultSeconds;
+  float scale = argc > 4 ? std::strtof(argv[4], nullptr) : kDefaultScale;
+  size_t num_workers = argc > 5 ? std::strtoul(argv[5], nullptr, 10) : 0;
+
+  Simulator simulator = MakeSimulator();
+  simulator.Seed(seed);
+  simulator.SetGameState(Simulator::kInGame);
+  Simulator prototype = simulator;
+  vector<SimulatorSnapshot> frames = PlayGame(
+      &simulator, static_cast<size_t>(std::max(0.0, seconds * kFrameRate)));
+
+  typedef std::chrono::steady_clock Clock;
+  Clock::time_point start = Clock::now();
+  size_t num_frames = 0;
+  try {
+    FrameExporter exporter(MakeStyle(), nullptr, num_workers, scale);
+    std::ofstream video;
+    std::unique_ptr<FrameSink> sink;
+    if (EndsWith(output_path, ".y4m")) {
+      video.open(output_path, std::ios::binary);
+      if (!video) {
+        throw std::runtime_error("Could not open " + output_path);
+      }
+      sink.reset(new Y4mWriter(video, static_cast<size_t>(kFrameRate)));
+    } else {
+      sink.reset(new PpmSequenceWriter(output_path));
+    }
+    exporter.Export(prototype, frames, sink.get());
+    num_frames = frames.size();
+    std::cerr << "Rendered " << num_frames << " frames of "
+              << exporter.GetFrameWidth() << "x" << exporter.GetFrameHeight()
+              << " on " << exporter.GetNumWorkers() << " workers"
+              << std::endl;
+  } catch (const std::exception& error) {
+    std::cerr << error.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  double render_seconds =
+      std::chrono::duration<double>(Clock::now() - start).count();
+  double frames_per_second = num_frames / render_seconds;
+  std::cerr << frames_per_second << " frames per second, "
+            << frames_per_second / kFrameRate << " times real time"
+            << std::endl;
+  return EXIT_SUCCESS;
+}
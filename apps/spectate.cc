@@ -0,0 +1,124 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+
+#include "core/datagram_socket.h"
+#include "core/spectator_protocol.h"
+
+using home_run_derby::DatagramSocket;
+using home_run_derby::DequantizePosition;
+using home_run_derby::EncodeControl;
+using home_run_derby::MakeLoopbackAddress;
+using home_run_derby::SocketAddress;
+using home_run_derby::SpectatorDecoder;
+using home_run_derby::SpectatorFrame;
+using home_run_derby::SpectatorMessage;
+
+namespace {
+
+// These mirror the game's constants.
+const uint16_t kDefaultPort = 47800;
+const float kDistanceScaleConstant = 50;
+
+// How often a frame is printed, and how long to wait before joining again.
+const size_t kPrintEveryFrames = 144;
+const int kRejoinMilliseconds = 1000;
+const int kPollMilliseconds = 100;
+
+const char* const kGameStateNames[] = {"start screen", "in game",
+                                       "end screen"};
+
+void PrintFrame(const SpectatorFrame& frame, double bytes_per_frame) {
+  int32_t game_state = frame.values[home_run_derby::kGameState];
+  std::printf(
+      "frame %u  %-12s  ball (%.1f, %.1f)  bat (%.1f, %.1f)  outs %d  "
+      "score %.0f ft.  %.1f bytes/frame\n",
+      static_cast<unsigned>(frame.tick),
+      game_state >= 0 && game_state < 3 ? kGameStateNames[game_state] : "?",
+      DequantizePosition(frame.values[home_run_derby::kBallX]),
+      DequantizePosition(frame.values[home_run_derby::kBallY]),
+      DequantizePosition(frame.values[home_run_derby::kBatX]),
+      DequantizePosition(frame.values[home_run_derby::kBatY]),
+      static_cast<int>(frame.values[home_run_derby::kOuts]),
+      frame.values[home_run_derby::kScore] / kDistanceScaleConstant,
+      bytes_per_frame);
+}
+
+}  // namespace
+
+/**
+ * Watches a running game without drawing it, printing the frames it rebuilds.
+ *
+ * Usage: spectate [port] [num_frames]
+ */
+int main(int argc, char** argv) {
+  uint16_t port = argc > 1 ? static_cast<uint16_t>(std::atoi(argv[1]))
+                           : kDefaultPort;
+  size_t num_frames =
+      argc > 2 ? static_cast<size_t>(std::atoll(argv[2])) : 0;
+
+  DatagramSocket socket;
+  try {
+    socket.Open(0);
+  } catch (const std::runtime_error& error) {
+    std::cerr << error.what() << std::endl;
+    return 1;
+  }
+  SocketAddress game = MakeLoopbackAddress(port);
+  SpectatorDecoder decoder;
+  uint8_t message[home_run_derby::kMaxSpectatorMessageSize];
+
+  typedef std::chrono::steady_clock Clock;
+  Clock::time_point last_frame_time = Clock::now();
+  bool has_joined = false;
+  bool has_frame = false;
+  uint32_t latest_tick = 0;
+  size_t num_received = 0;
+  size_t num_bytes = 0;
+  while (num_frames == 0 || num_received < num_frames) {
+    // Join, and join again whenever the game has gone quiet.
+    if (!has_joined ||
+        Clock::now() - last_frame_time >
+            std::chrono::milliseconds(kRejoinMilliseconds)) {
+      size_t size = EncodeControl(SpectatorMessage::kJoin, 0, message);
+      socket.SendTo(game, message, size);
+      has_joined = true;
+      last_frame_time = Clock::now();
+    }
+    if (!socket.Wait(kPollMilliseconds)) {
+      continue;
+    }
+
+    SocketAddress sender;
+    size_t size;
+    while ((size = socket.Receive(message, sizeof(message), &sender)) > 0) {
+      SpectatorFrame frame;
+      if (!(sender == game) || !decoder.Decode(message, size, &frame)) {
+        continue;
+      }
+      last_frame_time = Clock::now();
+      ++num_received;
+      num_bytes += size;
+      size_t ack_size = EncodeControl(SpectatorMessage::kAck, frame.tick,
+                                      message);
+      socket.SendTo(game, message, ack_size);
+
+      // Datagrams can arrive out of order; never show an older frame.
+      if (has_frame && static_cast<int32_t>(frame.tick - latest_tick) <= 0) {
+        continue;
+      }
+      has_frame = true;
+      latest_tick = frame.tick;
+      if (num_received % kPrintEveryFrames == 1) {
+        PrintFrame(frame, static_cast<double>(num_bytes) /
+                              static_cast<double>(num_received));
+      }
+    }
+  }
+
+  size_t size = EncodeControl(SpectatorMessage::kLeave, 0, message);
+  socket.SendTo(game, message, size);
+  return 0;
+}
@@ -0,0 +1,53 @@
+#ifndef HOME_RUN_DERBY_AI_BATTER_H
+#define HOME_RUN_DERBY_AI_BATTER_H
+
+#include "cinder/gl/gl.h"
+#include "core/ball.h"
+#include "core/bat.h"
+#include "core/swing_optimizer.h"
+
+namespace home_run_derby {
+
+using glm::vec2;
+
+/**
+ * A computer-controlled batter that plans the best swing it can find at the
+ * start of every pitch, then plays it back one tick at a time.
+ */
+class AiBatter {
+ public:
+  /**
+   * Creates a batter that swings within the given limits.
+   * @param limits The limits every swing must respect.
+   * @param budget_seconds How long to spend planning each swing.
+   */
+  AiBatter(const SwingLimits& limits, double budget_seconds);
+
+  /**
+   * Plans the swing for a pitch that has just been released.
+   * @param pitch The ball at the start of the pitch.
+   * @param bat The bat that will be swung.
+   */
+  void PlanSwing(const Ball& pitch, const Bat& bat);
+
+  /**
+   * Gets where the bat should be for a tick of the planned swing.
+   * @param tick The tick of the pitch, counted from when it was planned.
+   * @return The bat position for that tick.
+   */
+  const vec2& GetBatPosition(size_t tick) const;
+
+  const Swing& GetSwing() const;
+
+  const SwingOptimizer& GetOptimizer() const;
+
+ private:
+  SwingOptimizer optimizer_;
+  double budget_seconds_;
+  unsigned num_swings_planned_;
+  Swing swing_;
+};
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_AI_BATTER_H
@@ -0,0 +1,90 @@
+#ifndef HOME_RUN_DERBY_ALLOCATION_TRACKER_H
+#define HOME_RUN_DERBY_ALLOCATION_TRACKER_H
+
+#include <cstddef>
+#include <ostream>
+
+namespace home_run_derby {
+
+/**
+ * Counts heap allocations made during a frame, grouped by the call site that
+ * was active when they happened. Counting only takes place when the project is
+ * built with HOME_RUN_DERBY_TRACK_ALLOCATIONS, which replaces the global
+ * operator new; otherwise every count stays at zero.
+ */
+class AllocationTracker {
+ public:
+  /** The most call sites that can be told apart in a single report. **/
+  static const size_t kMaxCallSites = 16;
+
+  /**
+   * The allocations attributed to a single call site.
+   */
+  struct CallSiteCount {
+    const char* call_site;
+    size_t allocations;
+    size_t bytes;
+  };
+
+  /**
+   * Checks whether allocation counting was compiled in.
+   * @return true if allocations are being counted, false otherwise.
+   */
+  static bool IsEnabled();
+
+  /**
+   * Clears the counters and starts counting allocations for a new frame.
+   */
+  static void BeginFrame();
+
+  /**
+   * Stops counting allocations for the current frame.
+   * @return The number of allocations made during the frame.
+   */
+  static size_t EndFrame();
+
+  /**
+   * Records an allocation against the active call site. Called from the
+   * replaced operator new, so this must never allocate itself.
+   * @param bytes The size of the allocation.
+   */
+  static void RecordAllocation(size_t bytes);
+
+  /**
+   * Writes the per call site counts of the last frame to a stream.
+   * @param output The stream to write the report to.
+   */
+  static void Report(std::ostream& output);
+
+  static size_t GetFrameAllocations();
+
+  static size_t GetNumCallSites();
+
+  static const CallSiteCount& GetCallSite(size_t index);
+};
+
+/**
+ * Attributes every allocation made while it is alive to a call site label.
+ * Scopes can be nested; the innermost label wins.
+ */
+class AllocationScope {
+ public:
+  /**
+   * Makes a call site the active one for the current thread.
+   * @param call_site A label with static storage duration.
+   */
+  explicit AllocationScope(const char* call_site);
+
+  ~AllocationScope();
+
+  AllocationScope(const AllocationScope&) = delete;
+
+  AllocationScope& operator=(const AllocationScope&) = delete;
+
+ private:
+  const char* previous_call_site_;
+};
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_ALLOCATION_TRACKER_H
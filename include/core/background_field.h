@@ -0,0 +1,74 @@
+#ifndef HOME_RUN_DERBY_BACKGROUND_FIELD_H
+#define HOME_RUN_DERBY_BACKGROUND_FIELD_H
+
+#include <cstdint>
+#include <vector>
+
+#include "cinder/gl/gl.h"
+#include "core/particle.h"
+
+namespace home_run_derby {
+
+using glm::vec2;
+using std::vector;
+
+/**
+ * The stars in the sky and the dirt particles in the ground, laid out once
+ * and never changed, so any number of views can share one field.
+ *
+ * Nothing in the field moves. A view looks at it through a scroll, the
+ * distance the view has travelled, and every particle's position follows
+ * from that scroll alone: stars drift by a fraction of it for parallax and
+ * dirt moves with the ground, both wrapping around the canvas. Views can
+ * therefore be added without adding any particles or any per-tick work.
+ */
+class BackgroundField {
+ public:
+  /**
+   * Lays out a field.
+   * @param window_size The canvas size.
+   * @param stretch_constant The stretch constant for the horizontal screen
+   * width.
+   * @param num_stars The number of stars on the canvas.
+   * @param num_dirt_particles The number of dirt particles in the ground.
+   * @param star_radius The radius of the stars.
+   * @param dirt_particle_radius The radius of the dirt particles.
+   * @param seed Picks the layout.
+   */
+  BackgroundField(float window_size, float stretch_constant, size_t num_stars,
+                  size_t num_dirt_particles, float star_radius,
+                  float dirt_particle_radius, uint64_t seed);
+
+  size_t GetNumStars() const;
+
+  size_t GetNumDirtParticles() const;
+
+  /**
+   * Gets where a star is seen from a view.
+   * @param index The star, below GetNumStars().
+   * @param scroll How far the view has travelled across the field.
+   * @return The star's position on the canvas.
+   */
+  vec2 GetStarPosition(size_t index, const vec2& scroll) const;
+
+  /**
+   * Gets where a dirt particle is seen from a view. Dirt only wraps around
+   * horizontally, staying in the ground as the view rises and falls.
+   * @param index The dirt particle, below GetNumDirtParticles().
+   * @param scroll How far the view has travelled across the field.
+   * @return The dirt particle's position on the canvas.
+   */
+  vec2 GetDirtParticlePosition(size_t index, const vec2& scroll) const;
+
+ private:
+  float canvas_width_;
+  float canvas_height_;
+  float star_radius_;
+  float dirt_particle_radius_;
+  vector<Particle> stars_;
+  vector<Particle> dirt_particles_;
+};
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_BACKGROUND_FIELD_H
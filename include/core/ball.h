@@ -2,6 +2,8 @@
 #define IDEAL_GAS_BALL_H
 #include "cinder/gl/gl.h"
 #include "core/bat.h"
+#include "core/random.h"
+#include "core/stadium.h"
 
 namespace home_run_derby {
 
@@ -9,6 +11,48 @@ using ci::Color;
 using glm::vec2;
 using std::pair;
 
+/**
+ * How the bat met the ball, captured at the moment of contact.
+ */
+struct ContactEvent {
+  /** Where the ball was when the bat met it. **/
+  vec2 position;
+  /** The ball's speed just after contact, in pixels per tick. **/
+  float exit_speed;
+  /** The angle above level, toward the field, the ball left the bat at. **/
+  float launch_angle_degrees;
+  /**
+   * How far off center the ball was met, from -1 to 1, positive toward the
+   * end of the barrel.
+   */
+  float contact_offset;
+  /** The bat's speed as it met the ball, in pixels per tick. **/
+  float bat_speed;
+  /**
+   * How far toward the field the ball will first come down on flat ground,
+   * or 0 if it is not heading down onto it.
+   */
+  float carry;
+  /** How far above the contact the ball will rise. **/
+  float apex_height;
+};
+
+/**
+ * Everything about a ball that changes as it is pitched and hit, in a flat
+ * block that can be copied like plain memory.
+ */
+struct BallState {
+  vec2 position;
+  vec2 previous_position;
+  vec2 speed;
+  float ground_location;
+  float fence_clearance_x;
+  bool has_collided;
+  bool has_cleared_fence;
+  ContactEvent contact;
+  Random random;
+};
+
 /**
  * Handles the physics and whereabouts of the baseball.
  */
@@ -59,8 +103,10 @@ class Ball {
    * Updates the speed of the ball after colliding with a bat.
    * @param bat The bat instance to collide with.
    * @param bat_position The location to perform the collision at.
+   * @param bat_speed The speed of the bat at the collision.
    */
-  void UpdateSpeedOnCollision(const Bat& bat, const vec2& bat_position);
+  void UpdateSpeedOnCollision(const Bat& bat, const vec2& bat_position,
+                              const vec2& bat_speed);
 
   /**
    * Updates the positions and velocities of the ball.
@@ -77,6 +123,24 @@ class Ball {
    */
   void ResetPitchVelocity();
 
+  /**
+   * Restarts the sequence pitch velocities are drawn from.
+   * @param seed Picks the sequence.
+   */
+  void Seed(uint64_t seed);
+
+  /**
+   * Copies out everything that changes as the ball is pitched and hit.
+   * @param state Receives the state.
+   */
+  void SaveState(BallState* state) const;
+
+  /**
+   * Puts the ball back exactly as it was when a state was saved.
+   * @param state The saved state.
+   */
+  void RestoreState(const BallState& state);
+
   /**
    * Computes the roots of a quadratic equation in the form ax^2 + bx + c = 0.
    * @param A The coefficient of the x^2 term.
@@ -94,8 +158,45 @@ class Ball {
    */
   bool HitPastScreen() const;
 
+  /**
+   * Checks if the ball has been hit for a home run. Without a stadium that
+   * means past the left edge of the screen; in a stadium it means over a fence
+   * or off a foul pole.
+   * @return true if the ball was hit for a home run, false otherwise.
+   */
+  bool IsHomeRun() const;
+
+  /**
+   * Gets how far a home run went. In a stadium, a ball that bounces back
+   * after clearing still counts from where it cleared the fence.
+   * @return The distance past the left edge of the screen, or 0 if the ball
+   * has not been hit for a home run.
+   */
+  float GetHomeRunDistance() const;
+
+  /**
+   * Checks if the bat has made contact with the ball during this pitch.
+   * @return true if the ball has collided with the bat, false otherwise.
+   */
+  bool HasCollided() const;
+
+  /**
+   * Gets how the bat met the ball during this pitch, which is only
+   * meaningful once the ball has collided.
+   */
+  const ContactEvent& GetContact() const;
+
   void SetGroundLocation(float ground_location);
 
+  /**
+   * Plays the ball against a stadium's geometry instead of the flat ground.
+   * @param stadium The stadium, which must outlive the ball, or nullptr to go
+   * back to the flat ground.
+   */
+  void SetStadium(const Stadium* stadium);
+
+  const Stadium* GetStadium() const;
+
   const vec2& GetPosition() const;
 
   const vec2& GetSpeed() const;
@@ -103,6 +204,40 @@ class Ball {
   float GetRadius() const;
 
  private:
+  /**
+   * Computes the roots of a quadratic equation without throwing, so that the
+   * per-tick collision check never allocates an exception.
+   * @param A The coefficient of the x^2 term.
+   * @param B The coefficient of the x term.
+   * @param C The coefficient of the constant term.
+   * @param solutions Receives the solutions of the quadratic equation.
+   * @return true if the quadratic has solutions, false otherwise.
+   */
+  bool SolveQuadratic(float A, float B, float C,
+                      pair<float, float>& solutions) const;
+
+  /**
+   * Notes how the bat met the ball, just after the bounce.
+   * @param offset How far off center the ball was met.
+   * @param bat_speed The bat's velocity as it met the ball.
+   */
+  void CaptureContact(float offset, const vec2& bat_speed);
+
+  /**
+   * Moves the ball for a tick through the stadium, bouncing it off the first
+   * segment in its way and noting whether it scored.
+   */
+  void MoveThroughStadium();
+
+  /**
+   * Collides the ball with a bat that passed through several positions since
+   * the last tick. Each step of the bat's path is swept as a capsule against
+   * the ball moving over the same part of the tick, and the ball bounces off
+   * the first step to touch it.
+   * @param bat The bat, with at least one waypoint.
+   */
+  void HandleSweptBatCollisions(const Bat& bat);
+
   float mass_;
   float radius_;
   float gravity_;
@@ -117,8 +252,16 @@ class Ball {
   float max_y_pitch_speed_;
   float window_size_;
   bool has_collided_;
+  const Stadium* stadium_;
+  bool has_cleared_fence_;
+  // Where the ball cleared a fence or hit a foul pole.
+  float fence_clearance_x_;
+  ContactEvent contact_;
   vec2 position_;
+  // Where the ball started the last tick.
+  vec2 previous_position_;
   vec2 speed_;
+  Random random_;
 };
 
 }  // namespace home_run_derby
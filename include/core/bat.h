@@ -2,6 +2,7 @@
 #define HOME_RUN_DERBY_BAT_H
 
 #include "cinder/gl/gl.h"
+#include "core/bat_catalog.h"
 
 namespace home_run_derby {
 
@@ -12,6 +13,9 @@ using glm::vec2;
  */
 class Bat {
  public:
+  /** The most positions a bat remembers passing through within a tick. **/
+  static const size_t kMaxWaypoints = 16;
+
   /**
    * Default constructor.
    */
@@ -23,6 +27,16 @@ class Bat {
 
   void SetBatPosition(const vec2& new_position);
 
+  /**
+   * Swings a bat from the catalog, whose mass and barrel take the place of
+   * this bat's own, and whose response tables decide how hits come off it.
+   * @param model A model that outlives the bat, or nullptr to go back to the
+   * bat's own mass and radius.
+   */
+  void SetModel(const BatModel* model);
+
+  const BatModel* GetModel() const;
+
   float GetBatMass() const;
 
   float GetBatRadius() const;
@@ -31,11 +45,33 @@ class Bat {
 
   const vec2& GetBatPosition() const;
 
+  /**
+   * Remembers a position the bat passed through since the last tick, so a
+   * curved swing can be collided along its whole path rather than only its
+   * last step. Once full, the newest waypoint replaces the last one, which
+   * keeps where the tick started.
+   * @param waypoint The position, in the order the bat passed through them.
+   */
+  void AddWaypoint(const vec2& waypoint);
+
+  /**
+   * Forgets the path, once a tick has been played with it.
+   */
+  void ClearWaypoints();
+
+  size_t GetNumWaypoints() const;
+
+  const vec2& GetWaypoint(size_t index) const;
+
  private:
   float bat_mass_;
   float bat_radius_;
   vec2 bat_speed_;
   vec2 bat_position_;
+  // The path since the last tick, oldest first, not counting the position.
+  vec2 waypoints_[kMaxWaypoints];
+  size_t num_waypoints_ = 0;
+  const BatModel* model_ = nullptr;
 };
 
 }  // namespace home_run_derby
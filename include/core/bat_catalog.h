@@ -0,0 +1,158 @@
+#ifndef HOME_RUN_DERBY_BAT_CATALOG_H
+#define HOME_RUN_DERBY_BAT_CATALOG_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace home_run_derby {
+
+using std::string;
+using std::vector;
+
+/**
+ * The design of a bat, in game units, before its response is worked out.
+ * Positions along the bat are fractions of its length from the knob.
+ */
+struct BatProfile {
+  string name;
+  float mass;
+  float length;
+  float handle_radius;
+  float barrel_radius;
+  /** Where the handle starts to widen into the barrel. **/
+  float taper_start;
+  /** Where the barrel reaches its full radius. **/
+  float taper_end;
+  /** The center of the sweet spot. **/
+  float sweet_spot;
+  /** How quickly the response falls off away from the sweet spot. **/
+  float sweet_spot_width;
+  /** The restitution at the center of the sweet spot. **/
+  float peak_restitution;
+  /** The restitution far from the sweet spot. **/
+  float min_restitution;
+};
+
+/**
+ * How a bat responds to a ball at a point along its length.
+ */
+struct BatResponse {
+  /** The share of the closing speed the ball keeps, from 0 to 1. **/
+  float restitution;
+  /** The mass the ball feels, less than the bat's away from its center. **/
+  float effective_mass;
+};
+
+/**
+ * A bat ready to play with: its geometry, and tables of its response at
+ * evenly spaced points along its length. The tables are worked out once,
+ * offline, so a hit only has to look them up.
+ *
+ * A model is plain data, so a catalog of them can be read straight from a
+ * file.
+ */
+class BatModel {
+ public:
+  /** The number of points along the bat the response is tabulated at. **/
+  static const size_t kTableSize = 32;
+  /** The longest name a model can have. **/
+  static const size_t kMaxNameLength = 31;
+
+  /**
+   * Works out the response tables for a design by integrating the mass of
+   * the bat along its tapered profile.
+   * @param profile The design of the bat.
+   * @return The model.
+   * @throws invalid_argument if the design is out of range.
+   */
+  static BatModel Build(const BatProfile& profile);
+
+  const char* GetName() const;
+
+  float GetMass() const;
+
+  float GetLength() const;
+
+  float GetBarrelRadius() const;
+
+  /**
+   * Gets the distance from the knob to the center of mass.
+   */
+  float GetCenterOfMass() const;
+
+  /**
+   * Gets the distance from the knob to the center of the sweet spot.
+   */
+  float GetSweetSpot() const;
+
+  /**
+   * Finds where along the bat a contact landed. The game sees the bat end on,
+   * so this is judged by how squarely the ball was met: dead on is the sweet
+   * spot, and the more glancing the blow, the further toward the end of the
+   * barrel or the handle, depending on the side.
+   * @param offset How far off center the ball was met, from -1 to 1.
+   * @return The distance from the knob.
+   */
+  float GetContactPosition(float offset) const;
+
+  /**
+   * Looks up the response at a point, interpolating between the table's
+   * points.
+   * @param position The distance from the knob, clamped to the bat.
+   */
+  BatResponse GetResponse(float position) const;
+
+ private:
+  char name_[kMaxNameLength + 1];
+  float mass_;
+  float length_;
+  float barrel_radius_;
+  float center_of_mass_;
+  float sweet_spot_;
+  float restitution_[kTableSize];
+  float effective_mass_[kTableSize];
+};
+
+/**
+ * The bats a player can choose from, stored as a compact binary asset that
+ * is loaded once.
+ */
+class BatCatalog {
+ public:
+  BatCatalog() = default;
+
+  explicit BatCatalog(const vector<BatModel>& models);
+
+  /**
+   * Reads a catalog written by Save().
+   * @param path The path of the catalog.
+   * @return The catalog.
+   * @throws runtime_error if the file cannot be read or is corrupt.
+   */
+  static BatCatalog Load(const string& path);
+
+  /**
+   * Writes the catalog to a file, replacing it.
+   * @param path The path to write to.
+   * @throws runtime_error if the file cannot be written.
+   */
+  void Save(const string& path) const;
+
+  size_t GetNumModels() const;
+
+  const BatModel& GetModel(size_t index) const;
+
+  /**
+   * Finds a model by name.
+   * @return The model, or nullptr if there is none by that name.
+   */
+  const BatModel* Find(const string& name) const;
+
+ private:
+  vector<BatModel> models_;
+};
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_BAT_CATALOG_H
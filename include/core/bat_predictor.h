@@ -0,0 +1,82 @@
+#ifndef HOME_RUN_DERBY_BAT_PREDICTOR_H
+#define HOME_RUN_DERBY_BAT_PREDICTOR_H
+
+#include <chrono>
+
+#include "cinder/gl/gl.h"
+
+namespace home_run_derby {
+
+using glm::vec2;
+
+/**
+ * Guesses where the player's bat will be when a frame reaches the screen, so
+ * the bat can be drawn there rather than where the last input left it.
+ *
+ * The bat's path is smoothed by an alpha-beta filter over timestamped
+ * samples, which tracks its position and velocity, and extrapolated along
+ * that velocity. Only drawing uses the guess; the game itself always plays
+ * with the samples as they arrived.
+ */
+class BatPredictor {
+ public:
+  typedef std::chrono::steady_clock Clock;
+
+  /**
+   * Creates a predictor with no samples yet.
+   * @param alpha How far each position estimate moves toward a new sample,
+   * from just above 0 to 1.
+   * @param beta How far each velocity estimate moves toward the velocity a new
+   * sample implies, from 0 to 1.
+   * @param horizon_seconds The furthest ahead of the last sample to
+   * extrapolate. Past it, the bat is taken to have stopped where the last
+   * sample put it.
+   * @throws invalid_argument if a setting is out of range.
+   */
+  BatPredictor(float alpha, float beta, double horizon_seconds);
+
+  /**
+   * Updates the estimates with where the bat was at a time.
+   * @param position Where an input put the bat.
+   * @param time When the input arrived, no earlier than the last sample's.
+   */
+  void AddSample(const vec2& position, Clock::time_point time);
+
+  /**
+   * Forgets every sample, e.g. when something else takes over the bat.
+   */
+  void Reset();
+
+  bool HasSamples() const;
+
+  /**
+   * Guesses where the bat is at a time.
+   * @param time When the guess will be shown, usually a little from now.
+   * @return The extrapolated position, the last sample if the time is past
+   * the horizon, or the origin without any samples.
+   */
+  vec2 Predict(Clock::time_point time) const;
+
+  const vec2& GetPosition() const;
+
+  /**
+   * Gets the estimated velocity, in pixels per second.
+   */
+  const vec2& GetVelocity() const;
+
+ private:
+  float alpha_;
+  float beta_;
+  double horizon_seconds_;
+
+  vec2 position_;
+  vec2 velocity_;
+  // The filter lags a bat that has stopped, so it is drawn where it stopped.
+  vec2 last_sample_;
+  Clock::time_point last_sample_time_;
+  bool has_samples_;
+};
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_BAT_PREDICTOR_H
@@ -1,15 +1,27 @@
 #ifndef HOME_RUN_DERBY_CANVAS_FRAME_H
 #define HOME_RUN_DERBY_CANVAS_FRAME_H
-#include <vector>
+#include <memory>
 
 #include "cinder/gl/gl.h"
-#include "core/particle.h"
+#include "core/background_field.h"
+#include "core/random.h"
 
 namespace home_run_derby {
 
 using glm::vec2;
 using std::pair;
-using std::vector;
+using std::shared_ptr;
+
+/**
+ * Everything about a canvas that changes as the game is played, in a flat
+ * block that can be copied like plain memory. The background field is shared
+ * and never changes, so it is not part of the state.
+ */
+struct CanvasState {
+  vec2 offset;
+  vec2 field_origin;
+  Random random;
+};
 
 /**
  * Holds information about locations of drawings on the canvas for the current
@@ -20,7 +32,8 @@ class CanvasFrame {
   CanvasFrame() = default;
 
   /**
-   * Constructor for parameters for drawing the canvas frame.
+   * Constructor for parameters for drawing the canvas frame, laying out a
+   * background field of its own.
    * @param player_radius The radius of the player's body.
    * @param window_size The canvas size.
    * @param stretch_constant The stretch constant for the horizontal screen
@@ -37,14 +50,11 @@ class CanvasFrame {
               float star_radius, float dirt_particle_radius);
 
   /**
-   * Populates the vector of stars with initial values.
+   * Looks at a different background field, e.g. one shared with other
+   * canvases. The field is never changed through the canvas.
+   * @param field The field to look at.
    */
-  void PopulateStars();
-
-  /**
-   * Populates the vector of dirt particles with initial values.
-   */
-  void PopulateDirtParticles();
+  void SetField(const shared_ptr<const BackgroundField>& field);
 
   /**
    * Calculates the head location for the character.
@@ -71,28 +81,35 @@ class CanvasFrame {
   void CalculateDirtLocation(const vec2& offset);
 
   /**
-   * Updates the positions of all the stars on the canvas.
-   * @param velocity The velocity of the canvas at the time of this update call.
+   * Updates the canvas coordinate locations by applying an offset. The stars
+   * and dirt particles follow from the offset, so they cost nothing here.
+   * @param offset An offset to apply to the coordinates.
    */
-  void UpdateStarPositions(const vec2& velocity);
+  void UpdateCanvas(const vec2& offset);
 
   /**
-   * Updates the positions of all the stars on the canvas.
-   * @param velocity The velocity of the canvas at the time of the update call.
+   * Resets the state of the canvas, looking at a new part of the background
+   * field.
    */
-  void UpdateDirtParticlePositions(const vec2& velocity);
+  void ResetState();
 
   /**
-   * Updates the canvas coordinate locations by applying an offset.
-   * @param offset An offset to apply to the coordinates.
-   * @param velocity The velocity of the canvas reference frame.
+   * Restarts the sequence the parts of the background field are picked from.
+   * @param seed Picks the sequence.
    */
-  void UpdateCanvas(const vec2& offset, const vec2& velocity);
+  void Seed(uint64_t seed);
 
   /**
-   * Resets the state of the canvas.
+   * Copies out everything that changes as the canvas moves.
+   * @param state Receives the state.
    */
-  void ResetState();
+  void SaveState(CanvasState* state) const;
+
+  /**
+   * Puts the canvas back exactly as it was when a state was saved.
+   * @param state A state saved from a canvas of the same size.
+   */
+  void RestoreState(const CanvasState& state);
 
   const vec2& GetPlayerHeadLocation() const;
 
@@ -102,31 +119,40 @@ class CanvasFrame {
 
   const pair<vec2, vec2>& GetDirtLocation() const;
 
-  const vector<Particle>& GetStars() const;
+  const shared_ptr<const BackgroundField>& GetField() const;
 
-  const vector<Particle>& GetDirtParticles() const;
+  size_t GetNumStars() const;
+
+  /**
+   * Gets where a star is on the canvas.
+   * @param index The star, below GetNumStars().
+   */
+  vec2 GetStarPosition(size_t index) const;
+
+  size_t GetNumDirtParticles() const;
+
+  /**
+   * Gets where a dirt particle is on the canvas.
+   * @param index The dirt particle, below GetNumDirtParticles().
+   */
+  vec2 GetDirtParticlePosition(size_t index) const;
 
   const vec2& GetOffset() const;
 
  private:
-  // A fixed threshold when the velocity is considered "standstill."
-  float kVelocityConsideredStopped = 0.5f;
-
   float player_radius_;
   float window_size_;
   float stretch_constant_;
   float ground_height_;
-  float star_radius_;
-  float dirt_particle_radius_;
-  size_t num_stars_;
-  size_t num_dirt_particles_;
   vec2 player_head_location_;
   vec2 player_body_location_;
   pair<vec2, vec2> ground_location_;
   pair<vec2, vec2> dirt_location_;
-  vector<Particle> stars_;
-  vector<Particle> dirt_particles_;
+  shared_ptr<const BackgroundField> field_;
+  // Where in the field this canvas looks, before its offset.
+  vec2 field_origin_;
   vec2 offset_;
+  Random random_;
 };
 }  // namespace home_run_derby
 
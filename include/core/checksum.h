@@ -0,0 +1,21 @@
+#ifndef HOME_RUN_DERBY_CHECKSUM_H
+#define HOME_RUN_DERBY_CHECKSUM_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace home_run_derby {
+
+/**
+ * Computes the CRC-32 of a block of bytes. Passing the result of a previous
+ * call as the initial value continues the checksum over several blocks.
+ * @param data The bytes to checksum.
+ * @param size The number of bytes.
+ * @param crc The checksum of the preceding bytes, if any.
+ * @return The CRC-32 of all the bytes checksummed so far.
+ */
+uint32_t Crc32(const void* data, size_t size, uint32_t crc = 0);
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_CHECKSUM_H
@@ -0,0 +1,173 @@
+#ifndef HOME_RUN_DERBY_CONTACT_ANALYTICS_H
+#define HOME_RUN_DERBY_CONTACT_ANALYTICS_H
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "core/ball.h"
+
+namespace home_run_derby {
+
+using std::vector;
+
+/**
+ * Counts contacts by where they send the ball: columns by how far it carries
+ * and rows by how high it rises, in square cells. Contacts past the last
+ * column or row are counted in it.
+ */
+class SprayChart {
+ public:
+  /**
+   * Creates an empty chart.
+   * @param cell_size The width and height of a cell, in pixels.
+   * @param num_columns The number of cells along the carry.
+   * @param num_rows The number of cells along the height.
+   * @throws invalid_argument if the chart would be empty.
+   */
+  SprayChart(float cell_size, size_t num_columns, size_t num_rows);
+
+  /**
+   * Counts a contact in its cell.
+   */
+  void Add(const ContactEvent& contact);
+
+  /**
+   * Forgets every contact.
+   */
+  void Clear();
+
+  uint64_t GetCount(size_t column, size_t row) const;
+
+  /**
+   * Gets the mean exit speed of the contacts in a cell, or 0 if it has none.
+   */
+  float GetMeanExitSpeed(size_t column, size_t row) const;
+
+  float GetCellSize() const;
+
+  size_t GetNumColumns() const;
+
+  size_t GetNumRows() const;
+
+ private:
+  float cell_size_;
+  size_t num_columns_;
+  size_t num_rows_;
+  // Indexed by row, then column.
+  vector<uint64_t> counts_;
+  vector<float> exit_speed_sums_;
+};
+
+/**
+ * Running totals of a run of contacts, kept up to date with each one so
+ * reading them costs nothing.
+ */
+struct ContactSummary {
+  uint64_t num_contacts;
+  /** Contacts met within the sweet spot. **/
+  uint64_t num_sweet_spot;
+  /** Contacts that left the bat at least as fast as the hard-hit speed. **/
+  uint64_t num_hard_hit;
+  float max_exit_speed;
+  double exit_speed_sum;
+  double launch_angle_sum;
+  double bat_speed_sum;
+};
+
+/**
+ * Follows every contact a batter makes: a spray chart and totals across
+ * every game, totals for each game, and a log of the most recent contacts for
+ * export. A contact is folded into everything as it is recorded, so a display
+ * only ever reads the results.
+ *
+ * The log is a ring of fixed size, allocated up front, so recording never
+ * allocates however long the game runs; once it is full, each contact
+ * replaces the oldest.
+ */
+class ContactAnalytics {
+ public:
+  /** How far off center a contact on the sweet spot can be. **/
+  static const float kSweetSpotOffset;
+  /** The number of most recent contacts the log keeps. **/
+  static const size_t kMaxLoggedContacts = 4096;
+
+  /**
+   * Creates analytics with no contacts, in a first game.
+   * @param chart An empty chart laid out as the spray chart should be.
+   * @param hard_hit_speed The exit speed, in pixels per tick, at and above
+   * which a contact counts as hard hit.
+   */
+  ContactAnalytics(const SprayChart& chart, float hard_hit_speed);
+
+  /**
+   * Starts totals for a new game.
+   */
+  void BeginSession();
+
+  /**
+   * Records a contact.
+   */
+  void Record(const ContactEvent& contact);
+
+  /**
+   * Gets the number of contacts recorded, including those the log no longer
+   * keeps.
+   */
+  size_t GetNumContacts() const;
+
+  /**
+   * Gets the number of contacts in the log, at most kMaxLoggedContacts.
+   */
+  size_t GetNumLoggedContacts() const;
+
+  /**
+   * Gets the most recent contact, if there has been one.
+   */
+  const ContactEvent& GetLastContact() const;
+
+  /**
+   * Gets the totals of the current game.
+   */
+  const ContactSummary& GetSessionSummary() const;
+
+  /**
+   * Gets the totals of every game.
+   */
+  const ContactSummary& GetTotalSummary() const;
+
+  const SprayChart& GetSprayChart() const;
+
+  /**
+   * Gets the number of games so far, including the current one.
+   */
+  size_t GetNumSessions() const;
+
+  /**
+   * Writes every contact in the log as CSV, oldest first, one row each, with
+   * the game it was in.
+   * @param output The stream to write to.
+   */
+  void ExportCsv(std::ostream& output) const;
+
+ private:
+  /**
+   * A contact in the log, with the game it was in.
+   */
+  struct LoggedContact {
+    ContactEvent contact;
+    size_t session;
+  };
+
+  float hard_hit_speed_;
+  SprayChart chart_;
+  ContactSummary session_summary_;
+  ContactSummary total_summary_;
+  // Contact i of every one recorded is kept at i % kMaxLoggedContacts.
+  vector<LoggedContact> log_;
+  size_t num_sessions_;
+};
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_CONTACT_ANALYTICS_H
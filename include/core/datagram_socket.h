@@ -0,0 +1,94 @@
+#ifndef HOME_RUN_DERBY_DATAGRAM_SOCKET_H
+#define HOME_RUN_DERBY_DATAGRAM_SOCKET_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace home_run_derby {
+
+/**
+ * A port on the local machine that datagrams are sent from or to.
+ */
+struct SocketAddress {
+  /** The IPv4 address, in host byte order. **/
+  uint32_t host;
+  /** The port, in host byte order. **/
+  uint16_t port;
+
+  bool operator==(const SocketAddress& other) const;
+};
+
+/**
+ * Builds the address of a port on the loopback interface.
+ */
+SocketAddress MakeLoopbackAddress(uint16_t port);
+
+/**
+ * A non-blocking UDP socket bound to the loopback interface, so it is only
+ * reachable from the same machine. Sending and receiving never wait; Wait()
+ * is the only call that does.
+ */
+class DatagramSocket {
+ public:
+  DatagramSocket();
+
+  ~DatagramSocket();
+
+  DatagramSocket(const DatagramSocket&) = delete;
+
+  DatagramSocket& operator=(const DatagramSocket&) = delete;
+
+  /**
+   * Binds the socket, closing any previous one.
+   * @param port The port to bind, or 0 to pick a free one.
+   * @throws runtime_error if the socket could not be created or bound.
+   */
+  void Open(uint16_t port);
+
+  /**
+   * Closes the socket, if one is open.
+   */
+  void Close();
+
+  bool IsOpen() const;
+
+  /**
+   * Gets the port the socket is bound to.
+   */
+  uint16_t GetPort() const;
+
+  /**
+   * Sends a datagram without waiting.
+   * @param address Where to send the datagram.
+   * @param data The bytes to send.
+   * @param size The number of bytes.
+   * @return true if the datagram was handed to the operating system, false if
+   * it would have had to wait or could not be sent.
+   */
+  bool SendTo(const SocketAddress& address, const uint8_t* data, size_t size);
+
+  /**
+   * Takes the next waiting datagram, if there is one.
+   * @param buffer Receives the datagram. Longer datagrams are truncated.
+   * @param capacity The size of the buffer.
+   * @param sender Receives where the datagram came from.
+   * @return The number of bytes received, or 0 if nothing was waiting.
+   */
+  size_t Receive(uint8_t* buffer, size_t capacity, SocketAddress* sender);
+
+  /**
+   * Waits until a datagram arrives.
+   * @param timeout_milliseconds The longest to wait.
+   * @return true if a datagram is waiting, false if the wait timed out.
+   */
+  bool Wait(int timeout_milliseconds);
+
+ private:
+  // A SOCKET on Windows and a file descriptor elsewhere.
+  intptr_t handle_;
+  uint16_t port_;
+};
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_DATAGRAM_SOCKET_H
@@ -0,0 +1,94 @@
+#ifndef HOME_RUN_DERBY_DISTANCE_SURROGATE_H
+#define HOME_RUN_DERBY_DISTANCE_SURROGATE_H
+
+#include <cstddef>
+
+#include "cinder/gl/gl.h"
+#include "core/ball.h"
+
+namespace home_run_derby {
+
+using glm::vec2;
+
+/**
+ * Predicts how far a hit ball will go without simulating its flight.
+ *
+ * The flat ground and the per-bounce friction make the distance a ball travels
+ * scale with its exit x-speed, so the model predicts the travel per unit of
+ * x-speed as a cubic polynomial in the exit y-speed, the y-speed the ball
+ * first lands with and the exit x-speed. The first two fix the time spent in
+ * the air; the last only matters for how soon the ball counts as stopped. A
+ * second polynomial over the same terms predicts the typical size of the
+ * error. Both are fitted offline by SurrogateFitter; the shipped coefficients
+ * live in surrogate_coefficients.h.
+ */
+class DistanceSurrogate {
+ public:
+  /** The number of terms in a cubic polynomial of three variables. **/
+  static const size_t kNumTerms = 20;
+
+  /**
+   * Creates a surrogate with the shipped coefficients.
+   * @param ground_location The y-coordinate of the ground.
+   * @param ball_radius The radius of the ball.
+   * @param gravity The gravitational force acting on the ball.
+   */
+  DistanceSurrogate(float ground_location, float ball_radius, float gravity);
+
+  /**
+   * Creates a surrogate with fitted coefficients.
+   * @param ground_location The y-coordinate of the ground.
+   * @param ball_radius The radius of the ball.
+   * @param gravity The gravitational force acting on the ball.
+   * @param mean_coefficients The kNumTerms coefficients of the travel model.
+   * @param error_coefficients The kNumTerms coefficients of the error model.
+   */
+  DistanceSurrogate(float ground_location, float ball_radius, float gravity,
+                    const float* mean_coefficients,
+                    const float* error_coefficients);
+
+  /**
+   * Predicts how far a ball just hit will end up past the left edge.
+   * @param ball The ball just after contact.
+   * @param error Receives the typical error of the prediction, if not null.
+   * @return The predicted distance past the left edge, or 0 for an out.
+   */
+  float PredictDistance(const Ball& ball, float* error = nullptr) const;
+
+  /**
+   * Predicts the distances for many balls at once. The inputs are laid out as
+   * separate arrays and the loop has no branches, so the compiler can run it
+   * several balls to an instruction.
+   * @param positions_x The x-coordinates of the balls.
+   * @param positions_y The y-coordinates of the balls.
+   * @param speeds_x The exit x-speeds of the balls.
+   * @param speeds_y The exit y-speeds of the balls.
+   * @param count The number of balls.
+   * @param distances Receives the predicted distances.
+   * @param errors Receives the typical errors of the predictions.
+   */
+  void PredictDistances(const float* positions_x, const float* positions_y,
+                        const float* speeds_x, const float* speeds_y,
+                        size_t count, float* distances, float* errors) const;
+
+  /**
+   * Computes the polynomial terms that both models are fitted over.
+   * @param height The height of the bottom of the ball above the ground.
+   * @param exit_velocity The velocity of the ball just after contact.
+   * @param gravity The gravitational force acting on the ball.
+   * @param terms Receives the kNumTerms terms.
+   */
+  static void ComputeTerms(float height, const vec2& exit_velocity,
+                           float gravity, float* terms);
+
+ private:
+  float ground_location_;
+  float ball_radius_;
+  float gravity_;
+  float mean_coefficients_[kNumTerms];
+  float error_coefficients_[kNumTerms];
+};
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_DISTANCE_SURROGATE_H
@@ -0,0 +1,106 @@
+#ifndef HOME_RUN_DERBY_FIELDING_TEAM_H
+#define HOME_RUN_DERBY_FIELDING_TEAM_H
+
+#include <vector>
+
+#include "cinder/gl/gl.h"
+#include "core/ball.h"
+#include "core/spatial_grid.h"
+
+namespace home_run_derby {
+
+using glm::vec2;
+using std::vector;
+
+/**
+ * How a fielding team is laid out and how its fielders move.
+ */
+struct FieldingSettings {
+  /** The x-coordinate of the edge of the outfield nearest the batter. **/
+  float outfield_start_x;
+  /** The x-coordinate of the far edge of the outfield. **/
+  float outfield_end_x;
+  /** The y-coordinate of the ground the fielders stand on. **/
+  float ground_location;
+  /** The gravitational force acting on the ball. **/
+  float gravity;
+  /** The furthest a fielder runs in a tick. **/
+  float max_speed;
+  /** How far to either side a fielder can reach for the ball. **/
+  float catch_radius;
+  /** How high above the ground a fielder can reach for the ball. **/
+  float catch_height;
+  /** The closest two fielders stand to each other. **/
+  float separation;
+};
+
+/**
+ * A team of fielders who run down hit balls and catch them on the fly.
+ *
+ * Every tick the team predicts once where the ball will come down, and only
+ * the fielders who could get there in time chase it; the rest drift back to
+ * their positions. Finding those fielders, keeping them apart and checking
+ * for a catch are all spatial grid queries, so each costs about the same with
+ * hundreds of fielders as with a handful.
+ */
+class FieldingTeam {
+ public:
+  /**
+   * Spreads fielders evenly across the outfield.
+   * @param num_fielders The number of fielders.
+   * @param settings How the fielders are laid out and move.
+   */
+  FieldingTeam(size_t num_fielders, const FieldingSettings& settings);
+
+  /**
+   * Sends every fielder back to their position, ready for the next pitch.
+   */
+  void ResetPositions();
+
+  /**
+   * Moves the fielders for a tick, chasing the ball if it has been hit.
+   * @param ball The ball, after it has moved this tick.
+   */
+  void Update(const Ball& ball);
+
+  /**
+   * Checks if a fielder has caught the ball on the fly since the last reset.
+   * @return true if the ball was caught, false otherwise.
+   */
+  bool HasCaught() const;
+
+  size_t GetNumFielders() const;
+
+  const vec2& GetFielderPosition(size_t fielder) const;
+
+  /**
+   * Checks if a fielder is running down the ball.
+   * @param fielder The fielder to check.
+   * @return true if the fielder is chasing the ball, false otherwise.
+   */
+  bool IsChasing(size_t fielder) const;
+
+ private:
+  /**
+   * Runs a fielder towards a target, as far as a tick allows.
+   */
+  void RunTowards(size_t fielder, const vec2& target);
+
+  /**
+   * Pushes apart every pair of fielders standing too close together.
+   */
+  void SeparateFielders();
+
+  FieldingSettings settings_;
+  SpatialGrid grid_;
+  vector<vec2> home_positions_;
+  vector<bool> is_chasing_;
+  // Reused by every query, so the steady state does not allocate.
+  vector<size_t> nearby_fielders_;
+  bool has_ball_landed_;
+  bool has_caught_;
+};
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_FIELDING_TEAM_H
@@ -0,0 +1,72 @@
+#ifndef HOME_RUN_DERBY_FLIGHT_H
+#define HOME_RUN_DERBY_FLIGHT_H
+
+#include <cstddef>
+
+#include "cinder/gl/gl.h"
+#include "core/ball.h"
+
+namespace home_run_derby {
+
+using glm::vec2;
+
+/**
+ * When the simulator stops following a ball in flight.
+ */
+struct FlightLimits {
+  /** The x-coordinate past which a ball moving right is an out. **/
+  float right_edge;
+  /** The x-speed at or below which the ball is considered stopped. **/
+  float stopped_speed;
+  /** The most ticks of flight to simulate. **/
+  size_t max_ticks;
+};
+
+/**
+ * Where a ball in the air will first come down.
+ */
+struct Landing {
+  /** The center of the ball as it lands. **/
+  vec2 position;
+  /** The number of ticks until it lands, which may be fractional. **/
+  float ticks;
+};
+
+/**
+ * Predicts where a ball in the air first comes down on flat ground, in closed
+ * form rather than by stepping it forward.
+ * @param ball The ball in the air.
+ * @param ground_location The y-coordinate of the ground.
+ * @param gravity The gravitational force acting on the ball.
+ * @param landing Receives the landing, if there is one.
+ * @return true if the ball is above the ground and will come down on it,
+ * false otherwise.
+ */
+bool PredictLanding(const Ball& ball, float ground_location, float gravity,
+                    Landing* landing);
+
+/**
+ * Plays a ball out after contact, the same way the simulator does, and
+ * measures how far left it travels. Flight does not depend on where the ball
+ * starts horizontally, so this is the part of a hit that depends only on its
+ * height and exit velocity.
+ * @param ball The ball just after contact.
+ * @param limits When to stop following the ball.
+ * @return How far left the ball moves before it stops, or 0 if it has not
+ * been hit or is heading right.
+ */
+float SimulateTravel(const Ball& ball, const FlightLimits& limits);
+
+/**
+ * Plays a ball out after contact, the same way the simulator does, until it
+ * stops or runs out of ticks.
+ * @param ball The ball just after contact.
+ * @param limits When to stop following the ball.
+ * @return The distance the ball came to rest past the left edge, or 0 if it
+ * is not a home run.
+ */
+float SimulateFlight(const Ball& ball, const FlightLimits& limits);
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_FLIGHT_H
@@ -0,0 +1,45 @@
+#ifndef HOME_RUN_DERBY_FORMATTED_TEXT_H
+#define HOME_RUN_DERBY_FORMATTED_TEXT_H
+
+#include <string>
+
+namespace home_run_derby {
+
+using std::string;
+
+/**
+ * A line of text that is formatted in place every frame. The storage is
+ * reserved up front, so reformatting the line never allocates.
+ */
+class FormattedText {
+ public:
+  /** The longest line that can be formatted, including the terminator. **/
+  static const size_t kMaxLength = 128;
+
+  /**
+   * Reserves the storage for the line.
+   */
+  FormattedText();
+
+  /**
+   * Formats the line with printf-style arguments, truncating it if it does not
+   * fit in kMaxLength characters.
+   * @param format The printf-style format string.
+   * @return The formatted line.
+   */
+  const string& Format(const char* format, ...)
+#if defined(__GNUC__) || defined(__clang__)
+      __attribute__((format(printf, 2, 3)))
+#endif
+      ;
+
+  const string& GetText() const;
+
+ private:
+  char buffer_[kMaxLength];
+  string text_;
+};
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_FORMATTED_TEXT_H
@@ -0,0 +1,97 @@
+#ifndef HOME_RUN_DERBY_FRAME_SINK_H
+#define HOME_RUN_DERBY_FRAME_SINK_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "core/software_rasterizer.h"
+
+namespace home_run_derby {
+
+using std::string;
+using std::vector;
+
+/**
+ * Somewhere rendered frames go, one after another.
+ */
+class FrameSink {
+ public:
+  virtual ~FrameSink() = default;
+
+  /**
+   * Writes the next frame.
+   * @param image The frame, the same size as every other frame.
+   * @throws runtime_error if the frame cannot be written.
+   */
+  virtual void WriteFrame(const RasterImage& image) = 0;
+};
+
+/**
+ * Writes each frame to a numbered binary PPM file, e.g. the screenshots of
+ * a visual regression test. Alpha is dropped.
+ */
+class PpmSequenceWriter : public FrameSink {
+ public:
+  /**
+   * Creates a writer that has written nothing yet.
+   * @param path_prefix The start of each file's path, which is followed by a
+   * six digit frame number and ".ppm".
+   */
+  explicit PpmSequenceWriter(const string& path_prefix);
+
+  void WriteFrame(const RasterImage& image) override;
+
+  /**
+   * Gets the path the next frame will be written to.
+   */
+  string GetNextPath() const;
+
+  size_t GetNumFrames() const;
+
+ private:
+  string path_prefix_;
+  size_t num_frames_;
+  vector<uint8_t> row_;
+};
+
+/**
+ * Writes frames as a YUV4MPEG2 stream, which video encoders such as ffmpeg
+ * read as is. Colors are converted to full range BT.601 4:2:0, the chroma
+ * averaged over each two by two block of pixels. Alpha is dropped.
+ */
+class Y4mWriter : public FrameSink {
+ public:
+  /**
+   * Creates a writer that writes the stream's header with the first frame.
+   * @param output The stream to write to, which outlives the writer.
+   * @param frame_rate The number of frames in a second.
+   * @throws invalid_argument if the frame rate is not positive.
+   */
+  Y4mWriter(std::ostream& output, size_t frame_rate);
+
+  /**
+   * Writes the next frame.
+   * @throws invalid_argument if the frame is not the size of the first.
+   * @throws runtime_error if the stream fails.
+   */
+  void WriteFrame(const RasterImage& image) override;
+
+  size_t GetNumFrames() const;
+
+ private:
+  std::ostream& output_;
+  size_t frame_rate_;
+  size_t width_;
+  size_t height_;
+  size_t num_frames_;
+  // One frame's planes, reused for every frame.
+  vector<uint8_t> luma_;
+  vector<uint8_t> blue_chroma_;
+  vector<uint8_t> red_chroma_;
+};
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_FRAME_SINK_H
@@ -0,0 +1,81 @@
+#ifndef HOME_RUN_DERBY_HIT_STATISTICS_H
+#define HOME_RUN_DERBY_HIT_STATISTICS_H
+
+#include <ostream>
+#include <vector>
+
+#include "core/quantile_sketch.h"
+
+namespace home_run_derby {
+
+using std::vector;
+
+/**
+ * What came of the bat meeting the ball, measured once the pitch is over.
+ */
+struct HitOutcome {
+  /** How far left of where it was hit the ball ended up, in pixels. **/
+  float distance;
+  /** The ball's speed just after contact, in pixels per tick. **/
+  float exit_speed;
+  /** The angle above level, toward the field, the ball left the bat at. **/
+  float launch_angle_degrees;
+  /**
+   * The ticks from contact until the ball first came down, or until the pitch
+   * ended if it was caught or went by first.
+   */
+  float flight_ticks;
+};
+
+/**
+ * The measures of a hit that statistics are kept on.
+ */
+enum HitMeasure {
+  kHitDistance,
+  kExitSpeed,
+  kLaunchAngle,
+  kFlightTime,
+  kNumHitMeasures
+};
+
+/**
+ * Keeps the distribution of every measure of a stream of hits, in fixed
+ * memory however many hits there are.
+ *
+ * Statistics are not thread safe. Workers that play games at once each keep
+ * their own and merge them at the end.
+ */
+class HitStatistics {
+ public:
+  /** How far off, relative to the value, each estimate may be. **/
+  static const double kRelativeAccuracy;
+
+  HitStatistics();
+
+  /**
+   * Adds a hit to every measure.
+   */
+  void Record(const HitOutcome& hit);
+
+  /**
+   * Adds every hit of other statistics.
+   */
+  void Merge(const HitStatistics& other);
+
+  uint64_t GetNumHits() const;
+
+  const QuantileSketch& GetSketch(HitMeasure measure) const;
+
+  /**
+   * Writes the median and tail of every measure.
+   * @param output The stream to write to.
+   */
+  void Report(std::ostream& output) const;
+
+ private:
+  vector<QuantileSketch> sketches_;
+};
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_HIT_STATISTICS_H
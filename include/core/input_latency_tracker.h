@@ -0,0 +1,110 @@
+#ifndef HOME_RUN_DERBY_INPUT_LATENCY_TRACKER_H
+#define HOME_RUN_DERBY_INPUT_LATENCY_TRACKER_H
+
+#include <chrono>
+#include <ostream>
+
+#include "core/metrics.h"
+
+namespace home_run_derby {
+
+/**
+ * The points an input passes on its way to the screen, each measured from
+ * when the input arrived.
+ */
+enum LatencyStage {
+  // The bat was moved to the input's position.
+  kBatUpdated,
+  // A physics tick ran with the bat where the input put it.
+  kSimulated,
+  // The bat, where the input put it, made contact with the ball.
+  kContact,
+  // A frame showing that contact was drawn.
+  kPresented,
+  kNumLatencyStages
+};
+
+/**
+ * Follows each mouse input from its arrival to the frame that shows the bat
+ * it moved hitting the ball, and keeps the distribution of those latencies
+ * over a session.
+ *
+ * Only the newest input is followed, since it alone decides where the bat is.
+ * Every call takes the time it happens at, which defaults to now.
+ */
+class InputLatencyTracker {
+ public:
+  typedef std::chrono::steady_clock Clock;
+
+  /** The upper bounds, in seconds, of the buckets latencies fall into. **/
+  static const vector<double> kLatencyBuckets;
+
+  InputLatencyTracker();
+
+  /**
+   * Starts a new session, forgetting every latency and input so far.
+   */
+  void BeginSession();
+
+  /**
+   * Tags an input as it arrives, before anything acts on it.
+   */
+  void OnInput(Clock::time_point now = Clock::now());
+
+  /**
+   * Notes that the bat moved. The bat follows the newest input if one has
+   * arrived since the last move; otherwise something other than an input,
+   * e.g. the computer batter, moved it.
+   */
+  void OnBatUpdated(Clock::time_point now = Clock::now());
+
+  /**
+   * Notes that a physics tick ran with the bat where it is.
+   */
+  void OnTick(Clock::time_point now = Clock::now());
+
+  /**
+   * Notes that the bat made contact with the ball during the last tick.
+   */
+  void OnContact(Clock::time_point now = Clock::now());
+
+  /**
+   * Notes that a frame showing every tick so far was drawn.
+   */
+  void OnPresent(Clock::time_point now = Clock::now());
+
+  /**
+   * Gets the latencies, in seconds, of a stage over the session.
+   */
+  const Histogram& GetLatencies(LatencyStage stage) const;
+
+  /**
+   * Writes the median, 95th and 99th percentile of each stage.
+   * @param output The stream to write the report to.
+   */
+  void Report(std::ostream& output) const;
+
+ private:
+  /**
+   * Records the time from an input's arrival to a stage.
+   */
+  void Record(LatencyStage stage, Clock::time_point input,
+              Clock::time_point now);
+
+  unique_ptr<Histogram> latencies_[kNumLatencyStages];
+
+  // The newest input, until the bat follows it.
+  Clock::time_point new_input_;
+  bool has_new_input_;
+  // The input the bat is following, if any.
+  Clock::time_point bat_input_;
+  bool has_bat_input_;
+  bool has_simulated_bat_input_;
+  // The input behind a contact that has not been drawn yet, if any.
+  Clock::time_point contact_input_;
+  bool has_contact_input_;
+};
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_INPUT_LATENCY_TRACKER_H
@@ -0,0 +1,116 @@
+#ifndef HOME_RUN_DERBY_LEADERBOARD_H
+#define HOME_RUN_DERBY_LEADERBOARD_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace home_run_derby {
+
+using std::vector;
+
+/**
+ * Ranks every recorded score. Scores are counted in fixed-width buckets held
+ * in a Fenwick tree, so inserting a score and asking for a rank, percentile or
+ * the score at a rank all take O(log n) in the number of buckets, however many
+ * scores have been recorded. Memory stays fixed at one counter per bucket.
+ *
+ * A single writer may insert scores while any number of threads read. Counters
+ * are atomic, so readers never block and never see a torn count; a read that
+ * races an insert may or may not include it.
+ */
+class Leaderboard {
+ public:
+  /**
+   * Creates an empty leaderboard.
+   * @param max_score The highest score that can be told apart; higher scores
+   * share the top bucket.
+   * @param resolution The width of a bucket. Scores in the same bucket tie.
+   */
+  Leaderboard(float max_score, float resolution);
+
+  Leaderboard(const Leaderboard&) = delete;
+
+  Leaderboard& operator=(const Leaderboard&) = delete;
+
+  /**
+   * Records a score.
+   * @param score The score to record.
+   */
+  void Insert(float score);
+
+  /**
+   * Records many scores. Runs of scores that fall in the same bucket are added
+   * with a single update, so loading a sorted snapshot costs O(n) plus
+   * O(log n) per distinct bucket.
+   * @param scores The scores to record.
+   * @param num_scores The number of scores.
+   */
+  void InsertAll(const float* scores, size_t num_scores);
+
+  /**
+   * Gets the rank a score would have on the leaderboard.
+   * @param score The score to rank.
+   * @return One more than the number of recorded scores above it.
+   */
+  size_t GetRank(float score) const;
+
+  /**
+   * Gets the percentage of recorded scores at or below a score.
+   * @param score The score to look up.
+   * @return A percentage from 0 to 100, or 100 if nothing was recorded.
+   */
+  float GetPercentile(float score) const;
+
+  /**
+   * Gets the score at a rank, rounded down to its bucket.
+   * @param rank The rank, starting from 1 for the highest score.
+   * @return The score at that rank, or 0 if there is no such rank.
+   */
+  float GetScoreAtRank(size_t rank) const;
+
+  /**
+   * Gets the highest scores, rounded down to their buckets.
+   * @param count The number of scores to get.
+   * @return Up to count scores from highest to lowest.
+   */
+  vector<float> GetTopScores(size_t count) const;
+
+  size_t GetNumScores() const;
+
+ private:
+  /**
+   * Finds the bucket a score falls in.
+   */
+  size_t GetBucket(float score) const;
+
+  /**
+   * Adds to the count of a bucket.
+   */
+  void AddToBucket(size_t bucket, uint32_t count);
+
+  /**
+   * Counts the scores in buckets up to and including a bucket.
+   */
+  size_t CountThrough(size_t bucket) const;
+
+  /**
+   * Finds the lowest bucket through which at least a number of scores are
+   * counted.
+   */
+  size_t FindBucket(size_t num_scores) const;
+
+  float resolution_;
+  size_t num_buckets_;
+  // The largest power of two no greater than the number of buckets, used to
+  // search the tree from the top down.
+  size_t highest_step_;
+  // Fenwick tree over the bucket counts, indexed from 1.
+  vector<std::atomic<uint32_t>> tree_;
+  std::atomic<size_t> num_scores_;
+};
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_LEADERBOARD_H
@@ -0,0 +1,55 @@
+#ifndef HOME_RUN_DERBY_MAPPED_FILE_H
+#define HOME_RUN_DERBY_MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+namespace home_run_derby {
+
+using std::string;
+
+/**
+ * A read-only memory mapping of a whole file. Pages are loaded lazily by the
+ * operating system, so opening a large file costs the same as a small one.
+ */
+class MappedFile {
+ public:
+  MappedFile();
+
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  /**
+   * Maps a file into memory, replacing any previous mapping.
+   * @param path The path of the file to map.
+   * @return true if the file was mapped, false if it does not exist or could
+   * not be mapped.
+   */
+  bool Open(const string& path);
+
+  /**
+   * Unmaps the file, if one is mapped.
+   */
+  void Close();
+
+  bool IsOpen() const;
+
+  const char* GetData() const;
+
+  size_t GetSize() const;
+
+ private:
+  const char* data_;
+  size_t size_;
+#ifdef _WIN32
+  void* file_handle_;
+  void* mapping_handle_;
+#endif
+};
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_MAPPED_FILE_H
@@ -0,0 +1,179 @@
+#ifndef HOME_RUN_DERBY_METRICS_H
+#define HOME_RUN_DERBY_METRICS_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace home_run_derby {
+
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+/**
+ * A count that only goes up, e.g. the number of pitches thrown.
+ */
+class Counter {
+ public:
+  Counter();
+
+  void Increment(uint64_t amount = 1);
+
+  uint64_t GetValue() const;
+
+ private:
+  std::atomic<uint64_t> value_;
+};
+
+/**
+ * A value that can go up and down, e.g. the number of spectators.
+ */
+class Gauge {
+ public:
+  Gauge();
+
+  void Set(double value);
+
+  double GetValue() const;
+
+ private:
+  std::atomic<double> value_;
+};
+
+/**
+ * Counts observations, e.g. frame times, into buckets by their size.
+ */
+class Histogram {
+ public:
+  /**
+   * Creates an empty histogram.
+   * @param upper_bounds The inclusive upper bound of each bucket, in increasing
+   * order. A final bucket holds everything larger.
+   * @throws invalid_argument if the bounds are not strictly increasing.
+   */
+  explicit Histogram(const vector<double>& upper_bounds);
+
+  /**
+   * Records an observation.
+   */
+  void Observe(double value);
+
+  /**
+   * Adds every observation of another histogram, e.g. one kept per thread so
+   * that busy threads never contend on the same counts.
+   * @param other A histogram with the same bounds.
+   * @throws invalid_argument if the bounds differ.
+   */
+  void Merge(const Histogram& other);
+
+  const vector<double>& GetUpperBounds() const;
+
+  /**
+   * Gets the number of observations in a single bucket.
+   * @param bucket The bucket, where the number of upper bounds is the bucket
+   * for everything larger.
+   */
+  uint64_t GetBucketCount(size_t bucket) const;
+
+  double GetSum() const;
+
+  /**
+   * Gets the number of observations across every bucket.
+   */
+  uint64_t GetCount() const;
+
+  /**
+   * Estimates a quantile by interpolating within the bucket it falls in,
+   * assuming no observation is negative. A quantile in the final bucket is
+   * reported as the last upper bound.
+   * @param quantile Between 0 and 1, e.g. 0.95 for the 95th percentile.
+   * @return The estimate, or 0 if nothing has been observed.
+   */
+  double EstimateQuantile(double quantile) const;
+
+ private:
+  vector<double> upper_bounds_;
+  unique_ptr<std::atomic<uint64_t>[]> bucket_counts_;
+  std::atomic<double> sum_;
+};
+
+/**
+ * Holds the metrics a game exports, and writes them in the Prometheus text
+ * format.
+ *
+ * Metrics are registered once at startup. Updating one is a single atomic
+ * operation on the metric itself and never touches the registry, so the game
+ * loop never waits on a reader. Writing the metrics out reads each value
+ * atomically, so a reader sees every metric as it was at some instant, though
+ * not all at the same instant.
+ */
+class MetricsRegistry {
+ public:
+  MetricsRegistry() = default;
+
+  MetricsRegistry(const MetricsRegistry&) = delete;
+
+  MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+  /**
+   * Registers a counter.
+   * @param name The metric name, e.g. home_run_derby_pitches_total.
+   * @param help A description of what is counted.
+   * @return The counter, which lives as long as the registry.
+   * @throws invalid_argument if the name is malformed or already taken.
+   */
+  Counter* AddCounter(const string& name, const string& help);
+
+  /**
+   * Registers a gauge. See AddCounter().
+   */
+  Gauge* AddGauge(const string& name, const string& help);
+
+  /**
+   * Registers a histogram. See AddCounter() and Histogram().
+   */
+  Histogram* AddHistogram(const string& name, const string& help,
+                          const vector<double>& upper_bounds);
+
+  /**
+   * Writes every metric in the Prometheus text exposition format.
+   * @param output The stream to write to.
+   */
+  void WriteText(std::ostream& output) const;
+
+ private:
+  enum class MetricType { kCounter, kGauge, kHistogram };
+
+  struct Metric {
+    string name;
+    string help;
+    MetricType type;
+    unique_ptr<Counter> counter;
+    unique_ptr<Gauge> gauge;
+    unique_ptr<Histogram> histogram;
+  };
+
+  /**
+   * Creates a metric with no value yet, checking its name.
+   */
+  static unique_ptr<Metric> MakeMetric(const string& name, const string& help,
+                                       MetricType type);
+
+  /**
+   * Adds a finished metric, so readers never see one half built.
+   */
+  void Register(unique_ptr<Metric> metric);
+
+  // Only guards the list of metrics, never their values.
+  mutable std::mutex mutex_;
+  vector<unique_ptr<Metric>> metrics_;
+};
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_METRICS_H
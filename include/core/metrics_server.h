@@ -0,0 +1,80 @@
+#ifndef HOME_RUN_DERBY_METRICS_SERVER_H
+#define HOME_RUN_DERBY_METRICS_SERVER_H
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "core/metrics.h"
+
+namespace home_run_derby {
+
+/**
+ * A minimal HTTP server on the loopback interface that answers GET /metrics
+ * with a registry's metrics in the Prometheus text format.
+ *
+ * Requests are served one at a time on a background thread, which only reads
+ * the metrics, so a slow scraper can never hold up the game.
+ */
+class MetricsServer {
+ public:
+  /**
+   * Creates a server that has not started yet.
+   * @param registry The metrics to serve, which outlive the server.
+   * @param port The port to listen on, or 0 to pick a free one.
+   */
+  MetricsServer(const MetricsRegistry& registry, uint16_t port);
+
+  /**
+   * Stops serving.
+   */
+  ~MetricsServer();
+
+  MetricsServer(const MetricsServer&) = delete;
+
+  MetricsServer& operator=(const MetricsServer&) = delete;
+
+  /**
+   * Starts listening and serving on a background thread.
+   * @throws runtime_error if the port could not be bound.
+   */
+  void Start();
+
+  /**
+   * Stops serving and closes the port.
+   */
+  void Stop();
+
+  /**
+   * Gets the port being listened on, once started.
+   */
+  uint16_t GetPort() const;
+
+ private:
+  /**
+   * Runs on the background thread until stopped.
+   */
+  void Run();
+
+  /**
+   * Reads a request from a connection and writes the response.
+   */
+  void Serve(intptr_t connection);
+
+  /** The longest the server waits on a connection, in milliseconds. **/
+  static const int kPollMilliseconds = 100;
+  /** The longest request that is read. **/
+  static const size_t kMaxRequestSize = 4096;
+
+  const MetricsRegistry& registry_;
+  uint16_t port_;
+  // A SOCKET on Windows and a file descriptor elsewhere.
+  intptr_t listener_;
+  uint16_t bound_port_;
+  std::thread thread_;
+  std::atomic<bool> is_running_;
+};
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_METRICS_SERVER_H
@@ -0,0 +1,164 @@
+#ifndef HOME_RUN_DERBY_OUTCOME_CACHE_H
+#define HOME_RUN_DERBY_OUTCOME_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "cinder/gl/gl.h"
+#include "core/ball.h"
+#include "core/bat.h"
+#include "core/flight.h"
+
+namespace home_run_derby {
+
+using glm::vec2;
+using std::vector;
+
+/**
+ * What happens when a bat meets a ball.
+ */
+struct ContactOutcome {
+  /** Whether the bat made contact with the ball. **/
+  bool has_contact;
+  /** The velocity of the ball straight after the contact check. **/
+  vec2 exit_velocity;
+  /** The distance the ball is hit past the left edge, or 0 for an out. **/
+  float distance;
+};
+
+/**
+ * Remembers the outcome of bat-ball contacts, so that asking about the same
+ * contact again skips the collision and the whole flight simulation.
+ *
+ * Contacts are keyed on the ball and bat positions and speeds, rounded to a
+ * resolution, so nearby contacts share an outcome, along with the bat's model
+ * and the ball's stadium. The rest of the ball's physics is not part of the
+ * key, so a cache should only be asked about one kind of ball. Nor is the path
+ * the bat took within a tick, so every contact is played from the bat's last
+ * step alone.
+ *
+ * The cache holds a fixed number of entries in open-addressed tables split
+ * into independently locked shards. A key only ever lives within a short probe
+ * window of its home slot; once the window is full, a CLOCK sweep over it
+ * evicts an entry that has not been read since the sweep last passed.
+ */
+class OutcomeCache {
+ public:
+  /**
+   * Creates an empty cache.
+   * @param capacity The most outcomes to hold, rounded up to a power of two.
+   * @param position_resolution The rounding applied to positions in the key.
+   * @param speed_resolution The rounding applied to speeds in the key.
+   * @param flight When to stop following a hit ball.
+   */
+  OutcomeCache(size_t capacity, float position_resolution,
+               float speed_resolution, const FlightLimits& flight);
+
+  OutcomeCache(const OutcomeCache&) = delete;
+
+  OutcomeCache& operator=(const OutcomeCache&) = delete;
+
+  /**
+   * Gets the outcome of a bat meeting a ball, simulating it only if a nearby
+   * contact has not been seen before.
+   * @param ball The ball before the contact check.
+   * @param bat The bat to check contact with.
+   * @return The outcome of the contact.
+   */
+  const ContactOutcome Resolve(const Ball& ball, const Bat& bat);
+
+  /**
+   * Looks up a contact without simulating it.
+   * @param ball The ball before the contact check.
+   * @param bat The bat to check contact with.
+   * @param outcome Receives the outcome, if it is cached.
+   * @return true if the outcome was cached, false otherwise.
+   */
+  bool Lookup(const Ball& ball, const Bat& bat, ContactOutcome* outcome);
+
+  /**
+   * Stores the outcome of a contact, evicting another one if needed.
+   * @param ball The ball before the contact check.
+   * @param bat The bat to check contact with.
+   * @param outcome The outcome to store.
+   */
+  void Insert(const Ball& ball, const Bat& bat, const ContactOutcome& outcome);
+
+  /**
+   * Simulates a contact without the cache.
+   * @param ball The ball before the contact check.
+   * @param bat The bat to check contact with, of which only the last step is
+   * played; any waypoints are ignored.
+   * @return The outcome of the contact.
+   */
+  const ContactOutcome SimulateContact(const Ball& ball, const Bat& bat) const;
+
+  size_t GetCapacity() const;
+
+  size_t GetNumHits() const;
+
+  size_t GetNumMisses() const;
+
+  size_t GetNumEvictions() const;
+
+ private:
+  /** The number of independently locked parts of the cache. **/
+  static const size_t kNumShards = 16;
+  /** The number of slots after its home slot that a key may live in. **/
+  static const size_t kProbeWindow = 8;
+  /** The number of rounded values that make up a key. **/
+  static const size_t kKeySize = 9;
+
+  /**
+   * The rounded contact state that outcomes are looked up by, along with what
+   * the ball and bat are made of.
+   */
+  struct Key {
+    int32_t values[kKeySize];
+    const BatModel* model;
+    const Stadium* stadium;
+
+    bool operator==(const Key& other) const;
+  };
+
+  /**
+   * An entry in the open-addressed table. A hash of 0 marks an empty slot.
+   */
+  struct Slot {
+    uint64_t hash;
+    Key key;
+    ContactOutcome outcome;
+    bool is_referenced;
+  };
+
+  struct Shard {
+    std::mutex mutex;
+    vector<Slot> slots;
+    size_t clock_hand;
+  };
+
+  /**
+   * Rounds a contact state into a key and hashes it.
+   */
+  uint64_t MakeKey(const Ball& ball, const Bat& bat, Key* key) const;
+
+  Shard& GetShard(uint64_t hash) const;
+
+  size_t GetHomeSlot(uint64_t hash, const Shard& shard) const;
+
+  float position_resolution_;
+  float speed_resolution_;
+  FlightLimits flight_;
+  size_t capacity_;
+  std::unique_ptr<Shard[]> shards_;
+  std::atomic<size_t> num_hits_;
+  std::atomic<size_t> num_misses_;
+  std::atomic<size_t> num_evictions_;
+};
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_OUTCOME_CACHE_H
@@ -2,6 +2,7 @@
 #define HOME_RUN_DERBY_PARTICLE_H
 
 #include "cinder/gl/gl.h"
+#include "core/random.h"
 
 namespace home_run_derby {
 
@@ -20,10 +21,18 @@ class Particle {
   /**
    * Creates a particle at the specified position.
    * @param position The position on the canvas to create the particle.
-   * @param randomize_velocity Determines whether or not to randomize the
-   * velocity of the particle.
+   * @param random The generator to draw the particle's velocity from, or
+   * nullptr for a particle that moves with the canvas.
    */
-  Particle(const vec2& position, bool randomize_velocity = true);
+  Particle(const vec2& position, Random* random);
+
+  /**
+   * Reinitializes the particle in place at the specified position.
+   * @param position The position on the canvas to move the particle to.
+   * @param random The generator to draw the particle's velocity from, or
+   * nullptr for a particle that moves with the canvas.
+   */
+  void Reset(const vec2& position, Random* random);
 
   /**
    * Updates the position with a specified velocity.
@@ -35,9 +44,15 @@ class Particle {
 
   const vec2& GetPosition() const;
 
+  /**
+   * Gets the fraction of the canvas velocity the particle moves at.
+   */
+  float GetSpeedMultiplier() const;
+
  private:
-  const float kMinVelocityMultiplier = 0.1f;
-  const float kMaxVelocityMultiplier = 0.4f;
+  // Static, so that particles stay trivially copyable into snapshots.
+  static constexpr float kMinVelocityMultiplier = 0.1f;
+  static constexpr float kMaxVelocityMultiplier = 0.4f;
 
   float speed_multiplier_;
   vec2 position_;
@@ -0,0 +1,191 @@
+#ifndef HOME_RUN_DERBY_PHYSICS_CALIBRATOR_H
+#define HOME_RUN_DERBY_PHYSICS_CALIBRATOR_H
+
+#include <atomic>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinder/gl/gl.h"
+#include "core/ball.h"
+#include "core/bat.h"
+#include "core/flight.h"
+#include "core/physics_profile.h"
+#include "core/step_worker.h"
+
+namespace home_run_derby {
+
+using glm::vec2;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+/**
+ * A real batted ball, as measured by a tracking system.
+ */
+struct BattedBall {
+  float exit_speed_mph;
+  /** The angle above level the ball left the bat at. **/
+  float launch_angle_degrees;
+  /** How far from the plate the ball came to rest, in feet. **/
+  float distance_feet;
+  /** The bat's speed as it met the ball, or 0 if it was not measured. **/
+  float bat_speed_mph;
+};
+
+/**
+ * Everything about the game the calibration holds fixed.
+ */
+struct CalibrationSettings {
+  float ball_mass;
+  float ball_radius;
+  float bat_radius;
+  float terminal_velocity;
+  float window_size;
+  /** The y-coordinate of the ground. **/
+  float ground_location;
+  /** The number of ticks in a second. **/
+  float frame_rate;
+  /** The pitch's velocity as it reaches the bat, in pixels per tick. **/
+  vec2 pitch_speed;
+  /** How high above the ground real balls are met, in feet. **/
+  float contact_height;
+  /** When to stop following a ball, as the game does. **/
+  FlightLimits flight;
+  /** The number of worker threads, or 0 for one per hardware thread. **/
+  size_t num_workers;
+  /** The number of neighboring measurements a worker plays in one go. **/
+  size_t batch_size;
+};
+
+/**
+ * How far the game, played with some constants, is from the measurements.
+ */
+struct CalibrationError {
+  /** The RMS error of the distances, relative to the measured ones. **/
+  double distance;
+  /**
+   * The RMS error of the exit speeds of the measurements with a bat speed,
+   * relative to the measured ones.
+   */
+  double exit_speed;
+};
+
+/**
+ * What came of fitting a profile.
+ */
+struct CalibrationResult {
+  PhysicsProfile profile;
+  CalibrationError start_error;
+  CalibrationError error;
+  size_t num_evaluations;
+};
+
+/**
+ * Fits the game's physical constants to real batted balls.
+ *
+ * Each measurement is played out in the game: the ball leaves the bat at the
+ * measured exit velocity and angle, converted to pixels with the candidate's
+ * distance scale, and flies until it stops. Measurements with a bat speed
+ * are also swung at, square, to see how fast the game sends the ball off.
+ * A Nelder-Mead search over the logarithms of the constants, which keeps
+ * them positive, minimizes the relative errors of both.
+ *
+ * Every candidate is measured against all of the measurements at once, in
+ * batches handed out to a pool of workers.
+ */
+class PhysicsCalibrator {
+ public:
+  /**
+   * How strongly the fit is held near the starting constants. The flight
+   * of a ball in feet does not depend on the distance scale, nor the exit
+   * speed on how the boost and the bat's mass share the work, so only this
+   * settles them.
+   */
+  static const double kPriorWeight;
+  /** How far, as a factor, the first search steps from the start. **/
+  static const double kInitialStep;
+  /** The search stops once its candidates' errors are this close. **/
+  static const double kTolerance;
+
+  /**
+   * Loads measurements from a CSV file.
+   * @param path The path of the file.
+   * @return The measurements.
+   * @throws runtime_error if the file cannot be read or is malformed.
+   */
+  static vector<BattedBall> LoadMeasurements(const string& path);
+
+  /**
+   * Reads measurements as CSV: exit speed in mph, launch angle in degrees,
+   * distance in feet and, optionally, bat speed in mph, one ball a line. The
+   * first line may be a header.
+   * @param input The CSV text.
+   * @return The measurements.
+   * @throws runtime_error if a line is malformed.
+   */
+  static vector<BattedBall> ParseMeasurements(std::istream& input);
+
+  /**
+   * Starts the workers.
+   * @param settings What the calibration holds fixed.
+   * @param measurements The balls to fit to.
+   * @throws invalid_argument if there are no measurements or a setting is out
+   * of range.
+   */
+  PhysicsCalibrator(const CalibrationSettings& settings,
+                    const vector<BattedBall>& measurements);
+
+  /**
+   * Measures how far the game, played with a profile, is from the
+   * measurements.
+   */
+  CalibrationError Measure(const PhysicsProfile& profile);
+
+  /**
+   * Searches for the profile that best fits the measurements.
+   * @param start The constants to start from, and to hold the fit near.
+   * @param max_evaluations The most candidates to measure.
+   * @return The best profile found.
+   */
+  CalibrationResult Fit(const PhysicsProfile& start, size_t max_evaluations);
+
+ private:
+  /**
+   * The squared errors a worker has summed over its batches.
+   */
+  struct ErrorSums {
+    double distance;
+    double exit_speed;
+  };
+
+  /**
+   * Plays the batches of measurements handed to a worker.
+   */
+  void MeasureBatches(size_t worker);
+
+  /**
+   * Plays one measurement with the candidate, adding its squared errors.
+   */
+  void MeasureBall(const BattedBall& measurement, ErrorSums* sums) const;
+
+  /**
+   * Scores a candidate for the search: its squared errors plus how far it
+   * strays from the start.
+   */
+  double Score(const PhysicsProfile& profile, const PhysicsProfile& start);
+
+  CalibrationSettings settings_;
+  vector<BattedBall> measurements_;
+  size_t num_with_bat_speed_;
+  // The profile being measured, while the workers run.
+  const PhysicsProfile* candidate_;
+  std::atomic<size_t> next_batch_;
+  vector<ErrorSums> worker_sums_;
+  vector<unique_ptr<StepWorker>> workers_;
+};
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_PHYSICS_CALIBRATOR_H
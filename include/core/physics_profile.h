@@ -0,0 +1,63 @@
+#ifndef HOME_RUN_DERBY_PHYSICS_PROFILE_H
+#define HOME_RUN_DERBY_PHYSICS_PROFILE_H
+
+#include <istream>
+#include <ostream>
+#include <string>
+
+namespace home_run_derby {
+
+using std::string;
+
+/**
+ * The physical constants of the game that can be calibrated against real
+ * batted balls, rather than tuned by hand.
+ *
+ * Profiles are text files with one constant per line, written as its name
+ * followed by its value, e.g. "gravity 0.09". Anything after a '#' is a
+ * comment, and constants a profile leaves out keep their defaults.
+ */
+struct PhysicsProfile {
+  /** The gravitational force on the ball, in pixels per tick squared. **/
+  float gravity;
+  /** The factor the ball's exit velocity is boosted by. **/
+  float ball_velocity_boost_factor;
+  /** The amount of friction on the ground. **/
+  float ground_friction;
+  /** The restitution from the ground when bouncing. **/
+  float ground_restitution;
+  /** The number of pixels in a foot. **/
+  float distance_scale;
+  float bat_mass;
+
+  /**
+   * Loads a profile from a file.
+   * @param path The path of the profile.
+   * @param defaults The constants the profile leaves out.
+   * @return The profile.
+   * @throws runtime_error if the file cannot be read or is malformed.
+   */
+  static PhysicsProfile Load(const string& path,
+                             const PhysicsProfile& defaults);
+
+  /**
+   * Reads a profile.
+   * @param input The profile text.
+   * @param defaults The constants the profile leaves out.
+   * @return The profile.
+   * @throws runtime_error if the profile is malformed, names a constant that
+   * does not exist or gives one a value that is not positive.
+   */
+  static PhysicsProfile Parse(std::istream& input,
+                              const PhysicsProfile& defaults);
+
+  /**
+   * Writes the profile so that Parse() reads it back exactly.
+   * @param output The stream to write to.
+   */
+  void Write(std::ostream& output) const;
+};
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_PHYSICS_PROFILE_H
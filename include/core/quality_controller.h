@@ -0,0 +1,95 @@
+#ifndef HOME_RUN_DERBY_QUALITY_CONTROLLER_H
+#define HOME_RUN_DERBY_QUALITY_CONTROLLER_H
+
+#include <cstddef>
+
+namespace home_run_derby {
+
+/**
+ * How a quality controller weighs frames against the budget.
+ */
+struct QualitySettings {
+  /** The time a frame has, in seconds, e.g. 1 / 144. **/
+  double frame_budget_seconds;
+  /** The number of quality levels, at least 1. **/
+  size_t num_levels;
+  /** The level to start at, below num_levels. **/
+  size_t start_level;
+  /** How much of the budget frames have to use to lower the level. **/
+  double lower_load;
+  /** How little of the budget frames have to use to raise the level. **/
+  double raise_load;
+  /** How many frames in a row have to be too slow to lower the level. **/
+  size_t lower_frames;
+  /** How many frames in a row have to be fast enough to raise the level. **/
+  size_t raise_frames;
+  /** How far the smoothed frame time moves toward each new frame's. **/
+  double smoothing;
+};
+
+/**
+ * Picks how much visual detail to draw so that frames fit their budget,
+ * lowering the level as soon as frames run long and raising it only once
+ * they have had room to spare for a while.
+ *
+ * Frame times are smoothed, and the level only changes once the smoothed
+ * time has stayed outside the band between the two loads for long enough,
+ * after which the count starts over. A level that is just on the edge of
+ * the budget therefore does not flicker between two levels.
+ */
+class QualityController {
+ public:
+  /**
+   * Starts at the start level with no frames seen.
+   * @param settings How frames are weighed.
+   * @throws invalid_argument if a setting is out of range.
+   */
+  explicit QualityController(const QualitySettings& settings);
+
+  /**
+   * Weighs a frame, changing the level if it tips the balance.
+   * @param frame_seconds How long the frame's work took.
+   * @return true if the level changed.
+   */
+  bool OnFrame(double frame_seconds);
+
+  /**
+   * Gets the current level, from 0 for the least detail.
+   */
+  size_t GetLevel() const;
+
+  /**
+   * Gets the share of full detail the current level draws, e.g. 1 at the
+   * highest level and 1 / num_levels at the lowest.
+   */
+  float GetDetail() const;
+
+  /**
+   * Scales a count of things drawn at full detail to the current level,
+   * keeping at least one if there were any.
+   * @param full_count The count at full detail.
+   */
+  size_t Scale(size_t full_count) const;
+
+  /**
+   * Gets the smoothed frame time, in seconds, or 0 before any frames.
+   */
+  double GetSmoothedSeconds() const;
+
+ private:
+  /**
+   * Moves to a level and starts counting frames over.
+   */
+  void SetLevel(size_t level);
+
+  QualitySettings settings_;
+  size_t level_;
+  double smoothed_seconds_;
+  bool has_frames_;
+  size_t num_slow_frames_;
+  size_t num_fast_frames_;
+};
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_QUALITY_CONTROLLER_H
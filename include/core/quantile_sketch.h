@@ -0,0 +1,117 @@
+#ifndef HOME_RUN_DERBY_QUANTILE_SKETCH_H
+#define HOME_RUN_DERBY_QUANTILE_SKETCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace home_run_derby {
+
+using std::vector;
+
+/**
+ * Estimates quantiles of a stream of values, e.g. the distances of billions
+ * of hits, in a fixed amount of memory without keeping the values.
+ *
+ * Values are counted in bins whose bounds grow geometrically, so every
+ * estimate is within a fixed relative error of a value actually added, as in
+ * DDSketch. Each side of zero has a fixed number of bins; when the values span
+ * more than that, the bins nearest zero are collapsed into one, so only the
+ * smallest magnitudes lose accuracy.
+ *
+ * A sketch is not thread safe. Keep one per thread and merge them instead.
+ */
+class QuantileSketch {
+ public:
+  /** The default number of bins on each side of zero. **/
+  static const size_t kDefaultMaxBins = 1024;
+
+  /**
+   * Creates an empty sketch, allocating all of its bins.
+   * @param relative_accuracy How far off, relative to the value, an estimate
+   * may be, e.g. 0.01 for 1%. Between 0 and 1, exclusive.
+   * @param max_bins The number of bins on each side of zero, at least 1.
+   * @throws invalid_argument if a setting is out of range.
+   */
+  explicit QuantileSketch(double relative_accuracy,
+                          size_t max_bins = kDefaultMaxBins);
+
+  /**
+   * Adds a value. Values that are not finite are ignored.
+   */
+  void Add(double value);
+
+  /**
+   * Adds every value of another sketch.
+   * @param other A sketch with the same accuracy and number of bins.
+   * @throws invalid_argument if the settings differ.
+   */
+  void Merge(const QuantileSketch& other);
+
+  /**
+   * Estimates a quantile.
+   * @param quantile Between 0 and 1, e.g. 0.99 for the 99th percentile.
+   * @return The estimate, or 0 if nothing has been added.
+   */
+  double EstimateQuantile(double quantile) const;
+
+  uint64_t GetCount() const;
+
+  double GetSum() const;
+
+  /**
+   * Gets the smallest value added, or 0 if nothing has been added.
+   */
+  double GetMin() const;
+
+  /**
+   * Gets the largest value added, or 0 if nothing has been added.
+   */
+  double GetMax() const;
+
+  double GetRelativeAccuracy() const;
+
+  size_t GetMaxBins() const;
+
+ private:
+  /**
+   * The bins on one side of zero: a window of consecutive bin indices, the
+   * lowest of which also holds everything collapsed below it.
+   */
+  struct Store {
+    vector<uint64_t> counts;
+    int lowest_index;
+    uint64_t count;
+  };
+
+  /**
+   * Finds the bin a magnitude falls in.
+   */
+  int GetIndex(double magnitude) const;
+
+  /**
+   * Gets the value a bin stands for, within the accuracy of everything in it.
+   */
+  double GetValue(int index) const;
+
+  /**
+   * Counts values in a bin, sliding the window up and collapsing the lowest
+   * bins if the bin is above it.
+   */
+  static void AddToStore(Store* store, int index, uint64_t count);
+
+  double relative_accuracy_;
+  double gamma_;
+  double log_gamma_;
+  Store positive_;
+  // Holds the magnitudes of negative values.
+  Store negative_;
+  uint64_t zero_count_;
+  double sum_;
+  double min_;
+  double max_;
+};
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_QUANTILE_SKETCH_H
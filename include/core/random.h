@@ -0,0 +1,53 @@
+#ifndef HOME_RUN_DERBY_RANDOM_H
+#define HOME_RUN_DERBY_RANDOM_H
+
+#include <cstdint>
+
+namespace home_run_derby {
+
+/**
+ * A small random number generator whose whole state is a single word.
+ *
+ * Unlike the global generator behind ci::randFloat, each owner keeps its own
+ * copy, so the sequence a game draws can be saved, restored and replayed
+ * exactly by copying it.
+ */
+class Random {
+ public:
+  /**
+   * Default constructor, leaving the generator unseeded.
+   */
+  Random() = default;
+
+  /**
+   * Creates a generator.
+   * @param seed Picks the sequence of numbers drawn.
+   */
+  explicit Random(uint64_t seed);
+
+  /**
+   * Restarts the generator.
+   * @param seed Picks the sequence of numbers drawn. Nearby seeds give
+   * unrelated sequences.
+   */
+  void Seed(uint64_t seed);
+
+  /**
+   * Draws the next 32 random bits.
+   */
+  uint32_t NextInt();
+
+  /**
+   * Draws a number evenly between two bounds.
+   * @param min The smallest number that can be drawn.
+   * @param max The bound the number stays below.
+   */
+  float NextFloat(float min, float max);
+
+ private:
+  uint64_t state_;
+};
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_RANDOM_H
@@ -0,0 +1,128 @@
+#ifndef HOME_RUN_DERBY_SCORE_STORE_H
+#define HOME_RUN_DERBY_SCORE_STORE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "core/mapped_file.h"
+
+namespace home_run_derby {
+
+using std::string;
+using std::vector;
+
+/**
+ * Durably records the final score of every game.
+ *
+ * New scores are appended to a log of checksummed records and flushed to disk
+ * before RecordScore() returns. Once the log grows past a threshold, it is
+ * merged into a snapshot of all scores sorted from highest to lowest, which is
+ * written to a temporary file and renamed into place. On startup the snapshot
+ * is memory-mapped rather than read, and only the log written since the last
+ * compaction is replayed. A record torn by a crash is dropped.
+ */
+class ScoreStore {
+ public:
+  /** The default number of logged scores that triggers a compaction. **/
+  static const size_t kDefaultCompactionThreshold = 4096;
+
+  /**
+   * Creates a store whose files share a path prefix. Nothing is read until
+   * Open() is called.
+   * @param path_prefix The prefix of the log and snapshot file paths.
+   * @param compaction_threshold The number of logged scores that triggers a
+   * compaction.
+   */
+  explicit ScoreStore(
+      const string& path_prefix,
+      size_t compaction_threshold = kDefaultCompactionThreshold);
+
+  ~ScoreStore();
+
+  ScoreStore(const ScoreStore&) = delete;
+
+  ScoreStore& operator=(const ScoreStore&) = delete;
+
+  /**
+   * Maps the snapshot, replays the log and opens the log for appending.
+   * @throws runtime_error if the files exist but cannot be used.
+   */
+  void Open();
+
+  /**
+   * Durably appends a score to the log, compacting it if it has grown past the
+   * threshold.
+   * @param score The score to record.
+   * @throws runtime_error if the score could not be written.
+   */
+  void RecordScore(float score);
+
+  /**
+   * Merges the log into a new sorted snapshot and starts an empty log.
+   * @throws runtime_error if the snapshot could not be written or is corrupt.
+   */
+  void Compact();
+
+  /**
+   * Gets the highest recorded score without scanning the scores.
+   * @return The highest score, or 0 if no scores were recorded.
+   */
+  float GetHighScore() const;
+
+  size_t GetNumScores() const;
+
+  /**
+   * Gets the compacted scores, sorted from highest to lowest. The pointer is
+   * invalidated by the next compaction.
+   */
+  const float* GetSnapshotScores() const;
+
+  size_t GetNumSnapshotScores() const;
+
+  /**
+   * Gets the scores logged since the last compaction, in the order they were
+   * recorded.
+   */
+  const vector<float>& GetLogScores() const;
+
+  const string GetLogPath() const;
+
+  const string GetSnapshotPath() const;
+
+ private:
+  /**
+   * Maps the snapshot file, if there is one, and checks its header.
+   */
+  void LoadSnapshot();
+
+  /**
+   * Reads the log records of the current generation, truncating a torn tail.
+   */
+  void ReplayLog();
+
+  /**
+   * Creates an empty log for the current generation and opens it for
+   * appending.
+   */
+  void StartLog();
+
+  string path_prefix_;
+  size_t compaction_threshold_;
+
+  // Each compaction starts a new log generation. A log whose generation is
+  // not newer than the snapshot's was already merged into it.
+  uint32_t generation_;
+  MappedFile snapshot_;
+  const float* snapshot_scores_;
+  size_t num_snapshot_scores_;
+
+  vector<float> log_scores_;
+  float log_high_score_;
+  FILE* log_file_;
+};
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_SCORE_STORE_H
@@ -0,0 +1,103 @@
+#ifndef HOME_RUN_DERBY_SESSION_PROTOCOL_H
+#define HOME_RUN_DERBY_SESSION_PROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "cinder/gl/gl.h"
+
+namespace home_run_derby {
+
+using glm::vec2;
+using std::string;
+
+/**
+ * The kinds of datagram sent between a derby server and its clients. The
+ * first byte of every datagram is one of these.
+ */
+enum class SessionMessage : uint8_t {
+  /** Sent by a client to open a session of its own. **/
+  kOpen = 1,
+  /** Sent by a client to start a game in its session. **/
+  kStart = 2,
+  /** Sent by a client each time it moves its session's bat. **/
+  kInput = 3,
+  /** Sent by a client to close its session. **/
+  kClose = 4,
+  /** Sent by the server with the number of a newly opened session. **/
+  kOpened = 5,
+  /** Sent by the server when it has no room for another session. **/
+  kRejected = 6,
+  /** Sent by the server every few ticks with where a session's game is. **/
+  kStatus = 7
+};
+
+/**
+ * A message from a client, or the server's answer to an open.
+ */
+struct SessionCommand {
+  SessionMessage type;
+  /** The session the message is about; unused by opens and rejections. **/
+  uint32_t session;
+  /** Where an input moved the bat; only used by inputs. **/
+  vec2 bat_position;
+};
+
+/**
+ * Where a session's game is, as the server last ticked it.
+ */
+struct SessionStatus {
+  uint32_t session;
+  /** The number of ticks the session has played. **/
+  uint32_t tick;
+  /** A Simulator::GameState. **/
+  uint32_t game_state;
+  uint32_t outs;
+  /** The total distance hit, in whole pixels. **/
+  uint32_t score;
+};
+
+/** The largest datagram the protocol sends. **/
+const size_t kMaxSessionMessageSize = 1 + 5 * 5;
+
+/**
+ * Encodes a command. Positions are quantized like spectator frames.
+ * @param command The command to encode.
+ * @param buffer Receives at most kMaxSessionMessageSize bytes.
+ * @return The number of bytes written.
+ */
+size_t EncodeCommand(const SessionCommand& command, uint8_t* buffer);
+
+/**
+ * Decodes a command.
+ * @return false if the datagram is not a well-formed command.
+ */
+bool DecodeCommand(const uint8_t* data, size_t size, SessionCommand* command);
+
+/**
+ * Encodes a session's status.
+ * @param status The status to encode.
+ * @param buffer Receives at most kMaxSessionMessageSize bytes.
+ * @return The number of bytes written.
+ */
+size_t EncodeStatus(const SessionStatus& status, uint8_t* buffer);
+
+/**
+ * Decodes a session's status.
+ * @return false if the datagram is not a well-formed status.
+ */
+bool DecodeStatus(const uint8_t* data, size_t size, SessionStatus* status);
+
+/**
+ * Reads a client's command written out as text, e.g. "open", "start 3",
+ * "input 3 850 420" or "close 3", as a stand-in for datagrams.
+ * @param text The command.
+ * @param command Receives the command.
+ * @return false if the text is not a client's command.
+ */
+bool ParseCommand(const string& text, SessionCommand* command);
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_SESSION_PROTOCOL_H
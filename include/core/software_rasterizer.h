@@ -0,0 +1,213 @@
+#ifndef HOME_RUN_DERBY_SOFTWARE_RASTERIZER_H
+#define HOME_RUN_DERBY_SOFTWARE_RASTERIZER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cinder/gl/gl.h"
+#include "core/step_worker.h"
+
+namespace home_run_derby {
+
+using ci::ColorA;
+using glm::vec2;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+/**
+ * An image in memory, one packed pixel for each of its rows and columns with
+ * the red, green, blue and alpha bytes from lowest to highest.
+ */
+class RasterImage {
+ public:
+  /**
+   * Packs a color into a pixel, clamping each channel to [0, 1].
+   */
+  static uint32_t PackColor(const ColorA& color);
+
+  /**
+   * Creates an image of opaque black.
+   * @throws invalid_argument if the image would be empty.
+   */
+  RasterImage(size_t width, size_t height);
+
+  size_t GetWidth() const;
+
+  size_t GetHeight() const;
+
+  uint32_t GetPixel(size_t x, size_t y) const;
+
+  /**
+   * Gets the pixels of a row, from left to right.
+   */
+  const uint32_t* GetRow(size_t y) const;
+
+  uint32_t* GetRow(size_t y);
+
+ private:
+  size_t width_;
+  size_t height_;
+  vector<uint32_t> pixels_;
+};
+
+/**
+ * A frame's worth of shapes to draw, in the order they are drawn. Recording a
+ * list does no drawing, so a frame can be recorded once and rasterized on as
+ * many threads as there are. Once its storage has grown to fit a frame,
+ * clearing and recording the next one does not allocate.
+ */
+class DrawList {
+ public:
+  /**
+   * The shapes a list can hold.
+   */
+  enum class Shape { kRect, kCircle, kLine, kText };
+
+  /**
+   * A shape, scaled to the image, with the box it can touch.
+   */
+  struct Command {
+    Shape shape;
+    vec2 start;
+    vec2 end;
+    /** The radius of a circle, width of a line or height of a text cell. **/
+    float size;
+    uint32_t color;
+    vec2 min_bounds;
+    vec2 max_bounds;
+    size_t text_start;
+    size_t text_length;
+  };
+
+  /** The number of commands a list has room for before it grows. **/
+  static const size_t kReservedCommands = 1024;
+
+  /**
+   * Creates an empty list.
+   * @param scale The number of image pixels per unit of the recorded
+   * coordinates, e.g. 0.5 to draw a thumbnail.
+   * @throws invalid_argument if the scale is not positive.
+   */
+  explicit DrawList(float scale = 1);
+
+  /**
+   * Forgets every shape, keeping the storage.
+   */
+  void Clear();
+
+  /**
+   * Fills the rectangle between two opposite corners.
+   */
+  void FillRect(const vec2& first_corner, const vec2& second_corner,
+                const ColorA& color);
+
+  void FillCircle(const vec2& center, float radius, const ColorA& color);
+
+  /**
+   * Draws a line with square ends flush with its end points.
+   */
+  void DrawLine(const vec2& start, const vec2& end, float width,
+                const ColorA& color);
+
+  /**
+   * Draws a line of text in the built-in block font, which has capitals,
+   * digits and common punctuation. Lower case is drawn as capitals, and any
+   * other character as a question mark.
+   * @param text The text to draw.
+   * @param position The center of the top of the text.
+   * @param font_size The height of a line of text, as with a font's size.
+   * @param color The color of the text.
+   */
+  void DrawText(const string& text, const vec2& position, float font_size,
+                const ColorA& color);
+
+  const vector<Command>& GetCommands() const;
+
+  /**
+   * Gets the characters of every text command, one after another.
+   */
+  const string& GetText() const;
+
+  float GetScale() const;
+
+ private:
+  /**
+   * Adds a command, unless nothing of it is left to draw.
+   */
+  void Add(const Command& command);
+
+  float scale_;
+  vector<Command> commands_;
+  string text_;
+};
+
+/**
+ * Draws lists into images on the CPU, for servers without a GPU.
+ *
+ * The image is split into square tiles, which a pool of workers takes in turn.
+ * Each worker draws every shape that overlaps its tile, clipped to it, in the
+ * order the shapes were recorded, so no two workers ever write the same pixel
+ * and the image comes out the same however many there are. Shapes are filled
+ * a row at a time: opaque rows are copied in, and translucent rows are blended
+ * four pixels at a time where SSE2 is available.
+ *
+ * A pixel is covered by a shape if its center is inside it. Shapes are not
+ * antialiased.
+ */
+class SoftwareRasterizer {
+ public:
+  /** The width and height of a tile, in pixels, unless another is given. **/
+  static const size_t kDefaultTileSize = 64;
+
+  /**
+   * Starts the workers.
+   * @param num_workers The number of worker threads, or 0 for one per
+   * hardware thread. With 1, images are drawn on the calling thread.
+   * @param tile_size The width and height of a tile, in pixels.
+   * @throws invalid_argument if the tile size is 0.
+   */
+  explicit SoftwareRasterizer(size_t num_workers,
+                              size_t tile_size = kDefaultTileSize);
+
+  SoftwareRasterizer(const SoftwareRasterizer&) = delete;
+
+  SoftwareRasterizer& operator=(const SoftwareRasterizer&) = delete;
+
+  /**
+   * Draws a list over an image.
+   * @param list The shapes to draw.
+   * @param image The image to draw over, which is not cleared first.
+   */
+  void Render(const DrawList& list, RasterImage* image);
+
+  size_t GetNumWorkers() const;
+
+ private:
+  /**
+   * Draws the tiles handed to a worker.
+   */
+  void RenderTiles();
+
+  /**
+   * Draws every shape that overlaps a tile, clipped to it.
+   */
+  void RenderTile(size_t tile) const;
+
+  size_t num_workers_;
+  size_t tile_size_;
+  // The list and image being drawn, while the workers run.
+  const DrawList* list_;
+  RasterImage* image_;
+  size_t num_tile_columns_;
+  size_t num_tiles_;
+  std::atomic<size_t> next_tile_;
+  vector<unique_ptr<StepWorker>> workers_;
+};
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_SOFTWARE_RASTERIZER_H
@@ -0,0 +1,95 @@
+#ifndef HOME_RUN_DERBY_SPATIAL_GRID_H
+#define HOME_RUN_DERBY_SPATIAL_GRID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "cinder/gl/gl.h"
+
+namespace home_run_derby {
+
+using glm::vec2;
+using std::vector;
+
+/**
+ * Finds the points near a position without checking every point.
+ *
+ * Space is split into square cells, hashed into a fixed number of buckets, so
+ * the grid covers an unbounded world with bounded memory. Each bucket holds an
+ * intrusive linked list of its points, so moving a point only relinks it when
+ * it crosses into a new cell, and neither moving nor querying allocates once
+ * the points have been inserted.
+ */
+class SpatialGrid {
+ public:
+  /**
+   * Creates an empty grid.
+   * @param cell_size The width of a cell. Queries are cheapest with a radius
+   * around this size.
+   * @param num_buckets The number of buckets cells are hashed into, rounded up
+   * to a power of two. About twice the number of points works well.
+   */
+  SpatialGrid(float cell_size, size_t num_buckets);
+
+  /**
+   * Adds a point.
+   * @param position Where the point is.
+   * @return The id of the point, counting up from 0.
+   */
+  size_t Insert(const vec2& position);
+
+  /**
+   * Moves a point.
+   * @param id The id of the point.
+   * @param position Where the point is now.
+   */
+  void Move(size_t id, const vec2& position);
+
+  /**
+   * Finds every point within a distance of a position.
+   * @param center The position to search around.
+   * @param radius The distance to search within.
+   * @param ids Cleared, then receives the ids of the points found, in no
+   * particular order.
+   */
+  void Query(const vec2& center, float radius, vector<size_t>* ids) const;
+
+  const vec2& GetPosition(size_t id) const;
+
+  size_t GetNumPoints() const;
+
+  /**
+   * Gets the number of times a move has crossed into a new cell.
+   */
+  size_t GetNumRelinks() const;
+
+ private:
+  /** Marks the end of a bucket's list. **/
+  static const size_t kNone = static_cast<size_t>(-1);
+
+  struct Entry {
+    vec2 position;
+    int32_t cell_x;
+    int32_t cell_y;
+    size_t previous;
+    size_t next;
+  };
+
+  int32_t GetCell(float coordinate) const;
+
+  size_t GetBucket(int32_t cell_x, int32_t cell_y) const;
+
+  void Link(size_t id);
+
+  void Unlink(size_t id);
+
+  float cell_size_;
+  vector<size_t> heads_;
+  vector<Entry> entries_;
+  size_t num_relinks_;
+};
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_SPATIAL_GRID_H
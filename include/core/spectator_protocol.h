@@ -0,0 +1,130 @@
+#ifndef HOME_RUN_DERBY_SPECTATOR_PROTOCOL_H
+#define HOME_RUN_DERBY_SPECTATOR_PROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace home_run_derby {
+
+/**
+ * The values a spectator needs to mirror a frame of the game. Positions are
+ * quantized to a fraction of a pixel, everything else is a whole number.
+ */
+enum SpectatorField : size_t {
+  kBallX,
+  kBallY,
+  kBatX,
+  kBatY,
+  kOffsetX,
+  kOffsetY,
+  kOuts,
+  kScore,
+  kGameState,
+  kNumSpectatorFields
+};
+
+/**
+ * The kinds of datagram sent between a game and its spectators. The first byte
+ * of every datagram is one of these.
+ */
+enum class SpectatorMessage : uint8_t {
+  /** A whole frame, sent to spectators who have nothing to build on. **/
+  kKeyframe = 1,
+  /** A frame as differences from a frame the spectator acknowledged. **/
+  kDelta = 2,
+  /** Sent by a spectator to start receiving frames. **/
+  kJoin = 3,
+  /** Sent by a spectator for each frame it has rebuilt. **/
+  kAck = 4,
+  /** Sent by a spectator to stop receiving frames. **/
+  kLeave = 5
+};
+
+/**
+ * A quantized frame of the game, numbered in the order it was published.
+ */
+struct SpectatorFrame {
+  uint32_t tick;
+  int32_t values[kNumSpectatorFields];
+};
+
+/** The largest datagram the protocol sends. **/
+const size_t kMaxSpectatorMessageSize = 1 + 5 + 5 + 5 * kNumSpectatorFields;
+
+/**
+ * The number of recent frames a spectator keeps to decode deltas against. A
+ * game never sends a delta against an older frame.
+ */
+const size_t kSpectatorHistorySize = 64;
+
+/** The number of steps a pixel is quantized into. **/
+const float kSpectatorPositionScale = 4;
+
+/**
+ * Quantizes a position for a frame.
+ */
+int32_t QuantizePosition(float position);
+
+/**
+ * Turns a quantized position from a frame back into pixels.
+ */
+float DequantizePosition(int32_t position);
+
+/**
+ * Encodes a frame. Each value is written as a variable-length difference from
+ * the reference, so a value that has not changed costs a single byte.
+ * @param frame The frame to encode.
+ * @param reference A frame the receiver holds, or nullptr for a keyframe.
+ * @param buffer Receives at most kMaxSpectatorMessageSize bytes.
+ * @return The number of bytes written.
+ */
+size_t EncodeFrame(const SpectatorFrame& frame,
+                   const SpectatorFrame* reference, uint8_t* buffer);
+
+/**
+ * Encodes a join, acknowledgement or leave message.
+ * @param type The kind of message.
+ * @param tick The frame acknowledged; ignored by the other kinds.
+ * @param buffer Receives at most kMaxSpectatorMessageSize bytes.
+ * @return The number of bytes written.
+ */
+size_t EncodeControl(SpectatorMessage type, uint32_t tick, uint8_t* buffer);
+
+/**
+ * Reads what kind of message a datagram holds.
+ * @return false if the datagram is empty or of an unknown kind.
+ */
+bool ReadMessageType(const uint8_t* data, size_t size, SpectatorMessage* type);
+
+/**
+ * Reads the frame an acknowledgement is for.
+ * @return false if the datagram is not a well-formed acknowledgement.
+ */
+bool DecodeAck(const uint8_t* data, size_t size, uint32_t* tick);
+
+/**
+ * Rebuilds frames on the spectator's side, keeping the recent frames that
+ * later deltas are encoded against.
+ */
+class SpectatorDecoder {
+ public:
+  SpectatorDecoder();
+
+  /**
+   * Rebuilds a frame from a keyframe or delta.
+   * @param data The datagram.
+   * @param size The number of bytes in the datagram.
+   * @param frame Receives the frame.
+   * @return false if the datagram is malformed, or is a delta against a frame
+   * this decoder no longer holds.
+   */
+  bool Decode(const uint8_t* data, size_t size, SpectatorFrame* frame);
+
+ private:
+  SpectatorFrame history_[kSpectatorHistorySize];
+  bool has_frame_[kSpectatorHistorySize];
+};
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_SPECTATOR_PROTOCOL_H
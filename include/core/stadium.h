@@ -0,0 +1,158 @@
+#ifndef HOME_RUN_DERBY_STADIUM_H
+#define HOME_RUN_DERBY_STADIUM_H
+
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "cinder/gl/gl.h"
+
+namespace home_run_derby {
+
+using glm::vec2;
+using std::string;
+using std::vector;
+
+/**
+ * What a piece of stadium geometry is, which decides how it scores.
+ */
+enum class SurfaceType {
+  /** The ground, which may slope. **/
+  kTerrain,
+  /** A wall the ball bounces off. **/
+  kWall,
+  /** An outfield fence. A ball carried over it is a home run. **/
+  kFence,
+  /** A foul pole. A ball that hits it is a home run. **/
+  kFoulPole
+};
+
+/**
+ * A straight piece of stadium geometry.
+ */
+struct Segment {
+  vec2 start;
+  vec2 end;
+  SurfaceType type;
+};
+
+/**
+ * Where a moving ball first touches the stadium.
+ */
+struct SweepHit {
+  /** The fraction of the move made before touching, from 0 to 1. **/
+  float time;
+  /** The unit normal of the surface, pointing back at the ball. **/
+  vec2 normal;
+  /** The index of the segment touched. **/
+  size_t segment;
+};
+
+/**
+ * The static geometry of a stadium: terrain, walls, fences and foul poles.
+ *
+ * Segments are held in a bounding-volume hierarchy, so a swept query only
+ * visits the few segments near the ball's path and a layout with thousands of
+ * segments costs about the same per tick as a flat floor. Queries never
+ * allocate.
+ *
+ * Layouts are text files with one segment per line, written as its type
+ * (terrain, wall, fence or pole) followed by the x and y of its two ends.
+ * Anything after a '#' is a comment.
+ */
+class Stadium {
+ public:
+  /**
+   * Creates a stadium with no geometry.
+   */
+  Stadium() = default;
+
+  /**
+   * Creates a stadium from its segments.
+   * @param segments The segments, in any order.
+   */
+  explicit Stadium(const vector<Segment>& segments);
+
+  /**
+   * Loads a stadium layout from a file.
+   * @param path The path of the layout.
+   * @return The stadium.
+   * @throws runtime_error if the file cannot be read or is malformed.
+   */
+  static Stadium Load(const string& path);
+
+  /**
+   * Reads a stadium layout.
+   * @param input The layout text.
+   * @return The stadium.
+   * @throws runtime_error if the layout is malformed.
+   */
+  static Stadium Parse(std::istream& input);
+
+  /**
+   * Finds where a ball moving in a straight line first touches the stadium.
+   * A ball already touching a segment only hits it if moving into it.
+   * @param start The center of the ball before the move.
+   * @param end The center of the ball after the move.
+   * @param radius The radius of the ball.
+   * @param hit Receives the first touch, if there is one.
+   * @return true if the ball touches the stadium, false otherwise.
+   */
+  bool SweepCircle(const vec2& start, const vec2& end, float radius,
+                   SweepHit* hit) const;
+
+  /**
+   * Checks if a ball moving in a straight line carries over a fence, passing
+   * its line heading left with the whole ball above the top of the fence.
+   * @param start The center of the ball before the move.
+   * @param end The center of the ball after the move.
+   * @param radius The radius of the ball.
+   * @return true if the ball clears a fence, false otherwise.
+   */
+  bool ClearsFence(const vec2& start, const vec2& end, float radius) const;
+
+  const vector<Segment>& GetSegments() const;
+
+  size_t GetNumNodes() const;
+
+ private:
+  /** The most segments a leaf of the hierarchy holds. **/
+  static const size_t kMaxLeafSegments = 4;
+  /** The deepest the hierarchy is searched; a balanced build of 2^32
+   * segments stays well within it. **/
+  static const size_t kMaxDepth = 64;
+
+  /**
+   * A box in the hierarchy. A leaf holds a run of segments; an interior node
+   * is followed by its first child, and its second child is at second_child.
+   */
+  struct Node {
+    vec2 min;
+    vec2 max;
+    uint32_t first_segment;
+    uint32_t num_segments;
+    uint32_t second_child;
+  };
+
+  /**
+   * A fence line, reduced to what a clearance test needs.
+   */
+  struct Fence {
+    float x;
+    float top;
+  };
+
+  /**
+   * Builds the node for a run of segments, and the nodes under it.
+   */
+  void BuildNode(size_t first_segment, size_t num_segments, size_t depth);
+
+  vector<Segment> segments_;
+  vector<Node> nodes_;
+  vector<Fence> fences_;
+};
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_STADIUM_H
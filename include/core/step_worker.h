@@ -0,0 +1,66 @@
+#ifndef HOME_RUN_DERBY_STEP_WORKER_H
+#define HOME_RUN_DERBY_STEP_WORKER_H
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace home_run_derby {
+
+/**
+ * A thread that runs the same step, e.g. one tick of a game, each time it is
+ * posted, while the caller gets on with something else until it joins.
+ *
+ * The thread is started once and kept for the worker's lifetime, so posting
+ * a step neither creates a thread nor allocates.
+ */
+class StepWorker {
+ public:
+  /**
+   * Starts the thread, which waits for the first step.
+   * @param step The step to run each time one is posted.
+   */
+  explicit StepWorker(const std::function<void()>& step);
+
+  /**
+   * Waits for any posted step to finish, then stops the thread.
+   */
+  ~StepWorker();
+
+  StepWorker(const StepWorker&) = delete;
+
+  StepWorker& operator=(const StepWorker&) = delete;
+
+  /**
+   * Starts running the step on the thread.
+   * @throws logic_error if a posted step has not been joined yet.
+   */
+  void Post();
+
+  /**
+   * Waits for the posted step to finish. Does nothing if none was posted.
+   * @throws Whatever the step threw, if it threw.
+   */
+  void Join();
+
+ private:
+  /**
+   * Runs on the thread until the worker is destroyed.
+   */
+  void Run();
+
+  std::function<void()> step_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  bool is_posted_;
+  bool is_running_;
+  bool is_stopping_;
+  std::exception_ptr error_;
+  std::thread thread_;
+};
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_STEP_WORKER_H
@@ -0,0 +1,25 @@
+#ifndef HOME_RUN_DERBY_SURROGATE_COEFFICIENTS_H
+#define HOME_RUN_DERBY_SURROGATE_COEFFICIENTS_H
+
+// Generated by fit-surrogate from 1000000 contacts, with an RMS
+// error of 68.6645 px. Do not edit by hand; refit instead.
+
+namespace home_run_derby {
+
+constexpr float kSurrogateMeanCoefficients[20] = {
+    12.034297f, -558.637573f, 1174.21301f, 10.2199354f,
+    11.5324087f, 4.760427f, -3.2908752f, -9.47734356f,
+    8.22215748f, -15.5680723f, 0.983747542f, -6.29628468f,
+    -7.02224064f, -2.45725727f, -0.113634497f, 1.86606789f,
+    5.94060516f, 6.06604385f, -3.38205957f, 5.87847567f};
+
+constexpr float kSurrogateErrorCoefficients[20] = {
+    2.11309886f, -1.58706224f, 4.98976469f, -10.3134699f,
+    -11.9078941f, -0.817998946f, 5.29061127f, 12.093502f,
+    -12.4998684f, 16.7159615f, -1.08493757f, 5.05417681f,
+    8.56356049f, 1.35605681f, -0.0387387536f, -2.78103757f,
+    -5.34242725f, -7.29237652f, 5.24071455f, -6.40995312f};
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_SURROGATE_COEFFICIENTS_H
@@ -0,0 +1,101 @@
+#ifndef HOME_RUN_DERBY_SURROGATE_FITTER_H
+#define HOME_RUN_DERBY_SURROGATE_FITTER_H
+
+#include <vector>
+
+#include "cinder/gl/gl.h"
+#include "core/ball.h"
+#include "core/bat.h"
+#include "core/distance_surrogate.h"
+#include "core/swing_optimizer.h"
+
+namespace home_run_derby {
+
+using glm::vec2;
+using std::vector;
+
+/**
+ * The coefficients of a fitted DistanceSurrogate and how well they fit.
+ */
+struct SurrogateFit {
+  float mean_coefficients[DistanceSurrogate::kNumTerms];
+  float error_coefficients[DistanceSurrogate::kNumTerms];
+  /** The root mean square error of the predicted travel over the samples. **/
+  float rms_error;
+  size_t num_samples;
+};
+
+/**
+ * Fits DistanceSurrogate models to simulated contacts by least squares.
+ *
+ * Contacts are sampled the way the game produces them: a pitch is played
+ * forward to a random tick, a bat within the swing limits meets it through
+ * Ball::HandleBatCollisions, and the hit is flown out to measure its travel.
+ */
+class SurrogateFitter {
+ public:
+  /**
+   * Creates a fitter with no samples.
+   * @param limits The limits the sampled swings respect, and when to stop
+   * following the flight.
+   * @param ground_location The y-coordinate of the ground.
+   * @param gravity The gravitational force acting on the ball.
+   */
+  SurrogateFitter(const SwingLimits& limits, float ground_location,
+                  float gravity);
+
+  /**
+   * Adds a single contact.
+   * @param height The height of the bottom of the ball above the ground.
+   * @param exit_velocity The velocity of the ball just after contact.
+   * @param travel How far left the ball then travels.
+   */
+  void AddSample(float height, const vec2& exit_velocity, float travel);
+
+  /**
+   * Samples contacts against a pitch until enough of them send the ball left.
+   * @param pitch The ball as it is released.
+   * @param bat The bat to swing.
+   * @param num_contacts The number of contacts to add.
+   * @param seed Seeds the sampled ticks and swings.
+   * @return The number of contacts added, which is fewer than asked for only
+   * if the pitch can hardly be hit.
+   */
+  size_t SampleContacts(const Ball& pitch, const Bat& bat, size_t num_contacts,
+                        unsigned seed);
+
+  /**
+   * Fits both models to the samples added so far.
+   * @return The fitted coefficients.
+   * @throws runtime_error if there are too few samples to fit.
+   */
+  SurrogateFit Fit() const;
+
+  size_t GetNumSamples() const;
+
+ private:
+  /**
+   * A contact, reduced to the inputs and target of the models.
+   */
+  struct Sample {
+    float height;
+    vec2 exit_velocity;
+    float travel;
+  };
+
+  /**
+   * Fits coefficients to minimize the squared error against targets, one per
+   * sample.
+   */
+  void SolveLeastSquares(const vector<double>& targets,
+                         float* coefficients) const;
+
+  SwingLimits limits_;
+  float ground_location_;
+  float gravity_;
+  vector<Sample> samples_;
+};
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_SURROGATE_FITTER_H
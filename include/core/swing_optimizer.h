@@ -0,0 +1,197 @@
+#ifndef HOME_RUN_DERBY_SWING_OPTIMIZER_H
+#define HOME_RUN_DERBY_SWING_OPTIMIZER_H
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "cinder/gl/gl.h"
+#include "core/ball.h"
+#include "core/bat.h"
+#include "core/flight.h"
+#include "core/outcome_cache.h"
+#include "core/step_worker.h"
+
+namespace home_run_derby {
+
+using glm::vec2;
+using std::unique_ptr;
+using std::vector;
+
+/**
+ * The limits a swing has to respect, mirroring what the player's mouse is
+ * allowed to do.
+ */
+struct SwingLimits {
+  /** The top left corner the bat can reach. **/
+  vec2 min_bat_position;
+  /** The bottom right corner the bat can reach. **/
+  vec2 max_bat_position;
+  /** The furthest the bat can move in a single tick. **/
+  float max_bat_speed;
+  /** When to stop following the pitch and the hit. **/
+  FlightLimits flight;
+};
+
+/**
+ * A swing that holds the bat still at a start position until a contact tick,
+ * then moves it to an end position in a single tick.
+ */
+struct Swing {
+  /** The tick, counted from the pitch state, on which the bat moves. **/
+  size_t contact_tick;
+  vec2 start_position;
+  vec2 end_position;
+  /** The distance the ball travels past the left edge, or 0 for an out. **/
+  float distance;
+};
+
+/**
+ * Searches for the swing that hits a pitch the furthest.
+ *
+ * Candidate swings are played out on copies of the ball and bat, exactly as
+ * the simulator would play them. Several threads run independent
+ * cross-entropy searches, each sampling swings around the best ones it has
+ * seen so far, until the budget runs out. Swings that cannot reach the ball,
+ * or that send it right, are rejected without simulating the flight, and no
+ * candidate's flight is followed for more than kMaxSearchFlightTicks, so the
+ * deadline is never overrun by more than one short evaluation. Contacts are
+ * resolved through an outcome cache shared by the searches, so a contact that
+ * has already been seen, or one very like it, skips the flight altogether.
+ *
+ * The threads and the buffers they share are kept for the optimizer's
+ * lifetime, so searching neither creates threads nor allocates.
+ */
+class SwingOptimizer {
+ public:
+  /** The most ticks of flight followed for a swing found by a search. **/
+  static const size_t kMaxSearchFlightTicks = 2000;
+
+  /**
+   * Creates an optimizer for a set of swing limits.
+   * @param limits The limits every swing must respect.
+   * @param num_threads The number of searches to run in parallel, or 0 to use
+   * one per hardware thread.
+   */
+  explicit SwingOptimizer(const SwingLimits& limits, size_t num_threads = 0);
+
+  SwingOptimizer(const SwingOptimizer&) = delete;
+
+  SwingOptimizer& operator=(const SwingOptimizer&) = delete;
+
+  /**
+   * Finds the best swing against a pitch within a time budget. How far the
+   * searches get depends on how fast the machine is, so the same seed may
+   * give different swings from one call to the next.
+   * @param pitch The ball as it is now; ticks are counted from this state.
+   * @param bat The bat to swing, whose position and speed are ignored.
+   * @param budget_seconds How long to search for.
+   * @param seed Seeds the searches.
+   * @return The best swing found, or a swing that stays out of the ball's way
+   * with a distance of 0 if none hit. The distance is measured over at most
+   * kMaxSearchFlightTicks of flight.
+   */
+  Swing FindBestSwing(const Ball& pitch, const Bat& bat, double budget_seconds,
+                      unsigned seed = 0);
+
+  /**
+   * Finds the best swing against a pitch by trying a fixed number of swings,
+   * however long that takes, so the same seed always gives the same swing.
+   * What is in the outcome cache depends on earlier searches and on how the
+   * threads took turns, so these searches play every contact out instead.
+   * @param pitch The ball as it is now; ticks are counted from this state.
+   * @param bat The bat to swing, whose position and speed are ignored.
+   * @param num_evaluations The number of swings each search tries.
+   * @param seed Seeds the searches.
+   * @return The best swing found, or a swing that stays out of the ball's way
+   * with a distance of 0 if none hit. The distance is measured over at most
+   * kMaxSearchFlightTicks of flight.
+   */
+  Swing FindBestSwingWithEvaluations(const Ball& pitch, const Bat& bat,
+                                     size_t num_evaluations,
+                                     unsigned seed = 0);
+
+  /**
+   * Plays a swing out against a pitch.
+   * @param pitch The ball as it is now.
+   * @param bat The bat to swing.
+   * @param swing The swing to play; its distance is ignored.
+   * @return The distance the ball travels past the left edge, or 0 if the
+   * swing misses or the ball does not leave the screen.
+   */
+  float EvaluateSwing(const Ball& pitch, const Bat& bat,
+                      const Swing& swing) const;
+
+  /**
+   * Gets the cache the searches resolve contacts through, e.g. to see how
+   * often it saves a flight.
+   */
+  const OutcomeCache& GetOutcomeCache() const;
+
+ private:
+  /** The number of parameters that describe a candidate swing. **/
+  static const size_t kNumParameters = 5;
+  /** The number of swings sampled in each round of a search. **/
+  static const size_t kPopulationSize = 32;
+  /** The number of best swings that the next round is sampled around. **/
+  static const size_t kNumElites = 6;
+  /** The number of contacts the outcome cache holds. **/
+  static const size_t kOutcomeCacheCapacity = 4096;
+  /** How finely contact positions and speeds are told apart in the cache. **/
+  static constexpr float kOutcomeCacheResolution = 0.25f;
+
+  /**
+   * Runs every search on the pitch until the deadline or until each has
+   * tried its number of swings, whichever comes first.
+   */
+  Swing RunSearches(const Ball& pitch, const Bat& bat,
+                    std::chrono::steady_clock::time_point deadline,
+                    size_t num_evaluations, unsigned seed, bool use_cache);
+
+  /**
+   * Runs one of the searches, keeping the best swing it finds.
+   */
+  void Search(size_t index);
+
+  /**
+   * Turns search parameters into a swing that respects the limits.
+   */
+  Swing MakeSwing(const float* parameters) const;
+
+  /**
+   * Records where the ball goes if nothing hits it, until it leaves the
+   * screen.
+   */
+  void TracePitch(const Ball& pitch);
+
+  /**
+   * Plays a swing out after it has passed the bounding test.
+   * @param flight When to stop following the hit.
+   * @param cache Resolves the contact and its flight, or nullptr to play
+   * them out.
+   */
+  float SimulateSwing(const Ball& pitch, const Bat& bat, const Swing& swing,
+                      const FlightLimits& flight, OutcomeCache* cache) const;
+
+  SwingLimits limits_;
+  size_t num_threads_;
+  // Follows candidate flights for no more than kMaxSearchFlightTicks.
+  FlightLimits search_flight_;
+  OutcomeCache outcome_cache_;
+  // The pitch being searched and where the searches stop, while they run.
+  const Ball* pitch_;
+  const Bat* bat_;
+  std::chrono::steady_clock::time_point deadline_;
+  size_t num_evaluations_;
+  unsigned seed_;
+  OutcomeCache* search_cache_;
+  // Where the pitch goes if it is not hit, with room for the longest pitch.
+  vector<vec2> trajectory_;
+  // The best swing of each search; the last is run on the caller's thread.
+  vector<Swing> best_swings_;
+  vector<unique_ptr<StepWorker>> workers_;
+};
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_SWING_OPTIMIZER_H
@@ -0,0 +1,45 @@
+#ifndef HOME_RUN_DERBY_VARINT_H
+#define HOME_RUN_DERBY_VARINT_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace home_run_derby {
+
+/** The most bytes a 32-bit variable-length integer takes. **/
+const size_t kMaxVarintSize = 5;
+
+/**
+ * Writes a number in 7-bit groups, low group first, so small numbers take a
+ * single byte.
+ * @param value The number to write.
+ * @param buffer Receives at most kMaxVarintSize bytes.
+ * @return The number of bytes written.
+ */
+size_t WriteVarint(uint32_t value, uint8_t* buffer);
+
+/**
+ * Reads a number written by WriteVarint().
+ * @param data The bytes to read from.
+ * @param size The number of bytes.
+ * @param offset Where to start reading, moved past the number.
+ * @param value Receives the number.
+ * @return false if the bytes run out or the number is too long.
+ */
+bool ReadVarint(const uint8_t* data, size_t size, size_t* offset,
+                uint32_t* value);
+
+/**
+ * Maps a signed difference, in two's complement, onto a number that is small
+ * whenever the difference is, e.g. -1 to 1 and 1 to 2.
+ */
+uint32_t ToZigzag(uint32_t difference);
+
+/**
+ * Undoes ToZigzag().
+ */
+uint32_t FromZigzag(uint32_t zigzag);
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_VARINT_H
@@ -0,0 +1,127 @@
+#ifndef HOME_RUN_DERBY_FRAME_EXPORTER_H
+#define HOME_RUN_DERBY_FRAME_EXPORTER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "core/frame_sink.h"
+#include "core/software_rasterizer.h"
+#include "core/step_worker.h"
+#include "frame_renderer.h"
+#include "simulator.h"
+
+namespace home_run_derby {
+
+namespace visualizer {
+
+using std::unique_ptr;
+using std::vector;
+
+/**
+ * Turns a replay, saved a snapshot per tick, into video or screenshots on the
+ * CPU, faster than the game plays it.
+ *
+ * Export runs as a pipeline. Each worker restores the frames it takes into a
+ * game of its own, then records and rasterizes them into a ring of images
+ * shared with the writer. The writer, on the calling thread, hands the images
+ * to the sink strictly in order as they are finished. The ring holds two
+ * frames per worker, so the workers never wait on each other and only wait
+ * on the writer if it falls behind.
+ */
+class FrameExporter {
+ public:
+  /**
+   * Starts the workers.
+   * @param style How the game looks.
+   * @param stadium The stadium the game is played in, which outlives the
+   * exporter, or nullptr for the flat ground.
+   * @param num_workers The number of worker threads, or 0 for one per
+   * hardware thread.
+   * @param scale The number of pixels in a frame per pixel of the game.
+   * @throws invalid_argument if the scale is not positive.
+   */
+  FrameExporter(const FrameStyle& style, const Stadium* stadium,
+                size_t num_workers, float scale = 1);
+
+  FrameExporter(const FrameExporter&) = delete;
+
+  FrameExporter& operator=(const FrameExporter&) = delete;
+
+  /**
+   * Renders a replay and writes every frame of it, in order.
+   * @param prototype A game built with the settings the replay was played
+   * with, and with the same background field.
+   * @param frames The snapshots to render, one per frame.
+   * @param sink Where the frames go.
+   * @throws Whatever a worker or the sink threw, once everything has stopped.
+   */
+  void Export(const Simulator& prototype,
+              const vector<SimulatorSnapshot>& frames, FrameSink* sink);
+
+  size_t GetNumWorkers() const;
+
+  size_t GetFrameWidth() const;
+
+  size_t GetFrameHeight() const;
+
+ private:
+  /**
+   * What a worker renders with, so it shares nothing with the others.
+   */
+  struct Worker {
+    Worker(const FrameStyle& style, const Stadium* stadium, float scale);
+
+    // A copy of the prototype, made for each export.
+    unique_ptr<Simulator> simulator;
+    FrameRenderer renderer;
+    DrawList list;
+    SoftwareRasterizer rasterizer;
+    unique_ptr<StepWorker> thread;
+  };
+
+  /**
+   * An image in the ring, and the frame it holds once it is finished.
+   */
+  struct Slot {
+    RasterImage image;
+    size_t frame;
+    bool is_ready;
+  };
+
+  /**
+   * Renders the frames a worker takes until there are none left or the
+   * export has failed.
+   */
+  void RenderFrames(Worker* worker);
+
+  /**
+   * Writes the frames to the sink as they are finished.
+   */
+  void WriteFrames(FrameSink* sink);
+
+  /**
+   * Stops the export, waking anything waiting on it.
+   */
+  void Fail();
+
+  size_t frame_width_;
+  size_t frame_height_;
+  vector<unique_ptr<Worker>> workers_;
+  vector<Slot> slots_;
+  // The replay being exported, only set during Export().
+  const vector<SimulatorSnapshot>* frames_;
+  std::atomic<size_t> next_frame_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  size_t num_written_;
+  bool has_failed_;
+};
+
+}  // namespace visualizer
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_FRAME_EXPORTER_H
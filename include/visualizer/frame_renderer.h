@@ -0,0 +1,120 @@
+#ifndef HOME_RUN_DERBY_FRAME_RENDERER_H
+#define HOME_RUN_DERBY_FRAME_RENDERER_H
+
+#include "cinder/gl/gl.h"
+#include "core/distance_surrogate.h"
+#include "core/formatted_text.h"
+#include "core/software_rasterizer.h"
+#include "core/stadium.h"
+#include "simulator.h"
+
+namespace home_run_derby {
+
+namespace visualizer {
+
+using ci::Color;
+
+/**
+ * How a game looks: the sizes and colors it is drawn with, as the game's
+ * constants set them.
+ */
+struct FrameStyle {
+  float window_size;
+  float stretch_constant;
+  float ground_height;
+  float player_radius;
+  float star_radius;
+  float dirt_particle_radius;
+  float ball_radius;
+  float gravity;
+  /** Controls background color change w.r.t. vertical displacement. **/
+  float color_change_per_dist;
+  float stadium_line_width;
+  float statistics_font_size;
+  /** The y-coordinate of the top line of the game statistics. **/
+  float statistics_location;
+  /** The number of pixels in a foot. **/
+  float distance_scale;
+  Color background_color;
+  Color star_color;
+  Color ground_color;
+  Color dirt_color;
+  Color dirt_particle_color;
+  Color player_color;
+  Color ball_color;
+  Color bat_color;
+  Color stadium_color;
+  Color foul_pole_color;
+  Color statistics_text_color;
+};
+
+/**
+ * Records a game's frames as the game draws them on screen, for drawing on
+ * the CPU: the sky, stars, ground, dirt, stadium, player, ball, bat and game
+ * statistics, all at full detail. Only the player's own view is drawn, so
+ * fielders and swing statistics are left out.
+ *
+ * The statistics are formatted in place, so a renderer records a frame
+ * without allocating, but it can only be used by one thread at a time.
+ */
+class FrameRenderer {
+ public:
+  /**
+   * Creates a renderer.
+   * @param style How the game looks.
+   * @param stadium The stadium the game is played in, which outlives the
+   * renderer, or nullptr for the flat ground.
+   */
+  FrameRenderer(const FrameStyle& style, const Stadium* stadium);
+
+  /**
+   * Records a frame of a game, in the order the game draws it.
+   * @param simulator The game to draw.
+   * @param list The list to add the frame to.
+   */
+  void Record(const Simulator& simulator, DrawList* list);
+
+  /**
+   * Gets the width of a frame, in pixels, at a scale.
+   */
+  size_t GetFrameWidth(float scale) const;
+
+  /**
+   * Gets the height of a frame, in pixels, at a scale.
+   */
+  size_t GetFrameHeight(float scale) const;
+
+  const FrameStyle& GetStyle() const;
+
+ private:
+  void RecordGameBackground(const Simulator& simulator, DrawList* list) const;
+
+  void RecordStars(const Simulator& simulator, DrawList* list) const;
+
+  void RecordGround(const Simulator& simulator, DrawList* list) const;
+
+  void RecordStadium(const Simulator& simulator, DrawList* list) const;
+
+  void RecordCharacter(const Simulator& simulator, DrawList* list) const;
+
+  void RecordBall(const Simulator& simulator, DrawList* list) const;
+
+  void RecordBat(const Simulator& simulator, DrawList* list) const;
+
+  void RecordGameStatistics(const Simulator& simulator, DrawList* list);
+
+  FrameStyle style_;
+  const Stadium* stadium_;
+  DistanceSurrogate distance_surrogate_;
+  FormattedText outs_text_;
+  FormattedText total_distance_text_;
+  FormattedText current_distance_text_;
+  FormattedText current_altitude_text_;
+  FormattedText predicted_distance_text_;
+};
+
+}  // namespace visualizer
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_FRAME_RENDERER_H
@@ -2,11 +2,28 @@
 #define HOME_RUN_DERBY_APP_H
 
 #include <string>
+#include <vector>
 
 #include "cinder/app/App.h"
 #include "cinder/app/RendererGl.h"
+#include "cinder/gl/TextureFont.h"
 #include "cinder/gl/gl.h"
+#include "core/ai_batter.h"
+#include "core/bat_catalog.h"
+#include "core/bat_predictor.h"
+#include "core/contact_analytics.h"
+#include "core/distance_surrogate.h"
+#include "core/fielding_team.h"
+#include "core/formatted_text.h"
+#include "core/hit_statistics.h"
+#include "core/input_latency_tracker.h"
+#include "core/metrics.h"
+#include "core/metrics_server.h"
+#include "core/physics_profile.h"
+#include "core/quality_controller.h"
+#include "core/step_worker.h"
 #include "simulator.h"
+#include "spectator_broadcaster.h"
 
 namespace home_run_derby {
 
@@ -16,6 +33,7 @@ using ci::Color;
 using ci::ColorA;
 using glm::vec2;
 using std::string;
+using std::vector;
 
 /**
  * Allows us to visualize the game using the backend calculations.
@@ -27,6 +45,13 @@ class HomeRunDerbyApp : public ci::app::App {
    */
   HomeRunDerbyApp();
 
+  /**
+   * Builds the fonts once the OpenGL context exists, loads the recorded scores
+   * into the leaderboard, starts broadcasting to spectators and starts serving
+   * metrics.
+   */
+  void setup() override;
+
   /**
    * Draws the graphics on the canvas.
    */
@@ -45,7 +70,11 @@ class HomeRunDerbyApp : public ci::app::App {
   void mouseDrag(ci::app::MouseEvent event) override;
 
   /**
-   * Contains an event when a key is pressed.
+   * Contains an event when a key is pressed. SPACE moves past the start and
+   * end screens, 2 switches split screen against the computer on or off
+   * before a game, A hands the bat to the computer or takes it back, B picks
+   * the next bat from the catalog, F sends out or calls in the fielders, and
+   * R replays the current pitch from its release.
    * @param event Contains information about the key pressed.
    */
   void keyDown(ci::app::KeyEvent event) override;
@@ -63,43 +92,85 @@ class HomeRunDerbyApp : public ci::app::App {
 
   /**
    * Draws the background for the game.
+   * @param simulator The game to draw.
    */
-  void DrawGameBackground() const;
+  void DrawGameBackground(const Simulator& simulator) const;
 
   /**
    * Draws the stars on the UI.
+   * @param simulator The game to draw.
    */
-  void DrawStars() const;
+  void DrawStars(const Simulator& simulator) const;
 
   /**
    * Draws the ground on the UI.
+   * @param simulator The game to draw.
+   */
+  void DrawGround(const Simulator& simulator) const;
+
+  /**
+   * Draws the stadium's walls, fences and foul poles, if one is loaded.
+   * @param simulator The game to draw.
    */
-  void DrawGround() const;
+  void DrawStadium(const Simulator& simulator) const;
+
+  /**
+   * Draws the fielders, if they are out on the field.
+   * @param simulator The game to draw.
+   */
+  void DrawFielders(const Simulator& simulator) const;
 
   /**
    * Draws the character on the UI.
+   * @param simulator The game to draw.
    */
-  void DrawCharacter() const;
+  void DrawCharacter(const Simulator& simulator) const;
 
   /**
    * Draws the bat on the UI.
+   * @param simulator The game to draw.
+   */
+  void DrawBat(const Simulator& simulator) const;
+
+  /**
+   * Gets where to draw the bat: where the player's bat is predicted to be
+   * once the frame is on screen, or where the computer's bat is.
    */
-  void DrawBat() const;
+  vec2 GetDrawnBatPosition() const;
 
   /**
    * Draws the ball on the UI.
+   * @param simulator The game to draw.
    */
-  void DrawBall() const;
+  void DrawBall(const Simulator& simulator) const;
 
   /**
    * Displays the game statistics, e.g. outs, score.
+   * @param simulator The game to draw.
+   */
+  void DisplayGameStatistics(const Simulator& simulator) const;
+
+  /**
+   * Displays how the player's last swing met the ball and how their swings
+   * have gone this game.
    */
-  void DisplayGameStatistics() const;
+  void DisplaySwingStatistics() const;
+
+  /**
+   * Converts a speed in pixels per tick to miles per hour.
+   */
+  float ToMilesPerHour(float speed) const;
 
   /**
    * Draws the variable canvas features.
+   * @param simulator The game to draw.
+   */
+  void DrawCanvasFeatures(const Simulator& simulator) const;
+
+  /**
+   * Draws the player's game and the computer's side by side.
    */
-  void DrawCanvasFeatures() const;
+  void DrawSplitScreen() const;
 
   /**
    * Draws a solid left at the given corners.
@@ -109,10 +180,80 @@ class HomeRunDerbyApp : public ci::app::App {
   void DrawSolidRect(const vec2& top_left, const vec2& bottom_right) const;
 
   /**
-   * Converts a float to a string with precision.
-   * @param float_to_convert The float to convert into a string.
+   * Builds the limits that a computer-controlled swing has to respect, which
+   * match the limits on the player's mouse.
+   */
+  SwingLimits MakeSwingLimits() const;
+
+  /**
+   * Moves the bat along the computer-controlled swing, planning a new swing at
+   * the start of every pitch.
+   * @param ai_batter The computer batting.
+   * @param simulator The game it is batting in.
+   */
+  void UpdateAiBatter(AiBatter* ai_batter, Simulator* simulator);
+
+  /**
+   * Plays a tick of the player's game.
+   */
+  void StepFirstPlayer();
+
+  /**
+   * Plays a tick of the computer's game in split screen.
    */
-  const string FloatToString(float float_to_convert) const;
+  void StepSecondPlayer();
+
+  /**
+   * Builds the layout of the fielding team, spread across the outfield in
+   * front of the stadium's fence.
+   */
+  FieldingSettings MakeFieldingSettings() const;
+
+  /**
+   * Loads the calibrated physics profile, falling back on the game's own
+   * constants for anything it leaves out or if there is none.
+   */
+  PhysicsProfile LoadPhysicsProfile() const;
+
+  /**
+   * Registers everything the game exports as metrics.
+   */
+  void RegisterMetrics();
+
+  /**
+   * Passes on the lookups both computer batters' outcome caches have made
+   * since the last frame.
+   */
+  void UpdateSwingCacheMetrics();
+
+  /**
+   * Drops to the idle frame rate while a static screen is shown, and restores
+   * the full frame rate once the game is running again.
+   */
+  void UpdateFrameRate();
+
+  /**
+   * Builds the budget frames are held to and how quickly the detail drawn
+   * follows it.
+   */
+  QualitySettings MakeQualitySettings() const;
+
+  /**
+   * Gets the number of segments to draw a circle with at the current level
+   * of detail, all that could be seen at full detail and fewer below it.
+   * @param radius The radius of the circle.
+   */
+  int GetCircleSegments(float radius) const;
+
+  /**
+   * Draws a line of text centered horizontally at a position.
+   * @param font The prebuilt font to draw the text with.
+   * @param text The text to draw.
+   * @param position The center of the text's baseline.
+   * @param color The color of the text.
+   */
+  void DrawCenteredText(const ci::gl::TextureFontRef& font, const string& text,
+                        const vec2& position, const ColorA& color) const;
 
   /** BEGIN CONSTANTS **/
 
@@ -123,6 +264,26 @@ class HomeRunDerbyApp : public ci::app::App {
   const float kStretchConstant = 16.0f / 9.0f;
   /** Controls the frame rate of the game. **/
   const float kFrameRate = 144;
+  /** Controls the frame rate while a static screen is shown. **/
+  const float kIdleFrameRate = 10;
+
+  /** QUALITY CONSTANTS **/
+  /** The number of levels of visual detail. **/
+  const size_t kNumQualityLevels = 4;
+  /** The level the game starts at, which shows half the particles. **/
+  const size_t kStartQualityLevel = 1;
+  /** The share of a frame's budget that, used up, lowers the detail. **/
+  const double kLowerQualityLoad = 0.8;
+  /** The share of a frame's budget that, left unused, raises the detail. **/
+  const double kRaiseQualityLoad = 0.4;
+  /** The number of slow frames in a row, a quarter second, to lower it. **/
+  const size_t kLowerQualityFrames = 36;
+  /** The number of fast frames in a row, two seconds, to raise it. **/
+  const size_t kRaiseQualityFrames = 288;
+  /** How far the smoothed frame time moves toward each new frame's. **/
+  const double kQualitySmoothing = 0.05;
+  /** The fewest segments a circle is drawn with. **/
+  const int kMinCircleSegments = 8;
 
   /** UI COLOR CONSTANTS **/
   /** The color of the start screen. **/
@@ -144,10 +305,10 @@ class HomeRunDerbyApp : public ci::app::App {
   const Color kStarColor = Color(1, 1, 1);
 
   /** UI CONSTANTS **/
-  /** The number of stars to show on the canvas at a time. **/
-  const size_t kNumStars = 75;
-  /** The number of dirt particles to show on the canvas at a time. **/
-  const size_t kNumDirtParticles = 50;
+  /** The number of stars laid out, all of which show at full detail. **/
+  const size_t kNumStars = 150;
+  /** The number of dirt particles laid out, shown as the stars are. **/
+  const size_t kNumDirtParticles = 100;
   /** The radius of the stars. **/
   const float kStarRadius = 3;
   /** The radius of the dirt particles. **/
@@ -172,10 +333,63 @@ class HomeRunDerbyApp : public ci::app::App {
   const string kStatisticsFont = "Segue";
   /** The text font size of the game statistics. **/
   const float kStatisticsFontSize = 50;
+  /** The title shown on the start screen. **/
+  const string kTitleText = "Ultimate Home Run Derby";
+  /** The prompt shown on the start screen. **/
+  const string kStartPromptText = "Press SPACE to play";
+  /** The reminder shown on the start screen in split screen. **/
+  const string kSplitScreenText = "Split screen against the computer";
+  /** The title shown on the end screen. **/
+  const string kGameOverText = "Game over!";
+  /** The message shown on the end screen for a new high score. **/
+  const string kNewHighScoreText = "You got a new high score!";
+  /** The prompt shown on the end screen. **/
+  const string kPlayAgainPromptText = "Press SPACE to play again";
   /** The game statistics text location. **/
   const float kStatisticsLocation = 20;
   /** Precision for decimals shown for statistics. **/
   const float kPrecision = 0;
+  /** The exit speed, in mph, at and above which a swing is a hard hit. **/
+  const float kHardHitSpeed = 95;
+  /** The number of feet per second in a mile per hour. **/
+  const float kFeetPerSecondPerMph = 5280.0f / 3600;
+  /** The width and height of a spray chart cell, in feet. **/
+  const float kSprayChartCellSize = 25;
+  /** The number of spray chart cells along the carry. **/
+  const size_t kSprayChartColumns = 40;
+  /** The number of spray chart cells along the height. **/
+  const size_t kSprayChartRows = 12;
+
+  /** SPLIT SCREEN CONSTANTS **/
+  /** The color around the two views. **/
+  const Color kSplitScreenBorderColor = Color("black");
+
+  /** PERSISTENCE CONSTANTS **/
+  /** The path prefix of the files that hold every recorded score. **/
+  const string kScoreStorePath = "home_run_derby_scores";
+
+  /** SPECTATOR CONSTANTS **/
+  /** The loopback port spectators join the game on. **/
+  const uint16_t kSpectatorPort = 47800;
+
+  /** METRICS CONSTANTS **/
+  /** The loopback port metrics are scraped from, at /metrics. **/
+  const uint16_t kMetricsPort = 9464;
+  /** The upper bounds, in seconds, of the buckets frame times fall into. **/
+  const vector<double> kFrameSecondsBuckets = {
+      0.0005, 0.001, 0.002, 0.004, 0.007, 0.01, 0.02, 0.05, 0.1};
+
+  /** STADIUM CONSTANTS **/
+  /** The stadium layout asset; without it the game is on flat ground. **/
+  const string kStadiumAsset = "stadium.txt";
+  /** The color of the stadium's terrain, walls and fences. **/
+  const Color kStadiumColor = Color("darkgreen");
+  /** The color of the foul poles. **/
+  const Color kFoulPoleColor = Color("yellow");
+  /** The width of the stadium's lines. **/
+  const float kStadiumLineWidth = 6;
+  /** The longest distance, in feet, that the leaderboard can rank. **/
+  const float kLeaderboardMaxDistance = 1000000;
 
   /** BALL CONSTANTS **/
   /** The color of the ball. **/
@@ -195,6 +409,19 @@ class HomeRunDerbyApp : public ci::app::App {
   /** Factor limiting the furthest point on the screen the bat can go. **/
   const float kBatXLimitFactor = 3;
 
+  /** The bat catalog asset; without it only the plain bat is offered. **/
+  const string kBatCatalogAsset = "bats.bin";
+
+  /** BAT PREDICTION CONSTANTS **/
+  /** How far the drawn bat moves toward each new mouse sample. **/
+  const float kBatPredictionAlpha = 0.85f;
+  /** How far the bat's estimated velocity moves toward each new sample's. **/
+  const float kBatPredictionBeta = 0.4f;
+  /** The furthest past the last mouse sample the bat is drawn, in seconds. **/
+  const double kBatPredictionHorizon = 3 / kFrameRate;
+  /** How long a drawn frame takes to reach the screen, in seconds. **/
+  const double kBatPredictionLead = 1 / kFrameRate;
+
   /** GAME LOGIC CONSTANTS **/
   /** The maximum number of outs. **/
   const size_t kMaxOuts = 10;
@@ -208,6 +435,11 @@ class HomeRunDerbyApp : public ci::app::App {
   const float kGroundFriction = 0.1f;
   /** The restitution from the ground when bouncing. **/
   const float kGroundRestitution = 0.4f;
+  /**
+   * The calibrated physics profile asset, which overrides the constants
+   * above.
+   */
+  const string kPhysicsProfileAsset = "physics.txt";
   /** The terminal velocity of the ball in the y-direction. **/
   const float kBallTerminalVelocity = 1000;
   /** The minimum pitch speed in the x-direction. **/
@@ -219,9 +451,103 @@ class HomeRunDerbyApp : public ci::app::App {
   /** The maximum pitch speed in the y-direction. **/
   const float kMaxPitchSpeedY = 7;
 
+  /** AI BATTER CONSTANTS **/
+  /** The furthest the computer can move the bat in a single frame. **/
+  const float kAiMaxBatSpeed = 100;
+  /** The most frames of pitch and flight the computer looks ahead. **/
+  const size_t kAiMaxTicks = 20000;
+  /** The time the computer spends planning a swing, in seconds. **/
+  const double kAiPlanningTime = 0.5 / kFrameRate;
+
+  /** FIELDING CONSTANTS **/
+  /** The number of fielders sent out in defensive mode. **/
+  const size_t kNumFielders = 150;
+  /** The x-coordinate of the edge of the outfield nearest the batter. **/
+  const float kOutfieldStartX = -500;
+  /** The x-coordinate of the far edge of the outfield. **/
+  const float kOutfieldEndX = -17000;
+  /** The furthest a fielder runs in a frame. **/
+  const float kFielderSpeed = 5;
+  /** How far to either side a fielder can reach for the ball. **/
+  const float kFielderCatchRadius = 60;
+  /** How high above the ground a fielder can reach for the ball. **/
+  const float kFielderCatchHeight = 250;
+  /** The closest two fielders stand to each other. **/
+  const float kFielderSeparation = 40;
+  /** The radius of a fielder. **/
+  const float kFielderRadius = 20;
+  /** The color of a fielder standing at their position. **/
+  const Color kFielderColor = Color("navy");
+  /** The color of a fielder chasing the ball. **/
+  const Color kChasingFielderColor = Color("red");
+
   /** END CONSTANTS **/
 
+  // The constants the game is played with, calibrated if there is a profile.
+  const PhysicsProfile physics_;
   Simulator simulator_;
+  SpectatorBroadcaster spectator_broadcaster_;
+  MetricsRegistry metrics_registry_;
+  MetricsServer metrics_server_;
+  SimulatorMetrics simulator_metrics_;
+  Histogram* tick_seconds_;
+  Histogram* draw_seconds_;
+  Counter* allocations_;
+  Gauge* spectators_;
+  Gauge* quality_level_;
+  Counter* swing_cache_hits_;
+  Counter* swing_cache_misses_;
+  // The cache lookups already passed on to the counters.
+  size_t num_swing_cache_hits_;
+  size_t num_swing_cache_misses_;
+  InputLatencyTracker input_latency_tracker_;
+  // Every hit the player has made since the game was launched.
+  HitStatistics hit_statistics_;
+  // Every contact the player has made since the game was launched.
+  ContactAnalytics contact_analytics_;
+  BatPredictor bat_predictor_;
+  ScoreStore score_store_;
+  Leaderboard leaderboard_;
+  Stadium stadium_;
+  BatCatalog bat_catalog_;
+  // The catalog bat in use, or the number of models for the plain bat.
+  size_t bat_index_;
+  AiBatter ai_batter_;
+  DistanceSurrogate distance_surrogate_;
+  FieldingTeam fielding_team_;
+  bool is_ai_batting_;
+  bool is_fielding_;
+  // The game as it was when the current pitch was released.
+  SimulatorSnapshot pitch_snapshot_;
+  bool has_pitch_snapshot_;
+  bool is_idle_;
+  // The computer's game, played beside the player's in split screen. It
+  // shares the player's background field, stadium and pitches.
+  Simulator second_simulator_;
+  AiBatter second_ai_batter_;
+  StepWorker first_step_worker_;
+  StepWorker second_step_worker_;
+  bool is_split_screen_;
+  // Decides how many of the laid out particles are drawn, and how finely.
+  QualityController quality_controller_;
+
+  // Fonts are rasterized once into glyph atlases rather than every frame.
+  ci::gl::TextureFontRef title_font_;
+  ci::gl::TextureFontRef subtitle_font_;
+  ci::gl::TextureFontRef statistics_font_;
+
+  // Text that changes between frames is formatted into reserved storage.
+  mutable FormattedText high_score_text_;
+  mutable FormattedText final_score_text_;
+  mutable FormattedText rank_text_;
+  mutable FormattedText outs_text_;
+  mutable FormattedText total_distance_text_;
+  mutable FormattedText current_distance_text_;
+  mutable FormattedText current_altitude_text_;
+  mutable FormattedText predicted_distance_text_;
+  mutable FormattedText second_score_text_;
+  mutable FormattedText last_swing_text_;
+  mutable FormattedText swing_summary_text_;
 };
 
 }  // namespace visualizer
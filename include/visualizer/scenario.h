@@ -0,0 +1,195 @@
+#ifndef HOME_RUN_DERBY_SCENARIO_H
+#define HOME_RUN_DERBY_SCENARIO_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "simulator.h"
+
+namespace home_run_derby {
+
+namespace visualizer {
+
+using std::string;
+using std::vector;
+
+/**
+ * The things that happen in a game that a scenario can wait for.
+ */
+enum class ScenarioEvent {
+  /** The bat made contact with the ball. **/
+  kContact,
+  /**
+   * The pitch is over, whether the ball came to rest, was caught or went by
+   * unhit, and the next one has been released.
+   */
+  kPitchEnded,
+  kOut,
+  kHomeRun
+};
+
+/** The number of kinds of ScenarioEvent. **/
+const size_t kNumScenarioEvents = 4;
+
+/**
+ * A script of what a player does in a game and what should come of it, e.g.
+ * wait for the pitch, swing along a path at a tick, wait for the ball to
+ * come to rest, then check the score.
+ *
+ * A scenario is a list of steps, built up in order, that only describes the
+ * play: it can be run against any number of games at once by ScenarioRuns.
+ */
+class Scenario {
+ public:
+  typedef std::function<void(Simulator*)> Action;
+  typedef std::function<bool(const Simulator&)> Check;
+
+  /**
+   * Creates a scenario with no steps.
+   * @param name What the scenario is called in its failures.
+   */
+  explicit Scenario(const string& name);
+
+  /**
+   * Does something to the game, e.g. start it.
+   */
+  Scenario& Do(const Action& action);
+
+  /**
+   * Moves the bat, as an input between ticks would.
+   */
+  Scenario& MoveBat(const vec2& position);
+
+  /**
+   * Moves the bat along a path, one point per tick.
+   */
+  Scenario& Swing(const vector<vec2>& path);
+
+  /**
+   * Waits until something next happens in the game.
+   */
+  Scenario& WaitFor(ScenarioEvent event);
+
+  /**
+   * Waits for a number of ticks.
+   */
+  Scenario& WaitTicks(size_t num_ticks);
+
+  /**
+   * Waits until the pitch has been in the air for a number of ticks. If the
+   * current pitch is already past it, this waits for the next pitch.
+   */
+  Scenario& WaitForPitchTick(size_t pitch_tick);
+
+  /**
+   * Checks the game, failing the scenario if the check does not hold.
+   * @param description What the check expects, for the failure.
+   */
+  Scenario& Expect(const string& description, const Check& check);
+
+  const string& GetName() const;
+
+  size_t GetNumSteps() const;
+
+ private:
+  friend class ScenarioRun;
+
+  enum StepKind { kAct, kWaitForEvent, kWaitTicks, kWaitForPitchTick, kExpect };
+
+  struct Step {
+    StepKind kind;
+    Action action;
+    Check check;
+    ScenarioEvent event;
+    size_t count;
+    string description;
+  };
+
+  Scenario& AddStep(const Step& step);
+
+  string name_;
+  vector<Step> steps_;
+};
+
+/**
+ * One play of a scenario against a game. The run carries out the scenario's
+ * steps until one has to wait for the game, then suspends, and each Resume()
+ * plays one more tick toward it. Many runs can so be interleaved, however
+ * long each one waits.
+ */
+class ScenarioRun {
+ public:
+  /** The longest a single step may wait before the run fails. **/
+  static const size_t kMaxWaitTicks = 100000;
+
+  /**
+   * Gets a run ready to start at the scenario's first step.
+   * @param scenario A scenario that outlives the run.
+   * @param simulator The game to play, which outlives the run. Its ticks are
+   * played as the game plays them, in whatever state it is in.
+   */
+  ScenarioRun(const Scenario* scenario, Simulator* simulator);
+
+  /**
+   * Carries out steps up to the next one that waits, then plays one tick
+   * toward it. A step that throws fails the run.
+   * @return true if the run has more to do, false once it has finished.
+   */
+  bool Resume();
+
+  /**
+   * Resumes the run until it finishes.
+   * @return true if the run passed.
+   */
+  bool RunToEnd();
+
+  bool IsDone() const;
+
+  /**
+   * Checks whether the run finished without any step failing.
+   */
+  bool HasPassed() const;
+
+  /**
+   * Gets why the run failed, or an empty string if it has not.
+   */
+  const string& GetFailure() const;
+
+  /**
+   * Gets the number of ticks the run has played.
+   */
+  size_t GetNumTicks() const;
+
+  const Simulator& GetSimulator() const;
+
+ private:
+  /**
+   * Plays one tick, noting what happened in it.
+   */
+  void Tick();
+
+  /**
+   * Checks whether the current step has finished waiting.
+   */
+  bool IsWaitOver(const Scenario::Step& step) const;
+
+  void Fail(const string& reason);
+
+  const Scenario* scenario_;
+  Simulator* simulator_;
+  size_t step_;
+  bool is_done_;
+  string failure_;
+  size_t num_ticks_;
+  // What the current step has seen since it started waiting.
+  bool is_waiting_;
+  size_t num_wait_ticks_;
+  bool has_seen_[kNumScenarioEvents];
+};
+
+}  // namespace visualizer
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_SCENARIO_H
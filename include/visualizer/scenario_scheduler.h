@@ -0,0 +1,62 @@
+#ifndef HOME_RUN_DERBY_SCENARIO_SCHEDULER_H
+#define HOME_RUN_DERBY_SCENARIO_SCHEDULER_H
+
+#include <memory>
+#include <vector>
+
+#include "core/step_worker.h"
+#include "scenario.h"
+
+namespace home_run_derby {
+
+namespace visualizer {
+
+using std::unique_ptr;
+using std::vector;
+
+/**
+ * Plays many scenario runs to the end on a few threads.
+ *
+ * Each worker takes its share of the runs and resumes them in turn, one tick
+ * each, so a run waiting for a long pitch never holds up the ones behind it.
+ */
+class ScenarioScheduler {
+ public:
+  /**
+   * Starts the workers.
+   * @param num_workers The number of worker threads, or 0 for one per
+   * hardware thread.
+   */
+  explicit ScenarioScheduler(size_t num_workers);
+
+  ScenarioScheduler(const ScenarioScheduler&) = delete;
+
+  ScenarioScheduler& operator=(const ScenarioScheduler&) = delete;
+
+  /**
+   * Plays every run to the end, waiting for all of them. Each run must play a
+   * game of its own.
+   * @param runs The runs to play.
+   * @return The number of runs that passed.
+   */
+  size_t Run(vector<ScenarioRun>* runs);
+
+  size_t GetNumWorkers() const;
+
+ private:
+  /**
+   * Runs on a worker, interleaving its share of the runs until all are done.
+   * @param worker The worker's index.
+   */
+  void RunShare(size_t worker);
+
+  vector<unique_ptr<StepWorker>> workers_;
+  // The runs being played, only set during Run().
+  vector<ScenarioRun>* runs_;
+};
+
+}  // namespace visualizer
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_SCENARIO_SCHEDULER_H
@@ -0,0 +1,186 @@
+#ifndef HOME_RUN_DERBY_SESSION_HOST_H
+#define HOME_RUN_DERBY_SESSION_HOST_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "core/hit_statistics.h"
+#include "core/metrics.h"
+#include "core/step_worker.h"
+#include "simulator.h"
+
+namespace home_run_derby {
+
+namespace visualizer {
+
+using std::unique_ptr;
+using std::vector;
+
+/**
+ * How a host runs its sessions.
+ */
+struct SessionHostSettings {
+  /** The most sessions open at once. Their games are set aside up front. **/
+  size_t max_sessions;
+  /** The number of worker threads, or 0 for one per hardware thread. **/
+  size_t num_workers;
+  /** The number of neighboring sessions a worker ticks in one go. **/
+  size_t batch_size;
+  /** The outs that end a session's game. **/
+  size_t max_outs;
+  /** How soon after a tick starts each session should have been ticked. **/
+  double tick_slo_seconds;
+};
+
+/**
+ * How a session's ticks have measured up against the host's objective.
+ */
+struct SessionStats {
+  uint64_t num_ticks;
+  /** Ticks that finished later than the objective allows. **/
+  uint64_t num_slow_ticks;
+  /** How long after its tick started the session's last tick finished. **/
+  double last_tick_seconds;
+};
+
+/**
+ * Plays many independent headless games at once, each driven by its own
+ * client's inputs.
+ *
+ * Every session's game is laid out next to the others in one block, and each
+ * tick hands out neighboring sessions in batches to a fixed pool of workers,
+ * so a worker runs through games that sit together in memory rather than
+ * each game having a thread of its own. Inputs are queued between ticks and
+ * played in order at the start of the session's next tick.
+ *
+ * Opening, closing, starting and queuing inputs are not thread safe, and must
+ * not overlap a tick.
+ */
+class SessionHost {
+ public:
+  /** The upper bounds, in seconds, of the buckets tick latencies fall in. **/
+  static const vector<double> kTickLatencyBuckets;
+  /** The most inputs kept for a session between ticks. **/
+  static const size_t kMaxQueuedInputs = Bat::kMaxWaypoints;
+
+  /**
+   * Sets aside a game for every session and starts the workers.
+   * @param prototype The game every session starts as a copy of. Copies share
+   * its background field and stadium.
+   * @param settings How to run the sessions.
+   * @throws invalid_argument if a setting is out of range.
+   */
+  SessionHost(const Simulator& prototype, const SessionHostSettings& settings);
+
+  SessionHost(const SessionHost&) = delete;
+
+  SessionHost& operator=(const SessionHost&) = delete;
+
+  /**
+   * Opens a session on its start screen.
+   * @param seed Picks the session's pitches.
+   * @return The session's number, the lowest one free.
+   * @throws runtime_error if every session is open.
+   */
+  size_t OpenSession(uint64_t seed);
+
+  /**
+   * Closes a session, freeing its number.
+   * @throws invalid_argument if the session is not open.
+   */
+  void CloseSession(size_t session);
+
+  bool IsOpen(size_t session) const;
+
+  /**
+   * Starts a new game in a session that is not already playing one.
+   * @throws invalid_argument if the session is not open.
+   */
+  void StartGame(size_t session);
+
+  /**
+   * Queues a move of a session's bat for its next tick. Once the queue is
+   * full, a new input replaces the last one.
+   * @throws invalid_argument if the session is not open.
+   */
+  void QueueInput(size_t session, const vec2& bat_position);
+
+  /**
+   * Plays one tick of every open session with a game in progress, waiting
+   * for all of them. A game that runs out of outs moves to its end screen.
+   */
+  void Tick();
+
+  size_t GetNumOpenSessions() const;
+
+  size_t GetMaxSessions() const;
+
+  /**
+   * Gets a session's game, which is only read safely between ticks.
+   */
+  const Simulator& GetSimulator(size_t session) const;
+
+  const SessionStats& GetStats(size_t session) const;
+
+  /**
+   * Adds the latency of every session tick so far to a histogram.
+   * @param latencies A histogram with the bounds kTickLatencyBuckets.
+   */
+  void CollectTickLatencies(Histogram* latencies) const;
+
+  /**
+   * Adds every hit in every session so far to hit statistics.
+   */
+  void CollectHitStatistics(HitStatistics* hits) const;
+
+ private:
+  typedef std::chrono::steady_clock Clock;
+
+  struct Session {
+    explicit Session(const Simulator& prototype);
+
+    Simulator simulator;
+    bool is_open;
+    vec2 inputs[kMaxQueuedInputs];
+    size_t num_inputs;
+    SessionStats stats;
+  };
+
+  /**
+   * Runs on a worker, ticking batches of sessions until none are left.
+   * @param worker The worker's index.
+   */
+  void TickBatches(size_t worker);
+
+  /**
+   * Plays one tick of a session.
+   */
+  void TickSession(Session* session, Histogram* latencies,
+                   HitStatistics* hits);
+
+  Session& GetOpenSession(size_t session);
+
+  SessionHostSettings settings_;
+  // The state every session is reset to when it opens.
+  SimulatorSnapshot prototype_snapshot_;
+  vector<Session> sessions_;
+  // The numbers of the closed sessions, with the lowest last.
+  vector<size_t> free_sessions_;
+  // One past the highest open session, so ticks skip the rest.
+  size_t num_used_sessions_;
+  // Each worker counts its own latencies and hits, so workers never contend.
+  vector<unique_ptr<Histogram>> worker_latencies_;
+  vector<unique_ptr<HitStatistics>> worker_hits_;
+  vector<unique_ptr<StepWorker>> workers_;
+  std::atomic<size_t> next_batch_;
+  Clock::time_point tick_start_;
+};
+
+}  // namespace visualizer
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_SESSION_HOST_H
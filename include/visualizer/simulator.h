@@ -9,6 +9,14 @@
 #include "core/ball.h"
 #include "core/bat.h"
 #include "core/canvas_frame.h"
+#include "core/contact_analytics.h"
+#include "core/fielding_team.h"
+#include "core/hit_statistics.h"
+#include "core/input_latency_tracker.h"
+#include "core/leaderboard.h"
+#include "core/metrics.h"
+#include "core/score_store.h"
+#include "core/stadium.h"
 
 namespace home_run_derby {
 
@@ -16,12 +24,37 @@ namespace visualizer {
 
 using std::string;
 
+struct SimulatorSnapshot;
+
+/**
+ * The counters a simulator keeps up to date as it plays. Any of them may be
+ * nullptr to leave it uncounted.
+ */
+struct SimulatorMetrics {
+  // Pitches that ended, however they ended.
+  Counter* pitches;
+  // Pitches the bat made contact with.
+  Counter* hits;
+  Counter* home_runs;
+  Counter* outs;
+  // Outs made by a fielder catching the ball on the fly.
+  Counter* catches;
+  // Ticks on which the ball was checked against the bat.
+  Counter* collision_checks;
+};
+
 /**
  * This class handles the logic behind the simulator, tying backend calculations
  * with the frontend UI.
  */
 class Simulator {
  public:
+  /**
+   * The screens the game moves between. The values match the order in which
+   * IncrementGameState() cycles through them.
+   */
+  enum GameState : size_t { kStartScreen = 0, kInGame = 1, kEndScreen = 2 };
+
   /**
    * Default constructor.
    */
@@ -68,10 +101,8 @@ class Simulator {
   /**
    * Updates the offset for the canvas.
    * @param new_offset The new offset for the canvas.
-   * @param new_speed The new speed for the canvas.
    */
-  void UpdateOffset(const vec2& new_offset = vec2(0, 0),
-                    const vec2& new_speed = vec2(0, 0));
+  void UpdateOffset(const vec2& new_offset = vec2(0, 0));
 
   /**
    * Updates the states of the ball.
@@ -89,6 +120,111 @@ class Simulator {
    */
   void IncrementGameState();
 
+  /**
+   * Transitions to a new game state, running the exit hook of the current state
+   * and the enter hook of the new one exactly once. Setting the state that is
+   * already active does nothing.
+   * @param new_state The game state to transition to.
+   */
+  void SetGameState(GameState new_state);
+
+  /**
+   * Records the final score of every game in a durable store, and starts the
+   * high score from the best score it already holds.
+   * @param score_store An opened store that outlives the simulator.
+   */
+  void AttachScoreStore(ScoreStore* score_store);
+
+  /**
+   * Ranks the final score of every game on a leaderboard.
+   * @param leaderboard A leaderboard that outlives the simulator.
+   */
+  void AttachLeaderboard(Leaderboard* leaderboard);
+
+  /**
+   * Plays the ball in a stadium, scoring home runs over its fences rather
+   * than past the left edge of the screen.
+   * @param stadium A stadium that outlives the simulator, or nullptr to go back
+   * to the flat ground.
+   */
+  void AttachStadium(const Stadium* stadium);
+
+  /**
+   * Puts fielders on the field, who turn hits they catch on the fly into
+   * outs.
+   * @param fielding_team A team that outlives the simulator, or nullptr to
+   * play without fielders.
+   */
+  void AttachFieldingTeam(FieldingTeam* fielding_team);
+
+  /**
+   * Hands the batter a bat from the catalog.
+   * @param model A model that outlives the simulator, or nullptr to go back
+   * to the plain bat.
+   */
+  void AttachBatModel(const BatModel* model);
+
+  /**
+   * Draws the canvas's stars and dirt from a field shared with other games,
+   * rather than one of its own. Sharing is safe across threads, since the
+   * field never changes.
+   * @param field The field to share.
+   */
+  void SetBackgroundField(const shared_ptr<const BackgroundField>& field);
+
+  /**
+   * Counts what happens in the game as it is played.
+   * @param metrics Counters that outlive the simulator, or nullptr to stop
+   * counting.
+   */
+  void AttachMetrics(const SimulatorMetrics* metrics);
+
+  /**
+   * Follows bat inputs through the game, from the bat moving to the bat
+   * hitting the ball, starting a new session with every game.
+   * @param tracker A tracker that outlives the simulator, which is told of
+   * each input as it arrives, or nullptr to stop following inputs.
+   */
+  void AttachInputLatencyTracker(InputLatencyTracker* tracker);
+
+  /**
+   * Records what comes of every hit once its pitch is over.
+   * @param statistics Statistics that outlive the simulator, or nullptr to
+   * stop recording.
+   */
+  void AttachHitStatistics(HitStatistics* statistics);
+
+  /**
+   * Records every contact the bat makes with the ball as it happens, starting
+   * a new session with every game.
+   * @param analytics Analytics that outlive the simulator, or nullptr to stop
+   * recording.
+   */
+  void AttachContactAnalytics(ContactAnalytics* analytics);
+
+  /**
+   * Restarts every random sequence in the game, so that the same seed and the
+   * same inputs play out the same game.
+   * @param seed Picks the pitches and the layout of the canvas.
+   */
+  void Seed(uint64_t seed);
+
+  /**
+   * Copies out the whole state of the game, ready to be restored later.
+   * @param snapshot Receives the state.
+   */
+  void SaveSnapshot(SimulatorSnapshot* snapshot) const;
+
+  /**
+   * Puts the game back exactly as it was when a snapshot was saved, including
+   * where its random sequences were, without running any game state hooks.
+   * The attached store, leaderboard, stadium and background field are not
+   * part of the snapshot, and any fielders go back to their positions.
+   * @param snapshot A snapshot saved from a simulator built with the same
+   * settings.
+   */
+  void RestoreSnapshot(const SimulatorSnapshot& snapshot);
+
   /**
    * Resets the states of the game.
    */
@@ -106,7 +242,14 @@ class Simulator {
    */
   const vec2 GetBallDisplayPosition() const;
 
-  size_t GetCurrentGameState() const;
+  /**
+   * Checks whether the current game state shows a screen that only changes in
+   * response to input.
+   * @return true for the start and end screens, false while in-game.
+   */
+  bool IsStaticScreen() const;
+
+  GameState GetCurrentGameState() const;
 
   const CanvasFrame& GetCanvasFrame() const;
 
@@ -116,11 +259,53 @@ class Simulator {
 
   size_t GetOuts() const;
 
+  /**
+   * Gets the number of ticks since the current pitch was released.
+   */
+  size_t GetPitchTick() const;
+
+  /**
+   * Gets the x-speed at or below which the ball is considered stopped.
+   */
+  float GetBallStoppedSpeed() const;
+
   float GetScore() const;
 
   float GetHighScore() const;
 
  private:
+  /**
+   * Runs the one-time work needed when a game state is entered.
+   * @param state The game state being entered.
+   */
+  void OnEnterState(GameState state);
+
+  /**
+   * Runs the one-time work needed when a game state is left.
+   * @param state The game state being left.
+   */
+  void OnExitState(GameState state);
+
+  /**
+   * Gets the ball, bat, canvas and fielders ready for the next pitch.
+   */
+  void ResetPitch();
+
+  /**
+   * Starts measuring a hit as the bat meets the ball.
+   */
+  void BeginHit();
+
+  /**
+   * Records the pitch's hit, if the ball was hit, as the pitch ends.
+   */
+  void EndHit();
+
+  /**
+   * Adds one to a counter, if it is being counted.
+   */
+  void Count(Counter* SimulatorMetrics::*counter) const;
+
   // These constants should not be changed!
   const float kBallConsideredStoppedVelocity = 0.02f;
   const size_t kNumGameStates = 3;
@@ -130,14 +315,48 @@ class Simulator {
   float window_stretch_constant_;
 
   // Game logic variables.
-  size_t current_game_state_;
+  GameState current_game_state_;
   size_t outs_;
+  size_t pitch_tick_;
   float current_score_;
   float high_score_;
 
   CanvasFrame canvas_frame_;
   Ball baseball_;
   Bat baseball_bat_;
+  ScoreStore* score_store_;
+  Leaderboard* leaderboard_;
+  FieldingTeam* fielding_team_;
+  const SimulatorMetrics* metrics_;
+  InputLatencyTracker* input_latency_tracker_;
+  HitStatistics* hit_statistics_;
+  ContactAnalytics* contact_analytics_;
+
+  // The hit the current pitch has become, once the bat has met the ball.
+  HitOutcome hit_;
+  float contact_x_;
+  bool has_hit_landed_;
+};
+
+/**
+ * The whole state of a game, in a flat block that can be copied like plain
+ * memory. Saving and restoring one is cheap enough to do every frame, which
+ * allows retrying a pitch, rolling back to an earlier frame or playing out
+ * several what-ifs from the same moment.
+ */
+struct SimulatorSnapshot {
+  BallState ball;
+  vec2 bat_position;
+  vec2 bat_speed;
+  CanvasState canvas;
+  Simulator::GameState game_state;
+  size_t outs;
+  size_t pitch_tick;
+  float score;
+  float high_score;
+  HitOutcome hit;
+  float contact_x;
+  bool has_hit_landed;
 };
 
 }  // namespace visualizer
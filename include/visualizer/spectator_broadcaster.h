@@ -0,0 +1,155 @@
+#ifndef HOME_RUN_DERBY_SPECTATOR_BROADCASTER_H
+#define HOME_RUN_DERBY_SPECTATOR_BROADCASTER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "core/datagram_socket.h"
+#include "core/spectator_protocol.h"
+#include "simulator.h"
+
+namespace home_run_derby {
+
+namespace visualizer {
+
+using std::vector;
+
+/**
+ * Mirrors a game to spectator processes on the same machine.
+ *
+ * The game loop publishes a quantized frame every tick into a fixed queue,
+ * which never waits: if the broadcast thread falls behind, the frame is
+ * dropped. The broadcast thread sends only the newest frame to each spectator,
+ * as a keyframe until the spectator acknowledges one and then as a delta
+ * against the last frame it acknowledged, so a lost datagram never leaves a
+ * spectator unable to decode the next. An unchanged frame costs about a dozen
+ * bytes.
+ */
+class SpectatorBroadcaster {
+ public:
+  /**
+   * Creates a broadcaster that has not started yet.
+   * @param port The loopback port spectators join on, or 0 to pick a free one.
+   */
+  explicit SpectatorBroadcaster(uint16_t port);
+
+  /**
+   * Stops broadcasting.
+   */
+  ~SpectatorBroadcaster();
+
+  SpectatorBroadcaster(const SpectatorBroadcaster&) = delete;
+
+  SpectatorBroadcaster& operator=(const SpectatorBroadcaster&) = delete;
+
+  /**
+   * Binds the port and starts the broadcast thread.
+   * @throws runtime_error if the port could not be bound.
+   */
+  void Start();
+
+  /**
+   * Stops the broadcast thread and closes the port.
+   */
+  void Stop();
+
+  /**
+   * Queues the current frame of a game for the spectators, without waiting.
+   * Only the game loop may call this.
+   * @param simulator The game to mirror.
+   * @return true if the frame was queued, false if the broadcaster is stopped
+   * or too far behind.
+   */
+  bool Publish(const Simulator& simulator);
+
+  /**
+   * Gets the port spectators join on, once started.
+   */
+  uint16_t GetPort() const;
+
+  size_t GetNumSpectators() const;
+
+  /**
+   * Gets the number of frame bytes sent to all spectators so far.
+   */
+  uint64_t GetNumBytesSent() const;
+
+  /**
+   * Gets the number of frames sent to all spectators so far.
+   */
+  uint64_t GetNumFramesSent() const;
+
+  /**
+   * Gets the number of frames dropped because the queue was full.
+   */
+  uint64_t GetNumDroppedFrames() const;
+
+ private:
+  typedef std::chrono::steady_clock Clock;
+
+  struct Spectator {
+    SocketAddress address;
+    // The newest frame the spectator acknowledged, which deltas build on.
+    SpectatorFrame reference;
+    bool has_reference;
+    Clock::time_point last_heard;
+  };
+
+  /**
+   * Runs on the broadcast thread until stopped.
+   */
+  void Run();
+
+  /**
+   * Handles every join, acknowledgement and leave waiting on the socket.
+   */
+  void HandleMessages();
+
+  /**
+   * Sends a frame to every spectator and keeps it for their acknowledgements.
+   */
+  void SendFrame(const SpectatorFrame& frame);
+
+  /**
+   * Forgets spectators that have not been heard from in a while.
+   */
+  void DropSilentSpectators();
+
+  /** The number of frames the game can get ahead of the broadcast thread. **/
+  static const size_t kQueueSize = 64;
+  /** The most spectators that can watch at once. **/
+  static const size_t kMaxSpectators = 64;
+  /** The longest the broadcast thread waits for a message, in milliseconds. **/
+  static const int kPollMilliseconds = 2;
+  /** How long a spectator can stay silent before it is dropped, in seconds. **/
+  static const int kSpectatorTimeoutSeconds = 5;
+
+  uint16_t port_;
+  DatagramSocket socket_;
+  std::thread thread_;
+  std::atomic<bool> is_running_;
+
+  // A single-producer, single-consumer queue from the game loop.
+  SpectatorFrame queue_[kQueueSize];
+  std::atomic<uint64_t> write_index_;
+  std::atomic<uint64_t> read_index_;
+  uint32_t next_tick_;
+
+  // Only touched by the broadcast thread.
+  SpectatorFrame sent_frames_[kSpectatorHistorySize];
+  vector<Spectator> spectators_;
+
+  std::atomic<size_t> num_spectators_;
+  std::atomic<uint64_t> num_bytes_sent_;
+  std::atomic<uint64_t> num_frames_sent_;
+  std::atomic<uint64_t> num_dropped_frames_;
+};
+
+}  // namespace visualizer
+
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_SPECTATOR_BROADCASTER_H
@@ -0,0 +1,31 @@
+#include "core/ai_batter.h"
+
+namespace home_run_derby {
+
+AiBatter::AiBatter(const SwingLimits& limits, double budget_seconds)
+    : optimizer_(limits),
+      budget_seconds_(budget_seconds),
+      num_swings_planned_(0),
+      swing_({0, limits.max_bat_position, limits.max_bat_position, 0}) {
+}
+
+void AiBatter::PlanSwing(const Ball& pitch, const Bat& bat) {
+  // A different seed for every pitch keeps the batter from being predictable.
+  swing_ = optimizer_.FindBestSwing(pitch, bat, budget_seconds_,
+                                    num_swings_planned_++);
+}
+
+const vec2& AiBatter::GetBatPosition(size_t tick) const {
+  return tick < swing_.contact_tick ? swing_.start_position
+                                    : swing_.end_position;
+}
+
+const Swing& AiBatter::GetSwing() const {
+  return swing_;
+}
+
+const SwingOptimizer& AiBatter::GetOptimizer() const {
+  return optimizer_;
+}
+
+}  // namespace home_run_derby
@@ -0,0 +1,157 @@
+#include "core/allocation_tracker.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace home_run_derby {
+
+namespace {
+
+// The label used for allocations made outside of any AllocationScope.
+const char* const kUntrackedCallSite = "untracked";
+
+thread_local const char* current_call_site = nullptr;
+
+// The counters are guarded by a spin lock because a mutex may allocate.
+std::atomic_flag counters_lock = ATOMIC_FLAG_INIT;
+std::atomic<bool> is_counting(false);
+AllocationTracker::CallSiteCount call_sites[AllocationTracker::kMaxCallSites];
+size_t num_call_sites = 0;
+size_t frame_allocations = 0;
+
+void LockCounters() {
+  while (counters_lock.test_and_set(std::memory_order_acquire)) {
+  }
+}
+
+void UnlockCounters() {
+  counters_lock.clear(std::memory_order_release);
+}
+
+}  // namespace
+
+bool AllocationTracker::IsEnabled() {
+#ifdef HOME_RUN_DERBY_TRACK_ALLOCATIONS
+  return true;
+#else
+  return false;
+#endif
+}
+
+void AllocationTracker::BeginFrame() {
+  LockCounters();
+  num_call_sites = 0;
+  frame_allocations = 0;
+  UnlockCounters();
+  is_counting.store(true, std::memory_order_release);
+}
+
+size_t AllocationTracker::EndFrame() {
+  is_counting.store(false, std::memory_order_release);
+  return GetFrameAllocations();
+}
+
+void AllocationTracker::RecordAllocation(size_t bytes) {
+  if (!is_counting.load(std::memory_order_acquire)) {
+    return;
+  }
+  const char* call_site =
+      current_call_site != nullptr ? current_call_site : kUntrackedCallSite;
+
+  LockCounters();
+  ++frame_allocations;
+  // Call sites are labels with static storage, so comparing pointers is
+  // enough. Once the table is full, the last slot collects the rest.
+  size_t index = 0;
+  while (index < num_call_sites && call_sites[index].call_site != call_site) {
+    ++index;
+  }
+  if (index == num_call_sites) {
+    if (num_call_sites < kMaxCallSites) {
+      call_sites[num_call_sites++] = {call_site, 0, 0};
+    } else {
+      index = kMaxCallSites - 1;
+    }
+  }
+  ++call_sites[index].allocations;
+  call_sites[index].bytes += bytes;
+  UnlockCounters();
+}
+
+void AllocationTracker::Report(std::ostream& output) {
+  output << "Allocations this frame: " << GetFrameAllocations() << '\n';
+  for (size_t i = 0; i < GetNumCallSites(); ++i) {
+    const CallSiteCount& count = GetCallSite(i);
+    output << "  " << count.call_site << ": " << count.allocations << " ("
+           << count.bytes << " bytes)\n";
+  }
+}
+
+size_t AllocationTracker::GetFrameAllocations() {
+  return frame_allocations;
+}
+
+size_t AllocationTracker::GetNumCallSites() {
+  return num_call_sites;
+}
+
+const AllocationTracker::CallSiteCount& AllocationTracker::GetCallSite(
+    size_t index) {
+  return call_sites[index];
+}
+
+AllocationScope::AllocationScope(const char* call_site)
+    : previous_call_site_(current_call_site) {
+  current_call_site = call_site;
+}
+
+AllocationScope::~AllocationScope() {
+  current_call_site = previous_call_site_;
+}
+
+}  // namespace home_run_derby
+
+#ifdef HOME_RUN_DERBY_TRACK_ALLOCATIONS
+
+// Replacing the global allocation functions lets us see every allocation,
+// including the ones made inside the standard library and Cinder.
+void* operator new(size_t size) {
+  home_run_derby::AllocationTracker::RecordAllocation(size);
+  void* memory = std::malloc(size == 0 ? 1 : size);
+  if (memory == nullptr) {
+    throw std::bad_alloc();
+  }
+  return memory;
+}
+
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  home_run_derby::AllocationTracker::RecordAllocation(size);
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept {
+  return operator new(size, tag);
+}
+
+void operator delete(void* memory) noexcept {
+  std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+  std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept {
+  std::free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept {
+  std::free(memory);
+}
+
+#endif  // HOME_RUN_DERBY_TRACK_ALLOCATIONS
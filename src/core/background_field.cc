@@ -0,0 +1,73 @@
+#include "core/background_field.h"
+
+#include <cmath>
+
+#include "core/random.h"
+
+namespace home_run_derby {
+
+namespace {
+
+/**
+ * Wraps a coordinate around into [low, low + span).
+ */
+float Wrap(float value, float low, float span) {
+  float wrapped = std::fmod(value - low, span);
+  return low + (wrapped < 0 ? wrapped + span : wrapped);
+}
+
+}  // namespace
+
+BackgroundField::BackgroundField(float window_size, float stretch_constant,
+                                 size_t num_stars, size_t num_dirt_particles,
+                                 float star_radius, float dirt_particle_radius,
+                                 uint64_t seed)
+    : canvas_width_(window_size * stretch_constant),
+      canvas_height_(window_size),
+      star_radius_(star_radius),
+      dirt_particle_radius_(dirt_particle_radius) {
+  Random random(seed);
+  stars_.reserve(num_stars);
+  for (size_t i = 0; i < num_stars; ++i) {
+    stars_.push_back(Particle(vec2(random.NextFloat(0, canvas_width_),
+                                   random.NextFloat(0, canvas_height_)),
+                              &random));
+  }
+  // Dirt particles move with the ground rather than drifting like stars.
+  dirt_particles_.reserve(num_dirt_particles);
+  for (size_t i = 0; i < num_dirt_particles; ++i) {
+    dirt_particles_.push_back(Particle(
+        vec2(random.NextFloat(-dirt_particle_radius_,
+                              dirt_particle_radius_ + canvas_width_),
+             canvas_height_ + random.NextFloat(0, canvas_height_ / 2)),
+        nullptr));
+  }
+}
+
+size_t BackgroundField::GetNumStars() const {
+  return stars_.size();
+}
+
+size_t BackgroundField::GetNumDirtParticles() const {
+  return dirt_particles_.size();
+}
+
+vec2 BackgroundField::GetStarPosition(size_t index,
+                                      const vec2& scroll) const {
+  const Particle& star = stars_[index];
+  vec2 position = star.GetPosition() + star.GetSpeedMultiplier() * scroll;
+  // A star leaving one edge comes back in at the other, just out of sight.
+  return vec2(Wrap(position.x, -star_radius_, canvas_width_ + 2 * star_radius_),
+              Wrap(position.y, -star_radius_,
+                   canvas_height_ + 2 * star_radius_));
+}
+
+vec2 BackgroundField::GetDirtParticlePosition(size_t index,
+                                              const vec2& scroll) const {
+  vec2 position = dirt_particles_[index].GetPosition() + scroll;
+  return vec2(Wrap(position.x, -dirt_particle_radius_,
+                   canvas_width_ + 2 * dirt_particle_radius_),
+              position.y);
+}
+
+}  // namespace home_run_derby
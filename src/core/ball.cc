@@ -1,11 +1,12 @@
 #include "core/ball.h"
 
+#include <algorithm>
+#include <cmath>
 #include <vector>
 
-#include "cinder/Rand.h"
 #include "cinder/gl/gl.h"
+#include "core/flight.h"
 
-using ci::randFloat;
 using glm::dot;
 using glm::length;
 using glm::vec2;
@@ -14,6 +15,23 @@ using std::min;
 
 namespace home_run_derby {
 
+namespace {
+
+// How far the ball is left from a stadium surface after touching it, so the
+// next tick does not start inside it.
+const float kStadiumContactGap = 0.01f;
+
+// The sequence pitches are drawn from until the ball is seeded.
+const uint64_t kDefaultSeed = 1;
+
+bool BoxesOverlap(const vec2& first_min, const vec2& first_max,
+                  const vec2& second_min, const vec2& second_max) {
+  return first_min.x <= second_max.x && second_min.x <= first_max.x &&
+         first_min.y <= second_max.y && second_min.y <= first_max.y;
+}
+
+}  // namespace
+
 Ball::Ball(float mass, float radius, float gravity, float friction,
            float restitution, float ball_speed_boost_factor,
            float terminal_velocity, float min_x_pitch_speed,
@@ -31,7 +49,11 @@ Ball::Ball(float mass, float radius, float gravity, float friction,
       min_y_pitch_speed_(min_y_pitch_speed),
       max_y_pitch_speed_(max_y_pitch_speed),
       window_size_(window_size),
-      has_collided_(false) {
+      has_collided_(false),
+      stadium_(nullptr),
+      has_cleared_fence_(false),
+      fence_clearance_x_(0),
+      random_(kDefaultSeed) {
   ResetState();
 }
 
@@ -46,6 +68,13 @@ void Ball::HandleGroundCollisions() {
 }
 
 void Ball::HandleBatCollisions(const Bat& bat) {
+  // With more than one input since the last tick, a single step from the last
+  // input would miss the rest of the swing.
+  if (bat.GetNumWaypoints() > 1) {
+    HandleSweptBatCollisions(bat);
+    return;
+  }
+
   // Bat swing start position and length.
   vec2 bat_start_pos = bat.GetBatPosition() - bat.GetBatSpeed();
   vec2 bat_pos_vector = bat.GetBatPosition() - bat_start_pos;
@@ -68,7 +97,8 @@ void Ball::HandleBatCollisions(const Bat& bat) {
     has_collided_ = true;
 
     if (bat.GetBatSpeed().x == 0) {
-      UpdateSpeedOnCollision(bat, bat.GetBatPosition() - bat.GetBatSpeed());
+      UpdateSpeedOnCollision(bat, bat.GetBatPosition() - bat.GetBatSpeed(),
+                             bat.GetBatSpeed());
     } else {
       // Find the intersection between a sphere and a line.
       float slope = bat_pos_vector.y / bat_pos_vector.x;
@@ -78,70 +108,284 @@ void Ball::HandleBatCollisions(const Bat& bat) {
       float C = pow(position_.y, 2) - pow(radius_ + bat.GetBatRadius(), 2) +
                 pow(position_.x, 2) - (2 * position_.y * intercept) +
                 pow(intercept, 2);
-      try {
-        // Use the point closest to the bat's starting position.
-        pair<float, float> roots = QuadraticSolver(A, B, C);
+      // Use the point closest to the bat's starting position. Do nothing if
+      // the quadratic has no solutions.
+      pair<float, float> roots;
+      if (SolveQuadratic(A, B, C, roots)) {
         vec2 first_point =
             vec2(roots.first,
                  slope * (roots.first - bat_start_pos.x) + bat_start_pos.y);
         vec2 second_point =
             vec2(roots.second,
                  slope * (roots.second - bat_start_pos.x) + bat_start_pos.y);
-        UpdateSpeedOnCollision(bat, length(bat_start_pos - first_point) <=
-                                            length(bat_start_pos - second_point)
-                                        ? first_point
-                                        : second_point);
-      } catch (const invalid_argument&) {
-      }  // Do nothing if the quadratic has no solutions.
+        UpdateSpeedOnCollision(bat,
+                               length(bat_start_pos - first_point) <=
+                                       length(bat_start_pos - second_point)
+                                   ? first_point
+                                   : second_point,
+                               bat.GetBatSpeed());
+      }
     }
   }
 }
 
-void Ball::UpdateSpeedOnCollision(const Bat& bat, const vec2& bat_position) {
-  speed_ -= ball_speed_boost_factor_ *
-            (2.0f * bat.GetBatMass() / (mass_ + bat.GetBatMass())) *
-            (dot(speed_ - bat.GetBatSpeed(), position_ - bat_position) /
+void Ball::HandleSweptBatCollisions(const Bat& bat) {
+  if (has_collided_) {
+    return;
+  }
+  float reach = radius_ + bat.GetBatRadius();
+  size_t num_steps = bat.GetNumWaypoints();
+
+  // Most ticks the bat is nowhere near the ball, so first compare the box
+  // around the whole swing with the box around the ball's whole tick.
+  vec2 swing_min = bat.GetBatPosition();
+  vec2 swing_max = bat.GetBatPosition();
+  for (size_t i = 0; i < num_steps; ++i) {
+    swing_min = glm::min(swing_min, bat.GetWaypoint(i));
+    swing_max = glm::max(swing_max, bat.GetWaypoint(i));
+  }
+  if (!BoxesOverlap(swing_min, swing_max,
+                    glm::min(previous_position_, position_) - reach,
+                    glm::max(previous_position_, position_) + reach)) {
+    return;
+  }
+
+  // Each step takes an equal share of the tick.
+  for (size_t i = 0; i < num_steps; ++i) {
+    vec2 bat_start = bat.GetWaypoint(i);
+    vec2 bat_end =
+        i + 1 < num_steps ? bat.GetWaypoint(i + 1) : bat.GetBatPosition();
+    float start_time = static_cast<float>(i) / static_cast<float>(num_steps);
+    float end_time = static_cast<float>(i + 1) / static_cast<float>(num_steps);
+    vec2 ball_start = glm::mix(previous_position_, position_, start_time);
+    vec2 ball_end = glm::mix(previous_position_, position_, end_time);
+    if (!BoxesOverlap(glm::min(bat_start, bat_end) - reach,
+                      glm::max(bat_start, bat_end) + reach,
+                      glm::min(ball_start, ball_end),
+                      glm::max(ball_start, ball_end))) {
+      continue;
+    }
+
+    // Seen from the ball, the bat moves in a straight line over the step, so
+    // contact is where that line first comes within reach of the center.
+    vec2 relative_start = bat_start - ball_start;
+    vec2 relative_step = (bat_end - ball_end) - relative_start;
+    float contact_time;
+    if (dot(relative_start, relative_start) <= reach * reach) {
+      contact_time = 0;
+    } else if (dot(relative_step, relative_step) == 0) {
+      // The bat moves along with the ball, so it never comes any closer.
+      continue;
+    } else {
+      pair<float, float> roots;
+      if (!SolveQuadratic(dot(relative_step, relative_step),
+                          2 * dot(relative_start, relative_step),
+                          dot(relative_start, relative_start) - reach * reach,
+                          roots)) {
+        continue;
+      }
+      contact_time = std::min(roots.first, roots.second);
+      if (contact_time < 0 || contact_time > 1) {
+        continue;
+      }
+    }
+
+    // Bounce the ball where it is now, off the bat as they met. The step
+    // only covers its share of the tick, so the bat's speed over a whole tick
+    // is that many steps.
+    has_collided_ = true;
+    vec2 contact_offset = glm::mix(ball_start, ball_end, contact_time) -
+                          glm::mix(bat_start, bat_end, contact_time);
+    UpdateSpeedOnCollision(bat, position_ - contact_offset,
+                           static_cast<float>(num_steps) *
+                               (bat_end - bat_start));
+    return;
+  }
+}
+
+void Ball::UpdateSpeedOnCollision(const Bat& bat, const vec2& bat_position,
+                                  const vec2& bat_speed) {
+  // A plain bat is a perfectly elastic point mass. A catalog bat looks up
+  // how it responds where the ball met it.
+  float transfer = 2.0f * bat.GetBatMass() / (mass_ + bat.GetBatMass());
+  vec2 normal = position_ - bat_position;
+  float offset = 0;
+  if (length(bat_speed) > 0 && length(normal) > 0) {
+    offset = (bat_speed.x * normal.y - bat_speed.y * normal.x) /
+             (length(bat_speed) * length(normal));
+  }
+  const BatModel* model = bat.GetModel();
+  if (model != nullptr) {
+    BatResponse response =
+        model->GetResponse(model->GetContactPosition(offset));
+    transfer = (1 + response.restitution) * response.effective_mass /
+               (mass_ + response.effective_mass);
+  }
+  speed_ -= ball_speed_boost_factor_ * transfer *
+            (dot(speed_ - bat_speed, position_ - bat_position) /
              (length(position_ - bat_position) *
               (length(position_ - bat_position)))) *
             (position_ - bat_position);
+  CaptureContact(offset, bat_speed);
+}
+
+void Ball::CaptureContact(float offset, const vec2& bat_speed) {
+  contact_.position = position_;
+  contact_.exit_speed = length(speed_);
+  // The field is to the left, and up is toward negative y.
+  contact_.launch_angle_degrees =
+      glm::degrees(std::atan2(-speed_.y, -speed_.x));
+  contact_.contact_offset = offset;
+  contact_.bat_speed = length(bat_speed);
+  Landing landing;
+  contact_.carry =
+      PredictLanding(*this, ground_location_, gravity_, &landing)
+          ? std::max(0.0f, position_.x - landing.position.x)
+          : 0;
+  contact_.apex_height =
+      speed_.y < 0 && gravity_ > 0 ? speed_.y * speed_.y / (2 * gravity_) : 0;
 }
 
 void Ball::UpdateStates() {
-  // Check for collisions with the ground first. Then, update the position and
-  // restrict the speed by a terminal velocity.
-  HandleGroundCollisions();
-  position_ += speed_;
+  previous_position_ = position_;
+  // Check for collisions with the ground or stadium first. Then, update the
+  // position and restrict the speed by a terminal velocity.
+  if (stadium_ != nullptr) {
+    MoveThroughStadium();
+  } else {
+    HandleGroundCollisions();
+    position_ += speed_;
+  }
   speed_.y = min(speed_.y + gravity_, terminal_velocity_);
 }
 
+void Ball::MoveThroughStadium() {
+  vec2 start = position_;
+  SweepHit hit;
+  if (stadium_->SweepCircle(position_, position_ + speed_, radius_, &hit)) {
+    // Stop just short of the surface, then bounce: restitution on the speed
+    // into it and friction on the speed along it, as on the flat ground.
+    position_ += hit.time * speed_ + kStadiumContactGap * hit.normal;
+    float normal_speed = dot(speed_, hit.normal);
+    vec2 tangent_speed = speed_ - normal_speed * hit.normal;
+    speed_ = (1 - friction_) * tangent_speed -
+             restitution_ * normal_speed * hit.normal;
+    if (has_collided_ && !has_cleared_fence_ &&
+        stadium_->GetSegments()[hit.segment].type == SurfaceType::kFoulPole) {
+      has_cleared_fence_ = true;
+      fence_clearance_x_ = position_.x;
+    }
+  } else {
+    position_ += speed_;
+  }
+  if (has_collided_ && !has_cleared_fence_ &&
+      stadium_->ClearsFence(start, position_, radius_)) {
+    has_cleared_fence_ = true;
+    fence_clearance_x_ = position_.x;
+  }
+}
+
 void Ball::ResetState() {
   has_collided_ = false;
+  has_cleared_fence_ = false;
+  fence_clearance_x_ = 0;
+  contact_ = ContactEvent();
   position_.x = -radius_;
   position_.y = window_size_ / 2;
+  previous_position_ = position_;
   ResetPitchVelocity();
 }
 
 void Ball::ResetPitchVelocity() {
-  speed_.x = randFloat(min_x_pitch_speed_, max_x_pitch_speed_);
-  speed_.y = randFloat(-max_y_pitch_speed_, -min_y_pitch_speed_);
+  speed_.x = random_.NextFloat(min_x_pitch_speed_, max_x_pitch_speed_);
+  speed_.y = random_.NextFloat(-max_y_pitch_speed_, -min_y_pitch_speed_);
+}
+
+void Ball::Seed(uint64_t seed) {
+  random_.Seed(seed);
+}
+
+void Ball::SaveState(BallState* state) const {
+  state->position = position_;
+  state->previous_position = previous_position_;
+  state->speed = speed_;
+  state->ground_location = ground_location_;
+  state->fence_clearance_x = fence_clearance_x_;
+  state->has_collided = has_collided_;
+  state->has_cleared_fence = has_cleared_fence_;
+  state->contact = contact_;
+  state->random = random_;
+}
+
+void Ball::RestoreState(const BallState& state) {
+  position_ = state.position;
+  previous_position_ = state.previous_position;
+  speed_ = state.speed;
+  ground_location_ = state.ground_location;
+  fence_clearance_x_ = state.fence_clearance_x;
+  has_collided_ = state.has_collided;
+  has_cleared_fence_ = state.has_cleared_fence;
+  contact_ = state.contact;
+  random_ = state.random;
 }
 
 const pair<float, float> Ball::QuadraticSolver(float A, float B, float C) {
   // If the discriminant is negative, then throw an exception.
+  pair<float, float> solutions;
+  if (!SolveQuadratic(A, B, C, solutions)) {
+    throw invalid_argument("No solutions to the given quadratic!");
+  }
+  return solutions;
+}
+
+bool Ball::SolveQuadratic(float A, float B, float C,
+                          pair<float, float>& solutions) const {
   float discriminant = pow(B, 2) - 4 * A * C;
   if (discriminant < 0) {
-    throw invalid_argument("No solutions to the given quadratic!");
+    return false;
   }
-  pair<float, float> solutions;
   solutions.first = (-B + sqrt(discriminant)) / (2 * A);
   solutions.second = (-B - sqrt(discriminant)) / (2 * A);
-  return solutions;
+  return true;
 }
 
 bool Ball::HitPastScreen() const {
   return (has_collided_ && position_.x < 0);
 }
 
+bool Ball::IsHomeRun() const {
+  if (stadium_ == nullptr) {
+    return HitPastScreen();
+  }
+  return has_collided_ && has_cleared_fence_;
+}
+
+float Ball::GetHomeRunDistance() const {
+  if (!IsHomeRun()) {
+    return 0;
+  }
+  if (stadium_ == nullptr) {
+    return -position_.x;
+  }
+  return std::max(-position_.x, -fence_clearance_x_);
+}
+
+bool Ball::HasCollided() const {
+  return has_collided_;
+}
+
+const ContactEvent& Ball::GetContact() const {
+  return contact_;
+}
+
+void Ball::SetStadium(const Stadium* stadium) {
+  stadium_ = stadium;
+}
+
+const Stadium* Ball::GetStadium() const {
+  return stadium_;
+}
+
 void Ball::SetGroundLocation(float ground_location) {
   ground_location_ = ground_location;
 }
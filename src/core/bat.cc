@@ -2,6 +2,8 @@
 
 namespace home_run_derby {
 
+const size_t Bat::kMaxWaypoints;
+
 Bat::Bat(float bat_mass, float bat_radius)
     : bat_mass_(bat_mass), bat_radius_(bat_radius) {
 }
@@ -14,12 +16,20 @@ void Bat::SetBatPosition(const vec2& new_position) {
   bat_position_ = new_position;
 }
 
+void Bat::SetModel(const BatModel* model) {
+  model_ = model;
+}
+
+const BatModel* Bat::GetModel() const {
+  return model_;
+}
+
 float Bat::GetBatMass() const {
-  return bat_mass_;
+  return model_ != nullptr ? model_->GetMass() : bat_mass_;
 }
 
 float Bat::GetBatRadius() const {
-  return bat_radius_;
+  return model_ != nullptr ? model_->GetBarrelRadius() : bat_radius_;
 }
 
 const vec2& Bat::GetBatSpeed() const {
@@ -30,4 +40,23 @@ const vec2& Bat::GetBatPosition() const {
   return bat_position_;
 }
 
+void Bat::AddWaypoint(const vec2& waypoint) {
+  if (num_waypoints_ < kMaxWaypoints) {
+    ++num_waypoints_;
+  }
+  waypoints_[num_waypoints_ - 1] = waypoint;
+}
+
+void Bat::ClearWaypoints() {
+  num_waypoints_ = 0;
+}
+
+size_t Bat::GetNumWaypoints() const {
+  return num_waypoints_;
+}
+
+const vec2& Bat::GetWaypoint(size_t index) const {
+  return waypoints_[index];
+}
+
 }  // namespace home_run_derby
\ No newline at end of file
@@ -0,0 +1,231 @@
+#include "core/bat_catalog.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+#include "core/checksum.h"
+#include "core/mapped_file.h"
+
+namespace home_run_derby {
+
+using std::invalid_argument;
+using std::runtime_error;
+
+static_assert(std::is_trivially_copyable<BatModel>::value,
+              "Bat models must be readable as plain memory");
+
+namespace {
+
+const uint32_t kCatalogMagic = 0x42445248;  // "HRDB"
+// Bumped whenever the layout of a model changes.
+const uint32_t kCatalogVersion = 1;
+
+struct CatalogHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t num_models;
+  uint32_t models_checksum;
+};
+
+// The bat is integrated in this many slices along its length.
+const size_t kNumSlices = 1000;
+
+float GetRadiusAt(const BatProfile& profile, float fraction) {
+  if (fraction <= profile.taper_start) {
+    return profile.handle_radius;
+  }
+  if (fraction >= profile.taper_end) {
+    return profile.barrel_radius;
+  }
+  float taper = (fraction - profile.taper_start) /
+                (profile.taper_end - profile.taper_start);
+  return profile.handle_radius +
+         taper * (profile.barrel_radius - profile.handle_radius);
+}
+
+}  // namespace
+
+const size_t BatModel::kTableSize;
+const size_t BatModel::kMaxNameLength;
+
+BatModel BatModel::Build(const BatProfile& profile) {
+  if (profile.name.empty() || profile.name.size() > kMaxNameLength ||
+      !(profile.mass > 0) || !(profile.length > 0) ||
+      !(profile.handle_radius > 0) || !(profile.barrel_radius > 0) ||
+      !(profile.taper_start >= 0 && profile.taper_start <= profile.taper_end &&
+        profile.taper_end <= 1) ||
+      !(profile.sweet_spot >= 0 && profile.sweet_spot <= 1) ||
+      !(profile.sweet_spot_width > 0) ||
+      !(profile.min_restitution >= 0 &&
+        profile.min_restitution <= profile.peak_restitution &&
+        profile.peak_restitution <= 1)) {
+    throw invalid_argument("The bat profile " + profile.name +
+                           " is out of range");
+  }
+
+  BatModel model;
+  std::memset(&model, 0, sizeof(model));
+  std::memcpy(model.name_, profile.name.data(), profile.name.size());
+  model.mass_ = profile.mass;
+  model.length_ = profile.length;
+  model.barrel_radius_ = profile.barrel_radius;
+  model.sweet_spot_ = profile.sweet_spot * profile.length;
+
+  // A solid bat's mass follows its cross section, so weigh each slice by its
+  // radius squared, then scale the slices to the bat's mass.
+  double slice_length = profile.length / kNumSlices;
+  double weights[kNumSlices];
+  double total_weight = 0;
+  double moment = 0;
+  for (size_t i = 0; i < kNumSlices; ++i) {
+    double center = (i + 0.5) * slice_length;
+    double radius = GetRadiusAt(
+        profile, static_cast<float>(center / profile.length));
+    weights[i] = radius * radius;
+    total_weight += weights[i];
+    moment += weights[i] * center;
+  }
+  double center_of_mass = moment / total_weight;
+  double inertia = 0;
+  for (size_t i = 0; i < kNumSlices; ++i) {
+    double offset = (i + 0.5) * slice_length - center_of_mass;
+    inertia += profile.mass * weights[i] / total_weight * offset * offset;
+  }
+  model.center_of_mass_ = static_cast<float>(center_of_mass);
+
+  for (size_t i = 0; i < kTableSize; ++i) {
+    double position = profile.length * i / (kTableSize - 1);
+    // A blow away from the center of mass also spins the bat, so the ball
+    // feels less of its mass.
+    double offset = position - center_of_mass;
+    model.effective_mass_[i] = static_cast<float>(
+        1 / (1 / profile.mass + offset * offset / inertia));
+    double from_sweet_spot = (position - model.sweet_spot_) /
+                             (profile.sweet_spot_width * profile.length);
+    model.restitution_[i] = static_cast<float>(
+        profile.min_restitution +
+        (profile.peak_restitution - profile.min_restitution) *
+            std::exp(-from_sweet_spot * from_sweet_spot));
+  }
+  return model;
+}
+
+const char* BatModel::GetName() const {
+  return name_;
+}
+
+float BatModel::GetMass() const {
+  return mass_;
+}
+
+float BatModel::GetLength() const {
+  return length_;
+}
+
+float BatModel::GetBarrelRadius() const {
+  return barrel_radius_;
+}
+
+float BatModel::GetCenterOfMass() const {
+  return center_of_mass_;
+}
+
+float BatModel::GetSweetSpot() const {
+  return sweet_spot_;
+}
+
+float BatModel::GetContactPosition(float offset) const {
+  offset = std::max(-1.0f, std::min(offset, 1.0f));
+  return offset >= 0 ? sweet_spot_ + offset * (length_ - sweet_spot_)
+                     : sweet_spot_ + offset * sweet_spot_;
+}
+
+BatResponse BatModel::GetResponse(float position) const {
+  float index = std::max(0.0f, std::min(position / length_, 1.0f)) *
+                (kTableSize - 1);
+  size_t below = std::min(static_cast<size_t>(index), kTableSize - 2);
+  float weight = index - static_cast<float>(below);
+  BatResponse response;
+  response.restitution = restitution_[below] +
+                         weight * (restitution_[below + 1] -
+                                   restitution_[below]);
+  response.effective_mass = effective_mass_[below] +
+                            weight * (effective_mass_[below + 1] -
+                                      effective_mass_[below]);
+  return response;
+}
+
+BatCatalog::BatCatalog(const vector<BatModel>& models) : models_(models) {
+}
+
+BatCatalog BatCatalog::Load(const string& path) {
+  MappedFile file;
+  if (!file.Open(path)) {
+    throw runtime_error("Could not open the bat catalog " + path);
+  }
+  CatalogHeader header;
+  if (file.GetSize() < sizeof(header)) {
+    throw runtime_error("The bat catalog " + path + " is corrupt!");
+  }
+  std::memcpy(&header, file.GetData(), sizeof(header));
+  const char* models = file.GetData() + sizeof(header);
+  size_t models_size = file.GetSize() - sizeof(header);
+  if (header.magic != kCatalogMagic || header.version != kCatalogVersion ||
+      models_size != header.num_models * sizeof(BatModel) ||
+      header.models_checksum != Crc32(models, models_size)) {
+    throw runtime_error("The bat catalog " + path + " is corrupt!");
+  }
+
+  // Copy the models out, so the catalog outlives the mapping.
+  vector<BatModel> loaded(header.num_models);
+  if (models_size > 0) {
+    std::memcpy(loaded.data(), models, models_size);
+  }
+  return BatCatalog(loaded);
+}
+
+void BatCatalog::Save(const string& path) const {
+  size_t models_size = models_.size() * sizeof(BatModel);
+  CatalogHeader header;
+  header.magic = kCatalogMagic;
+  header.version = kCatalogVersion;
+  header.num_models = static_cast<uint32_t>(models_.size());
+  header.models_checksum = Crc32(models_.data(), models_size);
+
+  FILE* file = fopen(path.c_str(), "wb");
+  bool is_written =
+      file != nullptr && fwrite(&header, sizeof(header), 1, file) == 1 &&
+      (models_.empty() ||
+       fwrite(models_.data(), sizeof(BatModel), models_.size(), file) ==
+           models_.size());
+  if (file != nullptr && fclose(file) != 0) {
+    is_written = false;
+  }
+  if (!is_written) {
+    throw runtime_error("Could not write the bat catalog " + path);
+  }
+}
+
+size_t BatCatalog::GetNumModels() const {
+  return models_.size();
+}
+
+const BatModel& BatCatalog::GetModel(size_t index) const {
+  return models_[index];
+}
+
+const BatModel* BatCatalog::Find(const string& name) const {
+  for (const BatModel& model : models_) {
+    if (name == model.GetName()) {
+      return &model;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace home_run_derby
@@ -0,0 +1,82 @@
+#include "core/bat_predictor.h"
+
+#include <stdexcept>
+
+namespace home_run_derby {
+
+namespace {
+
+double SecondsBetween(BatPredictor::Clock::time_point start,
+                      BatPredictor::Clock::time_point end) {
+  return std::chrono::duration<double>(end - start).count();
+}
+
+}  // namespace
+
+BatPredictor::BatPredictor(float alpha, float beta, double horizon_seconds)
+    : alpha_(alpha),
+      beta_(beta),
+      horizon_seconds_(horizon_seconds),
+      has_samples_(false) {
+  if (!(alpha > 0 && alpha <= 1) || !(beta >= 0 && beta <= 1) ||
+      !(horizon_seconds >= 0)) {
+    throw std::invalid_argument("Bat prediction settings are out of range");
+  }
+}
+
+void BatPredictor::AddSample(const vec2& position, Clock::time_point time) {
+  double elapsed = has_samples_ ? SecondsBetween(last_sample_time_, time) : 0;
+  // After a pause longer than the horizon, the old velocity says nothing
+  // about the new movement, so start over from the sample.
+  if (!has_samples_ || elapsed > horizon_seconds_) {
+    position_ = position;
+    velocity_ = vec2(0, 0);
+  } else if (elapsed <= 0) {
+    // Samples at the same instant can only refine the position.
+    position_ += alpha_ * (position - position_);
+  } else {
+    float dt = static_cast<float>(elapsed);
+    vec2 predicted = position_ + velocity_ * dt;
+    vec2 residual = position - predicted;
+    position_ = predicted + alpha_ * residual;
+    velocity_ += (beta_ / dt) * residual;
+  }
+  last_sample_ = position;
+  last_sample_time_ = time;
+  has_samples_ = true;
+}
+
+void BatPredictor::Reset() {
+  position_ = vec2(0, 0);
+  velocity_ = vec2(0, 0);
+  last_sample_ = vec2(0, 0);
+  has_samples_ = false;
+}
+
+bool BatPredictor::HasSamples() const {
+  return has_samples_;
+}
+
+vec2 BatPredictor::Predict(Clock::time_point time) const {
+  if (!has_samples_) {
+    return position_;
+  }
+  double elapsed = SecondsBetween(last_sample_time_, time);
+  if (elapsed > horizon_seconds_) {
+    return last_sample_;
+  }
+  if (elapsed <= 0) {
+    return position_;
+  }
+  return position_ + velocity_ * static_cast<float>(elapsed);
+}
+
+const vec2& BatPredictor::GetPosition() const {
+  return position_;
+}
+
+const vec2& BatPredictor::GetVelocity() const {
+  return velocity_;
+}
+
+}  // namespace home_run_derby
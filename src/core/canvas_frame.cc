@@ -1,13 +1,19 @@
 #include "core/canvas_frame.h"
 
-#include "cinder/Rand.h"
-
 namespace home_run_derby {
 
-using ci::randFloat;
 using std::make_pair;
 using std::pair;
 
+namespace {
+
+// The sequence the canvas picks parts of its field from until it is seeded.
+const uint64_t kDefaultSeed = 2;
+// The layout of a canvas's own field.
+const uint64_t kFieldSeed = 3;
+
+}  // namespace
+
 CanvasFrame::CanvasFrame(float player_radius, float window_size,
                          float stretch_constant, float ground_height,
                          size_t num_stars, size_t num_dirt_particles,
@@ -16,35 +22,15 @@ CanvasFrame::CanvasFrame(float player_radius, float window_size,
       window_size_(window_size),
       stretch_constant_(stretch_constant),
       ground_height_(ground_height),
-      num_stars_(num_stars),
-      num_dirt_particles_(num_dirt_particles),
-      star_radius_(star_radius),
-      dirt_particle_radius_(dirt_particle_radius) {
+      field_(std::make_shared<BackgroundField>(
+          window_size, stretch_constant, num_stars, num_dirt_particles,
+          star_radius, dirt_particle_radius, kFieldSeed)),
+      random_(kDefaultSeed) {
   ResetState();
-  PopulateStars();
-  PopulateDirtParticles();
-}
-
-void CanvasFrame::PopulateStars() {
-  stars_.clear();
-  // Initialize the stars vector with random positions on the canvas.
-  for (size_t i = 0; i < num_stars_; ++i) {
-    stars_.emplace_back(vec2(randFloat(0, stretch_constant_ * window_size_),
-                             randFloat(0, window_size_)));
-  }
 }
 
-void CanvasFrame::PopulateDirtParticles() {
-  dirt_particles_.clear();
-  // Same thing as stars, except we are not randomizing the particle velocities.
-  for (size_t i = 0; i < num_dirt_particles_; ++i) {
-    dirt_particles_.emplace_back(
-        vec2(
-            randFloat(-dirt_particle_radius_,
-                      dirt_particle_radius_ + window_size_ * stretch_constant_),
-            window_size_ + randFloat(0, window_size_ / 2)),
-        false);
-  }
+void CanvasFrame::SetField(const shared_ptr<const BackgroundField>& field) {
+  field_ = field;
 }
 
 void CanvasFrame::CalculateCharacterHeadLocation(const vec2& offset) {
@@ -74,69 +60,41 @@ void CanvasFrame::CalculateDirtLocation(const vec2& offset) {
                 vec2(window_size_ * stretch_constant_, window_size_));
 }
 
-void CanvasFrame::UpdateStarPositions(const vec2& velocity) {
-  // Update the positions of all the stars, then reassign positions if particles
-  // are out of canvas.
-  for (Particle& star : stars_) {
-    star.UpdatePosition(velocity);
-
-    if (velocity.x > 0 && star.GetPosition().x >
-                              window_size_ * stretch_constant_ + star_radius_) {
-      star.SetPosition(
-          vec2(-star_radius_, randFloat(0, window_size_ + star_radius_)));
-    }
-
-    if (velocity.x < 0 && star.GetPosition().x < -star_radius_) {
-      star.SetPosition(vec2(window_size_ * stretch_constant_ + star_radius_,
-                            randFloat(0, window_size_ + star_radius_)));
-    }
-
-    if (velocity.y > 0 && star.GetPosition().y > window_size_ + star_radius_) {
-      star.SetPosition(
-          vec2(randFloat(0, window_size_ * stretch_constant_ + star_radius_),
-               -star_radius_));
-    }
-
-    if (velocity.y < 0 && star.GetPosition().y < -star_radius_) {
-      star.SetPosition(
-          vec2(randFloat(0, window_size_ * stretch_constant_ + star_radius_),
-               window_size_ + star_radius_));
-    }
-  }
-}
-
-void CanvasFrame::UpdateDirtParticlePositions(const vec2& velocity) {
-  for (Particle& dirt_particle : dirt_particles_) {
-    // To avoid drifting, stop updating the y after the y velocity is below a
-    // certain threshold.
-    dirt_particle.UpdatePosition(
-        vec2(velocity.x,
-             abs(velocity.y) < kVelocityConsideredStopped ? 0 : velocity.y));
-
-    // Handle wrapping around.
-    if (dirt_particle.GetPosition().x >
-        window_size_ * stretch_constant_ + dirt_particle_radius_) {
-      dirt_particle.SetPosition(
-          vec2(-dirt_particle_radius_,
-               window_size_ + randFloat(0, window_size_ / 2) + offset_.y));
-    }
-  }
-}
-
-void CanvasFrame::UpdateCanvas(const vec2& offset, const vec2& velocity) {
+void CanvasFrame::UpdateCanvas(const vec2& offset) {
   offset_ = offset;
   CalculateCharacterHeadLocation(offset);
   CalculateCharacterBodyLocation(offset);
   CalculateGroundLocation(offset);
   CalculateDirtLocation(offset);
-  UpdateStarPositions(velocity);
-  UpdateDirtParticlePositions(velocity);
 }
 
 void CanvasFrame::ResetState() {
-  UpdateCanvas(vec2(0, 0), vec2(0, 0));
-  PopulateStars();
-  PopulateDirtParticles();
+  // Every pitch looks at a different part of the field.
+  field_origin_ = vec2(random_.NextFloat(0, stretch_constant_ * window_size_),
+                       random_.NextFloat(0, window_size_));
+  UpdateCanvas(vec2(0, 0));
+}
+
+void CanvasFrame::Seed(uint64_t seed) {
+  random_.Seed(seed);
+}
+
+void CanvasFrame::SaveState(CanvasState* state) const {
+  state->offset = offset_;
+  state->field_origin = field_origin_;
+  state->random = random_;
+}
+
+void CanvasFrame::RestoreState(const CanvasState& state) {
+  field_origin_ = state.field_origin;
+  random_ = state.random;
+
+  // Everything else on the canvas follows from the offset.
+  offset_ = state.offset;
+  CalculateCharacterHeadLocation(offset_);
+  CalculateCharacterBodyLocation(offset_);
+  CalculateGroundLocation(offset_);
+  CalculateDirtLocation(offset_);
 }
 
 const vec2& CanvasFrame::GetPlayerHeadLocation() const {
@@ -155,12 +113,26 @@ const pair<vec2, vec2>& CanvasFrame::GetDirtLocation() const {
   return dirt_location_;
 }
 
-const vector<Particle>& CanvasFrame::GetStars() const {
-  return stars_;
+const shared_ptr<const BackgroundField>& CanvasFrame::GetField() const {
+  return field_;
+}
+
+size_t CanvasFrame::GetNumStars() const {
+  return field_ != nullptr ? field_->GetNumStars() : 0;
+}
+
+vec2 CanvasFrame::GetStarPosition(size_t index) const {
+  return field_->GetStarPosition(index, field_origin_ + offset_);
+}
+
+size_t CanvasFrame::GetNumDirtParticles() const {
+  return field_ != nullptr ? field_->GetNumDirtParticles() : 0;
 }
 
-const vector<Particle>& CanvasFrame::GetDirtParticles() const {
-  return dirt_particles_;
+vec2 CanvasFrame::GetDirtParticlePosition(size_t index) const {
+  // Dirt stays in the ground, so only the field's horizontal origin applies.
+  return field_->GetDirtParticlePosition(index,
+                                         vec2(field_origin_.x, 0) + offset_);
 }
 
 const vec2& CanvasFrame::GetOffset() const {
@@ -0,0 +1,36 @@
+#include "core/checksum.h"
+
+namespace home_run_derby {
+
+namespace {
+
+// The reflected CRC-32 polynomial used by zlib and PNG.
+const uint32_t kCrc32Polynomial = 0xEDB88320u;
+
+struct Crc32Table {
+  uint32_t entries[256];
+
+  Crc32Table() {
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t entry = i;
+      for (int bit = 0; bit < 8; ++bit) {
+        entry = (entry & 1) ? (entry >> 1) ^ kCrc32Polynomial : entry >> 1;
+      }
+      entries[i] = entry;
+    }
+  }
+};
+
+}  // namespace
+
+uint32_t Crc32(const void* data, size_t size, uint32_t crc) {
+  static const Crc32Table table;
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  crc = ~crc;
+  for (size_t i = 0; i < size; ++i) {
+    crc = table.entries[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+}  // namespace home_run_derby
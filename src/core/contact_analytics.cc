@@ -0,0 +1,159 @@
+#include "core/contact_analytics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace home_run_derby {
+
+namespace {
+
+/**
+ * Finds the cell a distance falls in, counting anything past the last cell
+ * in it.
+ */
+size_t GetCell(float distance, float cell_size, size_t num_cells) {
+  if (!(distance > 0)) {
+    return 0;
+  }
+  return std::min(static_cast<size_t>(distance / cell_size), num_cells - 1);
+}
+
+void AddToSummary(const ContactEvent& contact, float hard_hit_speed,
+                  ContactSummary* summary) {
+  ++summary->num_contacts;
+  if (std::abs(contact.contact_offset) <= ContactAnalytics::kSweetSpotOffset) {
+    ++summary->num_sweet_spot;
+  }
+  if (contact.exit_speed >= hard_hit_speed) {
+    ++summary->num_hard_hit;
+  }
+  summary->max_exit_speed =
+      std::max(summary->max_exit_speed, contact.exit_speed);
+  summary->exit_speed_sum += contact.exit_speed;
+  summary->launch_angle_sum += contact.launch_angle_degrees;
+  summary->bat_speed_sum += contact.bat_speed;
+}
+
+}  // namespace
+
+const float ContactAnalytics::kSweetSpotOffset = 0.2f;
+const size_t ContactAnalytics::kMaxLoggedContacts;
+
+SprayChart::SprayChart(float cell_size, size_t num_columns, size_t num_rows)
+    : cell_size_(cell_size),
+      num_columns_(num_columns),
+      num_rows_(num_rows),
+      counts_(num_columns * num_rows, 0),
+      exit_speed_sums_(num_columns * num_rows, 0) {
+  if (!(cell_size > 0) || num_columns == 0 || num_rows == 0) {
+    throw std::invalid_argument("A spray chart needs at least one cell");
+  }
+}
+
+void SprayChart::Add(const ContactEvent& contact) {
+  size_t cell =
+      GetCell(contact.apex_height, cell_size_, num_rows_) * num_columns_ +
+      GetCell(contact.carry, cell_size_, num_columns_);
+  ++counts_[cell];
+  exit_speed_sums_[cell] += contact.exit_speed;
+}
+
+void SprayChart::Clear() {
+  std::fill(counts_.begin(), counts_.end(), 0);
+  std::fill(exit_speed_sums_.begin(), exit_speed_sums_.end(), 0.0f);
+}
+
+uint64_t SprayChart::GetCount(size_t column, size_t row) const {
+  return counts_[row * num_columns_ + column];
+}
+
+float SprayChart::GetMeanExitSpeed(size_t column, size_t row) const {
+  size_t cell = row * num_columns_ + column;
+  return counts_[cell] > 0 ? exit_speed_sums_[cell] / counts_[cell] : 0;
+}
+
+float SprayChart::GetCellSize() const {
+  return cell_size_;
+}
+
+size_t SprayChart::GetNumColumns() const {
+  return num_columns_;
+}
+
+size_t SprayChart::GetNumRows() const {
+  return num_rows_;
+}
+
+ContactAnalytics::ContactAnalytics(const SprayChart& chart,
+                                   float hard_hit_speed)
+    : hard_hit_speed_(hard_hit_speed),
+      chart_(chart),
+      session_summary_(),
+      total_summary_(),
+      log_(kMaxLoggedContacts),
+      num_sessions_(1) {
+}
+
+void ContactAnalytics::BeginSession() {
+  // A game without contacts is not worth a row of its own.
+  if (session_summary_.num_contacts > 0) {
+    ++num_sessions_;
+  }
+  session_summary_ = ContactSummary();
+}
+
+void ContactAnalytics::Record(const ContactEvent& contact) {
+  LoggedContact& entry = log_[GetNumContacts() % kMaxLoggedContacts];
+  entry.contact = contact;
+  entry.session = num_sessions_ - 1;
+  chart_.Add(contact);
+  AddToSummary(contact, hard_hit_speed_, &session_summary_);
+  AddToSummary(contact, hard_hit_speed_, &total_summary_);
+}
+
+size_t ContactAnalytics::GetNumContacts() const {
+  return static_cast<size_t>(total_summary_.num_contacts);
+}
+
+size_t ContactAnalytics::GetNumLoggedContacts() const {
+  return std::min(GetNumContacts(), kMaxLoggedContacts);
+}
+
+const ContactEvent& ContactAnalytics::GetLastContact() const {
+  return log_[(GetNumContacts() - 1) % kMaxLoggedContacts].contact;
+}
+
+const ContactSummary& ContactAnalytics::GetSessionSummary() const {
+  return session_summary_;
+}
+
+const ContactSummary& ContactAnalytics::GetTotalSummary() const {
+  return total_summary_;
+}
+
+const SprayChart& ContactAnalytics::GetSprayChart() const {
+  return chart_;
+}
+
+size_t ContactAnalytics::GetNumSessions() const {
+  return num_sessions_;
+}
+
+void ContactAnalytics::ExportCsv(std::ostream& output) const {
+  output << "game,x,y,exit_speed,launch_angle_degrees,contact_offset,"
+            "bat_speed,carry,apex_height\n";
+  size_t num_contacts = GetNumContacts();
+  for (size_t i = num_contacts - GetNumLoggedContacts(); i < num_contacts;
+       ++i) {
+    const LoggedContact& entry = log_[i % kMaxLoggedContacts];
+    const ContactEvent& contact = entry.contact;
+    output << entry.session << ',' << contact.position.x << ','
+           << contact.position.y << ',' << contact.exit_speed << ','
+           << contact.launch_angle_degrees << ',' << contact.contact_offset
+           << ',' << contact.bat_speed << ',' << contact.carry << ','
+           << contact.apex_height << '\n';
+  }
+}
+
+}  // namespace home_run_derby
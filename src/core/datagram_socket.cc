@@ -0,0 +1,180 @@
+#include "core/datagram_socket.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace home_run_derby {
+
+using std::runtime_error;
+
+namespace {
+
+#ifdef _WIN32
+
+typedef SOCKET NativeSocket;
+typedef int AddressLength;
+const intptr_t kNoSocket = static_cast<intptr_t>(INVALID_SOCKET);
+
+void StartSockets() {
+  // Winsock has to be started once per process before any socket is made.
+  static const bool is_started = [] {
+    WSADATA data;
+    return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+  }();
+  if (!is_started) {
+    throw runtime_error("Could not start Winsock");
+  }
+}
+
+void CloseNativeSocket(NativeSocket socket) {
+  closesocket(socket);
+}
+
+bool SetNonBlocking(NativeSocket socket) {
+  u_long is_non_blocking = 1;
+  return ioctlsocket(socket, FIONBIO, &is_non_blocking) == 0;
+}
+
+#else
+
+typedef int NativeSocket;
+typedef socklen_t AddressLength;
+const intptr_t kNoSocket = -1;
+
+void StartSockets() {
+}
+
+void CloseNativeSocket(NativeSocket socket) {
+  close(socket);
+}
+
+bool SetNonBlocking(NativeSocket socket) {
+  int flags = fcntl(socket, F_GETFL, 0);
+  return flags >= 0 && fcntl(socket, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+#endif
+
+NativeSocket ToNative(intptr_t handle) {
+  return static_cast<NativeSocket>(handle);
+}
+
+sockaddr_in ToNative(const SocketAddress& address) {
+  sockaddr_in native;
+  std::memset(&native, 0, sizeof(native));
+  native.sin_family = AF_INET;
+  native.sin_addr.s_addr = htonl(address.host);
+  native.sin_port = htons(address.port);
+  return native;
+}
+
+}  // namespace
+
+bool SocketAddress::operator==(const SocketAddress& other) const {
+  return host == other.host && port == other.port;
+}
+
+SocketAddress MakeLoopbackAddress(uint16_t port) {
+  SocketAddress address = {INADDR_LOOPBACK, port};
+  return address;
+}
+
+DatagramSocket::DatagramSocket() : handle_(kNoSocket), port_(0) {
+}
+
+DatagramSocket::~DatagramSocket() {
+  Close();
+}
+
+void DatagramSocket::Open(uint16_t port) {
+  Close();
+  StartSockets();
+  NativeSocket native = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+  if (static_cast<intptr_t>(native) == kNoSocket) {
+    throw runtime_error("Could not create a socket");
+  }
+  handle_ = static_cast<intptr_t>(native);
+
+  sockaddr_in address = ToNative(MakeLoopbackAddress(port));
+  AddressLength length = sizeof(address);
+  if (bind(native, reinterpret_cast<sockaddr*>(&address), length) != 0 ||
+      getsockname(native, reinterpret_cast<sockaddr*>(&address), &length) !=
+          0 ||
+      !SetNonBlocking(native)) {
+    Close();
+    throw runtime_error("Could not bind a socket to port " +
+                        std::to_string(port));
+  }
+  port_ = ntohs(address.sin_port);
+}
+
+void DatagramSocket::Close() {
+  if (handle_ != kNoSocket) {
+    CloseNativeSocket(ToNative(handle_));
+    handle_ = kNoSocket;
+    port_ = 0;
+  }
+}
+
+bool DatagramSocket::IsOpen() const {
+  return handle_ != kNoSocket;
+}
+
+uint16_t DatagramSocket::GetPort() const {
+  return port_;
+}
+
+bool DatagramSocket::SendTo(const SocketAddress& address, const uint8_t* data,
+                            size_t size) {
+  sockaddr_in native = ToNative(address);
+  int sent = static_cast<int>(
+      sendto(ToNative(handle_), reinterpret_cast<const char*>(data),
+             static_cast<int>(size), 0,
+             reinterpret_cast<const sockaddr*>(&native), sizeof(native)));
+  return sent == static_cast<int>(size);
+}
+
+size_t DatagramSocket::Receive(uint8_t* buffer, size_t capacity,
+                               SocketAddress* sender) {
+  sockaddr_in native;
+  AddressLength length = sizeof(native);
+  int size = static_cast<int>(
+      recvfrom(ToNative(handle_), reinterpret_cast<char*>(buffer),
+               static_cast<int>(capacity), 0,
+               reinterpret_cast<sockaddr*>(&native), &length));
+  // A failed receive, most often because nothing is waiting, or one from
+  // something other than IPv4 is treated as nothing received.
+  if (size <= 0 || native.sin_family != AF_INET) {
+    return 0;
+  }
+  sender->host = ntohl(native.sin_addr.s_addr);
+  sender->port = ntohs(native.sin_port);
+  return static_cast<size_t>(size);
+}
+
+bool DatagramSocket::Wait(int timeout_milliseconds) {
+  NativeSocket native = ToNative(handle_);
+  fd_set readable;
+  FD_ZERO(&readable);
+  FD_SET(native, &readable);
+  timeval timeout;
+  timeout.tv_sec = timeout_milliseconds / 1000;
+  timeout.tv_usec = (timeout_milliseconds % 1000) * 1000;
+  return select(static_cast<int>(native) + 1, &readable, nullptr, nullptr,
+                &timeout) > 0;
+}
+
+}  // namespace home_run_derby
@@ -0,0 +1,123 @@
+#include "core/distance_surrogate.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "core/surrogate_coefficients.h"
+
+namespace home_run_derby {
+
+namespace {
+
+// Scales the speeds to around 1, so the fit stays well conditioned.
+const float kSpeedScale = 50;
+
+/**
+ * Gets the y-speed a ball first lands with, which is the same as it would
+ * take to throw the ball straight up to the top of its arc.
+ */
+inline float GetLandingSpeed(float height, float speed_y, float gravity) {
+  return std::sqrt(speed_y * speed_y + 2 * gravity * std::max(height, 0.0f));
+}
+
+/**
+ * Evaluates every monomial of degree 3 or less in three variables.
+ */
+inline void EvaluateMonomials(float a, float b, float c, float* terms) {
+  terms[0] = 1;
+  terms[1] = a;
+  terms[2] = b;
+  terms[3] = c;
+  terms[4] = a * a;
+  terms[5] = a * b;
+  terms[6] = a * c;
+  terms[7] = b * b;
+  terms[8] = b * c;
+  terms[9] = c * c;
+  terms[10] = a * a * a;
+  terms[11] = a * a * b;
+  terms[12] = a * a * c;
+  terms[13] = a * b * b;
+  terms[14] = a * b * c;
+  terms[15] = a * c * c;
+  terms[16] = b * b * b;
+  terms[17] = b * b * c;
+  terms[18] = b * c * c;
+  terms[19] = c * c * c;
+}
+
+}  // namespace
+
+DistanceSurrogate::DistanceSurrogate(float ground_location, float ball_radius,
+                                     float gravity)
+    : DistanceSurrogate(ground_location, ball_radius, gravity,
+                        kSurrogateMeanCoefficients,
+                        kSurrogateErrorCoefficients) {
+}
+
+DistanceSurrogate::DistanceSurrogate(float ground_location, float ball_radius,
+                                     float gravity,
+                                     const float* mean_coefficients,
+                                     const float* error_coefficients)
+    : ground_location_(ground_location),
+      ball_radius_(ball_radius),
+      gravity_(gravity) {
+  std::copy(mean_coefficients, mean_coefficients + kNumTerms,
+            mean_coefficients_);
+  std::copy(error_coefficients, error_coefficients + kNumTerms,
+            error_coefficients_);
+}
+
+float DistanceSurrogate::PredictDistance(const Ball& ball,
+                                         float* error) const {
+  float distance;
+  float distance_error;
+  PredictDistances(&ball.GetPosition().x, &ball.GetPosition().y,
+                   &ball.GetSpeed().x, &ball.GetSpeed().y, 1, &distance,
+                   &distance_error);
+  if (error != nullptr) {
+    *error = distance_error;
+  }
+  return distance;
+}
+
+void DistanceSurrogate::PredictDistances(const float* positions_x,
+                                         const float* positions_y,
+                                         const float* speeds_x,
+                                         const float* speeds_y, size_t count,
+                                         float* distances,
+                                         float* errors) const {
+  for (size_t i = 0; i < count; ++i) {
+    // A ball heading right is never hit past the left edge. The selects below
+    // compile to blends rather than branches.
+    float speed = std::max(-speeds_x[i], 0.0f);
+    float height = ground_location_ - ball_radius_ - positions_y[i];
+    float terms[kNumTerms];
+    EvaluateMonomials(
+        speeds_y[i] / kSpeedScale,
+        GetLandingSpeed(height, speeds_y[i], gravity_) / kSpeedScale,
+        speed / kSpeedScale, terms);
+
+    float travel_per_speed = 0;
+    float error_per_speed = 0;
+    for (size_t j = 0; j < kNumTerms; ++j) {
+      travel_per_speed += mean_coefficients_[j] * terms[j];
+      error_per_speed += error_coefficients_[j] * terms[j];
+    }
+    distances[i] = speed > 0
+                       ? std::max(speed * travel_per_speed - positions_x[i],
+                                  0.0f)
+                       : 0.0f;
+    errors[i] = speed * std::abs(error_per_speed);
+  }
+}
+
+void DistanceSurrogate::ComputeTerms(float height, const vec2& exit_velocity,
+                                     float gravity, float* terms) {
+  EvaluateMonomials(
+      exit_velocity.y / kSpeedScale,
+      GetLandingSpeed(height, exit_velocity.y, gravity) / kSpeedScale,
+      std::max(-exit_velocity.x, 0.0f) / kSpeedScale, terms);
+}
+
+}  // namespace home_run_derby
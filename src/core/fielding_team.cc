@@ -0,0 +1,131 @@
+#include "core/fielding_team.h"
+
+#include <algorithm>
+
+#include "core/flight.h"
+
+namespace home_run_derby {
+
+using glm::length;
+
+FieldingTeam::FieldingTeam(size_t num_fielders,
+                           const FieldingSettings& settings)
+    : settings_(settings),
+      grid_(std::max(settings.catch_radius, settings.separation),
+            2 * num_fielders),
+      is_chasing_(num_fielders, false),
+      has_ball_landed_(false),
+      has_caught_(false) {
+  home_positions_.reserve(num_fielders);
+  for (size_t i = 0; i < num_fielders; ++i) {
+    float fraction =
+        (static_cast<float>(i) + 0.5f) / static_cast<float>(num_fielders);
+    home_positions_.push_back(
+        vec2(settings_.outfield_start_x +
+                 fraction *
+                     (settings_.outfield_end_x - settings_.outfield_start_x),
+             settings_.ground_location));
+    grid_.Insert(home_positions_.back());
+  }
+  nearby_fielders_.reserve(num_fielders);
+}
+
+void FieldingTeam::ResetPositions() {
+  for (size_t i = 0; i < home_positions_.size(); ++i) {
+    grid_.Move(i, home_positions_[i]);
+    is_chasing_[i] = false;
+  }
+  has_ball_landed_ = false;
+  has_caught_ = false;
+}
+
+void FieldingTeam::Update(const Ball& ball) {
+  // Nobody moves until the ball is in play.
+  if (!ball.HasCollided()) {
+    return;
+  }
+  if (ball.GetPosition().y + ball.GetRadius() >= settings_.ground_location) {
+    has_ball_landed_ = true;
+  }
+  bool is_catchable = !has_caught_ && !has_ball_landed_;
+
+  // Read the trajectory once for the whole team, then send only the fielders
+  // who could reach the landing spot in time.
+  Landing landing;
+  std::fill(is_chasing_.begin(), is_chasing_.end(), false);
+  vec2 landing_spot;
+  if (is_catchable && PredictLanding(ball, settings_.ground_location,
+                                     settings_.gravity, &landing)) {
+    landing_spot = vec2(landing.position.x, settings_.ground_location);
+    grid_.Query(landing_spot,
+                settings_.max_speed * landing.ticks + settings_.catch_radius,
+                &nearby_fielders_);
+    for (size_t fielder : nearby_fielders_) {
+      is_chasing_[fielder] = true;
+    }
+  }
+  for (size_t i = 0; i < home_positions_.size(); ++i) {
+    RunTowards(i, is_chasing_[i] ? landing_spot : home_positions_[i]);
+  }
+  SeparateFielders();
+
+  // A fielder catches the ball if it comes within reach before it lands.
+  if (is_catchable && ball.GetPosition().y + ball.GetRadius() >=
+                          settings_.ground_location - settings_.catch_height) {
+    grid_.Query(vec2(ball.GetPosition().x, settings_.ground_location),
+                settings_.catch_radius, &nearby_fielders_);
+    has_caught_ = !nearby_fielders_.empty();
+  }
+}
+
+bool FieldingTeam::HasCaught() const {
+  return has_caught_;
+}
+
+size_t FieldingTeam::GetNumFielders() const {
+  return home_positions_.size();
+}
+
+const vec2& FieldingTeam::GetFielderPosition(size_t fielder) const {
+  return grid_.GetPosition(fielder);
+}
+
+bool FieldingTeam::IsChasing(size_t fielder) const {
+  return is_chasing_[fielder];
+}
+
+void FieldingTeam::RunTowards(size_t fielder, const vec2& target) {
+  const vec2& position = grid_.GetPosition(fielder);
+  vec2 to_target = target - position;
+  float distance = length(to_target);
+  if (distance <= settings_.max_speed) {
+    grid_.Move(fielder, target);
+  } else {
+    grid_.Move(fielder,
+               position + to_target * (settings_.max_speed / distance));
+  }
+}
+
+void FieldingTeam::SeparateFielders() {
+  for (size_t i = 0; i < home_positions_.size(); ++i) {
+    grid_.Query(grid_.GetPosition(i), settings_.separation, &nearby_fielders_);
+    for (size_t other : nearby_fielders_) {
+      // Each pair is only pushed apart once.
+      if (other <= i) {
+        continue;
+      }
+      vec2 offset = grid_.GetPosition(other) - grid_.GetPosition(i);
+      float distance = length(offset);
+      if (distance >= settings_.separation) {
+        continue;
+      }
+      // Fielders on the same spot split along the ground.
+      vec2 direction = distance > 0 ? offset / distance : vec2(1, 0);
+      vec2 push = direction * ((settings_.separation - distance) / 2);
+      grid_.Move(i, grid_.GetPosition(i) - push);
+      grid_.Move(other, grid_.GetPosition(other) + push);
+    }
+  }
+}
+
+}  // namespace home_run_derby
@@ -0,0 +1,66 @@
+#include "core/flight.h"
+
+#include <cmath>
+
+namespace home_run_derby {
+
+namespace {
+
+/**
+ * Plays a ball out until it stops or runs out of ticks.
+ */
+Ball FlyOut(Ball ball, const FlightLimits& limits) {
+  for (size_t tick = 0; tick < limits.max_ticks; ++tick) {
+    if (std::abs(ball.GetSpeed().x) <= limits.stopped_speed) {
+      break;
+    }
+    ball.UpdateStates();
+  }
+  return ball;
+}
+
+}  // namespace
+
+bool PredictLanding(const Ball& ball, float ground_location, float gravity,
+                    Landing* landing) {
+  // The ball moves by its speed before gravity is added, so after n ticks it
+  // has fallen n * speed + gravity * n * (n - 1) / 2.
+  float drop = ground_location - ball.GetRadius() - ball.GetPosition().y;
+  if (drop < 0) {
+    return false;
+  }
+  float speed_y = ball.GetSpeed().y;
+  float a = gravity / 2;
+  float b = speed_y - gravity / 2;
+  float ticks;
+  if (a > 0) {
+    ticks = (-b + std::sqrt(b * b + 4 * a * drop)) / (2 * a);
+  } else if (b > 0) {
+    ticks = drop / b;
+  } else {
+    return false;
+  }
+  landing->position = ball.GetPosition() + ticks * vec2(ball.GetSpeed().x, 0);
+  landing->position.y = ground_location - ball.GetRadius();
+  landing->ticks = ticks;
+  return true;
+}
+
+float SimulateTravel(const Ball& ball, const FlightLimits& limits) {
+  // Neither the ground nor gravity changes the direction of the x-speed, and a
+  // ball heading right leaves play before any stadium wall could turn it, so
+  // it can never be hit past the left edge.
+  if (!ball.HasCollided() || ball.GetSpeed().x >= 0) {
+    return 0;
+  }
+  return ball.GetPosition().x - FlyOut(ball, limits).GetPosition().x;
+}
+
+float SimulateFlight(const Ball& ball, const FlightLimits& limits) {
+  if (!ball.HasCollided() || ball.GetSpeed().x >= 0) {
+    return 0;
+  }
+  return FlyOut(ball, limits).GetHomeRunDistance();
+}
+
+}  // namespace home_run_derby
@@ -0,0 +1,27 @@
+#include "core/formatted_text.h"
+
+#include <cstdarg>
+#include <cstdio>
+
+namespace home_run_derby {
+
+FormattedText::FormattedText() : buffer_() {
+  text_.reserve(kMaxLength);
+}
+
+const string& FormattedText::Format(const char* format, ...) {
+  // Format into the fixed buffer first; assigning to a string that already
+  // has enough capacity reuses its storage.
+  va_list arguments;
+  va_start(arguments, format);
+  vsnprintf(buffer_, kMaxLength, format, arguments);
+  va_end(arguments);
+  text_.assign(buffer_);
+  return text_;
+}
+
+const string& FormattedText::GetText() const {
+  return text_;
+}
+
+}  // namespace home_run_derby
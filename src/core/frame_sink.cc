@@ -0,0 +1,153 @@
+#include "core/frame_sink.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+namespace home_run_derby {
+
+using std::invalid_argument;
+using std::runtime_error;
+
+namespace {
+
+/** The number of digits in the frame number of a PPM file's path. **/
+const int kFrameNumberDigits = 6;
+
+uint32_t GetChannel(uint32_t pixel, size_t channel) {
+  return (pixel >> (8 * channel)) & 0xFF;
+}
+
+/**
+ * Converts to a luma or chroma byte with weights in 65536ths, offset and
+ * rounded.
+ */
+uint8_t ToByte(int32_t red_weight, int32_t green_weight, int32_t blue_weight,
+               uint32_t red, uint32_t green, uint32_t blue, int32_t offset) {
+  int32_t value = red_weight * static_cast<int32_t>(red) +
+                  green_weight * static_cast<int32_t>(green) +
+                  blue_weight * static_cast<int32_t>(blue) + (offset << 16) +
+                  (1 << 15);
+  return static_cast<uint8_t>(std::min(255, std::max(0, value >> 16)));
+}
+
+}  // namespace
+
+PpmSequenceWriter::PpmSequenceWriter(const string& path_prefix)
+    : path_prefix_(path_prefix), num_frames_(0) {}
+
+void PpmSequenceWriter::WriteFrame(const RasterImage& image) {
+  string path = GetNextPath();
+  std::ofstream output(path, std::ios::binary);
+  if (!output) {
+    throw runtime_error("Could not open the frame " + path);
+  }
+  output << "P6\n" << image.GetWidth() << ' ' << image.GetHeight()
+         << "\n255\n";
+  row_.resize(3 * image.GetWidth());
+  for (size_t y = 0; y < image.GetHeight(); ++y) {
+    const uint32_t* pixels = image.GetRow(y);
+    for (size_t x = 0; x < image.GetWidth(); ++x) {
+      for (size_t channel = 0; channel < 3; ++channel) {
+        row_[3 * x + channel] =
+            static_cast<uint8_t>(GetChannel(pixels[x], channel));
+      }
+    }
+    output.write(reinterpret_cast<const char*>(row_.data()),
+                 static_cast<std::streamsize>(row_.size()));
+  }
+  if (!output) {
+    throw runtime_error("Could not write the frame " + path);
+  }
+  ++num_frames_;
+}
+
+string PpmSequenceWriter::GetNextPath() const {
+  char number[32];
+  std::snprintf(number, sizeof(number), "%0*zu", kFrameNumberDigits,
+                num_frames_);
+  return path_prefix_ + number + ".ppm";
+}
+
+size_t PpmSequenceWriter::GetNumFrames() const {
+  return num_frames_;
+}
+
+Y4mWriter::Y4mWriter(std::ostream& output, size_t frame_rate)
+    : output_(output),
+      frame_rate_(frame_rate),
+      width_(0),
+      height_(0),
+      num_frames_(0) {
+  if (frame_rate_ == 0) {
+    throw invalid_argument("A video needs a positive frame rate");
+  }
+}
+
+void Y4mWriter::WriteFrame(const RasterImage& image) {
+  if (num_frames_ == 0) {
+    width_ = image.GetWidth();
+    height_ = image.GetHeight();
+    output_ << "YUV4MPEG2 W" << width_ << " H" << height_ << " F"
+            << frame_rate_ << ":1 Ip A1:1 C420jpeg XCOLORRANGE=FULL\n";
+    luma_.resize(width_ * height_);
+    // Odd sizes get a chroma sample for their last, half covered, block.
+    size_t chroma_size = ((width_ + 1) / 2) * ((height_ + 1) / 2);
+    blue_chroma_.resize(chroma_size);
+    red_chroma_.resize(chroma_size);
+  } else if (image.GetWidth() != width_ || image.GetHeight() != height_) {
+    throw invalid_argument("Every frame of a video must be the same size");
+  }
+
+  // Each pair of rows makes a row of chroma. An odd last row or column is
+  // paired with itself, which averages the same as leaving it alone.
+  size_t chroma_width = (width_ + 1) / 2;
+  for (size_t y = 0; y < height_; y += 2) {
+    const uint32_t* rows[2] = {image.GetRow(y),
+                               image.GetRow(std::min(y + 1, height_ - 1))};
+    for (size_t row = 0; row < 2 && y + row < height_; ++row) {
+      uint8_t* luma = luma_.data() + (y + row) * width_;
+      for (size_t x = 0; x < width_; ++x) {
+        // The weights add up to one, so luma never needs clamping.
+        uint32_t pixel = rows[row][x];
+        luma[x] = static_cast<uint8_t>(
+            (19595 * GetChannel(pixel, 0) + 38470 * GetChannel(pixel, 1) +
+             7471 * GetChannel(pixel, 2) + (1 << 15)) >>
+            16);
+      }
+    }
+    size_t chroma_row = (y / 2) * chroma_width;
+    for (size_t x = 0; x < width_; x += 2) {
+      size_t next_x = std::min(x + 1, width_ - 1);
+      uint32_t means[3];
+      for (size_t channel = 0; channel < 3; ++channel) {
+        means[channel] = (GetChannel(rows[0][x], channel) +
+                          GetChannel(rows[0][next_x], channel) +
+                          GetChannel(rows[1][x], channel) +
+                          GetChannel(rows[1][next_x], channel) + 2) >>
+                         2;
+      }
+      blue_chroma_[chroma_row + x / 2] =
+          ToByte(-11059, -21709, 32768, means[0], means[1], means[2], 128);
+      red_chroma_[chroma_row + x / 2] =
+          ToByte(32768, -27439, -5329, means[0], means[1], means[2], 128);
+    }
+  }
+
+  output_ << "FRAME\n";
+  for (const vector<uint8_t>* plane : {&luma_, &blue_chroma_, &red_chroma_}) {
+    output_.write(reinterpret_cast<const char*>(plane->data()),
+                  static_cast<std::streamsize>(plane->size()));
+  }
+  if (!output_) {
+    throw runtime_error("Could not write the video");
+  }
+  ++num_frames_;
+}
+
+size_t Y4mWriter::GetNumFrames() const {
+  return num_frames_;
+}
+
+}  // namespace home_run_derby
@@ -0,0 +1,54 @@
+#include "core/hit_statistics.h"
+
+namespace home_run_derby {
+
+namespace {
+
+const char* const kMeasureNames[] = {"distance (px)", "exit speed (px/tick)",
+                                     "launch angle (degrees)",
+                                     "flight time (ticks)"};
+
+}  // namespace
+
+const double HitStatistics::kRelativeAccuracy = 0.01;
+
+HitStatistics::HitStatistics()
+    : sketches_(kNumHitMeasures, QuantileSketch(kRelativeAccuracy)) {
+}
+
+void HitStatistics::Record(const HitOutcome& hit) {
+  sketches_[kHitDistance].Add(hit.distance);
+  sketches_[kExitSpeed].Add(hit.exit_speed);
+  sketches_[kLaunchAngle].Add(hit.launch_angle_degrees);
+  sketches_[kFlightTime].Add(hit.flight_ticks);
+}
+
+void HitStatistics::Merge(const HitStatistics& other) {
+  for (size_t measure = 0; measure < kNumHitMeasures; ++measure) {
+    sketches_[measure].Merge(other.sketches_[measure]);
+  }
+}
+
+uint64_t HitStatistics::GetNumHits() const {
+  return sketches_[kHitDistance].GetCount();
+}
+
+const QuantileSketch& HitStatistics::GetSketch(HitMeasure measure) const {
+  return sketches_[measure];
+}
+
+void HitStatistics::Report(std::ostream& output) const {
+  output << "Hits: " << GetNumHits() << '\n';
+  if (GetNumHits() == 0) {
+    return;
+  }
+  for (size_t measure = 0; measure < kNumHitMeasures; ++measure) {
+    const QuantileSketch& sketch = sketches_[measure];
+    output << "  " << kMeasureNames[measure] << ": median "
+           << sketch.EstimateQuantile(0.5) << ", p99 "
+           << sketch.EstimateQuantile(0.99) << ", max " << sketch.GetMax()
+           << '\n';
+  }
+}
+
+}  // namespace home_run_derby
@@ -0,0 +1,94 @@
+#include "core/input_latency_tracker.h"
+
+namespace home_run_derby {
+
+namespace {
+
+const char* const kStageNames[] = {"bat updated", "simulated", "contact",
+                                   "presented"};
+
+}  // namespace
+
+// Fine enough below a frame to tell one frame of lag from two.
+const vector<double> InputLatencyTracker::kLatencyBuckets = {
+    0.0001, 0.00025, 0.0005, 0.001, 0.002, 0.004, 0.007, 0.01,
+    0.014,  0.02,    0.03,   0.05,  0.075, 0.1,   0.2,   0.5};
+
+InputLatencyTracker::InputLatencyTracker() {
+  BeginSession();
+}
+
+void InputLatencyTracker::BeginSession() {
+  for (unique_ptr<Histogram>& latencies : latencies_) {
+    latencies.reset(new Histogram(kLatencyBuckets));
+  }
+  has_new_input_ = false;
+  has_bat_input_ = false;
+  has_simulated_bat_input_ = false;
+  has_contact_input_ = false;
+}
+
+void InputLatencyTracker::OnInput(Clock::time_point now) {
+  new_input_ = now;
+  has_new_input_ = true;
+}
+
+void InputLatencyTracker::OnBatUpdated(Clock::time_point now) {
+  has_bat_input_ = has_new_input_;
+  has_simulated_bat_input_ = false;
+  if (has_new_input_) {
+    bat_input_ = new_input_;
+    has_new_input_ = false;
+    Record(kBatUpdated, bat_input_, now);
+  }
+}
+
+void InputLatencyTracker::OnTick(Clock::time_point now) {
+  // Only the first tick after an input shows how long it waited to be used.
+  if (has_bat_input_ && !has_simulated_bat_input_) {
+    has_simulated_bat_input_ = true;
+    Record(kSimulated, bat_input_, now);
+  }
+}
+
+void InputLatencyTracker::OnContact(Clock::time_point now) {
+  if (has_bat_input_) {
+    contact_input_ = bat_input_;
+    has_contact_input_ = true;
+    Record(kContact, contact_input_, now);
+  }
+}
+
+void InputLatencyTracker::OnPresent(Clock::time_point now) {
+  if (has_contact_input_) {
+    has_contact_input_ = false;
+    Record(kPresented, contact_input_, now);
+  }
+}
+
+const Histogram& InputLatencyTracker::GetLatencies(LatencyStage stage) const {
+  return *latencies_[stage];
+}
+
+void InputLatencyTracker::Report(std::ostream& output) const {
+  output << "Input latency this session, in milliseconds:\n";
+  for (size_t stage = 0; stage < kNumLatencyStages; ++stage) {
+    const Histogram& latencies = *latencies_[stage];
+    uint64_t count = latencies.GetCount();
+    output << "  " << kStageNames[stage] << ": " << count << " inputs";
+    if (count > 0) {
+      output << ", median " << 1000 * latencies.EstimateQuantile(0.5)
+             << ", p95 " << 1000 * latencies.EstimateQuantile(0.95)
+             << ", p99 " << 1000 * latencies.EstimateQuantile(0.99);
+    }
+    output << '\n';
+  }
+}
+
+void InputLatencyTracker::Record(LatencyStage stage, Clock::time_point input,
+                                 Clock::time_point now) {
+  latencies_[stage]->Observe(
+      std::chrono::duration<double>(now - input).count());
+}
+
+}  // namespace home_run_derby
@@ -0,0 +1,133 @@
+#include "core/leaderboard.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace home_run_derby {
+
+using std::memory_order_acquire;
+using std::memory_order_relaxed;
+using std::memory_order_release;
+
+Leaderboard::Leaderboard(float max_score, float resolution)
+    : resolution_(resolution),
+      num_buckets_(static_cast<size_t>(std::ceil(max_score / resolution)) + 1),
+      highest_step_(1),
+      tree_(num_buckets_ + 1),
+      num_scores_(0) {
+  while (highest_step_ * 2 <= num_buckets_) {
+    highest_step_ *= 2;
+  }
+}
+
+void Leaderboard::Insert(float score) {
+  AddToBucket(GetBucket(score), 1);
+  num_scores_.fetch_add(1, memory_order_release);
+}
+
+void Leaderboard::InsertAll(const float* scores, size_t num_scores) {
+  size_t run_start = 0;
+  while (run_start < num_scores) {
+    size_t bucket = GetBucket(scores[run_start]);
+    size_t run_end = run_start + 1;
+    while (run_end < num_scores && GetBucket(scores[run_end]) == bucket) {
+      ++run_end;
+    }
+    AddToBucket(bucket, static_cast<uint32_t>(run_end - run_start));
+    num_scores_.fetch_add(run_end - run_start, memory_order_release);
+    run_start = run_end;
+  }
+}
+
+size_t Leaderboard::GetRank(float score) const {
+  size_t num_scores = num_scores_.load(memory_order_acquire);
+  size_t num_at_or_below = CountThrough(GetBucket(score));
+  // An insert may have reached the tree but not the total yet.
+  num_scores = std::max(num_scores, num_at_or_below);
+  return num_scores - num_at_or_below + 1;
+}
+
+float Leaderboard::GetPercentile(float score) const {
+  size_t num_scores = num_scores_.load(memory_order_acquire);
+  if (num_scores == 0) {
+    return 100;
+  }
+  size_t num_at_or_below = CountThrough(GetBucket(score));
+  return std::min(100.0f, 100.0f * static_cast<float>(num_at_or_below) /
+                              static_cast<float>(num_scores));
+}
+
+float Leaderboard::GetScoreAtRank(size_t rank) const {
+  size_t num_scores = num_scores_.load(memory_order_acquire);
+  if (rank == 0 || rank > num_scores) {
+    return 0;
+  }
+  // The rank counts down from the highest score, the tree counts up.
+  return static_cast<float>(FindBucket(num_scores - rank + 1)) * resolution_;
+}
+
+vector<float> Leaderboard::GetTopScores(size_t count) const {
+  size_t num_scores = num_scores_.load(memory_order_acquire);
+  vector<float> top_scores;
+  top_scores.reserve(std::min(count, num_scores));
+
+  // Jump a whole bucket at a time, so this costs O(log n) per distinct score
+  // rather than per rank.
+  size_t rank = 1;
+  while (top_scores.size() < count && rank <= num_scores) {
+    size_t position = num_scores - rank + 1;
+    size_t bucket = FindBucket(position);
+    size_t num_below = bucket > 0 ? CountThrough(bucket - 1) : 0;
+    size_t num_in_bucket = position > num_below ? position - num_below : 1;
+    size_t num_to_add = std::min(num_in_bucket, count - top_scores.size());
+    top_scores.insert(top_scores.end(), num_to_add,
+                      static_cast<float>(bucket) * resolution_);
+    rank += num_in_bucket;
+  }
+  return top_scores;
+}
+
+size_t Leaderboard::GetNumScores() const {
+  return num_scores_.load(memory_order_acquire);
+}
+
+size_t Leaderboard::GetBucket(float score) const {
+  if (!(score > 0)) {
+    return 0;
+  }
+  return std::min(static_cast<size_t>(score / resolution_), num_buckets_ - 1);
+}
+
+void Leaderboard::AddToBucket(size_t bucket, uint32_t count) {
+  for (size_t index = bucket + 1; index <= num_buckets_;
+       index += index & (~index + 1)) {
+    tree_[index].fetch_add(count, memory_order_relaxed);
+  }
+}
+
+size_t Leaderboard::CountThrough(size_t bucket) const {
+  size_t count = 0;
+  for (size_t index = bucket + 1; index > 0; index -= index & (~index + 1)) {
+    count += tree_[index].load(memory_order_relaxed);
+  }
+  return count;
+}
+
+size_t Leaderboard::FindBucket(size_t num_scores) const {
+  // Descend the tree, keeping the largest prefix that counts fewer scores.
+  size_t index = 0;
+  size_t remaining = num_scores;
+  for (size_t step = highest_step_; step > 0; step /= 2) {
+    if (index + step <= num_buckets_) {
+      size_t count = tree_[index + step].load(memory_order_relaxed);
+      if (count < remaining) {
+        index += step;
+        remaining -= count;
+      }
+    }
+  }
+  // The tree is indexed from 1, so index is the zero-based bucket.
+  return std::min(index, num_buckets_ - 1);
+}
+
+}  // namespace home_run_derby
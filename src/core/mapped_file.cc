@@ -0,0 +1,122 @@
+#include "core/mapped_file.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace home_run_derby {
+
+#ifdef _WIN32
+
+MappedFile::MappedFile()
+    : data_(nullptr),
+      size_(0),
+      file_handle_(INVALID_HANDLE_VALUE),
+      mapping_handle_(nullptr) {
+}
+
+bool MappedFile::Open(const string& path) {
+  Close();
+  file_handle_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                             nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                             nullptr);
+  if (file_handle_ == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file_handle_, &file_size) || file_size.QuadPart == 0) {
+    Close();
+    return false;
+  }
+  mapping_handle_ =
+      CreateFileMappingA(file_handle_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (mapping_handle_ == nullptr) {
+    Close();
+    return false;
+  }
+  data_ = static_cast<const char*>(
+      MapViewOfFile(mapping_handle_, FILE_MAP_READ, 0, 0, 0));
+  if (data_ == nullptr) {
+    Close();
+    return false;
+  }
+  size_ = static_cast<size_t>(file_size.QuadPart);
+  return true;
+}
+
+void MappedFile::Close() {
+  if (data_ != nullptr) {
+    UnmapViewOfFile(data_);
+  }
+  if (mapping_handle_ != nullptr) {
+    CloseHandle(mapping_handle_);
+  }
+  if (file_handle_ != INVALID_HANDLE_VALUE) {
+    CloseHandle(file_handle_);
+  }
+  data_ = nullptr;
+  size_ = 0;
+  file_handle_ = INVALID_HANDLE_VALUE;
+  mapping_handle_ = nullptr;
+}
+
+#else
+
+MappedFile::MappedFile() : data_(nullptr), size_(0) {
+}
+
+bool MappedFile::Open(const string& path) {
+  Close();
+  int file_descriptor = open(path.c_str(), O_RDONLY);
+  if (file_descriptor < 0) {
+    return false;
+  }
+  struct stat file_stats;
+  if (fstat(file_descriptor, &file_stats) != 0 || file_stats.st_size == 0) {
+    close(file_descriptor);
+    return false;
+  }
+  void* data = mmap(nullptr, static_cast<size_t>(file_stats.st_size),
+                    PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+  // The mapping stays valid after the descriptor is closed.
+  close(file_descriptor);
+  if (data == MAP_FAILED) {
+    return false;
+  }
+  data_ = static_cast<const char*>(data);
+  size_ = static_cast<size_t>(file_stats.st_size);
+  return true;
+}
+
+void MappedFile::Close() {
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+  data_ = nullptr;
+  size_ = 0;
+}
+
+#endif  // _WIN32
+
+MappedFile::~MappedFile() {
+  Close();
+}
+
+bool MappedFile::IsOpen() const {
+  return data_ != nullptr;
+}
+
+const char* MappedFile::GetData() const {
+  return data_;
+}
+
+size_t MappedFile::GetSize() const {
+  return size_;
+}
+
+}  // namespace home_run_derby
@@ -0,0 +1,245 @@
+#include "core/metrics.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace home_run_derby {
+
+using std::invalid_argument;
+
+namespace {
+
+bool IsValidName(const string& name) {
+  if (name.empty() || std::isdigit(static_cast<unsigned char>(name[0]))) {
+    return false;
+  }
+  for (char character : name) {
+    if (!std::isalnum(static_cast<unsigned char>(character)) &&
+        character != '_' && character != ':') {
+      return false;
+    }
+  }
+  return true;
+}
+
+void WriteHelp(std::ostream& output, const string& help) {
+  for (char character : help) {
+    if (character == '\\') {
+      output << "\\\\";
+    } else if (character == '\n') {
+      output << "\\n";
+    } else {
+      output << character;
+    }
+  }
+}
+
+void WriteNumber(std::ostream& output, double value) {
+  if (std::isnan(value)) {
+    output << "NaN";
+  } else if (std::isinf(value)) {
+    output << (value > 0 ? "+Inf" : "-Inf");
+  } else {
+    output << value;
+  }
+}
+
+}  // namespace
+
+Counter::Counter() : value_(0) {
+}
+
+void Counter::Increment(uint64_t amount) {
+  value_.fetch_add(amount, std::memory_order_relaxed);
+}
+
+uint64_t Counter::GetValue() const {
+  return value_.load(std::memory_order_relaxed);
+}
+
+Gauge::Gauge() : value_(0) {
+}
+
+void Gauge::Set(double value) {
+  value_.store(value, std::memory_order_relaxed);
+}
+
+double Gauge::GetValue() const {
+  return value_.load(std::memory_order_relaxed);
+}
+
+Histogram::Histogram(const vector<double>& upper_bounds)
+    : upper_bounds_(upper_bounds),
+      bucket_counts_(new std::atomic<uint64_t>[upper_bounds.size() + 1]),
+      sum_(0) {
+  for (size_t i = 1; i < upper_bounds_.size(); ++i) {
+    if (!(upper_bounds_[i - 1] < upper_bounds_[i])) {
+      throw invalid_argument("Histogram bounds must be strictly increasing");
+    }
+  }
+  for (size_t i = 0; i <= upper_bounds_.size(); ++i) {
+    bucket_counts_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+void Histogram::Observe(double value) {
+  size_t bucket = std::lower_bound(upper_bounds_.begin(), upper_bounds_.end(),
+                                   value) -
+                  upper_bounds_.begin();
+  bucket_counts_[bucket].fetch_add(1, std::memory_order_relaxed);
+  // There is no atomic add for doubles, so retry until no other observation
+  // slipped in between.
+  double sum = sum_.load(std::memory_order_relaxed);
+  while (!sum_.compare_exchange_weak(sum, sum + value,
+                                     std::memory_order_relaxed)) {
+  }
+}
+
+void Histogram::Merge(const Histogram& other) {
+  if (other.upper_bounds_ != upper_bounds_) {
+    throw invalid_argument("Only histograms with the same bounds can merge");
+  }
+  for (size_t i = 0; i <= upper_bounds_.size(); ++i) {
+    bucket_counts_[i].fetch_add(other.GetBucketCount(i),
+                                std::memory_order_relaxed);
+  }
+  double sum = sum_.load(std::memory_order_relaxed);
+  while (!sum_.compare_exchange_weak(sum, sum + other.GetSum(),
+                                     std::memory_order_relaxed)) {
+  }
+}
+
+const vector<double>& Histogram::GetUpperBounds() const {
+  return upper_bounds_;
+}
+
+uint64_t Histogram::GetBucketCount(size_t bucket) const {
+  return bucket_counts_[bucket].load(std::memory_order_relaxed);
+}
+
+double Histogram::GetSum() const {
+  return sum_.load(std::memory_order_relaxed);
+}
+
+uint64_t Histogram::GetCount() const {
+  uint64_t count = 0;
+  for (size_t i = 0; i <= upper_bounds_.size(); ++i) {
+    count += GetBucketCount(i);
+  }
+  return count;
+}
+
+double Histogram::EstimateQuantile(double quantile) const {
+  uint64_t total = GetCount();
+  if (total == 0) {
+    return 0;
+  }
+  double rank = quantile * static_cast<double>(total);
+  double below = 0;
+  for (size_t i = 0; i < upper_bounds_.size(); ++i) {
+    double count = static_cast<double>(GetBucketCount(i));
+    if (count > 0 && below + count >= rank) {
+      double lower = i == 0 ? 0 : upper_bounds_[i - 1];
+      return lower + (upper_bounds_[i] - lower) * (rank - below) / count;
+    }
+    below += count;
+  }
+  return upper_bounds_.empty() ? 0 : upper_bounds_.back();
+}
+
+Counter* MetricsRegistry::AddCounter(const string& name, const string& help) {
+  unique_ptr<Metric> metric = MakeMetric(name, help, MetricType::kCounter);
+  metric->counter.reset(new Counter());
+  Counter* counter = metric->counter.get();
+  Register(std::move(metric));
+  return counter;
+}
+
+Gauge* MetricsRegistry::AddGauge(const string& name, const string& help) {
+  unique_ptr<Metric> metric = MakeMetric(name, help, MetricType::kGauge);
+  metric->gauge.reset(new Gauge());
+  Gauge* gauge = metric->gauge.get();
+  Register(std::move(metric));
+  return gauge;
+}
+
+Histogram* MetricsRegistry::AddHistogram(const string& name,
+                                         const string& help,
+                                         const vector<double>& upper_bounds) {
+  unique_ptr<Metric> metric = MakeMetric(name, help, MetricType::kHistogram);
+  metric->histogram.reset(new Histogram(upper_bounds));
+  Histogram* histogram = metric->histogram.get();
+  Register(std::move(metric));
+  return histogram;
+}
+
+void MetricsRegistry::WriteText(std::ostream& output) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const unique_ptr<Metric>& metric : metrics_) {
+    output << "# HELP " << metric->name << " ";
+    WriteHelp(output, metric->help);
+    output << "\n";
+    switch (metric->type) {
+      case MetricType::kCounter:
+        output << "# TYPE " << metric->name << " counter\n"
+               << metric->name << " " << metric->counter->GetValue() << "\n";
+        break;
+      case MetricType::kGauge:
+        output << "# TYPE " << metric->name << " gauge\n"
+               << metric->name << " ";
+        WriteNumber(output, metric->gauge->GetValue());
+        output << "\n";
+        break;
+      case MetricType::kHistogram: {
+        // Buckets are kept separately and written cumulatively, so the count
+        // always agrees with the last bucket.
+        const Histogram& histogram = *metric->histogram;
+        const vector<double>& upper_bounds = histogram.GetUpperBounds();
+        output << "# TYPE " << metric->name << " histogram\n";
+        uint64_t count = 0;
+        for (size_t i = 0; i <= upper_bounds.size(); ++i) {
+          count += histogram.GetBucketCount(i);
+          output << metric->name << "_bucket{le=\"";
+          if (i < upper_bounds.size()) {
+            WriteNumber(output, upper_bounds[i]);
+          } else {
+            output << "+Inf";
+          }
+          output << "\"} " << count << "\n";
+        }
+        output << metric->name << "_sum ";
+        WriteNumber(output, histogram.GetSum());
+        output << "\n" << metric->name << "_count " << count << "\n";
+        break;
+      }
+    }
+  }
+}
+
+unique_ptr<MetricsRegistry::Metric> MetricsRegistry::MakeMetric(
+    const string& name, const string& help, MetricType type) {
+  if (!IsValidName(name)) {
+    throw invalid_argument("Malformed metric name " + name);
+  }
+  unique_ptr<Metric> metric(new Metric());
+  metric->name = name;
+  metric->help = help;
+  metric->type = type;
+  return metric;
+}
+
+void MetricsRegistry::Register(unique_ptr<Metric> metric) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const unique_ptr<Metric>& other : metrics_) {
+    if (other->name == metric->name) {
+      throw invalid_argument("The metric " + metric->name +
+                             " already exists");
+    }
+  }
+  metrics_.push_back(std::move(metric));
+}
+
+}  // namespace home_run_derby
@@ -0,0 +1,248 @@
+#include "core/metrics_server.h"
+
+#include <chrono>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace home_run_derby {
+
+using std::runtime_error;
+using std::string;
+
+namespace {
+
+#ifdef _WIN32
+
+typedef SOCKET NativeSocket;
+typedef int AddressLength;
+const intptr_t kNoSocket = static_cast<intptr_t>(INVALID_SOCKET);
+const int kSendFlags = 0;
+
+void StartSockets() {
+  // Winsock has to be started once per process before any socket is made.
+  static const bool is_started = [] {
+    WSADATA data;
+    return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+  }();
+  if (!is_started) {
+    throw runtime_error("Could not start Winsock");
+  }
+}
+
+void CloseNativeSocket(NativeSocket socket) {
+  closesocket(socket);
+}
+
+bool SetBlocking(NativeSocket socket, bool is_blocking) {
+  u_long is_non_blocking = is_blocking ? 0 : 1;
+  return ioctlsocket(socket, FIONBIO, &is_non_blocking) == 0;
+}
+
+#else
+
+typedef int NativeSocket;
+typedef socklen_t AddressLength;
+const intptr_t kNoSocket = -1;
+#ifdef MSG_NOSIGNAL
+// A scraper hanging up early must not kill the game with SIGPIPE.
+const int kSendFlags = MSG_NOSIGNAL;
+#else
+const int kSendFlags = 0;
+#endif
+
+void StartSockets() {
+}
+
+void CloseNativeSocket(NativeSocket socket) {
+  close(socket);
+}
+
+bool SetBlocking(NativeSocket socket, bool is_blocking) {
+  int flags = fcntl(socket, F_GETFL, 0);
+  if (flags < 0) {
+    return false;
+  }
+  flags = is_blocking ? flags & ~O_NONBLOCK : flags | O_NONBLOCK;
+  return fcntl(socket, F_SETFL, flags) == 0;
+}
+
+#endif
+
+NativeSocket ToNative(intptr_t handle) {
+  return static_cast<NativeSocket>(handle);
+}
+
+/**
+ * Waits until a socket can be read from.
+ * @return Whether it can be read from before the timeout.
+ */
+bool WaitReadable(NativeSocket socket, int timeout_milliseconds) {
+  fd_set readable;
+  FD_ZERO(&readable);
+  FD_SET(socket, &readable);
+  timeval timeout;
+  timeout.tv_sec = timeout_milliseconds / 1000;
+  timeout.tv_usec = (timeout_milliseconds % 1000) * 1000;
+  return select(static_cast<int>(socket) + 1, &readable, nullptr, nullptr,
+                &timeout) > 0;
+}
+
+void SendAll(NativeSocket socket, const string& data) {
+  size_t num_sent = 0;
+  while (num_sent < data.size()) {
+    int sent = static_cast<int>(
+        send(socket, data.data() + num_sent,
+             static_cast<int>(data.size() - num_sent), kSendFlags));
+    if (sent <= 0) {
+      return;
+    }
+    num_sent += static_cast<size_t>(sent);
+  }
+}
+
+string MakeResponse(const string& status, const string& content_type,
+                    const string& body) {
+  std::ostringstream response;
+  response << "HTTP/1.0 " << status << "\r\n"
+           << "Content-Type: " << content_type << "\r\n"
+           << "Content-Length: " << body.size() << "\r\n"
+           << "Connection: close\r\n\r\n"
+           << body;
+  return response.str();
+}
+
+}  // namespace
+
+const int MetricsServer::kPollMilliseconds;
+const size_t MetricsServer::kMaxRequestSize;
+
+MetricsServer::MetricsServer(const MetricsRegistry& registry, uint16_t port)
+    : registry_(registry),
+      port_(port),
+      listener_(kNoSocket),
+      bound_port_(0),
+      is_running_(false) {
+}
+
+MetricsServer::~MetricsServer() {
+  Stop();
+}
+
+void MetricsServer::Start() {
+  Stop();
+  StartSockets();
+  NativeSocket native = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (static_cast<intptr_t>(native) == kNoSocket) {
+    throw runtime_error("Could not create a socket");
+  }
+
+  // Only the local machine may scrape the game.
+  sockaddr_in address;
+  std::memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = htons(port_);
+  AddressLength length = sizeof(address);
+  if (bind(native, reinterpret_cast<sockaddr*>(&address), length) != 0 ||
+      getsockname(native, reinterpret_cast<sockaddr*>(&address), &length) !=
+          0 ||
+      listen(native, SOMAXCONN) != 0 || !SetBlocking(native, false)) {
+    CloseNativeSocket(native);
+    throw runtime_error("Could not listen on port " + std::to_string(port_));
+  }
+  listener_ = static_cast<intptr_t>(native);
+  bound_port_ = ntohs(address.sin_port);
+  is_running_ = true;
+  thread_ = std::thread(&MetricsServer::Run, this);
+}
+
+void MetricsServer::Stop() {
+  is_running_ = false;
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  if (listener_ != kNoSocket) {
+    CloseNativeSocket(ToNative(listener_));
+    listener_ = kNoSocket;
+    bound_port_ = 0;
+  }
+}
+
+uint16_t MetricsServer::GetPort() const {
+  return bound_port_;
+}
+
+void MetricsServer::Run() {
+  NativeSocket listener = ToNative(listener_);
+  while (is_running_) {
+    // Wake up now and then to notice being stopped.
+    if (!WaitReadable(listener, kPollMilliseconds)) {
+      continue;
+    }
+    NativeSocket connection = accept(listener, nullptr, nullptr);
+    if (static_cast<intptr_t>(connection) == kNoSocket) {
+      continue;
+    }
+    Serve(static_cast<intptr_t>(connection));
+    CloseNativeSocket(connection);
+  }
+}
+
+void MetricsServer::Serve(intptr_t connection) {
+  NativeSocket native = ToNative(connection);
+  // Some platforms pass non-blocking on from the listener; reads below are
+  // bounded by select() instead.
+  if (!SetBlocking(native, true)) {
+    return;
+  }
+
+  // Read up to the end of the headers, giving up on a client that stalls.
+  string request;
+  char buffer[512];
+  std::chrono::steady_clock::time_point deadline =
+      std::chrono::steady_clock::now() +
+      std::chrono::milliseconds(10 * kPollMilliseconds);
+  while (request.find("\r\n\r\n") == string::npos &&
+         request.size() < kMaxRequestSize) {
+    if (!is_running_ || std::chrono::steady_clock::now() > deadline) {
+      return;
+    }
+    if (!WaitReadable(native, kPollMilliseconds)) {
+      continue;
+    }
+    int size = static_cast<int>(recv(native, buffer, sizeof(buffer), 0));
+    if (size <= 0) {
+      return;
+    }
+    request.append(buffer, static_cast<size_t>(size));
+  }
+
+  // Only the request line matters; any query string is ignored.
+  string request_line = request.substr(0, request.find("\r\n"));
+  if (request_line.compare(0, 13, "GET /metrics ") == 0 ||
+      request_line.compare(0, 13, "GET /metrics?") == 0) {
+    std::ostringstream body;
+    registry_.WriteText(body);
+    SendAll(native, MakeResponse("200 OK", "text/plain; version=0.0.4",
+                                 body.str()));
+  } else {
+    SendAll(native, MakeResponse("404 Not Found", "text/plain",
+                                 "Try GET /metrics\n"));
+  }
+}
+
+}  // namespace home_run_derby
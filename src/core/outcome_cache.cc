@@ -0,0 +1,209 @@
+#include "core/outcome_cache.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace home_run_derby {
+
+using std::memory_order_relaxed;
+
+namespace {
+
+// Keeps a rounded coordinate inside the range of the key, whatever the input.
+const float kMaxKeyValue = 1.0e9f;
+
+int32_t Quantize(float value, float resolution) {
+  float steps = std::round(value / resolution);
+  if (!(steps == steps)) {
+    return 0;
+  }
+  return static_cast<int32_t>(std::max(-kMaxKeyValue,
+                                       std::min(kMaxKeyValue, steps)));
+}
+
+size_t RoundUpToPowerOfTwo(size_t value) {
+  size_t power = 1;
+  while (power < value) {
+    power *= 2;
+  }
+  return power;
+}
+
+}  // namespace
+
+bool OutcomeCache::Key::operator==(const Key& other) const {
+  return std::equal(values, values + kKeySize, other.values) &&
+         model == other.model && stadium == other.stadium;
+}
+
+OutcomeCache::OutcomeCache(size_t capacity, float position_resolution,
+                           float speed_resolution, const FlightLimits& flight)
+    : position_resolution_(position_resolution),
+      speed_resolution_(speed_resolution),
+      flight_(flight),
+      capacity_(RoundUpToPowerOfTwo(
+          std::max(capacity, kNumShards * kProbeWindow))),
+      shards_(new Shard[kNumShards]),
+      num_hits_(0),
+      num_misses_(0),
+      num_evictions_(0) {
+  Slot empty_slot = {};
+  for (size_t i = 0; i < kNumShards; ++i) {
+    shards_[i].slots.assign(capacity_ / kNumShards, empty_slot);
+    shards_[i].clock_hand = 0;
+  }
+}
+
+const ContactOutcome OutcomeCache::Resolve(const Ball& ball, const Bat& bat) {
+  ContactOutcome outcome;
+  if (Lookup(ball, bat, &outcome)) {
+    return outcome;
+  }
+  // Simulate outside the lock, so a long flight never holds up other threads.
+  // Two threads missing on the same key both simulate and store the same
+  // outcome, which is harmless.
+  outcome = SimulateContact(ball, bat);
+  Insert(ball, bat, outcome);
+  return outcome;
+}
+
+bool OutcomeCache::Lookup(const Ball& ball, const Bat& bat,
+                          ContactOutcome* outcome) {
+  Key key;
+  uint64_t hash = MakeKey(ball, bat, &key);
+  Shard& shard = GetShard(hash);
+  size_t home_slot = GetHomeSlot(hash, shard);
+  size_t mask = shard.slots.size() - 1;
+
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  for (size_t i = 0; i < kProbeWindow; ++i) {
+    Slot& slot = shard.slots[(home_slot + i) & mask];
+    if (slot.hash == hash && slot.key == key) {
+      slot.is_referenced = true;
+      *outcome = slot.outcome;
+      num_hits_.fetch_add(1, memory_order_relaxed);
+      return true;
+    }
+  }
+  num_misses_.fetch_add(1, memory_order_relaxed);
+  return false;
+}
+
+void OutcomeCache::Insert(const Ball& ball, const Bat& bat,
+                          const ContactOutcome& outcome) {
+  Key key;
+  uint64_t hash = MakeKey(ball, bat, &key);
+  Shard& shard = GetShard(hash);
+  size_t home_slot = GetHomeSlot(hash, shard);
+  size_t mask = shard.slots.size() - 1;
+
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  Slot* target = nullptr;
+  for (size_t i = 0; i < kProbeWindow && target == nullptr; ++i) {
+    Slot& slot = shard.slots[(home_slot + i) & mask];
+    if (slot.hash == 0 || (slot.hash == hash && slot.key == key)) {
+      target = &slot;
+    }
+  }
+
+  if (target == nullptr) {
+    // The window is full. Sweep it from where the shard's hand last stopped,
+    // giving every recently read slot a second chance; two passes always find
+    // a victim.
+    for (size_t i = 0; i < 2 * kProbeWindow && target == nullptr; ++i) {
+      Slot& slot = shard.slots[(home_slot + (shard.clock_hand + i) %
+                                                kProbeWindow) & mask];
+      if (slot.is_referenced) {
+        slot.is_referenced = false;
+      } else {
+        target = &slot;
+        shard.clock_hand = (shard.clock_hand + i + 1) % kProbeWindow;
+      }
+    }
+    num_evictions_.fetch_add(1, memory_order_relaxed);
+  }
+
+  target->hash = hash;
+  target->key = key;
+  target->outcome = outcome;
+  target->is_referenced = false;
+}
+
+const ContactOutcome OutcomeCache::SimulateContact(const Ball& ball,
+                                                   const Bat& bat) const {
+  // The key has no room for the bat's path, so only its last step is played,
+  // as it would be with a single input a tick.
+  Ball contact_ball(ball);
+  Bat contact_bat(bat);
+  contact_bat.ClearWaypoints();
+  contact_ball.HandleBatCollisions(contact_bat);
+  ContactOutcome outcome;
+  outcome.has_contact = contact_ball.HasCollided();
+  outcome.exit_velocity = contact_ball.GetSpeed();
+  outcome.distance = SimulateFlight(contact_ball, flight_);
+  return outcome;
+}
+
+size_t OutcomeCache::GetCapacity() const {
+  return capacity_;
+}
+
+size_t OutcomeCache::GetNumHits() const {
+  return num_hits_.load(memory_order_relaxed);
+}
+
+size_t OutcomeCache::GetNumMisses() const {
+  return num_misses_.load(memory_order_relaxed);
+}
+
+size_t OutcomeCache::GetNumEvictions() const {
+  return num_evictions_.load(memory_order_relaxed);
+}
+
+uint64_t OutcomeCache::MakeKey(const Ball& ball, const Bat& bat,
+                               Key* key) const {
+  // A ball that has already been hit cannot be hit again, so that is part of
+  // the key as well.
+  const vec2& ball_position = ball.GetPosition();
+  const vec2& ball_speed = ball.GetSpeed();
+  const vec2& bat_position = bat.GetBatPosition();
+  const vec2& bat_speed = bat.GetBatSpeed();
+  key->values[0] = Quantize(ball_position.x, position_resolution_);
+  key->values[1] = Quantize(ball_position.y, position_resolution_);
+  key->values[2] = Quantize(ball_speed.x, speed_resolution_);
+  key->values[3] = Quantize(ball_speed.y, speed_resolution_);
+  key->values[4] = Quantize(bat_position.x, position_resolution_);
+  key->values[5] = Quantize(bat_position.y, position_resolution_);
+  key->values[6] = Quantize(bat_speed.x, speed_resolution_);
+  key->values[7] = Quantize(bat_speed.y, speed_resolution_);
+  key->values[8] = ball.HasCollided() ? 1 : 0;
+  key->model = bat.GetModel();
+  key->stadium = ball.GetStadium();
+
+  // FNV-1a over the key, followed by a final mix so the top bits that pick
+  // the shard depend on every value.
+  uint64_t hash = 14695981039346656037ull;
+  for (size_t i = 0; i < kKeySize; ++i) {
+    hash ^= static_cast<uint32_t>(key->values[i]);
+    hash *= 1099511628211ull;
+  }
+  hash ^= static_cast<uint64_t>(reinterpret_cast<uintptr_t>(key->model));
+  hash *= 1099511628211ull;
+  hash ^= static_cast<uint64_t>(reinterpret_cast<uintptr_t>(key->stadium));
+  hash *= 1099511628211ull;
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdull;
+  hash ^= hash >> 33;
+  // 0 marks an empty slot.
+  return hash == 0 ? 1 : hash;
+}
+
+OutcomeCache::Shard& OutcomeCache::GetShard(uint64_t hash) const {
+  return shards_[(hash >> 60) % kNumShards];
+}
+
+size_t OutcomeCache::GetHomeSlot(uint64_t hash, const Shard& shard) const {
+  return static_cast<size_t>(hash) & (shard.slots.size() - 1);
+}
+
+}  // namespace home_run_derby
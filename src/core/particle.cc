@@ -1,17 +1,19 @@
 #include "core/particle.h"
 
-#include "cinder/Rand.h"
-
 namespace home_run_derby {
 
-using ci::randFloat;
 using glm::vec2;
 
-Particle::Particle(const vec2 &position, bool randomize_velocity)
-    : position_(position),
-      speed_multiplier_(randomize_velocity ? randFloat(kMinVelocityMultiplier,
-                                                       kMaxVelocityMultiplier)
-                                           : 1) {
+Particle::Particle(const vec2 &position, Random *random) {
+  Reset(position, random);
+}
+
+void Particle::Reset(const vec2 &position, Random *random) {
+  position_ = position;
+  speed_multiplier_ =
+      random != nullptr
+          ? random->NextFloat(kMinVelocityMultiplier, kMaxVelocityMultiplier)
+          : 1;
 }
 
 void Particle::UpdatePosition(const vec2 &velocity) {
@@ -27,4 +29,8 @@ const vec2 &Particle::GetPosition() const {
   return position_;
 }
 
+float Particle::GetSpeedMultiplier() const {
+  return speed_multiplier_;
+}
+
 }  // namespace home_run_derby
\ No newline at end of file
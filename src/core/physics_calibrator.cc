@@ -0,0 +1,335 @@
+#include "core/physics_calibrator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace home_run_derby {
+
+using std::invalid_argument;
+using std::runtime_error;
+
+namespace {
+
+const float kPi = 3.14159265358979f;
+const float kFeetPerSecondPerMph = 5280.0f / 3600;
+
+/** The constants the search moves, in the order of its coordinates. **/
+float PhysicsProfile::*const kFittedConstants[] = {
+    &PhysicsProfile::gravity,
+    &PhysicsProfile::ball_velocity_boost_factor,
+    &PhysicsProfile::ground_friction,
+    &PhysicsProfile::ground_restitution,
+    &PhysicsProfile::distance_scale,
+    &PhysicsProfile::bat_mass};
+const size_t kNumFittedConstants = 6;
+
+typedef vector<double> Point;
+
+Point ToPoint(const PhysicsProfile& profile) {
+  Point point(kNumFittedConstants);
+  for (size_t i = 0; i < kNumFittedConstants; ++i) {
+    point[i] = std::log(static_cast<double>(profile.*kFittedConstants[i]));
+  }
+  return point;
+}
+
+PhysicsProfile ToProfile(const Point& point) {
+  PhysicsProfile profile = PhysicsProfile();
+  for (size_t i = 0; i < kNumFittedConstants; ++i) {
+    profile.*kFittedConstants[i] = static_cast<float>(std::exp(point[i]));
+  }
+  return profile;
+}
+
+/**
+ * Moves from one point through another by a factor of the way between them,
+ * e.g. -1 to reflect the first through the second.
+ */
+Point Step(const Point& from, const Point& through, double factor) {
+  Point point(from.size());
+  for (size_t i = 0; i < from.size(); ++i) {
+    point[i] = through[i] + factor * (through[i] - from[i]);
+  }
+  return point;
+}
+
+}  // namespace
+
+const double PhysicsCalibrator::kPriorWeight = 1e-3;
+const double PhysicsCalibrator::kInitialStep = 1.25;
+const double PhysicsCalibrator::kTolerance = 1e-10;
+
+vector<BattedBall> PhysicsCalibrator::LoadMeasurements(const string& path) {
+  std::ifstream input(path);
+  if (!input) {
+    throw runtime_error("Could not open the measurements " + path);
+  }
+  return ParseMeasurements(input);
+}
+
+vector<BattedBall> PhysicsCalibrator::ParseMeasurements(std::istream& input) {
+  vector<BattedBall> measurements;
+  string line;
+  for (size_t line_number = 1; std::getline(input, line); ++line_number) {
+    if (line.find_first_not_of(" \t\r") == string::npos) {
+      continue;
+    }
+    std::replace(line.begin(), line.end(), ',', ' ');
+    std::istringstream fields(line);
+    BattedBall measurement = BattedBall();
+    if (!(fields >> measurement.exit_speed_mph >>
+          measurement.launch_angle_degrees >> measurement.distance_feet)) {
+      if (line_number == 1) {
+        continue;
+      }
+      throw runtime_error("Malformed measurement on line " +
+                          std::to_string(line_number));
+    }
+    string trailing;
+    if ((!(fields >> measurement.bat_speed_mph) && !fields.eof()) ||
+        (fields >> trailing) || !(measurement.exit_speed_mph > 0) ||
+        !(measurement.distance_feet > 0) || measurement.bat_speed_mph < 0) {
+      throw runtime_error("Malformed measurement on line " +
+                          std::to_string(line_number));
+    }
+    measurements.push_back(measurement);
+  }
+  return measurements;
+}
+
+PhysicsCalibrator::PhysicsCalibrator(const CalibrationSettings& settings,
+                                     const vector<BattedBall>& measurements)
+    : settings_(settings),
+      measurements_(measurements),
+      num_with_bat_speed_(0),
+      candidate_(nullptr),
+      next_batch_(0) {
+  if (measurements_.empty()) {
+    throw invalid_argument("There is nothing to calibrate against");
+  }
+  if (!(settings_.frame_rate > 0) || settings_.batch_size == 0 ||
+      settings_.flight.max_ticks == 0) {
+    throw invalid_argument("Calibration settings are out of range");
+  }
+  for (const BattedBall& measurement : measurements_) {
+    if (measurement.bat_speed_mph > 0) {
+      ++num_with_bat_speed_;
+    }
+  }
+  if (settings_.num_workers == 0) {
+    settings_.num_workers = std::max(1u, std::thread::hardware_concurrency());
+  }
+  worker_sums_.resize(settings_.num_workers);
+  for (size_t i = 0; i < settings_.num_workers; ++i) {
+    workers_.emplace_back(new StepWorker([this, i] { MeasureBatches(i); }));
+  }
+}
+
+CalibrationError PhysicsCalibrator::Measure(const PhysicsProfile& profile) {
+  candidate_ = &profile;
+  next_batch_.store(0, std::memory_order_relaxed);
+  for (unique_ptr<StepWorker>& worker : workers_) {
+    worker->Post();
+  }
+  for (unique_ptr<StepWorker>& worker : workers_) {
+    worker->Join();
+  }
+  candidate_ = nullptr;
+
+  ErrorSums sums = {0, 0};
+  for (const ErrorSums& worker_sums : worker_sums_) {
+    sums.distance += worker_sums.distance;
+    sums.exit_speed += worker_sums.exit_speed;
+  }
+  CalibrationError error;
+  error.distance = std::sqrt(sums.distance / measurements_.size());
+  error.exit_speed =
+      num_with_bat_speed_ > 0
+          ? std::sqrt(sums.exit_speed / num_with_bat_speed_)
+          : 0;
+  return error;
+}
+
+CalibrationResult PhysicsCalibrator::Fit(const PhysicsProfile& start,
+                                         size_t max_evaluations) {
+  CalibrationResult result;
+  result.start_error = Measure(start);
+
+  // The simplex starts at the start and one step out along each constant.
+  size_t num_vertices = kNumFittedConstants + 1;
+  vector<Point> vertices(num_vertices, ToPoint(start));
+  vector<double> scores(num_vertices);
+  for (size_t i = 1; i < num_vertices; ++i) {
+    vertices[i][i - 1] += std::log(kInitialStep);
+  }
+  for (size_t i = 0; i < num_vertices; ++i) {
+    scores[i] = Score(ToProfile(vertices[i]), start);
+  }
+  size_t num_evaluations = num_vertices;
+
+  vector<size_t> order(num_vertices);
+  while (true) {
+    for (size_t i = 0; i < num_vertices; ++i) {
+      order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&scores](size_t a, size_t b) {
+      return scores[a] < scores[b];
+    });
+    size_t best = order.front();
+    size_t worst = order.back();
+    size_t second_worst = order[num_vertices - 2];
+    if (num_evaluations >= max_evaluations ||
+        scores[worst] - scores[best] <= kTolerance) {
+      break;
+    }
+
+    Point centroid(kNumFittedConstants, 0);
+    for (size_t i = 0; i < num_vertices; ++i) {
+      if (i != worst) {
+        for (size_t j = 0; j < kNumFittedConstants; ++j) {
+          centroid[j] += vertices[i][j] / kNumFittedConstants;
+        }
+      }
+    }
+
+    Point reflected = Step(vertices[worst], centroid, 1);
+    double reflected_score = Score(ToProfile(reflected), start);
+    ++num_evaluations;
+    if (reflected_score < scores[best]) {
+      Point expanded = Step(vertices[worst], centroid, 2);
+      double expanded_score = Score(ToProfile(expanded), start);
+      ++num_evaluations;
+      if (expanded_score < reflected_score) {
+        vertices[worst] = expanded;
+        scores[worst] = expanded_score;
+      } else {
+        vertices[worst] = reflected;
+        scores[worst] = reflected_score;
+      }
+      continue;
+    }
+    if (reflected_score < scores[second_worst]) {
+      vertices[worst] = reflected;
+      scores[worst] = reflected_score;
+      continue;
+    }
+
+    // Contract toward the centroid from whichever of the worst vertex and
+    // its reflection is better.
+    bool is_outside = reflected_score < scores[worst];
+    Point contracted =
+        Step(is_outside ? reflected : vertices[worst], centroid, -0.5);
+    double contracted_score = Score(ToProfile(contracted), start);
+    ++num_evaluations;
+    if (contracted_score < std::min(reflected_score, scores[worst])) {
+      vertices[worst] = contracted;
+      scores[worst] = contracted_score;
+      continue;
+    }
+
+    // Nothing along the line helped, so shrink everything toward the best.
+    for (size_t i = 0; i < num_vertices; ++i) {
+      if (i != best) {
+        vertices[i] = Step(vertices[i], vertices[best], -0.5);
+        scores[i] = Score(ToProfile(vertices[i]), start);
+        ++num_evaluations;
+      }
+    }
+  }
+
+  size_t best = static_cast<size_t>(
+      std::min_element(scores.begin(), scores.end()) - scores.begin());
+  result.profile = ToProfile(vertices[best]);
+  result.error = Measure(result.profile);
+  result.num_evaluations = num_evaluations;
+  return result;
+}
+
+void PhysicsCalibrator::MeasureBatches(size_t worker) {
+  ErrorSums sums = {0, 0};
+  size_t num_batches = (measurements_.size() + settings_.batch_size - 1) /
+                       settings_.batch_size;
+  size_t batch;
+  while ((batch = next_batch_.fetch_add(1, std::memory_order_relaxed)) <
+         num_batches) {
+    size_t end = std::min((batch + 1) * settings_.batch_size,
+                          measurements_.size());
+    for (size_t i = batch * settings_.batch_size; i < end; ++i) {
+      MeasureBall(measurements_[i], &sums);
+    }
+  }
+  worker_sums_[worker] = sums;
+}
+
+void PhysicsCalibrator::MeasureBall(const BattedBall& measurement,
+                                    ErrorSums* sums) const {
+  const PhysicsProfile& profile = *candidate_;
+  float pixels_per_mph =
+      kFeetPerSecondPerMph * profile.distance_scale / settings_.frame_rate;
+  float angle = measurement.launch_angle_degrees * kPi / 180;
+  // The field is to the left, and up is toward negative y.
+  vec2 direction(-std::cos(angle), -std::sin(angle));
+
+  Ball ball(settings_.ball_mass, settings_.ball_radius, profile.gravity,
+            profile.ground_friction, profile.ground_restitution,
+            profile.ball_velocity_boost_factor, settings_.terminal_velocity,
+            settings_.pitch_speed.x, settings_.pitch_speed.x,
+            settings_.pitch_speed.y, settings_.pitch_speed.y,
+            settings_.window_size);
+  ball.SetGroundLocation(settings_.ground_location);
+  BallState state;
+  ball.SaveState(&state);
+  state.position = vec2(0, settings_.ground_location - settings_.ball_radius -
+                               settings_.contact_height *
+                                   profile.distance_scale);
+  state.previous_position = state.position;
+
+  if (measurement.bat_speed_mph > 0) {
+    // Swing square along the launch direction at the pitch.
+    state.speed = settings_.pitch_speed;
+    ball.RestoreState(state);
+    Bat bat(profile.bat_mass, settings_.bat_radius);
+    ball.UpdateSpeedOnCollision(
+        bat,
+        state.position -
+            (settings_.ball_radius + settings_.bat_radius) * direction,
+        measurement.bat_speed_mph * pixels_per_mph * direction);
+    double error = glm::length(ball.GetSpeed()) / pixels_per_mph /
+                       measurement.exit_speed_mph -
+                   1;
+    sums->exit_speed += error * error;
+  }
+
+  state.speed = measurement.exit_speed_mph * pixels_per_mph * direction;
+  state.has_collided = true;
+  ball.RestoreState(state);
+  double error = SimulateTravel(ball, settings_.flight) /
+                     profile.distance_scale / measurement.distance_feet -
+                 1;
+  sums->distance += error * error;
+}
+
+double PhysicsCalibrator::Score(const PhysicsProfile& profile,
+                                const PhysicsProfile& start) {
+  // A ball that loses nothing to the ground never stops.
+  if (!(profile.ground_friction < 1) || !(profile.ground_restitution < 1)) {
+    return std::numeric_limits<double>::infinity();
+  }
+  CalibrationError error = Measure(profile);
+  double score =
+      error.distance * error.distance + error.exit_speed * error.exit_speed;
+  Point point = ToPoint(profile);
+  Point start_point = ToPoint(start);
+  for (size_t i = 0; i < kNumFittedConstants; ++i) {
+    double stray = point[i] - start_point[i];
+    score += kPriorWeight * stray * stray;
+  }
+  return score;
+}
+
+}  // namespace home_run_derby
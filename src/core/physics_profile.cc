@@ -0,0 +1,79 @@
+#include "core/physics_profile.h"
+
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace home_run_derby {
+
+using std::runtime_error;
+
+namespace {
+
+/**
+ * A constant as it is named in a profile.
+ */
+struct NamedConstant {
+  const char* name;
+  float PhysicsProfile::*value;
+};
+
+const NamedConstant kConstants[] = {
+    {"gravity", &PhysicsProfile::gravity},
+    {"ball_velocity_boost_factor",
+     &PhysicsProfile::ball_velocity_boost_factor},
+    {"ground_friction", &PhysicsProfile::ground_friction},
+    {"ground_restitution", &PhysicsProfile::ground_restitution},
+    {"distance_scale", &PhysicsProfile::distance_scale},
+    {"bat_mass", &PhysicsProfile::bat_mass}};
+
+}  // namespace
+
+PhysicsProfile PhysicsProfile::Load(const string& path,
+                                    const PhysicsProfile& defaults) {
+  std::ifstream input(path);
+  if (!input) {
+    throw runtime_error("Could not open the physics profile " + path);
+  }
+  return Parse(input, defaults);
+}
+
+PhysicsProfile PhysicsProfile::Parse(std::istream& input,
+                                     const PhysicsProfile& defaults) {
+  PhysicsProfile profile = defaults;
+  string line;
+  for (size_t line_number = 1; std::getline(input, line); ++line_number) {
+    std::istringstream fields(line.substr(0, line.find('#')));
+    string name;
+    if (!(fields >> name)) {
+      continue;
+    }
+    const NamedConstant* constant = nullptr;
+    for (const NamedConstant& named : kConstants) {
+      if (name == named.name) {
+        constant = &named;
+      }
+    }
+    float value;
+    string trailing;
+    if (constant == nullptr || !(fields >> value) || !(value > 0) ||
+        (fields >> trailing)) {
+      throw runtime_error("Malformed physics constant on line " +
+                          std::to_string(line_number));
+    }
+    profile.*constant->value = value;
+  }
+  return profile;
+}
+
+void PhysicsProfile::Write(std::ostream& output) const {
+  for (const NamedConstant& constant : kConstants) {
+    output << constant.name << ' '
+           << std::setprecision(std::numeric_limits<float>::max_digits10)
+           << this->*constant.value << '\n';
+  }
+}
+
+}  // namespace home_run_derby
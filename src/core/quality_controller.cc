@@ -0,0 +1,80 @@
+#include "core/quality_controller.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace home_run_derby {
+
+QualityController::QualityController(const QualitySettings& settings)
+    : settings_(settings),
+      level_(settings.start_level),
+      smoothed_seconds_(0),
+      has_frames_(false),
+      num_slow_frames_(0),
+      num_fast_frames_(0) {
+  if (!(settings.frame_budget_seconds > 0) || settings.num_levels == 0 ||
+      settings.start_level >= settings.num_levels ||
+      !(settings.raise_load > 0) ||
+      !(settings.lower_load > settings.raise_load) ||
+      settings.lower_frames == 0 || settings.raise_frames == 0 ||
+      !(settings.smoothing > 0 && settings.smoothing <= 1)) {
+    throw std::invalid_argument("Quality settings are out of range");
+  }
+}
+
+bool QualityController::OnFrame(double frame_seconds) {
+  if (!has_frames_) {
+    smoothed_seconds_ = frame_seconds;
+    has_frames_ = true;
+  } else {
+    smoothed_seconds_ += settings_.smoothing *
+                         (frame_seconds - smoothed_seconds_);
+  }
+
+  double load = smoothed_seconds_ / settings_.frame_budget_seconds;
+  num_slow_frames_ = load > settings_.lower_load ? num_slow_frames_ + 1 : 0;
+  num_fast_frames_ = load < settings_.raise_load ? num_fast_frames_ + 1 : 0;
+  if (num_slow_frames_ >= settings_.lower_frames && level_ > 0) {
+    SetLevel(level_ - 1);
+    return true;
+  }
+  if (num_fast_frames_ >= settings_.raise_frames &&
+      level_ + 1 < settings_.num_levels) {
+    SetLevel(level_ + 1);
+    return true;
+  }
+  return false;
+}
+
+size_t QualityController::GetLevel() const {
+  return level_;
+}
+
+float QualityController::GetDetail() const {
+  return static_cast<float>(level_ + 1) /
+         static_cast<float>(settings_.num_levels);
+}
+
+size_t QualityController::Scale(size_t full_count) const {
+  if (full_count == 0) {
+    return 0;
+  }
+  return std::max<size_t>(
+      1, static_cast<size_t>(std::lround(full_count * GetDetail())));
+}
+
+double QualityController::GetSmoothedSeconds() const {
+  return smoothed_seconds_;
+}
+
+void QualityController::SetLevel(size_t level) {
+  level_ = level;
+  // The frames so far were drawn at the old level, so they say little about
+  // the new one.
+  num_slow_frames_ = 0;
+  num_fast_frames_ = 0;
+  has_frames_ = false;
+}
+
+}  // namespace home_run_derby
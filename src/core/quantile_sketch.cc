@@ -0,0 +1,170 @@
+#include "core/quantile_sketch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace home_run_derby {
+
+const size_t QuantileSketch::kDefaultMaxBins;
+
+QuantileSketch::QuantileSketch(double relative_accuracy, size_t max_bins)
+    : relative_accuracy_(relative_accuracy),
+      zero_count_(0),
+      sum_(0),
+      min_(std::numeric_limits<double>::infinity()),
+      max_(-std::numeric_limits<double>::infinity()) {
+  if (!(relative_accuracy > 0 && relative_accuracy < 1) || max_bins == 0 ||
+      max_bins > static_cast<size_t>(std::numeric_limits<int>::max())) {
+    throw std::invalid_argument("Quantile sketch settings are out of range");
+  }
+  // Bin i holds magnitudes in (gamma^(i - 1), gamma^i], whose midpoint is
+  // within the relative accuracy of both ends.
+  gamma_ = (1 + relative_accuracy) / (1 - relative_accuracy);
+  log_gamma_ = std::log(gamma_);
+  for (Store* store : {&positive_, &negative_}) {
+    store->counts.assign(max_bins, 0);
+    store->lowest_index = 0;
+    store->count = 0;
+  }
+}
+
+void QuantileSketch::Add(double value) {
+  if (!std::isfinite(value)) {
+    return;
+  }
+  if (value > 0) {
+    AddToStore(&positive_, GetIndex(value), 1);
+  } else if (value < 0) {
+    AddToStore(&negative_, GetIndex(-value), 1);
+  } else {
+    ++zero_count_;
+  }
+  sum_ += value;
+  min_ = std::min(min_, value);
+  max_ = std::max(max_, value);
+}
+
+void QuantileSketch::Merge(const QuantileSketch& other) {
+  if (other.relative_accuracy_ != relative_accuracy_ ||
+      other.GetMaxBins() != GetMaxBins()) {
+    throw std::invalid_argument("Only sketches with the same settings merge");
+  }
+  const Store* other_stores[] = {&other.positive_, &other.negative_};
+  Store* stores[] = {&positive_, &negative_};
+  for (size_t side = 0; side < 2; ++side) {
+    const Store& other_store = *other_stores[side];
+    for (size_t i = 0; i < other_store.counts.size(); ++i) {
+      if (other_store.counts[i] > 0) {
+        AddToStore(stores[side], other_store.lowest_index + static_cast<int>(i),
+                   other_store.counts[i]);
+      }
+    }
+  }
+  zero_count_ += other.zero_count_;
+  sum_ += other.sum_;
+  min_ = std::min(min_, other.min_);
+  max_ = std::max(max_, other.max_);
+}
+
+double QuantileSketch::EstimateQuantile(double quantile) const {
+  uint64_t count = GetCount();
+  if (count == 0) {
+    return 0;
+  }
+  double rank = std::max(0.0, std::min(quantile, 1.0)) * (count - 1);
+
+  // Walk the values in order: negatives from the largest magnitude down, then
+  // zeros, then positives.
+  double estimate = max_;
+  uint64_t seen = 0;
+  bool is_found = false;
+  for (size_t i = negative_.counts.size(); i > 0 && !is_found; --i) {
+    seen += negative_.counts[i - 1];
+    if (seen > rank) {
+      estimate = -GetValue(negative_.lowest_index + static_cast<int>(i - 1));
+      is_found = true;
+    }
+  }
+  if (!is_found) {
+    seen += zero_count_;
+    if (seen > rank) {
+      estimate = 0;
+      is_found = true;
+    }
+  }
+  for (size_t i = 0; i < positive_.counts.size() && !is_found; ++i) {
+    seen += positive_.counts[i];
+    if (seen > rank) {
+      estimate = GetValue(positive_.lowest_index + static_cast<int>(i));
+      is_found = true;
+    }
+  }
+  return std::max(min_, std::min(estimate, max_));
+}
+
+uint64_t QuantileSketch::GetCount() const {
+  return positive_.count + negative_.count + zero_count_;
+}
+
+double QuantileSketch::GetSum() const {
+  return sum_;
+}
+
+double QuantileSketch::GetMin() const {
+  return GetCount() > 0 ? min_ : 0;
+}
+
+double QuantileSketch::GetMax() const {
+  return GetCount() > 0 ? max_ : 0;
+}
+
+double QuantileSketch::GetRelativeAccuracy() const {
+  return relative_accuracy_;
+}
+
+size_t QuantileSketch::GetMaxBins() const {
+  return positive_.counts.size();
+}
+
+int QuantileSketch::GetIndex(double magnitude) const {
+  return static_cast<int>(std::ceil(std::log(magnitude) / log_gamma_));
+}
+
+double QuantileSketch::GetValue(int index) const {
+  return 2 * std::pow(gamma_, index) / (gamma_ + 1);
+}
+
+void QuantileSketch::AddToStore(Store* store, int index, uint64_t count) {
+  vector<uint64_t>& counts = store->counts;
+  int size = static_cast<int>(counts.size());
+  if (store->count == 0) {
+    // Center the window on the first value, leaving room on both sides.
+    store->lowest_index = index - size / 2;
+  }
+
+  int highest_index = store->lowest_index + size - 1;
+  if (index > highest_index) {
+    // Slide the window up to the new bin, collapsing the bins that fall off
+    // its bottom into its new lowest bin.
+    int shift = index - highest_index;
+    int num_collapsed = std::min(shift + 1, size);
+    uint64_t collapsed = 0;
+    for (int i = 0; i < num_collapsed; ++i) {
+      collapsed += counts[i];
+    }
+    if (shift < size) {
+      std::copy(counts.begin() + shift + 1, counts.end(), counts.begin() + 1);
+    }
+    std::fill(counts.end() - std::min(shift, size - 1), counts.end(), 0);
+    counts[0] = collapsed;
+    store->lowest_index += shift;
+  }
+  size_t position =
+      index < store->lowest_index ? 0 : index - store->lowest_index;
+  counts[position] += count;
+  store->count += count;
+}
+
+}  // namespace home_run_derby
@@ -0,0 +1,42 @@
+#include "core/random.h"
+
+namespace home_run_derby {
+
+namespace {
+
+// The multiplier and increment of the PCG32 linear congruential step.
+const uint64_t kMultiplier = 6364136223846793005ull;
+const uint64_t kIncrement = 1442695040888963407ull;
+
+}  // namespace
+
+Random::Random(uint64_t seed) {
+  Seed(seed);
+}
+
+void Random::Seed(uint64_t seed) {
+  // Scramble the seed with SplitMix64 so that seeds 1, 2, 3... do not start
+  // from neighbouring states.
+  uint64_t mixed = seed + 0x9E3779B97F4A7C15ull;
+  mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ull;
+  mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBull;
+  state_ = mixed ^ (mixed >> 31);
+}
+
+uint32_t Random::NextInt() {
+  // PCG32: step the state, then output a permutation of its high bits.
+  uint64_t old_state = state_;
+  state_ = old_state * kMultiplier + kIncrement;
+  uint32_t shifted =
+      static_cast<uint32_t>(((old_state >> 18) ^ old_state) >> 27);
+  uint32_t rotation = static_cast<uint32_t>(old_state >> 59);
+  return (shifted >> rotation) | (shifted << ((32 - rotation) & 31));
+}
+
+float Random::NextFloat(float min, float max) {
+  // The top 24 bits fill a float's mantissa exactly.
+  float fraction = static_cast<float>(NextInt() >> 8) / 16777216.0f;
+  return min + fraction * (max - min);
+}
+
+}  // namespace home_run_derby
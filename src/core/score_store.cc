@@ -0,0 +1,304 @@
+#include "core/score_store.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+
+#include "core/checksum.h"
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace home_run_derby {
+
+using std::greater;
+using std::runtime_error;
+
+namespace {
+
+const uint32_t kLogMagic = 0x4C445248;       // "HRDL"
+const uint32_t kSnapshotMagic = 0x53445248;  // "HRDS"
+
+struct LogHeader {
+  uint32_t magic;
+  uint32_t generation;
+};
+
+struct LogRecord {
+  float score;
+  uint32_t checksum;
+};
+
+struct SnapshotHeader {
+  uint32_t magic;
+  uint32_t generation;
+  uint64_t num_scores;
+  uint32_t scores_checksum;
+  uint32_t header_checksum;
+};
+
+// Records are checksummed together with their generation, so a record can
+// never be replayed into the wrong log.
+uint32_t ChecksumRecord(uint32_t generation, float score) {
+  return Crc32(&score, sizeof(score),
+               Crc32(&generation, sizeof(generation)));
+}
+
+uint32_t ChecksumSnapshotHeader(const SnapshotHeader& header) {
+  return Crc32(&header, offsetof(SnapshotHeader, header_checksum));
+}
+
+// Flushes a file all the way to the disk.
+bool SyncFile(FILE* file) {
+  if (fflush(file) != 0) {
+    return false;
+  }
+#ifdef _WIN32
+  return _commit(_fileno(file)) == 0;
+#else
+  return fsync(fileno(file)) == 0;
+#endif
+}
+
+bool TruncateFile(const string& path, long size) {
+#ifdef _WIN32
+  FILE* file = fopen(path.c_str(), "r+b");
+  if (file == nullptr) {
+    return false;
+  }
+  bool truncated = _chsize_s(_fileno(file), size) == 0;
+  fclose(file);
+  return truncated;
+#else
+  return truncate(path.c_str(), size) == 0;
+#endif
+}
+
+// Atomically replaces a file, so readers see either the old or new contents.
+bool ReplaceFile(const string& source, const string& destination) {
+#ifdef _WIN32
+  return MoveFileExA(source.c_str(), destination.c_str(),
+                     MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+  return rename(source.c_str(), destination.c_str()) == 0;
+#endif
+}
+
+}  // namespace
+
+ScoreStore::ScoreStore(const string& path_prefix, size_t compaction_threshold)
+    : path_prefix_(path_prefix),
+      compaction_threshold_(compaction_threshold),
+      generation_(0),
+      snapshot_scores_(nullptr),
+      num_snapshot_scores_(0),
+      log_high_score_(0),
+      log_file_(nullptr) {
+}
+
+ScoreStore::~ScoreStore() {
+  if (log_file_ != nullptr) {
+    fclose(log_file_);
+  }
+}
+
+void ScoreStore::Open() {
+  LoadSnapshot();
+  ReplayLog();
+}
+
+void ScoreStore::RecordScore(float score) {
+  if (log_file_ == nullptr) {
+    throw runtime_error("The score store has not been opened!");
+  }
+  LogRecord record = {score, ChecksumRecord(generation_, score)};
+  if (fwrite(&record, sizeof(record), 1, log_file_) != 1 ||
+      !SyncFile(log_file_)) {
+    throw runtime_error("Could not write to the score log!");
+  }
+  log_scores_.push_back(score);
+  log_high_score_ = std::max(log_high_score_, score);
+
+  if (log_scores_.size() >= compaction_threshold_) {
+    Compact();
+  }
+}
+
+void ScoreStore::Compact() {
+  // The snapshot data is only verified here, where it is read in full anyway,
+  // so that startup never has to touch every page.
+  if (snapshot_.IsOpen()) {
+    const SnapshotHeader* header =
+        reinterpret_cast<const SnapshotHeader*>(snapshot_.GetData());
+    if (Crc32(snapshot_scores_, num_snapshot_scores_ * sizeof(float)) !=
+        header->scores_checksum) {
+      throw runtime_error("The score snapshot is corrupt!");
+    }
+  }
+
+  // Both runs are sorted from highest to lowest, so a single merge suffices.
+  vector<float> log_scores(log_scores_);
+  std::sort(log_scores.begin(), log_scores.end(), greater<float>());
+  vector<float> scores(num_snapshot_scores_ + log_scores.size());
+  std::merge(snapshot_scores_, snapshot_scores_ + num_snapshot_scores_,
+             log_scores.begin(), log_scores.end(), scores.begin(),
+             greater<float>());
+
+  SnapshotHeader header;
+  memset(&header, 0, sizeof(header));
+  header.magic = kSnapshotMagic;
+  header.generation = generation_;
+  header.num_scores = scores.size();
+  header.scores_checksum = Crc32(scores.data(), scores.size() * sizeof(float));
+  header.header_checksum = ChecksumSnapshotHeader(header);
+
+  string temporary_path = GetSnapshotPath() + ".tmp";
+  FILE* file = fopen(temporary_path.c_str(), "wb");
+  if (file == nullptr) {
+    throw runtime_error("Could not create the score snapshot!");
+  }
+  bool written =
+      fwrite(&header, sizeof(header), 1, file) == 1 &&
+      fwrite(scores.data(), sizeof(float), scores.size(), file) ==
+          scores.size() &&
+      SyncFile(file);
+  fclose(file);
+
+  // The old snapshot must be unmapped before it can be replaced on Windows.
+  snapshot_.Close();
+  if (!written || !ReplaceFile(temporary_path, GetSnapshotPath())) {
+    remove(temporary_path.c_str());
+    // Remap the old snapshot, but keep appending to the current log, whose
+    // records must stay checksummed with its own generation.
+    uint32_t log_generation = generation_;
+    LoadSnapshot();
+    generation_ = log_generation;
+    throw runtime_error("Could not replace the score snapshot!");
+  }
+
+  // If we crash before the new log is started, the old log is recognized as
+  // already compacted by its generation.
+  LoadSnapshot();
+  StartLog();
+}
+
+float ScoreStore::GetHighScore() const {
+  float snapshot_high_score =
+      num_snapshot_scores_ > 0 ? snapshot_scores_[0] : 0;
+  return std::max(snapshot_high_score, log_high_score_);
+}
+
+size_t ScoreStore::GetNumScores() const {
+  return num_snapshot_scores_ + log_scores_.size();
+}
+
+const float* ScoreStore::GetSnapshotScores() const {
+  return snapshot_scores_;
+}
+
+size_t ScoreStore::GetNumSnapshotScores() const {
+  return num_snapshot_scores_;
+}
+
+const vector<float>& ScoreStore::GetLogScores() const {
+  return log_scores_;
+}
+
+const string ScoreStore::GetLogPath() const {
+  return path_prefix_ + ".log";
+}
+
+const string ScoreStore::GetSnapshotPath() const {
+  return path_prefix_ + ".snapshot";
+}
+
+void ScoreStore::LoadSnapshot() {
+  snapshot_scores_ = nullptr;
+  num_snapshot_scores_ = 0;
+  generation_ = 0;
+  if (!snapshot_.Open(GetSnapshotPath())) {
+    return;
+  }
+
+  const SnapshotHeader* header =
+      reinterpret_cast<const SnapshotHeader*>(snapshot_.GetData());
+  if (snapshot_.GetSize() < sizeof(SnapshotHeader) ||
+      header->magic != kSnapshotMagic ||
+      header->header_checksum != ChecksumSnapshotHeader(*header) ||
+      snapshot_.GetSize() !=
+          sizeof(SnapshotHeader) + header->num_scores * sizeof(float)) {
+    snapshot_.Close();
+    throw runtime_error("The score snapshot is corrupt!");
+  }
+  generation_ = header->generation;
+  num_snapshot_scores_ = static_cast<size_t>(header->num_scores);
+  snapshot_scores_ = reinterpret_cast<const float*>(snapshot_.GetData() +
+                                                    sizeof(SnapshotHeader));
+}
+
+void ScoreStore::ReplayLog() {
+  if (log_file_ != nullptr) {
+    fclose(log_file_);
+    log_file_ = nullptr;
+  }
+  log_scores_.clear();
+  log_high_score_ = 0;
+
+  FILE* file = fopen(GetLogPath().c_str(), "rb");
+  LogHeader header;
+  if (file == nullptr || fread(&header, sizeof(header), 1, file) != 1 ||
+      header.magic != kLogMagic || header.generation <= generation_) {
+    // There is no log newer than the snapshot, so start a fresh one.
+    if (file != nullptr) {
+      fclose(file);
+    }
+    StartLog();
+    return;
+  }
+
+  // Replay records until the end of the file or the first torn record.
+  LogRecord record;
+  while (fread(&record, sizeof(record), 1, file) == 1 &&
+         record.checksum == ChecksumRecord(header.generation, record.score)) {
+    log_scores_.push_back(record.score);
+    log_high_score_ = std::max(log_high_score_, record.score);
+  }
+  fclose(file);
+  generation_ = header.generation;
+
+  // Drop anything after the last good record so new records follow it.
+  long valid_size = static_cast<long>(sizeof(LogHeader) +
+                                      log_scores_.size() * sizeof(LogRecord));
+  if (!TruncateFile(GetLogPath(), valid_size)) {
+    throw runtime_error("Could not repair the score log!");
+  }
+  log_file_ = fopen(GetLogPath().c_str(), "ab");
+  if (log_file_ == nullptr) {
+    throw runtime_error("Could not open the score log!");
+  }
+}
+
+void ScoreStore::StartLog() {
+  if (log_file_ != nullptr) {
+    fclose(log_file_);
+  }
+  log_scores_.clear();
+  log_high_score_ = 0;
+  ++generation_;
+
+  LogHeader header = {kLogMagic, generation_};
+  log_file_ = fopen(GetLogPath().c_str(), "wb");
+  if (log_file_ == nullptr ||
+      fwrite(&header, sizeof(header), 1, log_file_) != 1 ||
+      !SyncFile(log_file_)) {
+    throw runtime_error("Could not create the score log!");
+  }
+}
+
+}  // namespace home_run_derby
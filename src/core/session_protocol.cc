@@ -0,0 +1,130 @@
+#include "core/session_protocol.h"
+
+#include <sstream>
+
+#include "core/spectator_protocol.h"
+#include "core/varint.h"
+
+namespace home_run_derby {
+
+namespace {
+
+size_t WritePosition(float position, uint8_t* buffer) {
+  return WriteVarint(
+      ToZigzag(static_cast<uint32_t>(QuantizePosition(position))), buffer);
+}
+
+bool ReadPosition(const uint8_t* data, size_t size, size_t* offset,
+                  float* position) {
+  uint32_t zigzag;
+  if (!ReadVarint(data, size, offset, &zigzag)) {
+    return false;
+  }
+  *position = DequantizePosition(static_cast<int32_t>(FromZigzag(zigzag)));
+  return true;
+}
+
+bool HasSession(SessionMessage type) {
+  return type != SessionMessage::kOpen && type != SessionMessage::kRejected;
+}
+
+}  // namespace
+
+size_t EncodeCommand(const SessionCommand& command, uint8_t* buffer) {
+  size_t size = 0;
+  buffer[size++] = static_cast<uint8_t>(command.type);
+  if (HasSession(command.type)) {
+    size += WriteVarint(command.session, buffer + size);
+  }
+  if (command.type == SessionMessage::kInput) {
+    size += WritePosition(command.bat_position.x, buffer + size);
+    size += WritePosition(command.bat_position.y, buffer + size);
+  }
+  return size;
+}
+
+bool DecodeCommand(const uint8_t* data, size_t size, SessionCommand* command) {
+  if (size == 0 || data[0] < static_cast<uint8_t>(SessionMessage::kOpen) ||
+      data[0] > static_cast<uint8_t>(SessionMessage::kRejected)) {
+    return false;
+  }
+  SessionCommand decoded;
+  decoded.type = static_cast<SessionMessage>(data[0]);
+  decoded.session = 0;
+  size_t offset = 1;
+  if (HasSession(decoded.type) &&
+      !ReadVarint(data, size, &offset, &decoded.session)) {
+    return false;
+  }
+  if (decoded.type == SessionMessage::kInput &&
+      (!ReadPosition(data, size, &offset, &decoded.bat_position.x) ||
+       !ReadPosition(data, size, &offset, &decoded.bat_position.y))) {
+    return false;
+  }
+  if (offset != size) {
+    return false;
+  }
+  *command = decoded;
+  return true;
+}
+
+size_t EncodeStatus(const SessionStatus& status, uint8_t* buffer) {
+  size_t size = 0;
+  buffer[size++] = static_cast<uint8_t>(SessionMessage::kStatus);
+  size += WriteVarint(status.session, buffer + size);
+  size += WriteVarint(status.tick, buffer + size);
+  size += WriteVarint(status.game_state, buffer + size);
+  size += WriteVarint(status.outs, buffer + size);
+  size += WriteVarint(status.score, buffer + size);
+  return size;
+}
+
+bool DecodeStatus(const uint8_t* data, size_t size, SessionStatus* status) {
+  size_t offset = 1;
+  SessionStatus decoded;
+  if (size == 0 || data[0] != static_cast<uint8_t>(SessionMessage::kStatus) ||
+      !ReadVarint(data, size, &offset, &decoded.session) ||
+      !ReadVarint(data, size, &offset, &decoded.tick) ||
+      !ReadVarint(data, size, &offset, &decoded.game_state) ||
+      !ReadVarint(data, size, &offset, &decoded.outs) ||
+      !ReadVarint(data, size, &offset, &decoded.score) || offset != size) {
+    return false;
+  }
+  *status = decoded;
+  return true;
+}
+
+bool ParseCommand(const string& text, SessionCommand* command) {
+  std::istringstream stream(text);
+  string name;
+  stream >> name;
+  SessionCommand parsed;
+  parsed.session = 0;
+  if (name == "open") {
+    parsed.type = SessionMessage::kOpen;
+  } else if (name == "start") {
+    parsed.type = SessionMessage::kStart;
+  } else if (name == "input") {
+    parsed.type = SessionMessage::kInput;
+  } else if (name == "close") {
+    parsed.type = SessionMessage::kClose;
+  } else {
+    return false;
+  }
+  if (HasSession(parsed.type) && !(stream >> parsed.session)) {
+    return false;
+  }
+  if (parsed.type == SessionMessage::kInput &&
+      !(stream >> parsed.bat_position.x >> parsed.bat_position.y)) {
+    return false;
+  }
+  // Nothing may follow the command.
+  string rest;
+  if (stream >> rest) {
+    return false;
+  }
+  *command = parsed;
+  return true;
+}
+
+}  // namespace home_run_derby
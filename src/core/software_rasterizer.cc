@@ -0,0 +1,551 @@
+#include "core/software_rasterizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HOME_RUN_DERBY_HAS_SSE2
+#endif
+
+namespace home_run_derby {
+
+using std::invalid_argument;
+
+namespace {
+
+/** The number of cells across a glyph, and down one. **/
+const size_t kGlyphWidth = 5;
+const size_t kGlyphHeight = 7;
+/** The number of cells from one glyph to the next. **/
+const size_t kGlyphAdvance = 6;
+/** The number of cells in the height of a line of text. **/
+const float kCellsPerLine = 10;
+const uint32_t kOpaque = 0xFF000000u;
+
+/**
+ * A character of the built-in font: its rows from the top, with the leftmost
+ * cell in the highest of the five low bits.
+ */
+struct Glyph {
+  char character;
+  uint8_t rows[kGlyphHeight];
+};
+
+const Glyph kGlyphs[] = {
+    {' ', {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+    {'0', {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E}},
+    {'1', {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E}},
+    {'2', {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F}},
+    {'3', {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E}},
+    {'4', {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02}},
+    {'5', {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E}},
+    {'6', {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E}},
+    {'7', {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08}},
+    {'8', {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E}},
+    {'9', {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C}},
+    {'A', {0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}},
+    {'B', {0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E}},
+    {'C', {0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E}},
+    {'D', {0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C}},
+    {'E', {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F}},
+    {'F', {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10}},
+    {'G', {0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F}},
+    {'H', {0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}},
+    {'I', {0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E}},
+    {'J', {0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C}},
+    {'K', {0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11}},
+    {'L', {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F}},
+    {'M', {0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11}},
+    {'N', {0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11}},
+    {'O', {0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}},
+    {'P', {0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10}},
+    {'Q', {0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D}},
+    {'R', {0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11}},
+    {'S', {0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E}},
+    {'T', {0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04}},
+    {'U', {0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}},
+    {'V', {0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04}},
+    {'W', {0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A}},
+    {'X', {0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11}},
+    {'Y', {0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04}},
+    {'Z', {0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F}},
+    {'.', {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C}},
+    {',', {0x00, 0x00, 0x00, 0x00, 0x0C, 0x04, 0x08}},
+    {':', {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00}},
+    {'-', {0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00}},
+    {'+', {0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00}},
+    {'/', {0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00}},
+    {'%', {0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03}},
+    {'(', {0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02}},
+    {')', {0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08}},
+    {'!', {0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04}},
+    {'?', {0x0E, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04}},
+    {'\'', {0x0C, 0x04, 0x08, 0x00, 0x00, 0x00, 0x00}},
+};
+
+/**
+ * Finds the glyph of each character drawn, or nullptr for those drawn as a
+ * question mark.
+ */
+class GlyphTable {
+ public:
+  GlyphTable() {
+    std::fill(glyphs_, glyphs_ + kNumCharacters, nullptr);
+    for (const Glyph& glyph : kGlyphs) {
+      glyphs_[static_cast<unsigned char>(glyph.character)] = &glyph;
+    }
+  }
+
+  const Glyph* Find(char character) const {
+    unsigned char index = static_cast<unsigned char>(character);
+    return index < kNumCharacters ? glyphs_[index] : nullptr;
+  }
+
+ private:
+  static const size_t kNumCharacters = 128;
+  const Glyph* glyphs_[kNumCharacters];
+};
+
+const GlyphTable& GetGlyphTable() {
+  static const GlyphTable table;
+  return table;
+}
+
+/**
+ * Gets the first pixel whose center is at or past an edge, within a range.
+ */
+long ToPixel(float edge, long low, long high) {
+  float pixel = std::ceil(edge - 0.5f);
+  if (!(pixel > static_cast<float>(low))) {
+    return low;
+  }
+  if (pixel >= static_cast<float>(high)) {
+    return high;
+  }
+  return static_cast<long>(pixel);
+}
+
+/**
+ * Blends one channel of a color over another: exactly (source * alpha +
+ * destination * (255 - alpha)) / 255, rounded.
+ */
+uint32_t BlendChannel(uint32_t source, uint32_t destination, uint32_t alpha) {
+  uint32_t blended = source * alpha + destination * (255 - alpha) + 128;
+  return (blended + (blended >> 8)) >> 8;
+}
+
+uint32_t BlendPixel(uint32_t source, uint32_t destination, uint32_t alpha) {
+  uint32_t pixel = 0;
+  for (int shift = 0; shift < 32; shift += 8) {
+    pixel |= BlendChannel((source >> shift) & 0xFF,
+                          (destination >> shift) & 0xFF, alpha)
+             << shift;
+  }
+  return pixel;
+}
+
+/**
+ * Fills pixels with a color, blending it over them if it is translucent.
+ */
+void FillSpan(uint32_t* pixels, size_t count, uint32_t color) {
+  uint32_t alpha = color >> 24;
+  if (alpha == 255) {
+    std::fill_n(pixels, count, color);
+    return;
+  }
+  // The color covers the pixel as its alpha says, so the pixel ends up as
+  // opaque as the two together.
+  uint32_t source = color | kOpaque;
+  size_t i = 0;
+#ifdef HOME_RUN_DERBY_HAS_SSE2
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i weighted_source = _mm_add_epi16(
+      _mm_mullo_epi16(_mm_unpacklo_epi8(
+                          _mm_set1_epi32(static_cast<int>(source)), zero),
+                      _mm_set1_epi16(static_cast<short>(alpha))),
+      _mm_set1_epi16(128));
+  const __m128i inverse_alpha = _mm_set1_epi16(static_cast<short>(255 - alpha));
+  for (; i + 4 <= count; i += 4) {
+    __m128i destination =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i));
+    // Two pixels in each half, a channel in each 16 bits, which cannot
+    // overflow: 255 * 255 + 128 + 254 is below 65536.
+    __m128i low = _mm_add_epi16(
+        _mm_mullo_epi16(_mm_unpacklo_epi8(destination, zero), inverse_alpha),
+        weighted_source);
+    __m128i high = _mm_add_epi16(
+        _mm_mullo_epi16(_mm_unpackhi_epi8(destination, zero), inverse_alpha),
+        weighted_source);
+    low = _mm_srli_epi16(_mm_add_epi16(low, _mm_srli_epi16(low, 8)), 8);
+    high = _mm_srli_epi16(_mm_add_epi16(high, _mm_srli_epi16(high, 8)), 8);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i),
+                     _mm_packus_epi16(low, high));
+  }
+#endif
+  for (; i < count; ++i) {
+    pixels[i] = BlendPixel(source, pixels[i], alpha);
+  }
+}
+
+/**
+ * The pixels a worker may draw in: its tile.
+ */
+struct Clip {
+  long min_x;
+  long min_y;
+  long max_x;
+  long max_y;
+};
+
+/**
+ * Fills the pixels of a row whose centers are between two edges.
+ */
+void FillRow(RasterImage* image, const Clip& clip, long y, float left,
+             float right, uint32_t color) {
+  long begin = ToPixel(left, clip.min_x, clip.max_x);
+  long end = ToPixel(right, clip.min_x, clip.max_x);
+  if (begin < end) {
+    FillSpan(image->GetRow(static_cast<size_t>(y)) + begin,
+             static_cast<size_t>(end - begin), color);
+  }
+}
+
+void RenderRect(const vec2& min_corner, const vec2& max_corner,
+                uint32_t color, const Clip& clip, RasterImage* image) {
+  long end = ToPixel(max_corner.y, clip.min_y, clip.max_y);
+  for (long y = ToPixel(min_corner.y, clip.min_y, clip.max_y); y < end; ++y) {
+    FillRow(image, clip, y, min_corner.x, max_corner.x, color);
+  }
+}
+
+void RenderCircle(const DrawList::Command& command, const Clip& clip,
+                  RasterImage* image) {
+  const vec2& center = command.start;
+  float radius_squared = command.size * command.size;
+  long end = ToPixel(command.max_bounds.y, clip.min_y, clip.max_y);
+  for (long y = ToPixel(command.min_bounds.y, clip.min_y, clip.max_y);
+       y < end; ++y) {
+    float rise = static_cast<float>(y) + 0.5f - center.y;
+    float half_width_squared = radius_squared - rise * rise;
+    if (half_width_squared > 0) {
+      float half_width = std::sqrt(half_width_squared);
+      FillRow(image, clip, y, center.x - half_width, center.x + half_width,
+              command.color);
+    }
+  }
+}
+
+void RenderLine(const DrawList::Command& command, const Clip& clip,
+                RasterImage* image) {
+  vec2 along = command.end - command.start;
+  vec2 across =
+      vec2(-along.y, along.x) * (command.size / 2 / glm::length(along));
+  // The line is a rectangle, which crosses each row between two of its edges.
+  const vec2 corners[] = {command.start + across, command.end + across,
+                          command.end - across, command.start - across};
+  long end = ToPixel(command.max_bounds.y, clip.min_y, clip.max_y);
+  for (long y = ToPixel(command.min_bounds.y, clip.min_y, clip.max_y);
+       y < end; ++y) {
+    float center_y = static_cast<float>(y) + 0.5f;
+    float left = command.max_bounds.x;
+    float right = command.min_bounds.x;
+    for (size_t i = 0; i < 4; ++i) {
+      const vec2& from = corners[i];
+      const vec2& to = corners[(i + 1) % 4];
+      if ((from.y <= center_y) != (to.y <= center_y)) {
+        float x = from.x + (center_y - from.y) * (to.x - from.x) /
+                               (to.y - from.y);
+        left = std::min(left, x);
+        right = std::max(right, x);
+      }
+    }
+    FillRow(image, clip, y, left, right, command.color);
+  }
+}
+
+void RenderText(const DrawList::Command& command, const string& text,
+                const Clip& clip, RasterImage* image) {
+  const GlyphTable& table = GetGlyphTable();
+  float cell = command.size;
+  for (size_t i = 0; i < command.text_length; ++i) {
+    const Glyph* glyph = table.Find(text[command.text_start + i]);
+    float left = command.start.x +
+                 static_cast<float>(i * kGlyphAdvance) * cell;
+    if (left >= static_cast<float>(clip.max_x) ||
+        left + kGlyphWidth * cell <= static_cast<float>(clip.min_x)) {
+      continue;
+    }
+    for (size_t row = 0; row < kGlyphHeight; ++row) {
+      float top = command.start.y + static_cast<float>(row) * cell;
+      uint8_t bits = glyph->rows[row];
+      // Fill each run of cells in the row at once.
+      size_t column = 0;
+      while (column < kGlyphWidth) {
+        if (!(bits & (0x10 >> column))) {
+          ++column;
+          continue;
+        }
+        size_t run_start = column;
+        while (column < kGlyphWidth && (bits & (0x10 >> column))) {
+          ++column;
+        }
+        RenderRect(vec2(left + static_cast<float>(run_start) * cell, top),
+                   vec2(left + static_cast<float>(column) * cell, top + cell),
+                   command.color, clip, image);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+const size_t DrawList::kReservedCommands;
+const size_t SoftwareRasterizer::kDefaultTileSize;
+
+uint32_t RasterImage::PackColor(const ColorA& color) {
+  const float channels[] = {color.r, color.g, color.b, color.a};
+  uint32_t pixel = 0;
+  for (size_t i = 0; i < 4; ++i) {
+    uint32_t value = 0;
+    if (channels[i] >= 1) {
+      value = 255;
+    } else if (channels[i] > 0) {
+      value = static_cast<uint32_t>(channels[i] * 255 + 0.5f);
+    }
+    pixel |= value << (8 * i);
+  }
+  return pixel;
+}
+
+RasterImage::RasterImage(size_t width, size_t height)
+    : width_(width), height_(height), pixels_(width * height, kOpaque) {
+  if (width == 0 || height == 0) {
+    throw invalid_argument("An image needs at least one pixel");
+  }
+}
+
+size_t RasterImage::GetWidth() const {
+  return width_;
+}
+
+size_t RasterImage::GetHeight() const {
+  return height_;
+}
+
+uint32_t RasterImage::GetPixel(size_t x, size_t y) const {
+  return pixels_[y * width_ + x];
+}
+
+const uint32_t* RasterImage::GetRow(size_t y) const {
+  return pixels_.data() + y * width_;
+}
+
+uint32_t* RasterImage::GetRow(size_t y) {
+  return pixels_.data() + y * width_;
+}
+
+DrawList::DrawList(float scale) : scale_(scale) {
+  if (!(scale > 0)) {
+    throw invalid_argument("A draw list's scale must be positive");
+  }
+  commands_.reserve(kReservedCommands);
+}
+
+void DrawList::Clear() {
+  commands_.clear();
+  text_.clear();
+}
+
+void DrawList::FillRect(const vec2& first_corner, const vec2& second_corner,
+                        const ColorA& color) {
+  Command command = Command();
+  command.shape = Shape::kRect;
+  command.min_bounds = glm::min(first_corner, second_corner) * scale_;
+  command.max_bounds = glm::max(first_corner, second_corner) * scale_;
+  command.start = command.min_bounds;
+  command.end = command.max_bounds;
+  command.color = RasterImage::PackColor(color);
+  Add(command);
+}
+
+void DrawList::FillCircle(const vec2& center, float radius,
+                          const ColorA& color) {
+  Command command = Command();
+  command.shape = Shape::kCircle;
+  command.start = center * scale_;
+  command.size = radius * scale_;
+  command.min_bounds = command.start - vec2(command.size, command.size);
+  command.max_bounds = command.start + vec2(command.size, command.size);
+  command.color = RasterImage::PackColor(color);
+  Add(command);
+}
+
+void DrawList::DrawLine(const vec2& start, const vec2& end, float width,
+                        const ColorA& color) {
+  // A line without a length has no direction to be drawn across.
+  if (start == end) {
+    return;
+  }
+  Command command = Command();
+  command.shape = Shape::kLine;
+  command.start = start * scale_;
+  command.end = end * scale_;
+  command.size = width * scale_;
+  // The ends are square, so the corners reach half the width out.
+  vec2 reach(command.size / 2, command.size / 2);
+  command.min_bounds = glm::min(command.start, command.end) - reach;
+  command.max_bounds = glm::max(command.start, command.end) + reach;
+  command.color = RasterImage::PackColor(color);
+  Add(command);
+}
+
+void DrawList::DrawText(const string& text, const vec2& position,
+                        float font_size, const ColorA& color) {
+  if (text.empty()) {
+    return;
+  }
+  Command command = Command();
+  command.shape = Shape::kText;
+  command.size = font_size * scale_ / kCellsPerLine;
+  float width =
+      static_cast<float>(text.size() * kGlyphAdvance - 1) * command.size;
+  command.start = position * scale_ - vec2(width / 2, 0);
+  command.min_bounds = command.start;
+  command.max_bounds =
+      command.start + vec2(width, kGlyphHeight * command.size);
+  command.color = RasterImage::PackColor(color);
+  command.text_start = text_.size();
+  command.text_length = text.size();
+  // Keep the characters as they will be drawn, so drawing only looks them
+  // up.
+  const GlyphTable& table = GetGlyphTable();
+  for (char character : text) {
+    if (character >= 'a' && character <= 'z') {
+      character = static_cast<char>(character - 'a' + 'A');
+    }
+    text_.push_back(table.Find(character) != nullptr ? character : '?');
+  }
+  Add(command);
+}
+
+const vector<DrawList::Command>& DrawList::GetCommands() const {
+  return commands_;
+}
+
+const string& DrawList::GetText() const {
+  return text_;
+}
+
+float DrawList::GetScale() const {
+  return scale_;
+}
+
+void DrawList::Add(const Command& command) {
+  if ((command.color >> 24) == 0 ||
+      !(command.min_bounds.x < command.max_bounds.x) ||
+      !(command.min_bounds.y < command.max_bounds.y)) {
+    // Drop any characters the command would have drawn.
+    if (command.shape == Shape::kText) {
+      text_.resize(command.text_start);
+    }
+    return;
+  }
+  commands_.push_back(command);
+}
+
+SoftwareRasterizer::SoftwareRasterizer(size_t num_workers, size_t tile_size)
+    : num_workers_(num_workers),
+      tile_size_(tile_size),
+      list_(nullptr),
+      image_(nullptr),
+      num_tile_columns_(0),
+      num_tiles_(0),
+      next_tile_(0) {
+  if (tile_size_ == 0) {
+    throw invalid_argument("Tiles need at least one pixel");
+  }
+  if (num_workers_ == 0) {
+    num_workers_ = std::max(1u, std::thread::hardware_concurrency());
+  }
+  // A single worker would only keep the calling thread waiting.
+  if (num_workers_ > 1) {
+    for (size_t i = 0; i < num_workers_; ++i) {
+      workers_.emplace_back(new StepWorker([this] { RenderTiles(); }));
+    }
+  }
+}
+
+void SoftwareRasterizer::Render(const DrawList& list, RasterImage* image) {
+  list_ = &list;
+  image_ = image;
+  num_tile_columns_ = (image->GetWidth() + tile_size_ - 1) / tile_size_;
+  num_tiles_ = num_tile_columns_ *
+               ((image->GetHeight() + tile_size_ - 1) / tile_size_);
+  next_tile_.store(0, std::memory_order_relaxed);
+  if (workers_.empty()) {
+    RenderTiles();
+  } else {
+    for (unique_ptr<StepWorker>& worker : workers_) {
+      worker->Post();
+    }
+    for (unique_ptr<StepWorker>& worker : workers_) {
+      worker->Join();
+    }
+  }
+  list_ = nullptr;
+  image_ = nullptr;
+}
+
+size_t SoftwareRasterizer::GetNumWorkers() const {
+  return num_workers_;
+}
+
+void SoftwareRasterizer::RenderTiles() {
+  size_t tile;
+  while ((tile = next_tile_.fetch_add(1, std::memory_order_relaxed)) <
+         num_tiles_) {
+    RenderTile(tile);
+  }
+}
+
+void SoftwareRasterizer::RenderTile(size_t tile) const {
+  size_t left = (tile % num_tile_columns_) * tile_size_;
+  size_t top = (tile / num_tile_columns_) * tile_size_;
+  Clip clip;
+  clip.min_x = static_cast<long>(left);
+  clip.min_y = static_cast<long>(top);
+  clip.max_x = static_cast<long>(std::min(left + tile_size_,
+                                          image_->GetWidth()));
+  clip.max_y = static_cast<long>(std::min(top + tile_size_,
+                                          image_->GetHeight()));
+
+  for (const DrawList::Command& command : list_->GetCommands()) {
+    // Most shapes are small, and most tiles are far from most of them.
+    if (command.max_bounds.x <= static_cast<float>(clip.min_x) ||
+        command.min_bounds.x >= static_cast<float>(clip.max_x) ||
+        command.max_bounds.y <= static_cast<float>(clip.min_y) ||
+        command.min_bounds.y >= static_cast<float>(clip.max_y)) {
+      continue;
+    }
+    switch (command.shape) {
+      case DrawList::Shape::kRect:
+        RenderRect(command.start, command.end, command.color, clip, image_);
+        break;
+      case DrawList::Shape::kCircle:
+        RenderCircle(command, clip, image_);
+        break;
+      case DrawList::Shape::kLine:
+        RenderLine(command, clip, image_);
+        break;
+      case DrawList::Shape::kText:
+        RenderText(command, list_->GetText(), clip, image_);
+        break;
+    }
+  }
+}
+
+}  // namespace home_run_derby
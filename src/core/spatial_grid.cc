@@ -0,0 +1,136 @@
+#include "core/spatial_grid.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace home_run_derby {
+
+namespace {
+
+// Keeps cell coordinates far from overflowing, wherever a point wanders.
+const float kMaxCell = 1.0e9f;
+
+}  // namespace
+
+const size_t SpatialGrid::kNone;
+
+SpatialGrid::SpatialGrid(float cell_size, size_t num_buckets)
+    : cell_size_(cell_size), num_relinks_(0) {
+  size_t num_heads = 1;
+  while (num_heads < num_buckets) {
+    num_heads *= 2;
+  }
+  heads_.assign(num_heads, kNone);
+}
+
+size_t SpatialGrid::Insert(const vec2& position) {
+  Entry entry = {position, GetCell(position.x), GetCell(position.y), kNone,
+                 kNone};
+  entries_.push_back(entry);
+  Link(entries_.size() - 1);
+  return entries_.size() - 1;
+}
+
+void SpatialGrid::Move(size_t id, const vec2& position) {
+  Entry& entry = entries_[id];
+  entry.position = position;
+  int32_t cell_x = GetCell(position.x);
+  int32_t cell_y = GetCell(position.y);
+  if (cell_x == entry.cell_x && cell_y == entry.cell_y) {
+    return;
+  }
+  Unlink(id);
+  entry.cell_x = cell_x;
+  entry.cell_y = cell_y;
+  Link(id);
+  ++num_relinks_;
+}
+
+void SpatialGrid::Query(const vec2& center, float radius,
+                        vector<size_t>* ids) const {
+  ids->clear();
+  float squared_radius = radius * radius;
+  int32_t min_x = GetCell(center.x - radius);
+  int32_t max_x = GetCell(center.x + radius);
+  int32_t min_y = GetCell(center.y - radius);
+  int32_t max_y = GetCell(center.y + radius);
+
+  // A search wider than the table would visit some buckets many times, so it
+  // is cheaper to check every point.
+  double num_cells = (static_cast<double>(max_x) - min_x + 1) *
+                     (static_cast<double>(max_y) - min_y + 1);
+  if (num_cells > static_cast<double>(heads_.size())) {
+    for (size_t id = 0; id < entries_.size(); ++id) {
+      vec2 offset = entries_[id].position - center;
+      if (glm::dot(offset, offset) <= squared_radius) {
+        ids->push_back(id);
+      }
+    }
+    return;
+  }
+
+  for (int32_t cell_x = min_x; cell_x <= max_x; ++cell_x) {
+    for (int32_t cell_y = min_y; cell_y <= max_y; ++cell_y) {
+      for (size_t id = heads_[GetBucket(cell_x, cell_y)]; id != kNone;
+           id = entries_[id].next) {
+        // Other cells share the bucket; skip them so no point is found twice.
+        const Entry& entry = entries_[id];
+        if (entry.cell_x != cell_x || entry.cell_y != cell_y) {
+          continue;
+        }
+        vec2 offset = entry.position - center;
+        if (glm::dot(offset, offset) <= squared_radius) {
+          ids->push_back(id);
+        }
+      }
+    }
+  }
+}
+
+const vec2& SpatialGrid::GetPosition(size_t id) const {
+  return entries_[id].position;
+}
+
+size_t SpatialGrid::GetNumPoints() const {
+  return entries_.size();
+}
+
+size_t SpatialGrid::GetNumRelinks() const {
+  return num_relinks_;
+}
+
+int32_t SpatialGrid::GetCell(float coordinate) const {
+  float cell = std::floor(coordinate / cell_size_);
+  return static_cast<int32_t>(std::max(-kMaxCell, std::min(kMaxCell, cell)));
+}
+
+size_t SpatialGrid::GetBucket(int32_t cell_x, int32_t cell_y) const {
+  uint32_t hash = static_cast<uint32_t>(cell_x) * 73856093u ^
+                  static_cast<uint32_t>(cell_y) * 19349663u;
+  return hash & (heads_.size() - 1);
+}
+
+void SpatialGrid::Link(size_t id) {
+  Entry& entry = entries_[id];
+  size_t& head = heads_[GetBucket(entry.cell_x, entry.cell_y)];
+  entry.previous = kNone;
+  entry.next = head;
+  if (head != kNone) {
+    entries_[head].previous = id;
+  }
+  head = id;
+}
+
+void SpatialGrid::Unlink(size_t id) {
+  Entry& entry = entries_[id];
+  if (entry.previous != kNone) {
+    entries_[entry.previous].next = entry.next;
+  } else {
+    heads_[GetBucket(entry.cell_x, entry.cell_y)] = entry.next;
+  }
+  if (entry.next != kNone) {
+    entries_[entry.next].previous = entry.previous;
+  }
+}
+
+}  // namespace home_run_derby
@@ -0,0 +1,123 @@
+#include "core/spectator_protocol.h"
+
+#include <cmath>
+
+#include "core/varint.h"
+
+namespace home_run_derby {
+
+int32_t QuantizePosition(float position) {
+  return static_cast<int32_t>(std::lround(position * kSpectatorPositionScale));
+}
+
+float DequantizePosition(int32_t position) {
+  return static_cast<float>(position) / kSpectatorPositionScale;
+}
+
+size_t EncodeFrame(const SpectatorFrame& frame,
+                   const SpectatorFrame* reference, uint8_t* buffer) {
+  size_t size = 0;
+  buffer[size++] = static_cast<uint8_t>(reference == nullptr
+                                            ? SpectatorMessage::kKeyframe
+                                            : SpectatorMessage::kDelta);
+  size += WriteVarint(frame.tick, buffer + size);
+  if (reference != nullptr) {
+    size += WriteVarint(frame.tick - reference->tick, buffer + size);
+  }
+  for (size_t field = 0; field < kNumSpectatorFields; ++field) {
+    uint32_t base = reference == nullptr
+                        ? 0
+                        : static_cast<uint32_t>(reference->values[field]);
+    size += WriteVarint(
+        ToZigzag(static_cast<uint32_t>(frame.values[field]) - base),
+        buffer + size);
+  }
+  return size;
+}
+
+size_t EncodeControl(SpectatorMessage type, uint32_t tick, uint8_t* buffer) {
+  size_t size = 0;
+  buffer[size++] = static_cast<uint8_t>(type);
+  if (type == SpectatorMessage::kAck) {
+    size += WriteVarint(tick, buffer + size);
+  }
+  return size;
+}
+
+bool ReadMessageType(const uint8_t* data, size_t size,
+                     SpectatorMessage* type) {
+  if (size == 0 ||
+      data[0] < static_cast<uint8_t>(SpectatorMessage::kKeyframe) ||
+      data[0] > static_cast<uint8_t>(SpectatorMessage::kLeave)) {
+    return false;
+  }
+  *type = static_cast<SpectatorMessage>(data[0]);
+  return true;
+}
+
+bool DecodeAck(const uint8_t* data, size_t size, uint32_t* tick) {
+  SpectatorMessage type;
+  size_t offset = 1;
+  return ReadMessageType(data, size, &type) &&
+         type == SpectatorMessage::kAck &&
+         ReadVarint(data, size, &offset, tick) && offset == size;
+}
+
+SpectatorDecoder::SpectatorDecoder() {
+  for (size_t i = 0; i < kSpectatorHistorySize; ++i) {
+    has_frame_[i] = false;
+  }
+}
+
+bool SpectatorDecoder::Decode(const uint8_t* data, size_t size,
+                              SpectatorFrame* frame) {
+  SpectatorMessage type;
+  if (!ReadMessageType(data, size, &type) ||
+      (type != SpectatorMessage::kKeyframe &&
+       type != SpectatorMessage::kDelta)) {
+    return false;
+  }
+  size_t offset = 1;
+  uint32_t tick;
+  if (!ReadVarint(data, size, &offset, &tick)) {
+    return false;
+  }
+
+  const SpectatorFrame* reference = nullptr;
+  if (type == SpectatorMessage::kDelta) {
+    uint32_t age;
+    if (!ReadVarint(data, size, &offset, &age)) {
+      return false;
+    }
+    uint32_t reference_tick = tick - age;
+    size_t slot = reference_tick % kSpectatorHistorySize;
+    if (!has_frame_[slot] || history_[slot].tick != reference_tick) {
+      return false;
+    }
+    reference = &history_[slot];
+  }
+
+  SpectatorFrame decoded;
+  decoded.tick = tick;
+  for (size_t field = 0; field < kNumSpectatorFields; ++field) {
+    uint32_t zigzag;
+    if (!ReadVarint(data, size, &offset, &zigzag)) {
+      return false;
+    }
+    uint32_t base = reference == nullptr
+                        ? 0
+                        : static_cast<uint32_t>(reference->values[field]);
+    decoded.values[field] = static_cast<int32_t>(base + FromZigzag(zigzag));
+  }
+  if (offset != size) {
+    return false;
+  }
+
+  size_t slot = tick % kSpectatorHistorySize;
+  history_[slot] = decoded;
+  has_frame_[slot] = true;
+  *frame = decoded;
+  return true;
+}
+
+}  // namespace home_run_derby
@@ -0,0 +1,290 @@
+#include "core/stadium.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace home_run_derby {
+
+using glm::dot;
+using glm::length;
+using glm::max;
+using glm::min;
+using std::runtime_error;
+
+namespace {
+
+/**
+ * Finds when a ball moving from start by move first touches a circle.
+ */
+bool SweepAgainstPoint(const vec2& start, const vec2& move, float radius,
+                       const vec2& point, float* time, vec2* normal) {
+  vec2 from_point = start - point;
+  float half_b = dot(from_point, move);
+  float c = dot(from_point, from_point) - radius * radius;
+  float a = dot(move, move);
+  if (a == 0 || c < 0 || half_b > 0) {
+    return false;
+  }
+  float discriminant = half_b * half_b - a * c;
+  if (discriminant < 0) {
+    return false;
+  }
+  float touch_time = (-half_b - std::sqrt(discriminant)) / a;
+  if (touch_time < 0 || touch_time > 1) {
+    return false;
+  }
+  *time = touch_time;
+  *normal = (start + touch_time * move - point) / radius;
+  return true;
+}
+
+/**
+ * Finds when a ball moving from start by move first touches a segment.
+ */
+bool SweepAgainstSegment(const vec2& start, const vec2& move, float radius,
+                         const Segment& segment, float* time, vec2* normal) {
+  vec2 along = segment.end - segment.start;
+  float squared_length = dot(along, along);
+  float projection =
+      squared_length > 0
+          ? glm::clamp(dot(start - segment.start, along) / squared_length,
+                       0.0f, 1.0f)
+          : 0.0f;
+  vec2 closest = segment.start + projection * along;
+  vec2 from_closest = start - closest;
+
+  // A ball already touching only hits if it is moving further in.
+  if (dot(from_closest, from_closest) <= radius * radius) {
+    if (dot(from_closest, from_closest) == 0 || dot(move, from_closest) >= 0) {
+      return false;
+    }
+    *time = 0;
+    *normal = from_closest / length(from_closest);
+    return true;
+  }
+
+  bool has_hit = false;
+  float best_time = 2;
+  vec2 best_normal;
+
+  // The flat side of the segment facing the ball.
+  if (squared_length > 0) {
+    vec2 side_normal = vec2(-along.y, along.x) / std::sqrt(squared_length);
+    float distance = dot(start - segment.start, side_normal);
+    if (distance < 0) {
+      side_normal = -side_normal;
+      distance = -distance;
+    }
+    float approach_speed = dot(move, side_normal);
+    if (approach_speed < 0) {
+      float touch_time = (radius - distance) / approach_speed;
+      vec2 touch_position = start + touch_time * move;
+      float touch_projection =
+          dot(touch_position - segment.start, along) / squared_length;
+      if (touch_time >= 0 && touch_time <= 1 && touch_projection >= 0 &&
+          touch_projection <= 1) {
+        has_hit = true;
+        best_time = touch_time;
+        best_normal = side_normal;
+      }
+    }
+  }
+
+  // The rounded ends.
+  float end_time;
+  vec2 end_normal;
+  if (SweepAgainstPoint(start, move, radius, segment.start, &end_time,
+                        &end_normal) &&
+      end_time < best_time) {
+    has_hit = true;
+    best_time = end_time;
+    best_normal = end_normal;
+  }
+  if (SweepAgainstPoint(start, move, radius, segment.end, &end_time,
+                        &end_normal) &&
+      end_time < best_time) {
+    has_hit = true;
+    best_time = end_time;
+    best_normal = end_normal;
+  }
+
+  if (has_hit) {
+    *time = best_time;
+    *normal = best_normal;
+  }
+  return has_hit;
+}
+
+bool ParseType(const string& name, SurfaceType* type) {
+  if (name == "terrain") {
+    *type = SurfaceType::kTerrain;
+  } else if (name == "wall") {
+    *type = SurfaceType::kWall;
+  } else if (name == "fence") {
+    *type = SurfaceType::kFence;
+  } else if (name == "pole") {
+    *type = SurfaceType::kFoulPole;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+Stadium::Stadium(const vector<Segment>& segments) : segments_(segments) {
+  for (const Segment& segment : segments_) {
+    if (segment.type == SurfaceType::kFence) {
+      // The ball has to clear the higher end, which has the smaller y.
+      const vec2& top =
+          segment.start.y < segment.end.y ? segment.start : segment.end;
+      Fence fence = {top.x, top.y};
+      fences_.push_back(fence);
+    }
+  }
+  if (!segments_.empty()) {
+    nodes_.reserve(2 * segments_.size() / kMaxLeafSegments + 1);
+    BuildNode(0, segments_.size(), 0);
+  }
+}
+
+Stadium Stadium::Load(const string& path) {
+  std::ifstream input(path);
+  if (!input) {
+    throw runtime_error("Could not open the stadium layout " + path);
+  }
+  return Parse(input);
+}
+
+Stadium Stadium::Parse(std::istream& input) {
+  vector<Segment> segments;
+  string line;
+  for (size_t line_number = 1; std::getline(input, line); ++line_number) {
+    std::istringstream fields(line.substr(0, line.find('#')));
+    string type_name;
+    if (!(fields >> type_name)) {
+      continue;
+    }
+    Segment segment;
+    string trailing;
+    if (!ParseType(type_name, &segment.type) ||
+        !(fields >> segment.start.x >> segment.start.y >> segment.end.x >>
+          segment.end.y) ||
+        (fields >> trailing)) {
+      throw runtime_error("Malformed stadium segment on line " +
+                          std::to_string(line_number));
+    }
+    segments.push_back(segment);
+  }
+  return Stadium(segments);
+}
+
+bool Stadium::SweepCircle(const vec2& start, const vec2& end, float radius,
+                          SweepHit* hit) const {
+  if (nodes_.empty()) {
+    return false;
+  }
+  vec2 move = end - start;
+  vec2 sweep_min = min(start, end) - vec2(radius, radius);
+  vec2 sweep_max = max(start, end) + vec2(radius, radius);
+
+  bool has_hit = false;
+  hit->time = 2;
+  uint32_t stack[kMaxDepth];
+  size_t stack_size = 0;
+  stack[stack_size++] = 0;
+  while (stack_size > 0) {
+    uint32_t index = stack[--stack_size];
+    const Node& node = nodes_[index];
+    if (node.min.x > sweep_max.x || node.max.x < sweep_min.x ||
+        node.min.y > sweep_max.y || node.max.y < sweep_min.y) {
+      continue;
+    }
+    if (node.num_segments > 0) {
+      for (uint32_t i = node.first_segment;
+           i < node.first_segment + node.num_segments; ++i) {
+        float time;
+        vec2 normal;
+        if (SweepAgainstSegment(start, move, radius, segments_[i], &time,
+                                &normal) &&
+            time < hit->time) {
+          has_hit = true;
+          hit->time = time;
+          hit->normal = normal;
+          hit->segment = i;
+        }
+      }
+    } else {
+      stack[stack_size++] = node.second_child;
+      stack[stack_size++] = index + 1;
+    }
+  }
+  return has_hit;
+}
+
+bool Stadium::ClearsFence(const vec2& start, const vec2& end,
+                          float radius) const {
+  for (const Fence& fence : fences_) {
+    if (start.x > fence.x && end.x <= fence.x) {
+      float fraction = (start.x - fence.x) / (start.x - end.x);
+      float crossing_y = start.y + fraction * (end.y - start.y);
+      if (crossing_y + radius < fence.top) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+const vector<Segment>& Stadium::GetSegments() const {
+  return segments_;
+}
+
+size_t Stadium::GetNumNodes() const {
+  return nodes_.size();
+}
+
+void Stadium::BuildNode(size_t first_segment, size_t num_segments,
+                        size_t depth) {
+  size_t index = nodes_.size();
+  nodes_.push_back(Node());
+  vec2 bounds_min = segments_[first_segment].start;
+  vec2 bounds_max = bounds_min;
+  for (size_t i = first_segment; i < first_segment + num_segments; ++i) {
+    bounds_min = min(bounds_min, min(segments_[i].start, segments_[i].end));
+    bounds_max = max(bounds_max, max(segments_[i].start, segments_[i].end));
+  }
+  nodes_[index].min = bounds_min;
+  nodes_[index].max = bounds_max;
+
+  // The stack used by queries bounds the depth; a median split never gets
+  // close, but a leaf is always a safe place to stop.
+  if (num_segments <= kMaxLeafSegments || depth + 2 >= kMaxDepth) {
+    nodes_[index].first_segment = static_cast<uint32_t>(first_segment);
+    nodes_[index].num_segments = static_cast<uint32_t>(num_segments);
+    nodes_[index].second_child = 0;
+    return;
+  }
+
+  // Split at the median segment along the longer side of the box.
+  int axis = bounds_max.x - bounds_min.x >= bounds_max.y - bounds_min.y
+                    ? 0
+                    : 1;
+  vector<Segment>::iterator first = segments_.begin() + first_segment;
+  size_t num_first = num_segments / 2;
+  std::nth_element(first, first + num_first, first + num_segments,
+                   [axis](const Segment& left, const Segment& right) {
+                     return left.start[axis] + left.end[axis] <
+                            right.start[axis] + right.end[axis];
+                   });
+  nodes_[index].first_segment = 0;
+  nodes_[index].num_segments = 0;
+  BuildNode(first_segment, num_first, depth + 1);
+  nodes_[index].second_child = static_cast<uint32_t>(nodes_.size());
+  BuildNode(first_segment + num_first, num_segments - num_first, depth + 1);
+}
+
+}  // namespace home_run_derby
@@ -0,0 +1,74 @@
+#include "core/step_worker.h"
+
+#include <stdexcept>
+
+namespace home_run_derby {
+
+using std::mutex;
+using std::unique_lock;
+
+StepWorker::StepWorker(const std::function<void()>& step)
+    : step_(step),
+      is_posted_(false),
+      is_running_(false),
+      is_stopping_(false) {
+  // Start the thread last, once everything it reads is initialized.
+  thread_ = std::thread(&StepWorker::Run, this);
+}
+
+StepWorker::~StepWorker() {
+  {
+    unique_lock<mutex> lock(mutex_);
+    condition_.wait(lock, [this] { return !is_posted_ && !is_running_; });
+    is_stopping_ = true;
+  }
+  condition_.notify_all();
+  thread_.join();
+}
+
+void StepWorker::Post() {
+  {
+    unique_lock<mutex> lock(mutex_);
+    if (is_posted_ || is_running_) {
+      throw std::logic_error("A step was posted before the last was joined");
+    }
+    is_posted_ = true;
+  }
+  condition_.notify_all();
+}
+
+void StepWorker::Join() {
+  unique_lock<mutex> lock(mutex_);
+  condition_.wait(lock, [this] { return !is_posted_ && !is_running_; });
+  if (error_) {
+    std::exception_ptr error = error_;
+    error_ = nullptr;
+    std::rethrow_exception(error);
+  }
+}
+
+void StepWorker::Run() {
+  unique_lock<mutex> lock(mutex_);
+  while (true) {
+    condition_.wait(lock, [this] { return is_posted_ || is_stopping_; });
+    if (is_stopping_) {
+      return;
+    }
+    is_posted_ = false;
+    is_running_ = true;
+    lock.unlock();
+    // The step may throw, which is handed to whoever joins it.
+    std::exception_ptr error;
+    try {
+      step_();
+    } catch (...) {
+      error = std::current_exception();
+    }
+    lock.lock();
+    error_ = error;
+    is_running_ = false;
+    condition_.notify_all();
+  }
+}
+
+}  // namespace home_run_derby
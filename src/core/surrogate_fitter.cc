@@ -0,0 +1,205 @@
+#include "core/surrogate_fitter.h"
+
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <utility>
+
+#include "core/flight.h"
+
+namespace home_run_derby {
+
+using glm::clamp;
+using std::invalid_argument;
+using std::runtime_error;
+
+namespace {
+
+const float kPi = 3.14159265358979f;
+
+// Keeps the normal equations solvable when a term barely varies over the
+// samples, relative to the size of the equations.
+const double kRidgeFraction = 1e-12;
+
+float DotTerms(const float* coefficients, const float* terms) {
+  float sum = 0;
+  for (size_t i = 0; i < DistanceSurrogate::kNumTerms; ++i) {
+    sum += coefficients[i] * terms[i];
+  }
+  return sum;
+}
+
+}  // namespace
+
+SurrogateFitter::SurrogateFitter(const SwingLimits& limits,
+                                 float ground_location, float gravity)
+    : limits_(limits), ground_location_(ground_location), gravity_(gravity) {
+}
+
+void SurrogateFitter::AddSample(float height, const vec2& exit_velocity,
+                                float travel) {
+  if (!(exit_velocity.x < 0)) {
+    throw invalid_argument("A sampled hit must leave the bat heading left!");
+  }
+  Sample sample = {height, exit_velocity, travel};
+  samples_.push_back(sample);
+}
+
+size_t SurrogateFitter::SampleContacts(const Ball& pitch, const Bat& bat,
+                                       size_t num_contacts, unsigned seed) {
+  float reach = pitch.GetRadius() + bat.GetBatRadius();
+
+  // Only the ticks on which the ball passes within reach of the bat's limits
+  // can produce a contact.
+  vector<Ball> reachable_pitches;
+  Ball ball(pitch);
+  for (size_t tick = 0; tick < limits_.flight.max_ticks &&
+                        ball.GetPosition().x < limits_.flight.right_edge;
+       ++tick) {
+    vec2 nearest = clamp(ball.GetPosition(), limits_.min_bat_position,
+                         limits_.max_bat_position);
+    if (glm::length(nearest - ball.GetPosition()) <= reach) {
+      reachable_pitches.push_back(ball);
+    }
+    ball.UpdateStates();
+  }
+  if (reachable_pitches.empty()) {
+    return 0;
+  }
+
+  std::mt19937 generator(seed);
+  std::uniform_int_distribution<size_t> pick_tick(0,
+                                                  reachable_pitches.size() - 1);
+  std::uniform_real_distribution<float> uniform(0, 1);
+  size_t num_added = 0;
+  size_t max_attempts = 20 * num_contacts + 100;
+  for (size_t attempt = 0; attempt < max_attempts && num_added < num_contacts;
+       ++attempt) {
+    Ball contact_ball(reachable_pitches[pick_tick(generator)]);
+
+    // Aim anywhere within reach of the ball, swinging from the right.
+    float offset_angle = 2 * kPi * uniform(generator);
+    float offset_length = reach * std::sqrt(uniform(generator));
+    float swing_angle = kPi / 2 + kPi * uniform(generator);
+    float swing_speed = limits_.max_bat_speed * uniform(generator);
+
+    Bat swing_bat(bat);
+    swing_bat.SetBatPosition(
+        clamp(contact_ball.GetPosition() +
+                  offset_length *
+                      vec2(std::cos(offset_angle), std::sin(offset_angle)),
+              limits_.min_bat_position, limits_.max_bat_position));
+    swing_bat.SetBatSpeed(swing_speed *
+                          vec2(std::cos(swing_angle), std::sin(swing_angle)));
+    contact_ball.HandleBatCollisions(swing_bat);
+    if (!contact_ball.HasCollided() || !(contact_ball.GetSpeed().x < 0)) {
+      continue;
+    }
+
+    AddSample(ground_location_ - contact_ball.GetRadius() -
+                  contact_ball.GetPosition().y,
+              contact_ball.GetSpeed(),
+              SimulateTravel(contact_ball, limits_.flight));
+    ++num_added;
+  }
+  return num_added;
+}
+
+SurrogateFit SurrogateFitter::Fit() const {
+  if (samples_.size() < DistanceSurrogate::kNumTerms) {
+    throw runtime_error("Too few samples to fit the surrogate!");
+  }
+  SurrogateFit fit;
+  fit.num_samples = samples_.size();
+
+  // The model predicts travel per unit of exit x-speed.
+  vector<double> targets(samples_.size());
+  for (size_t i = 0; i < samples_.size(); ++i) {
+    targets[i] = samples_[i].travel / -samples_[i].exit_velocity.x;
+  }
+  SolveLeastSquares(targets, fit.mean_coefficients);
+
+  // The error model is fitted to how far off the first one is.
+  float terms[DistanceSurrogate::kNumTerms];
+  double squared_error = 0;
+  for (size_t i = 0; i < samples_.size(); ++i) {
+    DistanceSurrogate::ComputeTerms(samples_[i].height,
+                                    samples_[i].exit_velocity, gravity_,
+                                    terms);
+    double residual = targets[i] - DotTerms(fit.mean_coefficients, terms);
+    double travel_error = residual * -samples_[i].exit_velocity.x;
+    squared_error += travel_error * travel_error;
+    targets[i] = std::abs(residual);
+  }
+  SolveLeastSquares(targets, fit.error_coefficients);
+  fit.rms_error = static_cast<float>(
+      std::sqrt(squared_error / static_cast<double>(samples_.size())));
+  return fit;
+}
+
+size_t SurrogateFitter::GetNumSamples() const {
+  return samples_.size();
+}
+
+void SurrogateFitter::SolveLeastSquares(const vector<double>& targets,
+                                        float* coefficients) const {
+  const size_t kNumTerms = DistanceSurrogate::kNumTerms;
+
+  // Accumulate the normal equations, with the right-hand side as the last
+  // column.
+  double equations[kNumTerms][kNumTerms + 1] = {};
+  float terms[kNumTerms];
+  for (size_t i = 0; i < samples_.size(); ++i) {
+    DistanceSurrogate::ComputeTerms(samples_[i].height,
+                                    samples_[i].exit_velocity, gravity_,
+                                    terms);
+    for (size_t row = 0; row < kNumTerms; ++row) {
+      for (size_t column = 0; column < kNumTerms; ++column) {
+        equations[row][column] +=
+            static_cast<double>(terms[row]) * terms[column];
+      }
+      equations[row][kNumTerms] += terms[row] * targets[i];
+    }
+  }
+  double trace = 0;
+  for (size_t row = 0; row < kNumTerms; ++row) {
+    trace += equations[row][row];
+  }
+  for (size_t row = 0; row < kNumTerms; ++row) {
+    equations[row][row] += kRidgeFraction * trace;
+  }
+
+  // Gaussian elimination with partial pivoting, then back substitution.
+  for (size_t pivot = 0; pivot < kNumTerms; ++pivot) {
+    size_t best_row = pivot;
+    for (size_t row = pivot + 1; row < kNumTerms; ++row) {
+      if (std::abs(equations[row][pivot]) >
+          std::abs(equations[best_row][pivot])) {
+        best_row = row;
+      }
+    }
+    if (equations[best_row][pivot] == 0) {
+      throw runtime_error("The surrogate samples do not determine a fit!");
+    }
+    for (size_t column = 0; column <= kNumTerms; ++column) {
+      std::swap(equations[pivot][column], equations[best_row][column]);
+    }
+    for (size_t row = pivot + 1; row < kNumTerms; ++row) {
+      double factor = equations[row][pivot] / equations[pivot][pivot];
+      for (size_t column = pivot; column <= kNumTerms; ++column) {
+        equations[row][column] -= factor * equations[pivot][column];
+      }
+    }
+  }
+  double solution[kNumTerms];
+  for (size_t row = kNumTerms; row-- > 0;) {
+    double value = equations[row][kNumTerms];
+    for (size_t column = row + 1; column < kNumTerms; ++column) {
+      value -= equations[row][column] * solution[column];
+    }
+    solution[row] = value / equations[row][row];
+    coefficients[row] = static_cast<float>(solution[row]);
+  }
+}
+
+}  // namespace home_run_derby
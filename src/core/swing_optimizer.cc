@@ -0,0 +1,319 @@
+#include "core/swing_optimizer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <limits>
+#include <random>
+#include <thread>
+
+namespace home_run_derby {
+
+using glm::clamp;
+using glm::dot;
+using glm::length;
+using std::chrono::duration;
+using std::chrono::steady_clock;
+
+namespace {
+
+// The smallest spread a search keeps, relative to its starting spread, before
+// it restarts somewhere new.
+const float kRestartDeviationFraction = 0.02f;
+
+float DistanceToSegment(const vec2& point, const vec2& start,
+                        const vec2& end) {
+  vec2 segment = end - start;
+  float squared_length = dot(segment, segment);
+  if (squared_length == 0) {
+    return length(point - start);
+  }
+  float t = clamp(dot(point - start, segment) / squared_length, 0.0f, 1.0f);
+  return length(point - (start + t * segment));
+}
+
+FlightLimits MakeSearchFlight(const FlightLimits& flight,
+                              size_t max_search_ticks) {
+  FlightLimits search_flight = flight;
+  search_flight.max_ticks = std::min(flight.max_ticks, max_search_ticks);
+  return search_flight;
+}
+
+}  // namespace
+
+const size_t SwingOptimizer::kMaxSearchFlightTicks;
+constexpr float SwingOptimizer::kOutcomeCacheResolution;
+
+SwingOptimizer::SwingOptimizer(const SwingLimits& limits, size_t num_threads)
+    : limits_(limits),
+      num_threads_(num_threads),
+      search_flight_(MakeSearchFlight(limits.flight, kMaxSearchFlightTicks)),
+      outcome_cache_(kOutcomeCacheCapacity, kOutcomeCacheResolution,
+                     kOutcomeCacheResolution, search_flight_),
+      pitch_(nullptr),
+      bat_(nullptr),
+      num_evaluations_(0),
+      seed_(0),
+      search_cache_(nullptr) {
+  if (num_threads_ == 0) {
+    num_threads_ = std::max(1u, std::thread::hardware_concurrency());
+  }
+  trajectory_.reserve(limits_.flight.max_ticks + 1);
+  best_swings_.resize(num_threads_);
+  // The caller's thread runs the last search.
+  for (size_t i = 0; i + 1 < num_threads_; ++i) {
+    workers_.emplace_back(new StepWorker([this, i] { Search(i); }));
+  }
+}
+
+Swing SwingOptimizer::FindBestSwing(const Ball& pitch, const Bat& bat,
+                                    double budget_seconds, unsigned seed) {
+  steady_clock::time_point deadline =
+      steady_clock::now() + std::chrono::duration_cast<steady_clock::duration>(
+                                duration<double>(budget_seconds));
+  return RunSearches(pitch, bat, deadline,
+                     std::numeric_limits<size_t>::max(), seed, true);
+}
+
+Swing SwingOptimizer::FindBestSwingWithEvaluations(const Ball& pitch,
+                                                   const Bat& bat,
+                                                   size_t num_evaluations,
+                                                   unsigned seed) {
+  return RunSearches(pitch, bat, steady_clock::time_point::max(),
+                     num_evaluations, seed, false);
+}
+
+float SwingOptimizer::EvaluateSwing(const Ball& pitch, const Bat& bat,
+                                    const Swing& swing) const {
+  return SimulateSwing(pitch, bat, swing, limits_.flight, nullptr);
+}
+
+const OutcomeCache& SwingOptimizer::GetOutcomeCache() const {
+  return outcome_cache_;
+}
+
+Swing SwingOptimizer::RunSearches(const Ball& pitch, const Bat& bat,
+                                  steady_clock::time_point deadline,
+                                  size_t num_evaluations, unsigned seed,
+                                  bool use_cache) {
+  // Until something hits, the best swing is to keep the bat out of the way.
+  Swing best_swing = {0, limits_.max_bat_position, limits_.max_bat_position,
+                      0};
+  TracePitch(pitch);
+  if (trajectory_.size() < 2) {
+    return best_swing;
+  }
+
+  pitch_ = &pitch;
+  bat_ = &bat;
+  deadline_ = deadline;
+  num_evaluations_ = num_evaluations;
+  seed_ = seed;
+  search_cache_ = use_cache ? &outcome_cache_ : nullptr;
+  for (Swing& swing : best_swings_) {
+    swing = best_swing;
+  }
+  for (unique_ptr<StepWorker>& worker : workers_) {
+    worker->Post();
+  }
+  // Every worker is joined before anything is rethrown, so none is left
+  // running on a pitch that has gone.
+  std::exception_ptr error;
+  try {
+    Search(num_threads_ - 1);
+  } catch (...) {
+    error = std::current_exception();
+  }
+  for (unique_ptr<StepWorker>& worker : workers_) {
+    try {
+      worker->Join();
+    } catch (...) {
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+  pitch_ = nullptr;
+  bat_ = nullptr;
+  if (error) {
+    std::rethrow_exception(error);
+  }
+
+  for (const Swing& swing : best_swings_) {
+    if (swing.distance > best_swing.distance) {
+      best_swing = swing;
+    }
+  }
+  return best_swing;
+}
+
+void SwingOptimizer::Search(size_t index) {
+  const Ball& pitch = *pitch_;
+  const Bat& bat = *bat_;
+  Swing* best_swing = &best_swings_[index];
+  std::mt19937 generator(seed_ + static_cast<unsigned>(index));
+  std::normal_distribution<float> normal(0, 1);
+  std::uniform_real_distribution<float> uniform(0, 1);
+
+  // Parameters: contact tick, bat offset from the ball at contact (x, y), and
+  // bat velocity at contact (x, y). Hitting the ball left means coming at it
+  // from the right, so the search starts there.
+  float reach = pitch.GetRadius() + bat.GetBatRadius();
+  float last_tick = static_cast<float>(trajectory_.size() - 1);
+  const float initial_deviation[kNumParameters] = {
+      last_tick / 4, reach, reach, limits_.max_bat_speed / 2,
+      limits_.max_bat_speed / 2};
+  float mean[kNumParameters];
+  float deviation[kNumParameters];
+  bool needs_restart = true;
+
+  float samples[kPopulationSize][kNumParameters];
+  float fitness[kPopulationSize];
+  size_t ranking[kPopulationSize];
+  size_t num_evaluations = 0;
+
+  while (true) {
+    if (needs_restart) {
+      mean[0] = uniform(generator) * last_tick;
+      mean[1] = reach / 2;
+      mean[2] = 0;
+      mean[3] = -limits_.max_bat_speed / 2;
+      mean[4] = 0;
+      std::copy(initial_deviation, initial_deviation + kNumParameters,
+                deviation);
+      needs_restart = false;
+    }
+
+    for (size_t i = 0; i < kPopulationSize; ++i) {
+      // A single candidate is cheap, so the budget is checked before each one
+      // rather than once a round.
+      if (num_evaluations == num_evaluations_ ||
+          steady_clock::now() >= deadline_) {
+        return;
+      }
+      ++num_evaluations;
+      for (size_t j = 0; j < kNumParameters; ++j) {
+        samples[i][j] = mean[j] + deviation[j] * normal(generator);
+      }
+      Swing swing = MakeSwing(samples[i]);
+
+      // A swing that cannot reach the ball is a miss; rank it by how close it
+      // came so the search is pulled towards contact.
+      float gap = DistanceToSegment(trajectory_[swing.contact_tick],
+                                    swing.start_position,
+                                    swing.end_position) -
+                  reach;
+      if (gap > 0) {
+        fitness[i] = -gap;
+        continue;
+      }
+      swing.distance =
+          SimulateSwing(pitch, bat, swing, search_flight_, search_cache_);
+      fitness[i] = swing.distance;
+      if (swing.distance > best_swing->distance) {
+        *best_swing = swing;
+      }
+    }
+
+    // Refit the sampling distribution to the best swings of this round.
+    for (size_t i = 0; i < kPopulationSize; ++i) {
+      ranking[i] = i;
+    }
+    std::partial_sort(ranking, ranking + kNumElites, ranking + kPopulationSize,
+                      [&fitness](size_t first, size_t second) {
+                        return fitness[first] > fitness[second];
+                      });
+    needs_restart = true;
+    for (size_t j = 0; j < kNumParameters; ++j) {
+      float elite_mean = 0;
+      for (size_t i = 0; i < kNumElites; ++i) {
+        elite_mean += samples[ranking[i]][j];
+      }
+      elite_mean /= kNumElites;
+      float variance = 0;
+      for (size_t i = 0; i < kNumElites; ++i) {
+        float difference = samples[ranking[i]][j] - elite_mean;
+        variance += difference * difference;
+      }
+      mean[j] = elite_mean;
+      deviation[j] = std::sqrt(variance / kNumElites);
+      if (deviation[j] > kRestartDeviationFraction * initial_deviation[j]) {
+        needs_restart = false;
+      }
+    }
+  }
+}
+
+Swing SwingOptimizer::MakeSwing(const float* parameters) const {
+  Swing swing;
+  float last_tick = static_cast<float>(trajectory_.size() - 1);
+  swing.contact_tick =
+      static_cast<size_t>(clamp(std::round(parameters[0]), 1.0f, last_tick));
+  swing.end_position = clamp(
+      trajectory_[swing.contact_tick] + vec2(parameters[1], parameters[2]),
+      limits_.min_bat_position, limits_.max_bat_position);
+
+  vec2 velocity(parameters[3], parameters[4]);
+  if (length(velocity) > limits_.max_bat_speed) {
+    velocity *= limits_.max_bat_speed / length(velocity);
+  }
+  swing.start_position = clamp(swing.end_position - velocity,
+                               limits_.min_bat_position,
+                               limits_.max_bat_position);
+  swing.distance = 0;
+  return swing;
+}
+
+void SwingOptimizer::TracePitch(const Ball& pitch) {
+  // The trajectory has room for the longest pitch, so this never allocates.
+  Ball ball(pitch);
+  trajectory_.assign(1, ball.GetPosition());
+  while (trajectory_.size() <= limits_.flight.max_ticks &&
+         ball.GetPosition().x < limits_.flight.right_edge &&
+         std::abs(ball.GetSpeed().x) > limits_.flight.stopped_speed) {
+    ball.UpdateStates();
+    trajectory_.push_back(ball.GetPosition());
+  }
+}
+
+float SwingOptimizer::SimulateSwing(const Ball& pitch, const Bat& bat,
+                                    const Swing& swing,
+                                    const FlightLimits& flight,
+                                    OutcomeCache* cache) const {
+  // Play the pitch out tick by tick in the same order as the simulator, until
+  // the swing has either made contact or missed.
+  Ball ball(pitch);
+  Bat swing_bat(bat);
+  swing_bat.SetBatPosition(swing.start_position);
+  swing_bat.SetBatSpeed(vec2(0, 0));
+  // A swing is a single step a tick, whatever path the bat was on.
+  swing_bat.ClearWaypoints();
+
+  for (size_t tick = 1; tick <= swing.contact_tick; ++tick) {
+    ball.UpdateStates();
+    if (tick == swing.contact_tick) {
+      swing_bat.SetBatSpeed(swing.end_position - swing.start_position);
+      swing_bat.SetBatPosition(swing.end_position);
+      if (cache != nullptr) {
+        // The contact and the flight after it come from the cache. Contact
+        // only changes the ball's speed, so the checks below still apply.
+        ContactOutcome outcome = cache->Resolve(ball, swing_bat);
+        if (ball.GetPosition().x >= limits_.flight.right_edge ||
+            std::abs(outcome.exit_velocity.x) <=
+                limits_.flight.stopped_speed) {
+          return 0;
+        }
+        return outcome.distance;
+      }
+    }
+    ball.HandleBatCollisions(swing_bat);
+    if (ball.GetPosition().x >= limits_.flight.right_edge ||
+        std::abs(ball.GetSpeed().x) <= limits_.flight.stopped_speed) {
+      return 0;
+    }
+  }
+  return SimulateFlight(ball, flight);
+}
+
+}  // namespace home_run_derby
@@ -0,0 +1,41 @@
+#include "core/varint.h"
+
+namespace home_run_derby {
+
+size_t WriteVarint(uint32_t value, uint8_t* buffer) {
+  size_t size = 0;
+  while (value >= 0x80) {
+    buffer[size++] = static_cast<uint8_t>(value | 0x80);
+    value >>= 7;
+  }
+  buffer[size++] = static_cast<uint8_t>(value);
+  return size;
+}
+
+bool ReadVarint(const uint8_t* data, size_t size, size_t* offset,
+                uint32_t* value) {
+  *value = 0;
+  for (uint32_t shift = 0; shift < 35; shift += 7) {
+    if (*offset >= size) {
+      return false;
+    }
+    uint8_t byte = data[(*offset)++];
+    *value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// The arithmetic is unsigned, so differences that overflow wrap and decode
+// back exactly.
+uint32_t ToZigzag(uint32_t difference) {
+  return (difference << 1) ^ (0u - (difference >> 31));
+}
+
+uint32_t FromZigzag(uint32_t zigzag) {
+  return (zigzag >> 1) ^ (0u - (zigzag & 1));
+}
+
+}  // namespace home_run_derby
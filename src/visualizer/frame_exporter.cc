@@ -0,0 +1,162 @@
+#include <visualizer/frame_exporter.h>
+
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+
+namespace home_run_derby {
+
+namespace visualizer {
+
+using std::mutex;
+using std::unique_lock;
+
+FrameExporter::Worker::Worker(const FrameStyle& style, const Stadium* stadium,
+                              float scale)
+    : renderer(style, stadium), list(scale), rasterizer(1) {}
+
+FrameExporter::FrameExporter(const FrameStyle& style, const Stadium* stadium,
+                             size_t num_workers, float scale)
+    : frames_(nullptr), next_frame_(0), num_written_(0), has_failed_(false) {
+  if (!(scale > 0)) {
+    throw std::invalid_argument("Frames must be drawn at a positive scale");
+  }
+  if (num_workers == 0) {
+    num_workers = std::max(1u, std::thread::hardware_concurrency());
+  }
+  for (size_t i = 0; i < num_workers; ++i) {
+    workers_.emplace_back(new Worker(style, stadium, scale));
+    Worker* worker = workers_.back().get();
+    worker->thread.reset(
+        new StepWorker([this, worker] { RenderFrames(worker); }));
+  }
+  frame_width_ = workers_.front()->renderer.GetFrameWidth(scale);
+  frame_height_ = workers_.front()->renderer.GetFrameHeight(scale);
+  Slot slot = {RasterImage(frame_width_, frame_height_), 0, false};
+  slots_.assign(2 * num_workers, slot);
+}
+
+void FrameExporter::Export(const Simulator& prototype,
+                           const vector<SimulatorSnapshot>& frames,
+                           FrameSink* sink) {
+  frames_ = &frames;
+  next_frame_.store(0, std::memory_order_relaxed);
+  num_written_ = 0;
+  has_failed_ = false;
+  for (Slot& slot : slots_) {
+    slot.is_ready = false;
+  }
+  for (unique_ptr<Worker>& worker : workers_) {
+    worker->simulator.reset(new Simulator(prototype));
+    worker->thread->Post();
+  }
+
+  std::exception_ptr error;
+  try {
+    WriteFrames(sink);
+  } catch (...) {
+    error = std::current_exception();
+    Fail();
+  }
+  // Every worker is joined, even once one has thrown, before anything is
+  // rethrown.
+  for (unique_ptr<Worker>& worker : workers_) {
+    try {
+      worker->thread->Join();
+    } catch (...) {
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+  frames_ = nullptr;
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+size_t FrameExporter::GetNumWorkers() const {
+  return workers_.size();
+}
+
+size_t FrameExporter::GetFrameWidth() const {
+  return frame_width_;
+}
+
+size_t FrameExporter::GetFrameHeight() const {
+  return frame_height_;
+}
+
+void FrameExporter::RenderFrames(Worker* worker) {
+  try {
+    size_t frame;
+    while ((frame = next_frame_.fetch_add(1, std::memory_order_relaxed)) <
+           frames_->size()) {
+      Slot& slot = slots_[frame % slots_.size()];
+      {
+        // The slot is free once the writer is done with the frame before.
+        unique_lock<mutex> lock(mutex_);
+        condition_.wait(lock, [this, frame] {
+          return has_failed_ || frame < num_written_ + slots_.size();
+        });
+        if (has_failed_) {
+          return;
+        }
+      }
+
+      worker->simulator->RestoreSnapshot((*frames_)[frame]);
+      worker->list.Clear();
+      worker->renderer.Record(*worker->simulator, &worker->list);
+      worker->rasterizer.Render(worker->list, &slot.image);
+
+      {
+        unique_lock<mutex> lock(mutex_);
+        slot.frame = frame;
+        slot.is_ready = true;
+      }
+      condition_.notify_all();
+    }
+  } catch (...) {
+    Fail();
+    throw;
+  }
+}
+
+void FrameExporter::WriteFrames(FrameSink* sink) {
+  for (size_t frame = 0; frame < frames_->size(); ++frame) {
+    Slot& slot = slots_[frame % slots_.size()];
+    {
+      unique_lock<mutex> lock(mutex_);
+      condition_.wait(lock, [this, &slot, frame] {
+        return has_failed_ || (slot.is_ready && slot.frame == frame);
+      });
+      // A worker has failed, and will say why when it is joined.
+      if (has_failed_) {
+        return;
+      }
+    }
+
+    // No worker touches a finished slot until the writer frees it.
+    sink->WriteFrame(slot.image);
+
+    {
+      unique_lock<mutex> lock(mutex_);
+      slot.is_ready = false;
+      ++num_written_;
+    }
+    condition_.notify_all();
+  }
+}
+
+void FrameExporter::Fail() {
+  {
+    unique_lock<mutex> lock(mutex_);
+    has_failed_ = true;
+  }
+  condition_.notify_all();
+}
+
+}  // namespace visualizer
+
+}  // namespace home_run_derby
@@ -0,0 +1,181 @@
+#include <visualizer/frame_renderer.h>
+
+#include <cmath>
+
+namespace home_run_derby {
+
+namespace visualizer {
+
+using ci::ColorA;
+
+FrameRenderer::FrameRenderer(const FrameStyle& style, const Stadium* stadium)
+    : style_(style),
+      stadium_(stadium),
+      distance_surrogate_(style.window_size - style.ground_height,
+                          style.ball_radius, style.gravity) {}
+
+void FrameRenderer::Record(const Simulator& simulator, DrawList* list) {
+  RecordGameBackground(simulator, list);
+  RecordStars(simulator, list);
+  RecordGround(simulator, list);
+  RecordStadium(simulator, list);
+  RecordCharacter(simulator, list);
+  RecordBall(simulator, list);
+  RecordBat(simulator, list);
+  RecordGameStatistics(simulator, list);
+}
+
+size_t FrameRenderer::GetFrameWidth(float scale) const {
+  return static_cast<size_t>(
+      std::ceil(style_.window_size * style_.stretch_constant * scale));
+}
+
+size_t FrameRenderer::GetFrameHeight(float scale) const {
+  return static_cast<size_t>(std::ceil(style_.window_size * scale));
+}
+
+const FrameStyle& FrameRenderer::GetStyle() const {
+  return style_;
+}
+
+void FrameRenderer::RecordGameBackground(const Simulator& simulator,
+                                         DrawList* list) const {
+  // The sky darkens as the canvas follows the ball up.
+  Color background_color(style_.background_color -
+                         ((style_.window_size - style_.ground_height +
+                           simulator.GetCanvasFrame().GetOffset().y) /
+                          style_.color_change_per_dist));
+  list->FillRect(vec2(0, 0),
+                 vec2(style_.window_size * style_.stretch_constant,
+                      style_.window_size),
+                 ColorA(background_color, 1));
+}
+
+void FrameRenderer::RecordStars(const Simulator& simulator,
+                                DrawList* list) const {
+  // Star opacity should be dependent on the ball height.
+  const CanvasFrame& canvas_frame = simulator.GetCanvasFrame();
+  ColorA star_color(
+      style_.star_color,
+      std::abs(canvas_frame.GetOffset().y / style_.color_change_per_dist));
+  for (size_t i = 0; i < canvas_frame.GetNumStars(); ++i) {
+    list->FillCircle(canvas_frame.GetStarPosition(i), style_.star_radius,
+                     star_color);
+  }
+}
+
+void FrameRenderer::RecordGround(const Simulator& simulator,
+                                 DrawList* list) const {
+  const CanvasFrame& canvas_frame = simulator.GetCanvasFrame();
+  list->FillRect(canvas_frame.GetGroundLocation().first,
+                 canvas_frame.GetGroundLocation().second,
+                 ColorA(style_.ground_color, 1));
+  list->FillRect(canvas_frame.GetDirtLocation().first,
+                 canvas_frame.GetDirtLocation().second,
+                 ColorA(style_.dirt_color, 1));
+  ColorA dirt_particle_color(style_.dirt_particle_color, 1);
+  for (size_t i = 0; i < canvas_frame.GetNumDirtParticles(); ++i) {
+    list->FillCircle(canvas_frame.GetDirtParticlePosition(i),
+                     style_.dirt_particle_radius, dirt_particle_color);
+  }
+}
+
+void FrameRenderer::RecordStadium(const Simulator& simulator,
+                                  DrawList* list) const {
+  if (stadium_ == nullptr) {
+    return;
+  }
+  // The stadium is fixed in the world, so it moves with the canvas.
+  const vec2& offset = simulator.GetCanvasFrame().GetOffset();
+  for (const Segment& segment : stadium_->GetSegments()) {
+    list->DrawLine(segment.start + offset, segment.end + offset,
+                   style_.stadium_line_width,
+                   ColorA(segment.type == SurfaceType::kFoulPole
+                              ? style_.foul_pole_color
+                              : style_.stadium_color,
+                          1));
+  }
+}
+
+void FrameRenderer::RecordCharacter(const Simulator& simulator,
+                                    DrawList* list) const {
+  ColorA player_color(style_.player_color, 1);
+  list->FillCircle(simulator.GetCanvasFrame().GetPlayerHeadLocation(),
+                   style_.player_radius, player_color);
+  list->FillCircle(simulator.GetCanvasFrame().GetPlayerBodyLocation(),
+                   style_.player_radius / 2, player_color);
+}
+
+void FrameRenderer::RecordBall(const Simulator& simulator,
+                               DrawList* list) const {
+  list->FillCircle(simulator.GetBallDisplayPosition(),
+                   simulator.GetBall().GetRadius(),
+                   ColorA(style_.ball_color, 1));
+}
+
+void FrameRenderer::RecordBat(const Simulator& simulator,
+                              DrawList* list) const {
+  // Only draw the bat if it has not collided with the ball yet.
+  if (!simulator.GetBall().HitPastScreen()) {
+    list->FillCircle(simulator.GetBat().GetBatPosition(),
+                     simulator.GetBat().GetBatRadius(),
+                     ColorA(style_.bat_color, 1));
+  }
+}
+
+void FrameRenderer::RecordGameStatistics(const Simulator& simulator,
+                                         DrawList* list) {
+  // Make the color of the statistics variable with the height of the ball.
+  ColorA text_color(style_.statistics_text_color -
+                        simulator.GetBall().GetPosition().y /
+                            style_.color_change_per_dist,
+                    1);
+  float center_x = style_.stretch_constant * style_.window_size / 2;
+  float line_height = style_.statistics_font_size;
+  list->DrawText(outs_text_.Format("Outs: %zu", simulator.GetOuts()),
+                 vec2(center_x, style_.statistics_location),
+                 style_.statistics_font_size, text_color);
+  list->DrawText(
+      total_distance_text_.Format(
+          "Total Distance: %.0f ft.",
+          simulator.GetScore() / style_.distance_scale),
+      vec2(center_x, style_.statistics_location + line_height),
+      style_.statistics_font_size, text_color);
+
+  // Only draw the current distance and altitude if the ball has been hit.
+  if (!simulator.GetBall().HitPastScreen()) {
+    return;
+  }
+  const vec2& position = simulator.GetBall().GetPosition();
+  list->DrawText(
+      current_distance_text_.Format("Current Distance: %.0f ft.",
+                                    -position.x / style_.distance_scale),
+      vec2(center_x, style_.statistics_location + 2 * line_height),
+      style_.statistics_font_size, text_color);
+  list->DrawText(
+      current_altitude_text_.Format(
+          "Current Altitude: %.0f ft.",
+          (style_.window_size - position.y - style_.ground_height -
+           style_.ball_radius) /
+              style_.distance_scale),
+      vec2(center_x, style_.statistics_location + 3 * line_height),
+      style_.statistics_font_size, text_color);
+
+  // The surrogate is only fitted to the flat ground.
+  if (stadium_ == nullptr || stadium_->GetSegments().empty()) {
+    float error;
+    float predicted_distance =
+        distance_surrogate_.PredictDistance(simulator.GetBall(), &error);
+    list->DrawText(
+        predicted_distance_text_.Format(
+            "Predicted Distance: %.0f +/- %.0f ft.",
+            predicted_distance / style_.distance_scale,
+            error / style_.distance_scale),
+        vec2(center_x, style_.statistics_location + 4 * line_height),
+        style_.statistics_font_size, text_color);
+  }
+}
+
+}  // namespace visualizer
+
+}  // namespace home_run_derby
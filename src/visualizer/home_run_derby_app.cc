@@ -1,6 +1,10 @@
 #include <visualizer/home_run_derby_app.h>
 
-#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <exception>
+
+#include "core/allocation_tracker.h"
 
 namespace home_run_derby {
 
@@ -8,44 +12,160 @@ namespace visualizer {
 
 using ci::ColorA;
 using glm::vec2;
-using std::ostringstream;
+using std::runtime_error;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const float kPi = 3.14159265358979f;
+
+double SecondsSince(const Clock::time_point& start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+}  // namespace
 
 HomeRunDerbyApp::HomeRunDerbyApp()
-    : simulator_(kPlayerRadius, kWindowSize, kStretchConstant, kGroundHeight,
-                 kBallMass, kBallRadius, kGravity, kGroundFriction,
-                 kGroundRestitution, kBallVelocityBoostFactor,
-                 kBallTerminalVelocity, kMinPitchSpeedX, kMaxPitchSpeedX,
-                 kMinPitchSpeedY, kMaxPitchSpeedY, kBatMass, kBatRadius,
-                 kNumStars, kNumDirtParticles, kStarRadius,
-                 kDirtParticleRadius) {
+    : physics_(LoadPhysicsProfile()),
+      simulator_(kPlayerRadius, kWindowSize, kStretchConstant, kGroundHeight,
+                 kBallMass, kBallRadius, physics_.gravity,
+                 physics_.ground_friction, physics_.ground_restitution,
+                 physics_.ball_velocity_boost_factor, kBallTerminalVelocity,
+                 kMinPitchSpeedX, kMaxPitchSpeedX, kMinPitchSpeedY,
+                 kMaxPitchSpeedY, physics_.bat_mass, kBatRadius, kNumStars,
+                 kNumDirtParticles, kStarRadius, kDirtParticleRadius),
+      spectator_broadcaster_(kSpectatorPort),
+      metrics_server_(metrics_registry_, kMetricsPort),
+      num_swing_cache_hits_(0),
+      num_swing_cache_misses_(0),
+      contact_analytics_(
+          SprayChart(kSprayChartCellSize * physics_.distance_scale,
+                     kSprayChartColumns, kSprayChartRows),
+          kHardHitSpeed * kFeetPerSecondPerMph * physics_.distance_scale /
+              kFrameRate),
+      bat_predictor_(kBatPredictionAlpha, kBatPredictionBeta,
+                     kBatPredictionHorizon),
+      score_store_(kScoreStorePath),
+      leaderboard_(kLeaderboardMaxDistance * physics_.distance_scale,
+                   physics_.distance_scale),
+      bat_index_(0),
+      ai_batter_(MakeSwingLimits(), kAiPlanningTime),
+      distance_surrogate_(kWindowSize - kGroundHeight, kBallRadius,
+                          physics_.gravity),
+      fielding_team_(kNumFielders, MakeFieldingSettings()),
+      is_ai_batting_(false),
+      is_fielding_(false),
+      has_pitch_snapshot_(false),
+      is_idle_(false),
+      second_simulator_(
+          kPlayerRadius, kWindowSize, kStretchConstant, kGroundHeight,
+          kBallMass, kBallRadius, physics_.gravity, physics_.ground_friction,
+          physics_.ground_restitution, physics_.ball_velocity_boost_factor,
+          kBallTerminalVelocity, kMinPitchSpeedX, kMaxPitchSpeedX,
+          kMinPitchSpeedY, kMaxPitchSpeedY, physics_.bat_mass, kBatRadius,
+          kNumStars, kNumDirtParticles, kStarRadius, kDirtParticleRadius),
+      second_ai_batter_(MakeSwingLimits(), kAiPlanningTime),
+      first_step_worker_([this] { StepFirstPlayer(); }),
+      second_step_worker_([this] { StepSecondPlayer(); }),
+      is_split_screen_(false),
+      quality_controller_(MakeQualitySettings()) {
   ci::app::setWindowSize(static_cast<int>(kWindowSize * kStretchConstant),
                          static_cast<int>(kWindowSize));
   ci::app::setFrameRate(kFrameRate);
+  RegisterMetrics();
+  // However many games are shown, there is only one background field.
+  second_simulator_.SetBackgroundField(simulator_.GetCanvasFrame().GetField());
+}
+
+void HomeRunDerbyApp::setup() {
+  title_font_ = ci::gl::TextureFont::create(
+      ci::Font(kStartScreenTextFont, kStartScreenTextFontSize));
+  subtitle_font_ = ci::gl::TextureFont::create(
+      ci::Font(kStartScreenTextFont, kStartScreenTextFontSize / 2));
+  statistics_font_ = ci::gl::TextureFont::create(
+      ci::Font(kStatisticsFont, kStatisticsFontSize));
+
+  // The game is still playable if the scores cannot be saved.
+  try {
+    score_store_.Open();
+    simulator_.AttachScoreStore(&score_store_);
+    leaderboard_.InsertAll(score_store_.GetSnapshotScores(),
+                           score_store_.GetNumSnapshotScores());
+    leaderboard_.InsertAll(score_store_.GetLogScores().data(),
+                           score_store_.GetLogScores().size());
+  } catch (const runtime_error& error) {
+    ci::app::console() << error.what() << std::endl;
+  }
+  simulator_.AttachLeaderboard(&leaderboard_);
+  simulator_.AttachInputLatencyTracker(&input_latency_tracker_);
+  simulator_.AttachHitStatistics(&hit_statistics_);
+  simulator_.AttachContactAnalytics(&contact_analytics_);
+
+  // The game is still playable if nobody can watch it.
+  try {
+    spectator_broadcaster_.Start();
+  } catch (const runtime_error& error) {
+    ci::app::console() << error.what() << std::endl;
+  }
+
+  // Nor if nothing can scrape its metrics.
+  try {
+    metrics_server_.Start();
+  } catch (const runtime_error& error) {
+    ci::app::console() << error.what() << std::endl;
+  }
+
+  // Without a bat catalog, the game is played with the plain bat.
+  ci::fs::path bat_catalog_path = ci::app::getAssetPath(kBatCatalogAsset);
+  if (!bat_catalog_path.empty()) {
+    try {
+      bat_catalog_ = BatCatalog::Load(bat_catalog_path.string());
+    } catch (const runtime_error& error) {
+      ci::app::console() << error.what() << std::endl;
+    }
+  }
+  bat_index_ = bat_catalog_.GetNumModels();
+
+  // Without a stadium layout, the game is played on the flat ground.
+  ci::fs::path stadium_path = ci::app::getAssetPath(kStadiumAsset);
+  if (!stadium_path.empty()) {
+    try {
+      stadium_ = Stadium::Load(stadium_path.string());
+      simulator_.AttachStadium(&stadium_);
+      second_simulator_.AttachStadium(&stadium_);
+    } catch (const runtime_error& error) {
+      ci::app::console() << error.what() << std::endl;
+    }
+  }
 }
 
 void HomeRunDerbyApp::DisplayStartScreen() const {
   ci::gl::color(kStartScreenColor);
   DrawSolidRect(vec2(0, 0), vec2(kWindowSize * kStretchConstant, kWindowSize));
-  ci::gl::drawStringCentered(
-      "Ultimate Home Run Derby",
-      glm::vec2(kStretchConstant * kWindowSize / 2,
-                kWindowSize / 2 - kStartScreenTextFontSize),
-      kStartScreenTextColor,
-      ci::Font(kStartScreenTextFont, kStartScreenTextFontSize));
-  ci::gl::drawStringCentered(
-      "Press SPACE to play",
-      glm::vec2(kStretchConstant * kWindowSize / 2,
-                kWindowSize / 2 + kStartScreenTextFontSize / 2),
-      kStartScreenTextColor,
-      ci::Font(kStartScreenTextFont, kStartScreenTextFontSize / 2));
-  ci::gl::drawStringCentered(
-      "High score: " +
-          FloatToString(simulator_.GetHighScore() / kDistanceScaleConstant) +
-          " ft.",
+  DrawCenteredText(title_font_, kTitleText,
+                   glm::vec2(kStretchConstant * kWindowSize / 2,
+                             kWindowSize / 2 - kStartScreenTextFontSize),
+                   kStartScreenTextColor);
+  DrawCenteredText(subtitle_font_, kStartPromptText,
+                   glm::vec2(kStretchConstant * kWindowSize / 2,
+                             kWindowSize / 2 + kStartScreenTextFontSize / 2),
+                   kStartScreenTextColor);
+  DrawCenteredText(
+      subtitle_font_,
+      high_score_text_.Format(
+          "High score: %.*f ft.", static_cast<int>(kPrecision),
+          simulator_.GetHighScore() / physics_.distance_scale),
       glm::vec2(kStretchConstant * kWindowSize / 2,
                 kWindowSize / 2 + kStartScreenTextFontSize),
-      kStartScreenTextColor,
-      ci::Font(kStartScreenTextFont, kStartScreenTextFontSize / 2));
+      kStartScreenTextColor);
+  if (is_split_screen_) {
+    DrawCenteredText(
+        subtitle_font_, kSplitScreenText,
+        glm::vec2(kStretchConstant * kWindowSize / 2,
+                  kWindowSize / 2 + 3 * kStartScreenTextFontSize / 2),
+        kStartScreenTextColor);
+  }
 }
 
 void HomeRunDerbyApp::DisplayEndScreen() const {
@@ -53,150 +173,285 @@ void HomeRunDerbyApp::DisplayEndScreen() const {
   DrawSolidRect(vec2(0, 0), vec2(kStretchConstant * kWindowSize, kWindowSize));
   if (simulator_.GetHighScore() == simulator_.GetScore() &&
       simulator_.GetScore() != 0) {
-    ci::gl::drawStringCentered(
-        "You got a new high score!",
+    DrawCenteredText(
+        title_font_, kNewHighScoreText,
         glm::vec2(kStretchConstant * kWindowSize / 2,
                   kWindowSize / 2 - 1 * kStartScreenTextFontSize / 8),
-        kStartScreenTextColor,
-        ci::Font(kStartScreenTextFont, kStartScreenTextFontSize));
+        kStartScreenTextColor);
   }
-  ci::gl::drawStringCentered(
-      "Game over!",
-      glm::vec2(kStretchConstant * kWindowSize / 2,
-                kWindowSize / 2 - 2 * kStartScreenTextFontSize),
-      kStartScreenTextColor,
-      ci::Font(kStartScreenTextFont, kStartScreenTextFontSize));
-  ci::gl::drawStringCentered(
-      "Total distance hit: " +
-          FloatToString(simulator_.GetScore() / kDistanceScaleConstant) +
-          " ft. in " + FloatToString(static_cast<float>(kMaxOuts)) + " outs",
+  DrawCenteredText(title_font_, kGameOverText,
+                   glm::vec2(kStretchConstant * kWindowSize / 2,
+                             kWindowSize / 2 - 2 * kStartScreenTextFontSize),
+                   kStartScreenTextColor);
+  DrawCenteredText(
+      title_font_,
+      final_score_text_.Format(
+          "Total distance hit: %.*f ft. in %zu outs",
+          static_cast<int>(kPrecision),
+          simulator_.GetScore() / physics_.distance_scale, kMaxOuts),
       glm::vec2(kStretchConstant * kWindowSize / 2,
                 kWindowSize / 2 - kStartScreenTextFontSize),
-      kStartScreenTextColor,
-      ci::Font(kStartScreenTextFont, kStartScreenTextFontSize));
-  ci::gl::drawStringCentered(
-      "Press SPACE to play again",
+      kStartScreenTextColor);
+  // The game's score was ranked when it ended, so there is at least one.
+  size_t rank = leaderboard_.GetRank(simulator_.GetScore());
+  size_t num_scores = std::max<size_t>(leaderboard_.GetNumScores(), 1);
+  DrawCenteredText(
+      subtitle_font_,
+      rank_text_.Format("Global rank: %zu of %zu (top %.*f%%)", rank,
+                        num_scores, static_cast<int>(kPrecision),
+                        100.0f * static_cast<float>(rank) /
+                            static_cast<float>(num_scores)),
       glm::vec2(kStretchConstant * kWindowSize / 2,
-                kWindowSize / 2 + kStartScreenTextFontSize),
-      kStartScreenTextColor,
-      ci::Font(kStartScreenTextFont, kStartScreenTextFontSize / 2));
+                kWindowSize / 2 + kStartScreenTextFontSize / 2),
+      kStartScreenTextColor);
+  DrawCenteredText(subtitle_font_, kPlayAgainPromptText,
+                   glm::vec2(kStretchConstant * kWindowSize / 2,
+                             kWindowSize / 2 + kStartScreenTextFontSize),
+                   kStartScreenTextColor);
+  if (is_split_screen_) {
+    DrawCenteredText(
+        subtitle_font_,
+        second_score_text_.Format(
+            "The computer hit: %.*f ft.", static_cast<int>(kPrecision),
+            second_simulator_.GetScore() / physics_.distance_scale),
+        glm::vec2(kStretchConstant * kWindowSize / 2,
+                  kWindowSize / 2 + 3 * kStartScreenTextFontSize / 2),
+        kStartScreenTextColor);
+  }
 }
 
-void HomeRunDerbyApp::DrawGameBackground() const {
+void HomeRunDerbyApp::DrawGameBackground(const Simulator& simulator) const {
   // Draw the sky with dynamic background colors.
   ci::Color8u background_color(kGameBackgroundColor -
                                ((kWindowSize - kGroundHeight +
-                                 simulator_.GetCanvasFrame().GetOffset().y) /
+                                 simulator.GetCanvasFrame().GetOffset().y) /
                                 kColorChangePerDist));
-  ci::gl::clear(background_color);
+  // Fill the canvas rather than clearing, which would wipe the other view.
+  ci::gl::color(background_color);
+  DrawSolidRect(vec2(0, 0), vec2(kWindowSize * kStretchConstant, kWindowSize));
 }
 
-void HomeRunDerbyApp::DrawStars() const {
+void HomeRunDerbyApp::DrawStars(const Simulator& simulator) const {
   // Star opacity should be dependent on the ball height.
-  for (const Particle& star : simulator_.GetCanvasFrame().GetStars()) {
-    ci::gl::color(ColorA(
-        kStarColor,
-        abs(simulator_.GetCanvasFrame().GetOffset().y / kColorChangePerDist)));
-    ci::gl::drawSolidCircle(star.GetPosition(), kStarRadius);
+  const CanvasFrame& canvas_frame = simulator.GetCanvasFrame();
+  ci::gl::color(ColorA(
+      kStarColor, abs(canvas_frame.GetOffset().y / kColorChangePerDist)));
+  // The field is laid out at random, so the first stars are as evenly spread
+  // as all of them.
+  size_t num_stars = quality_controller_.Scale(canvas_frame.GetNumStars());
+  int segments = GetCircleSegments(kStarRadius);
+  for (size_t i = 0; i < num_stars; ++i) {
+    ci::gl::drawSolidCircle(canvas_frame.GetStarPosition(i), kStarRadius,
+                            segments);
   }
 }
 
-void HomeRunDerbyApp::DrawGround() const {
+void HomeRunDerbyApp::DrawGround(const Simulator& simulator) const {
   ci::gl::color(kGroundColor);
   // Draw the grass.
-  DrawSolidRect(simulator_.GetCanvasFrame().GetGroundLocation().first,
-                simulator_.GetCanvasFrame().GetGroundLocation().second);
+  DrawSolidRect(simulator.GetCanvasFrame().GetGroundLocation().first,
+                simulator.GetCanvasFrame().GetGroundLocation().second);
   // Draw the dirt.
   ci::gl::color(kDirtColor);
-  DrawSolidRect(simulator_.GetCanvasFrame().GetDirtLocation().first,
-                simulator_.GetCanvasFrame().GetDirtLocation().second);
+  DrawSolidRect(simulator.GetCanvasFrame().GetDirtLocation().first,
+                simulator.GetCanvasFrame().GetDirtLocation().second);
   // Draw the dirt particles.
   ci::gl::color(kDirtParticleColor);
-  for (const Particle& dirt_particle :
-       simulator_.GetCanvasFrame().GetDirtParticles()) {
-    ci::gl::drawSolidCircle(dirt_particle.GetPosition(), kDirtParticleRadius);
+  const CanvasFrame& canvas_frame = simulator.GetCanvasFrame();
+  size_t num_dirt_particles =
+      quality_controller_.Scale(canvas_frame.GetNumDirtParticles());
+  int segments = GetCircleSegments(kDirtParticleRadius);
+  for (size_t i = 0; i < num_dirt_particles; ++i) {
+    ci::gl::drawSolidCircle(canvas_frame.GetDirtParticlePosition(i),
+                            kDirtParticleRadius, segments);
+  }
+}
+
+void HomeRunDerbyApp::DrawStadium(const Simulator& simulator) const {
+  // The stadium is fixed in the world, so it moves with the canvas.
+  const vec2& offset = simulator.GetCanvasFrame().GetOffset();
+  ci::gl::lineWidth(kStadiumLineWidth);
+  for (const Segment& segment : stadium_.GetSegments()) {
+    ci::gl::color(segment.type == SurfaceType::kFoulPole ? kFoulPoleColor
+                                                         : kStadiumColor);
+    ci::gl::drawLine(segment.start + offset, segment.end + offset);
   }
 }
 
-void HomeRunDerbyApp::DrawCharacter() const {
+void HomeRunDerbyApp::DrawFielders(const Simulator& simulator) const {
+  // Only the player's game is fielded.
+  if (!is_fielding_ || &simulator != &simulator_) {
+    return;
+  }
+  // Fielders stand on the ground, which moves with the canvas.
+  vec2 offset =
+      simulator.GetCanvasFrame().GetOffset() - vec2(0, kFielderRadius);
+  int segments = GetCircleSegments(kFielderRadius);
+  for (size_t i = 0; i < fielding_team_.GetNumFielders(); ++i) {
+    ci::gl::color(fielding_team_.IsChasing(i) ? kChasingFielderColor
+                                              : kFielderColor);
+    ci::gl::drawSolidCircle(fielding_team_.GetFielderPosition(i) + offset,
+                            kFielderRadius, segments);
+  }
+}
+
+void HomeRunDerbyApp::DrawCharacter(const Simulator& simulator) const {
   ci::gl::color(kPlayerColor);
 
   // Draw the top ellipse.
-  ci::gl::drawSolidCircle(simulator_.GetCanvasFrame().GetPlayerHeadLocation(),
-                          kPlayerRadius);
+  ci::gl::drawSolidCircle(simulator.GetCanvasFrame().GetPlayerHeadLocation(),
+                          kPlayerRadius, GetCircleSegments(kPlayerRadius));
 
   // Draw the bottom ellipse.
-  ci::gl::drawSolidCircle(simulator_.GetCanvasFrame().GetPlayerBodyLocation(),
-                          kPlayerRadius / 2);
+  ci::gl::drawSolidCircle(simulator.GetCanvasFrame().GetPlayerBodyLocation(),
+                          kPlayerRadius / 2,
+                          GetCircleSegments(kPlayerRadius / 2));
 }
 
-void HomeRunDerbyApp::DrawBat() const {
+void HomeRunDerbyApp::DrawBat(const Simulator& simulator) const {
   // Only draw the bat if it has not collided with the ball yet.
-  if (!simulator_.GetBall().HitPastScreen()) {
+  if (!simulator.GetBall().HitPastScreen()) {
     ci::gl::color(kBatColor);
-    ci::gl::drawSolidCircle(simulator_.GetBat().GetBatPosition(), kBatRadius);
+    float radius = simulator.GetBat().GetBatRadius();
+    ci::gl::drawSolidCircle(&simulator == &simulator_
+                                ? GetDrawnBatPosition()
+                                : simulator.GetBat().GetBatPosition(),
+                            radius, GetCircleSegments(radius));
   }
 }
 
-void HomeRunDerbyApp::DrawBall() const {
+vec2 HomeRunDerbyApp::GetDrawnBatPosition() const {
+  // The computer moves the bat on ticks, so its bat is never behind.
+  if (is_ai_batting_ || !bat_predictor_.HasSamples()) {
+    return simulator_.GetBat().GetBatPosition();
+  }
+  Clock::time_point present_time =
+      Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                         std::chrono::duration<double>(kBatPredictionLead));
+  SwingLimits limits = MakeSwingLimits();
+  return glm::clamp(bat_predictor_.Predict(present_time),
+                    limits.min_bat_position, limits.max_bat_position);
+}
+
+void HomeRunDerbyApp::DrawBall(const Simulator& simulator) const {
   ci::gl::color(kBallColor);
-  ci::gl::drawSolidCircle(simulator_.GetBallDisplayPosition(),
-                          simulator_.GetBall().GetRadius());
+  ci::gl::drawSolidCircle(simulator.GetBallDisplayPosition(),
+                          simulator.GetBall().GetRadius(),
+                          GetCircleSegments(simulator.GetBall().GetRadius()));
 }
 
-void HomeRunDerbyApp::DisplayGameStatistics() const {
+void HomeRunDerbyApp::DisplayGameStatistics(const Simulator& simulator) const {
   // Make the color of the statistics variable with the height of the ball.
-  ci::gl::drawStringCentered(
-      "Outs: " + FloatToString(static_cast<float>(simulator_.GetOuts())),
+  ColorA text_color(kStatisticsTextColor -
+                        simulator.GetBall().GetPosition().y /
+                            kColorChangePerDist,
+                    1);
+  DrawCenteredText(
+      statistics_font_, outs_text_.Format("Outs: %zu", simulator.GetOuts()),
       glm::vec2(kStretchConstant * kWindowSize / 2, kStatisticsLocation),
-      kStatisticsTextColor -
-          simulator_.GetBall().GetPosition().y / kColorChangePerDist,
-      ci::Font(kStatisticsFont, kStatisticsFontSize));
-  ci::gl::drawStringCentered(
-      "Total Distance: " +
-          FloatToString(simulator_.GetScore() / kDistanceScaleConstant) +
-          " ft.",
+      text_color);
+  DrawCenteredText(
+      statistics_font_,
+      total_distance_text_.Format(
+          "Total Distance: %.*f ft.", static_cast<int>(kPrecision),
+          simulator.GetScore() / physics_.distance_scale),
       glm::vec2(kStretchConstant * kWindowSize / 2,
                 kStatisticsLocation + kStatisticsFontSize),
-      kStatisticsTextColor -
-          simulator_.GetBall().GetPosition().y / kColorChangePerDist,
-      ci::Font(kStatisticsFont, kStatisticsFontSize));
+      text_color);
 
   // Only draw the current distance and altitude if the ball has been hit.
-  if (simulator_.GetBall().HitPastScreen()) {
-    ci::gl::drawStringCentered(
-        "Current Distance: " +
-            FloatToString(-simulator_.GetBall().GetPosition().x /
-                          kDistanceScaleConstant) +
-            " ft.",
+  if (simulator.GetBall().HitPastScreen()) {
+    DrawCenteredText(
+        statistics_font_,
+        current_distance_text_.Format(
+            "Current Distance: %.*f ft.", static_cast<int>(kPrecision),
+            -simulator.GetBall().GetPosition().x / physics_.distance_scale),
         glm::vec2(kStretchConstant * kWindowSize / 2,
                   kStatisticsLocation + 2 * kStatisticsFontSize),
-        kStatisticsTextColor -
-            simulator_.GetBall().GetPosition().y / kColorChangePerDist,
-        ci::Font(kStatisticsFont, kStatisticsFontSize));
-    ci::gl::drawStringCentered(
-        "Current Altitude: " +
-            FloatToString(kGroundRestitution +
-                          (kWindowSize - simulator_.GetBall().GetPosition().y -
-                           kGroundHeight - kBallRadius) /
-                              kDistanceScaleConstant) +
-            " ft.",
+        text_color);
+    DrawCenteredText(
+        statistics_font_,
+        current_altitude_text_.Format(
+            "Current Altitude: %.*f ft.", static_cast<int>(kPrecision),
+            kGroundRestitution +
+                (kWindowSize - simulator.GetBall().GetPosition().y -
+                 kGroundHeight - kBallRadius) /
+                    physics_.distance_scale),
         glm::vec2(kStretchConstant * kWindowSize / 2,
                   kStatisticsLocation + 3 * kStatisticsFontSize),
-        kStatisticsTextColor -
-            simulator_.GetBall().GetPosition().y / kColorChangePerDist,
-        ci::Font(kStatisticsFont, kStatisticsFontSize));
+        text_color);
+  }
+
+  // Predicting where the ball lands is cheap enough to redo every frame. The
+  // surrogate is only fitted to the flat ground.
+  if (simulator.GetBall().HitPastScreen() &&
+      stadium_.GetSegments().empty()) {
+    float error;
+    float predicted_distance =
+        distance_surrogate_.PredictDistance(simulator.GetBall(), &error);
+    DrawCenteredText(
+        statistics_font_,
+        predicted_distance_text_.Format(
+            "Predicted Distance: %.*f +/- %.*f ft.",
+            static_cast<int>(kPrecision),
+            predicted_distance / physics_.distance_scale,
+            static_cast<int>(kPrecision), error / physics_.distance_scale),
+        glm::vec2(kStretchConstant * kWindowSize / 2,
+                  kStatisticsLocation + 4 * kStatisticsFontSize),
+        text_color);
+  }
+
+  // Only the player's swings are followed.
+  if (&simulator == &simulator_) {
+    DisplaySwingStatistics();
+  }
+}
+
+void HomeRunDerbyApp::DisplaySwingStatistics() const {
+  // The summaries are kept up to date as contacts happen, so this only reads
+  // them.
+  const ContactSummary& summary = contact_analytics_.GetSessionSummary();
+  if (summary.num_contacts == 0) {
+    return;
   }
+  const ContactEvent& contact = contact_analytics_.GetLastContact();
+  DrawCenteredText(
+      statistics_font_,
+      last_swing_text_.Format(
+          "Last Swing: %.1f mph at %.0f deg, bat %.1f mph, %.2f off center",
+          ToMilesPerHour(contact.exit_speed), contact.launch_angle_degrees,
+          ToMilesPerHour(contact.bat_speed), contact.contact_offset),
+      glm::vec2(kStretchConstant * kWindowSize / 2,
+                kStatisticsLocation + 5 * kStatisticsFontSize),
+      ColorA(kStatisticsTextColor, 1));
+  DrawCenteredText(
+      statistics_font_,
+      swing_summary_text_.Format(
+          "Contacts: %llu, mean %.1f mph, %llu hard hit, %llu sweet spot",
+          static_cast<unsigned long long>(summary.num_contacts),
+          ToMilesPerHour(static_cast<float>(summary.exit_speed_sum /
+                                            summary.num_contacts)),
+          static_cast<unsigned long long>(summary.num_hard_hit),
+          static_cast<unsigned long long>(summary.num_sweet_spot)),
+      glm::vec2(kStretchConstant * kWindowSize / 2,
+                kStatisticsLocation + 6 * kStatisticsFontSize),
+      ColorA(kStatisticsTextColor, 1));
 }
 
-void HomeRunDerbyApp::DrawCanvasFeatures() const {
-  DrawGameBackground();
-  DrawStars();
-  DrawGround();
-  DrawCharacter();
-  DrawBall();
-  DrawBat();
-  DisplayGameStatistics();
+float HomeRunDerbyApp::ToMilesPerHour(float speed) const {
+  return speed * kFrameRate / physics_.distance_scale / kFeetPerSecondPerMph;
+}
+
+void HomeRunDerbyApp::DrawCanvasFeatures(const Simulator& simulator) const {
+  DrawGameBackground(simulator);
+  DrawStars(simulator);
+  DrawGround(simulator);
+  DrawStadium(simulator);
+  DrawFielders(simulator);
+  DrawCharacter(simulator);
+  DrawBall(simulator);
+  DrawBat(simulator);
+  DisplayGameStatistics(simulator);
 }
 
 void HomeRunDerbyApp::draw() {
@@ -206,37 +461,119 @@ void HomeRunDerbyApp::draw() {
    *    1 = in-game,
    *    2 = end screen
    */
-  if (simulator_.GetCurrentGameState() == 0) {
-    simulator_.ResetGame();
+  AllocationTracker::BeginFrame();
+  Clock::time_point draw_start = Clock::now();
+  if (simulator_.GetCurrentGameState() == Simulator::kStartScreen) {
+    AllocationScope scope("start screen");
     DisplayStartScreen();
-  } else if (simulator_.GetCurrentGameState() == 1) {
-    DrawCanvasFeatures();
-    simulator_.UpdateOffset();
-    simulator_.UpdateBallStates();
+    draw_seconds_->Observe(SecondsSince(draw_start));
+  } else if (simulator_.GetCurrentGameState() == Simulator::kInGame) {
+    {
+      AllocationScope scope("draw canvas");
+      if (is_split_screen_) {
+        DrawSplitScreen();
+      } else {
+        DrawCanvasFeatures(simulator_);
+      }
+    }
+    draw_seconds_->Observe(SecondsSince(draw_start));
+    // The canvas now shows every tick simulated before this frame.
+    input_latency_tracker_.OnPresent();
+    if (is_split_screen_) {
+      // Each game steps on its own thread, and both are done before the next
+      // frame is drawn. A player who is out of outs waits for the other.
+      if (simulator_.GetOuts() < kMaxOuts) {
+        first_step_worker_.Post();
+      }
+      if (second_simulator_.GetOuts() < kMaxOuts) {
+        second_step_worker_.Post();
+      }
+      // Both games are joined before either's error is rethrown, so neither
+      // is left running into the next frame.
+      std::exception_ptr error;
+      StepWorker* workers[] = {&first_step_worker_, &second_step_worker_};
+      for (StepWorker* worker : workers) {
+        try {
+          worker->Join();
+        } catch (...) {
+          if (!error) {
+            error = std::current_exception();
+          }
+        }
+      }
+      if (error) {
+        std::rethrow_exception(error);
+      }
+    } else {
+      StepFirstPlayer();
+    }
 
-    if (simulator_.GetOuts() >= kMaxOuts) {
-      simulator_.IncrementGameState();
+    if (simulator_.GetOuts() >= kMaxOuts &&
+        (!is_split_screen_ || second_simulator_.GetOuts() >= kMaxOuts)) {
+      try {
+        simulator_.SetGameState(Simulator::kEndScreen);
+      } catch (const runtime_error& error) {
+        // The score could not be saved, but the game has still ended.
+        ci::app::console() << error.what() << std::endl;
+      }
+      second_simulator_.SetGameState(Simulator::kEndScreen);
+      input_latency_tracker_.Report(ci::app::console());
+      hit_statistics_.Report(ci::app::console());
     }
+
+    // The whole frame, drawing and simulating, has to fit the budget.
+    quality_controller_.OnFrame(SecondsSince(draw_start));
+    quality_level_->Set(static_cast<double>(quality_controller_.GetLevel()));
+    UpdateSwingCacheMetrics();
   } else {
+    AllocationScope scope("end screen");
     DisplayEndScreen();
+    draw_seconds_->Observe(SecondsSince(draw_start));
   }
+  spectator_broadcaster_.Publish(simulator_);
+  spectators_->Set(
+      static_cast<double>(spectator_broadcaster_.GetNumSpectators()));
+
+  // When allocation tracking is compiled in, report every frame that
+  // allocated so the offending call sites can be found.
+  size_t num_allocations = AllocationTracker::EndFrame();
+  allocations_->Increment(num_allocations);
+  if (num_allocations > 0) {
+    AllocationTracker::Report(ci::app::console());
+  }
+
+  // The game may have just ended, leaving a static screen.
+  UpdateFrameRate();
 }
 
 void HomeRunDerbyApp::mouseMove(ci::app::MouseEvent event) {
+  if (is_ai_batting_) {
+    return;
+  }
+  Clock::time_point arrival = Clock::now();
+  input_latency_tracker_.OnInput(arrival);
   // Constrain how far the user's mouse can go to control the bat.
-  simulator_.UpdateBatStates(
-      vec2(fmaxf(static_cast<float>(event.getPos().x),
-                 kWindowSize * kStretchConstant / kBatXLimitFactor),
-           fminf(fmaxf(kBatRadius, static_cast<float>(event.getPos().y)),
-                 kWindowSize - kBatRadius - kGroundHeight)));
+  vec2 position(fmaxf(static_cast<float>(event.getPos().x),
+                      kWindowSize * kStretchConstant / kBatXLimitFactor),
+                fminf(fmaxf(kBatRadius, static_cast<float>(event.getPos().y)),
+                      kWindowSize - kBatRadius - kGroundHeight));
+  simulator_.UpdateBatStates(position);
+  bat_predictor_.AddSample(position, arrival);
 }
 
 void HomeRunDerbyApp::mouseDrag(ci::app::MouseEvent event) {
+  if (is_ai_batting_) {
+    return;
+  }
+  Clock::time_point arrival = Clock::now();
+  input_latency_tracker_.OnInput(arrival);
   // If the mouse is dragged, the simulator should still update the position of
   // the bat to avoid any cheap overpowered shots.
-  simulator_.UpdateBatStates(vec2(fmaxf(static_cast<float>(event.getPos().x),
-                                        kWindowSize * kStretchConstant / 3),
-                                  event.getPos().y));
+  vec2 position(fmaxf(static_cast<float>(event.getPos().x),
+                      kWindowSize * kStretchConstant / 3),
+                static_cast<float>(event.getPos().y));
+  simulator_.UpdateBatStates(position);
+  bat_predictor_.AddSample(position, arrival);
 }
 
 void HomeRunDerbyApp::keyDown(ci::app::KeyEvent event) {
@@ -244,10 +581,110 @@ void HomeRunDerbyApp::keyDown(ci::app::KeyEvent event) {
     case ci::app::KeyEvent::KEY_SPACE:
       // If at the end or start screen and SPACE is pressed, go to the next game
       // state.
-      if (simulator_.GetCurrentGameState() != 1) {
+      if (simulator_.GetCurrentGameState() != Simulator::kInGame) {
         simulator_.IncrementGameState();
+        second_simulator_.SetGameState(simulator_.GetCurrentGameState());
+        UpdateFrameRate();
+      }
+      break;
+    case ci::app::KeyEvent::KEY_2:
+      // Players can only be added or dropped before a game starts.
+      if (simulator_.GetCurrentGameState() == Simulator::kStartScreen) {
+        is_split_screen_ = !is_split_screen_;
       }
       break;
+    case ci::app::KeyEvent::KEY_a:
+      is_ai_batting_ = !is_ai_batting_;
+      bat_predictor_.Reset();
+      break;
+    case ci::app::KeyEvent::KEY_r:
+      if (simulator_.GetCurrentGameState() == Simulator::kInGame &&
+          has_pitch_snapshot_) {
+        simulator_.RestoreSnapshot(pitch_snapshot_);
+        bat_predictor_.Reset();
+      }
+      break;
+    case ci::app::KeyEvent::KEY_b:
+      // Cycle through the catalog, then back to the plain bat.
+      bat_index_ = (bat_index_ + 1) % (bat_catalog_.GetNumModels() + 1);
+      simulator_.AttachBatModel(bat_index_ < bat_catalog_.GetNumModels()
+                                    ? &bat_catalog_.GetModel(bat_index_)
+                                    : nullptr);
+      break;
+    case ci::app::KeyEvent::KEY_f:
+      is_fielding_ = !is_fielding_;
+      simulator_.AttachFieldingTeam(is_fielding_ ? &fielding_team_ : nullptr);
+      break;
+  }
+}
+
+void HomeRunDerbyApp::RegisterMetrics() {
+  simulator_metrics_.pitches = metrics_registry_.AddCounter(
+      "home_run_derby_pitches_total", "Pitches that have ended.");
+  simulator_metrics_.hits = metrics_registry_.AddCounter(
+      "home_run_derby_hits_total", "Pitches the bat made contact with.");
+  simulator_metrics_.home_runs = metrics_registry_.AddCounter(
+      "home_run_derby_home_runs_total", "Pitches hit for a home run.");
+  simulator_metrics_.outs = metrics_registry_.AddCounter(
+      "home_run_derby_outs_total", "Pitches that ended in an out.");
+  simulator_metrics_.catches = metrics_registry_.AddCounter(
+      "home_run_derby_catches_total", "Outs made by a fielder's catch.");
+  simulator_metrics_.collision_checks = metrics_registry_.AddCounter(
+      "home_run_derby_collision_checks_total",
+      "Ticks on which the ball was checked against the bat.");
+  tick_seconds_ = metrics_registry_.AddHistogram(
+      "home_run_derby_tick_seconds", "Time spent simulating a frame.",
+      kFrameSecondsBuckets);
+  draw_seconds_ = metrics_registry_.AddHistogram(
+      "home_run_derby_draw_seconds", "Time spent drawing a frame.",
+      kFrameSecondsBuckets);
+  allocations_ = metrics_registry_.AddCounter(
+      "home_run_derby_allocations_total",
+      "Heap allocations made while drawing frames; always zero unless "
+      "allocation tracking is compiled in.");
+  spectators_ = metrics_registry_.AddGauge(
+      "home_run_derby_spectators", "Spectators watching the game.");
+  quality_level_ = metrics_registry_.AddGauge(
+      "home_run_derby_quality_level",
+      "The level of visual detail drawn, from 0 for the least.");
+  swing_cache_hits_ = metrics_registry_.AddCounter(
+      "home_run_derby_swing_cache_hits_total",
+      "Candidate swings whose contact the computer batter had already seen.");
+  swing_cache_misses_ = metrics_registry_.AddCounter(
+      "home_run_derby_swing_cache_misses_total",
+      "Candidate swings whose contact the computer batter played out.");
+  simulator_.AttachMetrics(&simulator_metrics_);
+}
+
+void HomeRunDerbyApp::UpdateSwingCacheMetrics() {
+  // The caches count every lookup they have made, so only what is new since
+  // the last frame is added to the counters.
+  size_t num_hits = 0;
+  size_t num_misses = 0;
+  const AiBatter* ai_batters[] = {&ai_batter_, &second_ai_batter_};
+  for (const AiBatter* ai_batter : ai_batters) {
+    const OutcomeCache& cache = ai_batter->GetOptimizer().GetOutcomeCache();
+    num_hits += cache.GetNumHits();
+    num_misses += cache.GetNumMisses();
+  }
+  swing_cache_hits_->Increment(num_hits - num_swing_cache_hits_);
+  swing_cache_misses_->Increment(num_misses - num_swing_cache_misses_);
+  num_swing_cache_hits_ = num_hits;
+  num_swing_cache_misses_ = num_misses;
+}
+
+void HomeRunDerbyApp::DrawSplitScreen() const {
+  ci::gl::clear(kSplitScreenBorderColor);
+  // Each game is drawn as usual into its own half of the window. The window's
+  // matrices stay in place, so each view is scaled down to fit.
+  int view_width = static_cast<int>(kWindowSize * kStretchConstant / 2);
+  int view_height = static_cast<int>(kWindowSize / 2);
+  const Simulator* views[] = {&simulator_, &second_simulator_};
+  for (size_t i = 0; i < 2; ++i) {
+    ci::gl::ScopedViewport viewport(
+        ci::ivec2(static_cast<int>(i) * view_width, view_height / 2),
+        ci::ivec2(view_width, view_height));
+    DrawCanvasFeatures(*views[i]);
   }
 }
 
@@ -257,12 +694,126 @@ void HomeRunDerbyApp::DrawSolidRect(const vec2& top_left,
   ci::gl::drawSolidRect(container_box);
 }
 
-const string HomeRunDerbyApp::FloatToString(float float_to_convert) const {
-  // We are returning by value because the variable address is temporary.
-  ostringstream string_stream;
-  string_stream << roundf(pow(10.0f, kPrecision) * float_to_convert) /
-                       pow(10.0f, kPrecision);
-  return string_stream.str();
+SwingLimits HomeRunDerbyApp::MakeSwingLimits() const {
+  SwingLimits limits;
+  limits.min_bat_position =
+      vec2(kWindowSize * kStretchConstant / kBatXLimitFactor, kBatRadius);
+  limits.max_bat_position = vec2(kWindowSize * kStretchConstant,
+                                 kWindowSize - kBatRadius - kGroundHeight);
+  limits.max_bat_speed = kAiMaxBatSpeed;
+  limits.flight.right_edge = kWindowSize * kStretchConstant + kBallRadius;
+  limits.flight.stopped_speed = simulator_.GetBallStoppedSpeed();
+  limits.flight.max_ticks = kAiMaxTicks;
+  return limits;
+}
+
+PhysicsProfile HomeRunDerbyApp::LoadPhysicsProfile() const {
+  PhysicsProfile defaults;
+  defaults.gravity = kGravity;
+  defaults.ball_velocity_boost_factor = kBallVelocityBoostFactor;
+  defaults.ground_friction = kGroundFriction;
+  defaults.ground_restitution = kGroundRestitution;
+  defaults.distance_scale = kDistanceScaleConstant;
+  defaults.bat_mass = kBatMass;
+
+  // Without a profile, the game is played with the constants as written.
+  ci::fs::path path = ci::app::getAssetPath(kPhysicsProfileAsset);
+  if (path.empty()) {
+    return defaults;
+  }
+  try {
+    return PhysicsProfile::Load(path.string(), defaults);
+  } catch (const runtime_error& error) {
+    ci::app::console() << error.what() << std::endl;
+    return defaults;
+  }
+}
+
+FieldingSettings HomeRunDerbyApp::MakeFieldingSettings() const {
+  FieldingSettings settings;
+  settings.outfield_start_x = kOutfieldStartX;
+  settings.outfield_end_x = kOutfieldEndX;
+  settings.ground_location = kWindowSize - kGroundHeight;
+  settings.gravity = physics_.gravity;
+  settings.max_speed = kFielderSpeed;
+  settings.catch_radius = kFielderCatchRadius;
+  settings.catch_height = kFielderCatchHeight;
+  settings.separation = kFielderSeparation;
+  return settings;
+}
+
+void HomeRunDerbyApp::UpdateAiBatter(AiBatter* ai_batter,
+                                     Simulator* simulator) {
+  // Plan once, as the pitch is released, then follow the plan every frame.
+  if (simulator->GetPitchTick() == 0) {
+    AllocationScope scope("ai planning");
+    ai_batter->PlanSwing(simulator->GetBall(), simulator->GetBat());
+  }
+  simulator->UpdateBatStates(
+      ai_batter->GetBatPosition(simulator->GetPitchTick() + 1));
+}
+
+void HomeRunDerbyApp::StepFirstPlayer() {
+  Clock::time_point tick_start = Clock::now();
+  AllocationScope scope("simulation");
+  simulator_.UpdateOffset();
+  // Keep the moment each pitch is released, so it can be retried.
+  if (simulator_.GetPitchTick() == 0) {
+    simulator_.SaveSnapshot(&pitch_snapshot_);
+    has_pitch_snapshot_ = true;
+  }
+  if (is_ai_batting_) {
+    UpdateAiBatter(&ai_batter_, &simulator_);
+  }
+  simulator_.UpdateBallStates();
+  tick_seconds_->Observe(SecondsSince(tick_start));
+}
+
+void HomeRunDerbyApp::StepSecondPlayer() {
+  AllocationScope scope("second player simulation");
+  second_simulator_.UpdateOffset();
+  UpdateAiBatter(&second_ai_batter_, &second_simulator_);
+  second_simulator_.UpdateBallStates();
+}
+
+void HomeRunDerbyApp::UpdateFrameRate() {
+  // Nothing on the start and end screens moves until a key is pressed, so
+  // there is no need to redraw them at the full frame rate.
+  if (simulator_.IsStaticScreen() != is_idle_) {
+    is_idle_ = simulator_.IsStaticScreen();
+    ci::app::setFrameRate(is_idle_ ? kIdleFrameRate : kFrameRate);
+  }
+}
+
+QualitySettings HomeRunDerbyApp::MakeQualitySettings() const {
+  QualitySettings settings;
+  settings.frame_budget_seconds = 1 / kFrameRate;
+  settings.num_levels = kNumQualityLevels;
+  settings.start_level = kStartQualityLevel;
+  settings.lower_load = kLowerQualityLoad;
+  settings.raise_load = kRaiseQualityLoad;
+  settings.lower_frames = kLowerQualityFrames;
+  settings.raise_frames = kRaiseQualityFrames;
+  settings.smoothing = kQualitySmoothing;
+  return settings;
+}
+
+int HomeRunDerbyApp::GetCircleSegments(float radius) const {
+  // One segment per pixel of circumference is as fine as can be seen.
+  float circumference = 2 * kPi * radius;
+  return std::max(kMinCircleSegments,
+                  static_cast<int>(circumference *
+                                   quality_controller_.GetDetail()));
+}
+
+void HomeRunDerbyApp::DrawCenteredText(const ci::gl::TextureFontRef& font,
+                                       const string& text,
+                                       const vec2& position,
+                                       const ColorA& color) const {
+  ci::gl::color(color);
+  font->drawString(text,
+                   vec2(position.x - font->measureString(text).x / 2,
+                        position.y));
 }
 
 }  // namespace visualizer
@@ -0,0 +1,214 @@
+#include <visualizer/scenario.h>
+
+#include <algorithm>
+#include <exception>
+
+namespace home_run_derby {
+
+namespace visualizer {
+
+namespace {
+
+const char* const kEventNames[] = {"contact", "the pitch to end", "an out",
+                                   "a home run"};
+
+}  // namespace
+
+const size_t ScenarioRun::kMaxWaitTicks;
+
+Scenario::Scenario(const string& name) : name_(name) {
+}
+
+Scenario& Scenario::Do(const Action& action) {
+  Step step = Step();
+  step.kind = kAct;
+  step.action = action;
+  return AddStep(step);
+}
+
+Scenario& Scenario::MoveBat(const vec2& position) {
+  return Do([position](Simulator* simulator) {
+    simulator->UpdateBatStates(position);
+  });
+}
+
+Scenario& Scenario::Swing(const vector<vec2>& path) {
+  for (const vec2& position : path) {
+    MoveBat(position);
+    WaitTicks(1);
+  }
+  return *this;
+}
+
+Scenario& Scenario::WaitFor(ScenarioEvent event) {
+  Step step = Step();
+  step.kind = kWaitForEvent;
+  step.event = event;
+  step.description = kEventNames[static_cast<size_t>(event)];
+  return AddStep(step);
+}
+
+Scenario& Scenario::WaitTicks(size_t num_ticks) {
+  Step step = Step();
+  step.kind = kWaitTicks;
+  step.count = num_ticks;
+  step.description = std::to_string(num_ticks) + " ticks";
+  return AddStep(step);
+}
+
+Scenario& Scenario::WaitForPitchTick(size_t pitch_tick) {
+  Step step = Step();
+  step.kind = kWaitForPitchTick;
+  step.count = pitch_tick;
+  step.description = "pitch tick " + std::to_string(pitch_tick);
+  return AddStep(step);
+}
+
+Scenario& Scenario::Expect(const string& description, const Check& check) {
+  Step step = Step();
+  step.kind = kExpect;
+  step.check = check;
+  step.description = description;
+  return AddStep(step);
+}
+
+const string& Scenario::GetName() const {
+  return name_;
+}
+
+size_t Scenario::GetNumSteps() const {
+  return steps_.size();
+}
+
+Scenario& Scenario::AddStep(const Step& step) {
+  steps_.push_back(step);
+  return *this;
+}
+
+ScenarioRun::ScenarioRun(const Scenario* scenario, Simulator* simulator)
+    : scenario_(scenario),
+      simulator_(simulator),
+      step_(0),
+      is_done_(false),
+      num_ticks_(0),
+      is_waiting_(false),
+      num_wait_ticks_(0) {
+  std::fill(has_seen_, has_seen_ + kNumScenarioEvents, false);
+}
+
+bool ScenarioRun::Resume() {
+  if (is_done_) {
+    return false;
+  }
+  const vector<Scenario::Step>& steps = scenario_->steps_;
+  try {
+    // Carry out steps until one has to wait for the game.
+    while (step_ < steps.size()) {
+      const Scenario::Step& step = steps[step_];
+      if (step.kind == Scenario::kAct) {
+        step.action(simulator_);
+      } else if (step.kind == Scenario::kExpect) {
+        if (!step.check(*simulator_)) {
+          Fail("expected " + step.description);
+          return false;
+        }
+      } else {
+        if (!is_waiting_) {
+          is_waiting_ = true;
+          num_wait_ticks_ = 0;
+          std::fill(has_seen_, has_seen_ + kNumScenarioEvents, false);
+        }
+        if (!IsWaitOver(step)) {
+          break;
+        }
+        is_waiting_ = false;
+      }
+      ++step_;
+    }
+    if (step_ == steps.size()) {
+      is_done_ = true;
+      return false;
+    }
+
+    if (num_wait_ticks_ >= kMaxWaitTicks) {
+      Fail("gave up waiting for " + steps[step_].description);
+      return false;
+    }
+    Tick();
+  } catch (const std::exception& error) {
+    Fail(string("threw ") + error.what());
+    return false;
+  }
+  return true;
+}
+
+bool ScenarioRun::RunToEnd() {
+  while (Resume()) {
+  }
+  return HasPassed();
+}
+
+bool ScenarioRun::IsDone() const {
+  return is_done_;
+}
+
+bool ScenarioRun::HasPassed() const {
+  return is_done_ && failure_.empty();
+}
+
+const string& ScenarioRun::GetFailure() const {
+  return failure_;
+}
+
+size_t ScenarioRun::GetNumTicks() const {
+  return num_ticks_;
+}
+
+const Simulator& ScenarioRun::GetSimulator() const {
+  return *simulator_;
+}
+
+void ScenarioRun::Tick() {
+  bool had_collided = simulator_->GetBall().HasCollided();
+  size_t outs = simulator_->GetOuts();
+  float score = simulator_->GetScore();
+
+  simulator_->UpdateOffset();
+  simulator_->UpdateBallStates();
+  ++num_ticks_;
+  ++num_wait_ticks_;
+
+  // A new pitch is released the moment the last one ends.
+  bool has_pitch_ended = simulator_->GetPitchTick() == 0;
+  has_seen_[static_cast<size_t>(ScenarioEvent::kContact)] |=
+      !had_collided && simulator_->GetBall().HasCollided();
+  has_seen_[static_cast<size_t>(ScenarioEvent::kPitchEnded)] |=
+      has_pitch_ended;
+  has_seen_[static_cast<size_t>(ScenarioEvent::kOut)] |=
+      simulator_->GetOuts() > outs;
+  has_seen_[static_cast<size_t>(ScenarioEvent::kHomeRun)] |=
+      simulator_->GetScore() > score;
+}
+
+bool ScenarioRun::IsWaitOver(const Scenario::Step& step) const {
+  switch (step.kind) {
+    case Scenario::kWaitForEvent:
+      return has_seen_[static_cast<size_t>(step.event)];
+    case Scenario::kWaitTicks:
+      return num_wait_ticks_ >= step.count;
+    case Scenario::kWaitForPitchTick:
+      return simulator_->GetPitchTick() == step.count;
+    default:
+      return true;
+  }
+}
+
+void ScenarioRun::Fail(const string& reason) {
+  failure_ = scenario_->GetName() + ": " + reason + " at tick " +
+             std::to_string(num_ticks_);
+  is_done_ = true;
+}
+
+}  // namespace visualizer
+
+}  // namespace home_run_derby
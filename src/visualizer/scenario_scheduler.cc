@@ -0,0 +1,62 @@
+#include <visualizer/scenario_scheduler.h>
+
+#include <algorithm>
+#include <thread>
+
+namespace home_run_derby {
+
+namespace visualizer {
+
+ScenarioScheduler::ScenarioScheduler(size_t num_workers) : runs_(nullptr) {
+  if (num_workers == 0) {
+    num_workers = std::max(1u, std::thread::hardware_concurrency());
+  }
+  for (size_t i = 0; i < num_workers; ++i) {
+    workers_.emplace_back(new StepWorker([this, i] { RunShare(i); }));
+  }
+}
+
+size_t ScenarioScheduler::Run(vector<ScenarioRun>* runs) {
+  runs_ = runs;
+  for (unique_ptr<StepWorker>& worker : workers_) {
+    worker->Post();
+  }
+  for (unique_ptr<StepWorker>& worker : workers_) {
+    worker->Join();
+  }
+  runs_ = nullptr;
+
+  size_t num_passed = 0;
+  for (const ScenarioRun& run : *runs) {
+    if (run.HasPassed()) {
+      ++num_passed;
+    }
+  }
+  return num_passed;
+}
+
+size_t ScenarioScheduler::GetNumWorkers() const {
+  return workers_.size();
+}
+
+void ScenarioScheduler::RunShare(size_t worker) {
+  vector<ScenarioRun*> active;
+  for (size_t i = worker; i < runs_->size(); i += workers_.size()) {
+    active.push_back(&(*runs_)[i]);
+  }
+  while (!active.empty()) {
+    // Give every run a tick, dropping the ones that finish.
+    for (size_t i = 0; i < active.size();) {
+      if (active[i]->Resume()) {
+        ++i;
+      } else {
+        active[i] = active.back();
+        active.pop_back();
+      }
+    }
+  }
+}
+
+}  // namespace visualizer
+
+}  // namespace home_run_derby
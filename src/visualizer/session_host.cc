@@ -0,0 +1,204 @@
+#include <visualizer/session_host.h>
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+
+namespace home_run_derby {
+
+namespace visualizer {
+
+using std::invalid_argument;
+
+// Fine enough to tell a session that waited behind a few batches from one
+// that waited a whole frame.
+const vector<double> SessionHost::kTickLatencyBuckets = {
+    0.00005, 0.0001, 0.00025, 0.0005, 0.001, 0.002, 0.004,
+    0.007,   0.01,   0.02,    0.05,   0.1,   0.5};
+
+const size_t SessionHost::kMaxQueuedInputs;
+
+SessionHost::Session::Session(const Simulator& prototype)
+    : simulator(prototype), is_open(false), num_inputs(0) {
+  stats.num_ticks = 0;
+  stats.num_slow_ticks = 0;
+  stats.last_tick_seconds = 0;
+}
+
+SessionHost::SessionHost(const Simulator& prototype,
+                         const SessionHostSettings& settings)
+    : settings_(settings), num_used_sessions_(0), next_batch_(0) {
+  if (settings_.max_sessions == 0 || settings_.batch_size == 0 ||
+      settings_.max_outs == 0 || !(settings_.tick_slo_seconds > 0)) {
+    throw invalid_argument("Session host settings are out of range");
+  }
+  if (settings_.num_workers == 0) {
+    settings_.num_workers = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  prototype.SaveSnapshot(&prototype_snapshot_);
+  sessions_.reserve(settings_.max_sessions);
+  free_sessions_.reserve(settings_.max_sessions);
+  for (size_t i = 0; i < settings_.max_sessions; ++i) {
+    sessions_.emplace_back(prototype);
+    free_sessions_.push_back(settings_.max_sessions - 1 - i);
+  }
+  for (size_t i = 0; i < settings_.num_workers; ++i) {
+    worker_latencies_.emplace_back(new Histogram(kTickLatencyBuckets));
+    worker_hits_.emplace_back(new HitStatistics());
+    workers_.emplace_back(new StepWorker([this, i] { TickBatches(i); }));
+  }
+}
+
+size_t SessionHost::OpenSession(uint64_t seed) {
+  if (free_sessions_.empty()) {
+    throw std::runtime_error("Every session is already open");
+  }
+  size_t number = free_sessions_.back();
+  free_sessions_.pop_back();
+  num_used_sessions_ = std::max(num_used_sessions_, number + 1);
+
+  // Restoring the prototype's snapshot resets the game without allocating.
+  Session& session = sessions_[number];
+  session.simulator.RestoreSnapshot(prototype_snapshot_);
+  session.simulator.Seed(seed);
+  session.simulator.ResetGame();
+  session.is_open = true;
+  session.num_inputs = 0;
+  session.stats.num_ticks = 0;
+  session.stats.num_slow_ticks = 0;
+  session.stats.last_tick_seconds = 0;
+  return number;
+}
+
+void SessionHost::CloseSession(size_t session) {
+  GetOpenSession(session).is_open = false;
+  // Keep the lowest number at the back, so sessions stay packed together.
+  free_sessions_.insert(std::upper_bound(free_sessions_.begin(),
+                                         free_sessions_.end(), session,
+                                         std::greater<size_t>()),
+                        session);
+  while (num_used_sessions_ > 0 && !sessions_[num_used_sessions_ - 1].is_open) {
+    --num_used_sessions_;
+  }
+}
+
+bool SessionHost::IsOpen(size_t session) const {
+  return session < sessions_.size() && sessions_[session].is_open;
+}
+
+void SessionHost::StartGame(size_t session) {
+  Simulator& simulator = GetOpenSession(session).simulator;
+  if (simulator.GetCurrentGameState() == Simulator::kEndScreen) {
+    // The start screen sets up the next game.
+    simulator.SetGameState(Simulator::kStartScreen);
+  }
+  simulator.SetGameState(Simulator::kInGame);
+}
+
+void SessionHost::QueueInput(size_t session, const vec2& bat_position) {
+  Session& open_session = GetOpenSession(session);
+  if (open_session.num_inputs < kMaxQueuedInputs) {
+    ++open_session.num_inputs;
+  }
+  open_session.inputs[open_session.num_inputs - 1] = bat_position;
+}
+
+void SessionHost::Tick() {
+  tick_start_ = Clock::now();
+  next_batch_.store(0, std::memory_order_relaxed);
+  for (unique_ptr<StepWorker>& worker : workers_) {
+    worker->Post();
+  }
+  for (unique_ptr<StepWorker>& worker : workers_) {
+    worker->Join();
+  }
+}
+
+void SessionHost::TickBatches(size_t worker) {
+  Histogram* latencies = worker_latencies_[worker].get();
+  HitStatistics* hits = worker_hits_[worker].get();
+  size_t num_batches = (num_used_sessions_ + settings_.batch_size - 1) /
+                       settings_.batch_size;
+  size_t batch;
+  while ((batch = next_batch_.fetch_add(1, std::memory_order_relaxed)) <
+         num_batches) {
+    size_t end = std::min((batch + 1) * settings_.batch_size,
+                          num_used_sessions_);
+    for (size_t i = batch * settings_.batch_size; i < end; ++i) {
+      TickSession(&sessions_[i], latencies, hits);
+    }
+  }
+}
+
+void SessionHost::TickSession(Session* session, Histogram* latencies,
+                              HitStatistics* hits) {
+  if (!session->is_open) {
+    return;
+  }
+  Simulator& simulator = session->simulator;
+  // Whichever worker ticks the session records its hits.
+  simulator.AttachHitStatistics(hits);
+  for (size_t i = 0; i < session->num_inputs; ++i) {
+    simulator.UpdateBatStates(session->inputs[i]);
+  }
+  session->num_inputs = 0;
+  if (simulator.GetCurrentGameState() != Simulator::kInGame) {
+    return;
+  }
+
+  simulator.UpdateOffset();
+  simulator.UpdateBallStates();
+  if (simulator.GetOuts() >= settings_.max_outs) {
+    simulator.SetGameState(Simulator::kEndScreen);
+  }
+
+  double seconds =
+      std::chrono::duration<double>(Clock::now() - tick_start_).count();
+  latencies->Observe(seconds);
+  ++session->stats.num_ticks;
+  if (seconds > settings_.tick_slo_seconds) {
+    ++session->stats.num_slow_ticks;
+  }
+  session->stats.last_tick_seconds = seconds;
+}
+
+size_t SessionHost::GetNumOpenSessions() const {
+  return sessions_.size() - free_sessions_.size();
+}
+
+size_t SessionHost::GetMaxSessions() const {
+  return sessions_.size();
+}
+
+const Simulator& SessionHost::GetSimulator(size_t session) const {
+  return sessions_[session].simulator;
+}
+
+const SessionStats& SessionHost::GetStats(size_t session) const {
+  return sessions_[session].stats;
+}
+
+void SessionHost::CollectTickLatencies(Histogram* latencies) const {
+  for (const unique_ptr<Histogram>& worker_latencies : worker_latencies_) {
+    latencies->Merge(*worker_latencies);
+  }
+}
+
+void SessionHost::CollectHitStatistics(HitStatistics* hits) const {
+  for (const unique_ptr<HitStatistics>& worker_hits : worker_hits_) {
+    hits->Merge(*worker_hits);
+  }
+}
+
+SessionHost::Session& SessionHost::GetOpenSession(size_t session) {
+  if (!IsOpen(session)) {
+    throw invalid_argument("The session is not open");
+  }
+  return sessions_[session];
+}
+
+}  // namespace visualizer
+
+}  // namespace home_run_derby
@@ -1,9 +1,14 @@
 #include <visualizer/simulator.h>
 
+#include <type_traits>
+
 namespace home_run_derby {
 
 namespace visualizer {
 
+static_assert(std::is_trivially_copyable<SimulatorSnapshot>::value,
+              "Snapshots must be copyable as plain memory");
+
 Simulator::Simulator(float player_radius, float window_size,
                      float stretch_constant, float ground_height,
                      float ball_mass, float ball_radius, float gravity,
@@ -24,30 +29,77 @@ Simulator::Simulator(float player_radius, float window_size,
                 window_size),
       baseball_bat_(bat_mass, bat_radius),
       outs_(0),
+      pitch_tick_(0),
       current_score_(0),
       high_score_(0),
-      current_game_state_(0) {
+      current_game_state_(kStartScreen),
+      score_store_(nullptr),
+      leaderboard_(nullptr),
+      fielding_team_(nullptr),
+      metrics_(nullptr),
+      input_latency_tracker_(nullptr),
+      hit_statistics_(nullptr),
+      contact_analytics_(nullptr),
+      hit_(),
+      contact_x_(0),
+      has_hit_landed_(false) {
+  // The members above are freshly initialized, so the start screen does not
+  // need to run its enter hook here.
 }
 
-void Simulator::UpdateOffset(const vec2& new_offset, const vec2& new_speed) {
+void Simulator::UpdateOffset(const vec2& new_offset) {
   // Reset the ground location of the ball after updating the canvas with the
   // offset.
-  canvas_frame_.UpdateCanvas(new_offset, new_speed);
+  canvas_frame_.UpdateCanvas(new_offset);
   baseball_.SetGroundLocation(canvas_frame_.GetGroundLocation().first.y);
 }
 
 void Simulator::UpdateBallStates() {
+  float fall_speed = baseball_.GetSpeed().y;
   baseball_.UpdateStates();
+  ++pitch_tick_;
+
+  // Follow a hit through the air until it first comes down, which is when
+  // the ground turns its fall around.
+  if (baseball_.HasCollided() && !has_hit_landed_) {
+    ++hit_.flight_ticks;
+    has_hit_landed_ = fall_speed > 0 && baseball_.GetSpeed().y < fall_speed;
+  }
+
+  // A catch ends the pitch as an out, wherever the ball was headed.
+  if (fielding_team_ != nullptr) {
+    fielding_team_->Update(baseball_);
+    if (fielding_team_->HasCaught()) {
+      ++outs_;
+      Count(&SimulatorMetrics::pitches);
+      Count(&SimulatorMetrics::outs);
+      Count(&SimulatorMetrics::catches);
+      EndHit();
+      ResetPitch();
+      return;
+    }
+  }
 
   // If the baseball has already collided with the bat, change the location of
   // the canvas with respect to the ball.
   if (baseball_.HitPastScreen()) {
     canvas_frame_.UpdateCanvas(
         vec2(window_size_ * window_stretch_constant_ / 2, window_size_ / 2) -
-            baseball_.GetPosition(),
-        -baseball_.GetSpeed());
+        baseball_.GetPosition());
   } else {
+    bool had_collided = baseball_.HasCollided();
     baseball_.HandleBatCollisions(baseball_bat_);
+    Count(&SimulatorMetrics::collision_checks);
+    if (input_latency_tracker_ != nullptr) {
+      input_latency_tracker_->OnTick();
+    }
+    if (!had_collided && baseball_.HasCollided()) {
+      BeginHit();
+      Count(&SimulatorMetrics::hits);
+      if (input_latency_tracker_ != nullptr) {
+        input_latency_tracker_->OnContact();
+      }
+    }
 
     // If the ball is past the right edge of the screen when being pitched,
     // reset the states.
@@ -56,6 +108,9 @@ void Simulator::UpdateBallStates() {
       ResetStates();
     }
   }
+  // The next tick only follows the swing from here.
+  baseball_bat_.ClearWaypoints();
+
   // Whenever the ball stops moving, reset the states.
   if (abs(baseball_.GetSpeed().x) <= kBallConsideredStoppedVelocity) {
     ResetStates();
@@ -63,34 +118,214 @@ void Simulator::UpdateBallStates() {
 }
 
 void Simulator::UpdateBatStates(const vec2& new_position) {
-  // Set the bat velocity based on the previous bat position.
+  // Set the bat velocity based on the previous bat position, and remember
+  // that position so the tick can follow the whole swing.
+  baseball_bat_.AddWaypoint(baseball_bat_.GetBatPosition());
   baseball_bat_.SetBatSpeed(new_position - baseball_bat_.GetBatPosition());
   baseball_bat_.SetBatPosition(new_position);
+  if (input_latency_tracker_ != nullptr) {
+    input_latency_tracker_->OnBatUpdated();
+  }
 }
 
 void Simulator::IncrementGameState() {
-  // Update the current game state and constrain it.
-  ++current_game_state_ %= kNumGameStates;
+  // Move to the next game state and constrain it.
+  SetGameState(
+      static_cast<GameState>((current_game_state_ + 1) % kNumGameStates));
+}
+
+void Simulator::SetGameState(GameState new_state) {
+  if (new_state == current_game_state_) {
+    return;
+  }
+  // Switch states before running the hooks, so that a hook that throws cannot
+  // leave the game stuck repeating the same transition.
+  GameState previous_state = current_game_state_;
+  current_game_state_ = new_state;
+  OnExitState(previous_state);
+  OnEnterState(new_state);
+}
+
+void Simulator::OnEnterState(GameState state) {
+  switch (state) {
+    case kStartScreen:
+      // Set up the next game once, rather than on every start screen frame.
+      ResetGame();
+      break;
+    case kInGame:
+      if (input_latency_tracker_ != nullptr) {
+        input_latency_tracker_->BeginSession();
+      }
+      if (contact_analytics_ != nullptr) {
+        contact_analytics_->BeginSession();
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+void Simulator::OnExitState(GameState state) {
+  switch (state) {
+    case kInGame:
+      // The game is over, so the score is final.
+      if (leaderboard_ != nullptr) {
+        leaderboard_->Insert(current_score_);
+      }
+      if (score_store_ != nullptr) {
+        score_store_->RecordScore(current_score_);
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+void Simulator::AttachScoreStore(ScoreStore* score_store) {
+  score_store_ = score_store;
+  high_score_ = fmaxf(high_score_, score_store_->GetHighScore());
+}
+
+void Simulator::AttachLeaderboard(Leaderboard* leaderboard) {
+  leaderboard_ = leaderboard;
+}
+
+void Simulator::AttachStadium(const Stadium* stadium) {
+  baseball_.SetStadium(stadium);
+}
+
+void Simulator::Seed(uint64_t seed) {
+  // Give the ball and canvas unrelated sequences from the one seed.
+  baseball_.Seed(2 * seed);
+  canvas_frame_.Seed(2 * seed + 1);
+}
+
+void Simulator::SaveSnapshot(SimulatorSnapshot* snapshot) const {
+  baseball_.SaveState(&snapshot->ball);
+  snapshot->bat_position = baseball_bat_.GetBatPosition();
+  snapshot->bat_speed = baseball_bat_.GetBatSpeed();
+  canvas_frame_.SaveState(&snapshot->canvas);
+  snapshot->game_state = current_game_state_;
+  snapshot->outs = outs_;
+  snapshot->pitch_tick = pitch_tick_;
+  snapshot->score = current_score_;
+  snapshot->high_score = high_score_;
+  snapshot->hit = hit_;
+  snapshot->contact_x = contact_x_;
+  snapshot->has_hit_landed = has_hit_landed_;
+}
+
+void Simulator::RestoreSnapshot(const SimulatorSnapshot& snapshot) {
+  baseball_.RestoreState(snapshot.ball);
+  baseball_bat_.SetBatPosition(snapshot.bat_position);
+  baseball_bat_.SetBatSpeed(snapshot.bat_speed);
+  baseball_bat_.ClearWaypoints();
+  canvas_frame_.RestoreState(snapshot.canvas);
+  current_game_state_ = snapshot.game_state;
+  outs_ = snapshot.outs;
+  pitch_tick_ = snapshot.pitch_tick;
+  current_score_ = snapshot.score;
+  high_score_ = snapshot.high_score;
+  hit_ = snapshot.hit;
+  contact_x_ = snapshot.contact_x;
+  has_hit_landed_ = snapshot.has_hit_landed;
+  if (fielding_team_ != nullptr) {
+    fielding_team_->ResetPositions();
+  }
 }
 
 void Simulator::ResetStates() {
-  // Increment the outs if the ball was not hit past the screen.
-  if (!baseball_.HitPastScreen()) {
+  // Increment the outs if the ball was not hit for a home run.
+  Count(&SimulatorMetrics::pitches);
+  if (!baseball_.IsHomeRun()) {
     ++outs_;
+    Count(&SimulatorMetrics::outs);
   } else {
-    current_score_ -= baseball_.GetPosition().x;
+    current_score_ += baseball_.GetHomeRunDistance();
+    // Show a record as it is set, rather than once the game is over.
     high_score_ = fmaxf(high_score_, current_score_);
+    Count(&SimulatorMetrics::home_runs);
   }
-  baseball_.ResetState();
-  canvas_frame_.ResetState();
+  EndHit();
+  ResetPitch();
 }
 
 void Simulator::ResetGame() {
-  ResetStates();
+  // Reinitialize the ball and canvas in place without scoring the last pitch.
+  ResetPitch();
   outs_ = 0;
   current_score_ = 0;
 }
 
+void Simulator::AttachFieldingTeam(FieldingTeam* fielding_team) {
+  fielding_team_ = fielding_team;
+  if (fielding_team_ != nullptr) {
+    fielding_team_->ResetPositions();
+  }
+}
+
+void Simulator::SetBackgroundField(
+    const shared_ptr<const BackgroundField>& field) {
+  canvas_frame_.SetField(field);
+}
+
+void Simulator::AttachMetrics(const SimulatorMetrics* metrics) {
+  metrics_ = metrics;
+}
+
+void Simulator::AttachBatModel(const BatModel* model) {
+  baseball_bat_.SetModel(model);
+}
+
+void Simulator::AttachInputLatencyTracker(InputLatencyTracker* tracker) {
+  input_latency_tracker_ = tracker;
+}
+
+void Simulator::AttachHitStatistics(HitStatistics* statistics) {
+  hit_statistics_ = statistics;
+}
+
+void Simulator::AttachContactAnalytics(ContactAnalytics* analytics) {
+  contact_analytics_ = analytics;
+}
+
+void Simulator::Count(Counter* SimulatorMetrics::*counter) const {
+  if (metrics_ != nullptr && metrics_->*counter != nullptr) {
+    (metrics_->*counter)->Increment();
+  }
+}
+
+void Simulator::ResetPitch() {
+  baseball_.ResetState();
+  baseball_bat_.ClearWaypoints();
+  canvas_frame_.ResetState();
+  pitch_tick_ = 0;
+  if (fielding_team_ != nullptr) {
+    fielding_team_->ResetPositions();
+  }
+}
+
+void Simulator::BeginHit() {
+  const ContactEvent& contact = baseball_.GetContact();
+  hit_.distance = 0;
+  hit_.exit_speed = contact.exit_speed;
+  hit_.launch_angle_degrees = contact.launch_angle_degrees;
+  hit_.flight_ticks = 0;
+  contact_x_ = baseball_.GetPosition().x;
+  has_hit_landed_ = false;
+  if (contact_analytics_ != nullptr) {
+    contact_analytics_->Record(contact);
+  }
+}
+
+void Simulator::EndHit() {
+  if (hit_statistics_ == nullptr || !baseball_.HasCollided()) {
+    return;
+  }
+  hit_.distance = contact_x_ - baseball_.GetPosition().x;
+  hit_statistics_->Record(hit_);
+}
+
 const vec2 Simulator::GetBallDisplayPosition() const {
   if (baseball_.HitPastScreen()) {
     return vec2(window_stretch_constant_ * window_size_ / 2, window_size_ / 2);
@@ -98,7 +333,11 @@ const vec2 Simulator::GetBallDisplayPosition() const {
   return baseball_.GetPosition();
 }
 
-size_t Simulator::GetCurrentGameState() const {
+bool Simulator::IsStaticScreen() const {
+  return current_game_state_ != kInGame;
+}
+
+Simulator::GameState Simulator::GetCurrentGameState() const {
   return current_game_state_;
 }
 
@@ -118,6 +357,14 @@ size_t Simulator::GetOuts() const {
   return outs_;
 }
 
+size_t Simulator::GetPitchTick() const {
+  return pitch_tick_;
+}
+
+float Simulator::GetBallStoppedSpeed() const {
+  return kBallConsideredStoppedVelocity;
+}
+
 float Simulator::GetScore() const {
   return current_score_;
 }
@@ -0,0 +1,209 @@
+#include <visualizer/spectator_broadcaster.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace home_run_derby {
+
+namespace visualizer {
+
+namespace {
+
+void MakeFrame(const Simulator& simulator, uint32_t tick,
+               SpectatorFrame* frame) {
+  const vec2& ball = simulator.GetBall().GetPosition();
+  const vec2& bat = simulator.GetBat().GetBatPosition();
+  const vec2& offset = simulator.GetCanvasFrame().GetOffset();
+  frame->tick = tick;
+  frame->values[kBallX] = QuantizePosition(ball.x);
+  frame->values[kBallY] = QuantizePosition(ball.y);
+  frame->values[kBatX] = QuantizePosition(bat.x);
+  frame->values[kBatY] = QuantizePosition(bat.y);
+  frame->values[kOffsetX] = QuantizePosition(offset.x);
+  frame->values[kOffsetY] = QuantizePosition(offset.y);
+  frame->values[kOuts] = static_cast<int32_t>(simulator.GetOuts());
+  frame->values[kScore] =
+      static_cast<int32_t>(std::lround(simulator.GetScore()));
+  frame->values[kGameState] =
+      static_cast<int32_t>(simulator.GetCurrentGameState());
+}
+
+}  // namespace
+
+const size_t SpectatorBroadcaster::kQueueSize;
+const size_t SpectatorBroadcaster::kMaxSpectators;
+const int SpectatorBroadcaster::kPollMilliseconds;
+const int SpectatorBroadcaster::kSpectatorTimeoutSeconds;
+
+SpectatorBroadcaster::SpectatorBroadcaster(uint16_t port)
+    : port_(port),
+      is_running_(false),
+      write_index_(0),
+      read_index_(0),
+      next_tick_(0),
+      num_spectators_(0),
+      num_bytes_sent_(0),
+      num_frames_sent_(0),
+      num_dropped_frames_(0) {
+  spectators_.reserve(kMaxSpectators);
+}
+
+SpectatorBroadcaster::~SpectatorBroadcaster() {
+  Stop();
+}
+
+void SpectatorBroadcaster::Start() {
+  Stop();
+  socket_.Open(port_);
+  spectators_.clear();
+  num_spectators_.store(0);
+  read_index_.store(write_index_.load());
+  is_running_.store(true);
+  thread_ = std::thread(&SpectatorBroadcaster::Run, this);
+}
+
+void SpectatorBroadcaster::Stop() {
+  is_running_.store(false);
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  socket_.Close();
+}
+
+bool SpectatorBroadcaster::Publish(const Simulator& simulator) {
+  if (!is_running_.load(std::memory_order_relaxed)) {
+    return false;
+  }
+  uint64_t write_index = write_index_.load(std::memory_order_relaxed);
+  if (write_index - read_index_.load(std::memory_order_acquire) >=
+      kQueueSize) {
+    num_dropped_frames_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  MakeFrame(simulator, next_tick_++, &queue_[write_index % kQueueSize]);
+  write_index_.store(write_index + 1, std::memory_order_release);
+  return true;
+}
+
+uint16_t SpectatorBroadcaster::GetPort() const {
+  return socket_.GetPort();
+}
+
+size_t SpectatorBroadcaster::GetNumSpectators() const {
+  return num_spectators_.load(std::memory_order_relaxed);
+}
+
+uint64_t SpectatorBroadcaster::GetNumBytesSent() const {
+  return num_bytes_sent_.load(std::memory_order_relaxed);
+}
+
+uint64_t SpectatorBroadcaster::GetNumFramesSent() const {
+  return num_frames_sent_.load(std::memory_order_relaxed);
+}
+
+uint64_t SpectatorBroadcaster::GetNumDroppedFrames() const {
+  return num_dropped_frames_.load(std::memory_order_relaxed);
+}
+
+void SpectatorBroadcaster::Run() {
+  while (is_running_.load()) {
+    socket_.Wait(kPollMilliseconds);
+    HandleMessages();
+
+    // A mirror only needs the newest frame; any older ones still queued are
+    // skipped rather than sent late.
+    uint64_t write_index = write_index_.load(std::memory_order_acquire);
+    if (write_index != read_index_.load(std::memory_order_relaxed)) {
+      SpectatorFrame frame = queue_[(write_index - 1) % kQueueSize];
+      read_index_.store(write_index, std::memory_order_release);
+      SendFrame(frame);
+    }
+    DropSilentSpectators();
+  }
+}
+
+void SpectatorBroadcaster::HandleMessages() {
+  uint8_t message[kMaxSpectatorMessageSize];
+  SocketAddress sender;
+  size_t size;
+  while ((size = socket_.Receive(message, sizeof(message), &sender)) > 0) {
+    SpectatorMessage type;
+    if (!ReadMessageType(message, size, &type)) {
+      continue;
+    }
+    vector<Spectator>::iterator spectator = std::find_if(
+        spectators_.begin(), spectators_.end(),
+        [&sender](const Spectator& other) { return other.address == sender; });
+
+    if (type == SpectatorMessage::kJoin) {
+      // Joining again starts over from a keyframe.
+      if (spectator == spectators_.end()) {
+        if (spectators_.size() >= kMaxSpectators) {
+          continue;
+        }
+        spectators_.push_back(Spectator());
+        spectator = spectators_.end() - 1;
+        spectator->address = sender;
+      }
+      spectator->has_reference = false;
+      spectator->last_heard = Clock::now();
+    } else if (type == SpectatorMessage::kLeave) {
+      if (spectator != spectators_.end()) {
+        spectators_.erase(spectator);
+      }
+    } else if (type == SpectatorMessage::kAck &&
+               spectator != spectators_.end()) {
+      uint32_t tick;
+      if (!DecodeAck(message, size, &tick)) {
+        continue;
+      }
+      spectator->last_heard = Clock::now();
+      // Acknowledgements can arrive out of order; only move forwards.
+      const SpectatorFrame& acknowledged =
+          sent_frames_[tick % kSpectatorHistorySize];
+      if (acknowledged.tick == tick &&
+          (!spectator->has_reference ||
+           static_cast<int32_t>(tick - spectator->reference.tick) > 0)) {
+        spectator->reference = acknowledged;
+        spectator->has_reference = true;
+      }
+    }
+  }
+  num_spectators_.store(spectators_.size(), std::memory_order_relaxed);
+}
+
+void SpectatorBroadcaster::SendFrame(const SpectatorFrame& frame) {
+  sent_frames_[frame.tick % kSpectatorHistorySize] = frame;
+  uint8_t message[kMaxSpectatorMessageSize];
+  for (Spectator& spectator : spectators_) {
+    // The spectator only keeps recent frames, so build on an older one with a
+    // keyframe instead.
+    bool is_delta = spectator.has_reference &&
+                    frame.tick - spectator.reference.tick <
+                        kSpectatorHistorySize;
+    size_t size = EncodeFrame(
+        frame, is_delta ? &spectator.reference : nullptr, message);
+    // A frame that would block is simply lost; the next builds on the same
+    // acknowledged frame, so the spectator catches up.
+    if (socket_.SendTo(spectator.address, message, size)) {
+      num_bytes_sent_.fetch_add(size, std::memory_order_relaxed);
+      num_frames_sent_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+}
+
+void SpectatorBroadcaster::DropSilentSpectators() {
+  Clock::time_point cutoff =
+      Clock::now() - std::chrono::seconds(kSpectatorTimeoutSeconds);
+  spectators_.erase(
+      std::remove_if(spectators_.begin(), spectators_.end(),
+                     [cutoff](const Spectator& spectator) {
+                       return spectator.last_heard < cutoff;
+                     }),
+      spectators_.end());
+  num_spectators_.store(spectators_.size(), std::memory_order_relaxed);
+}
+
+}  // namespace visualizer
+
+}  // namespace home_run_derby
@@ -0,0 +1,58 @@
+#include <core/background_field.h>
+
+#include <catch2/catch.hpp>
+
+using glm::vec2;
+using home_run_derby::BackgroundField;
+
+TEST_CASE("Test BackgroundField class") {
+  BackgroundField field(1080, 16.0f / 9.0f, 20, 10, 5, 1, 7);
+
+  SECTION("Test the layout is fixed by the seed") {
+    BackgroundField same(1080, 16.0f / 9.0f, 20, 10, 5, 1, 7);
+    BackgroundField different(1080, 16.0f / 9.0f, 20, 10, 5, 1, 8);
+    REQUIRE(field.GetNumStars() == 20);
+    REQUIRE(field.GetNumDirtParticles() == 10);
+    REQUIRE(field.GetStarPosition(3, vec2(0, 0)) ==
+            same.GetStarPosition(3, vec2(0, 0)));
+    REQUIRE(field.GetStarPosition(3, vec2(0, 0)) !=
+            different.GetStarPosition(3, vec2(0, 0)));
+  }
+
+  SECTION("Test stars stay on the canvas wherever the view has scrolled") {
+    vec2 scrolls[] = {vec2(0, 0), vec2(-123456, 98765), vec2(4000, -3e6f)};
+    for (const vec2& scroll : scrolls) {
+      for (size_t i = 0; i < field.GetNumStars(); ++i) {
+        vec2 star = field.GetStarPosition(i, scroll);
+        REQUIRE(star.x >= -5);
+        REQUIRE(star.x < 1920 + 5);
+        REQUIRE(star.y >= -5);
+        REQUIRE(star.y < 1080 + 5);
+      }
+    }
+  }
+
+  SECTION("Test stars drift slower than the view for parallax") {
+    for (size_t i = 0; i < field.GetNumStars(); ++i) {
+      vec2 star = field.GetStarPosition(i, vec2(0, 0));
+      vec2 moved = field.GetStarPosition(i, vec2(0, 10));
+      // Skip a star that wrapped around.
+      if (moved.y > star.y) {
+        REQUIRE(moved.y - star.y >= 0.99f);
+        REQUIRE(moved.y - star.y <= 4.01f);
+      }
+      REQUIRE(moved.x == star.x);
+    }
+  }
+
+  SECTION("Test dirt stays in the ground as the view rises") {
+    for (size_t i = 0; i < field.GetNumDirtParticles(); ++i) {
+      vec2 dirt_particle = field.GetDirtParticlePosition(i, vec2(0, 0));
+      REQUIRE(dirt_particle.y >= 1080);
+      REQUIRE(field.GetDirtParticlePosition(i, vec2(0, 5000)).y ==
+              Approx(dirt_particle.y + 5000));
+      vec2 wrapped = field.GetDirtParticlePosition(i, vec2(-1922, 0));
+      REQUIRE(wrapped.x == Approx(dirt_particle.x).margin(0.01));
+    }
+  }
+}
@@ -0,0 +1,182 @@
+#include <core/ball.h>
+#include <core/bat.h>
+#include <core/bat_catalog.h>
+
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using glm::vec2;
+using home_run_derby::Ball;
+using home_run_derby::Bat;
+using home_run_derby::BatCatalog;
+using home_run_derby::BatModel;
+using home_run_derby::BatProfile;
+using home_run_derby::BatResponse;
+using std::string;
+using std::vector;
+
+namespace {
+
+const string kTestCatalogPath = "test_bat_catalog.bin";
+
+BatProfile MakeProfile(const string& name) {
+  BatProfile profile = {name, 5,     300,   6,     15,   0.3f,
+                        0.6f, 0.8f, 0.1f, 0.95f, 0.5f};
+  return profile;
+}
+
+}  // namespace
+
+TEST_CASE("Test BatModel class") {
+  BatModel model = BatModel::Build(MakeProfile("Ash"));
+
+  SECTION("Test the geometry") {
+    REQUIRE(string(model.GetName()) == "Ash");
+    REQUIRE(model.GetMass() == 5);
+    REQUIRE(model.GetLength() == 300);
+    REQUIRE(model.GetBarrelRadius() == 15);
+    REQUIRE(model.GetSweetSpot() == Approx(240));
+    // The barrel is heavier than the handle.
+    REQUIRE(model.GetCenterOfMass() > 150);
+    REQUIRE(model.GetCenterOfMass() < 300);
+  }
+
+  SECTION("Test the sweet spot is the liveliest point") {
+    BatResponse sweet_spot = model.GetResponse(model.GetSweetSpot());
+    REQUIRE(sweet_spot.restitution == Approx(0.95f).epsilon(0.01));
+    REQUIRE(model.GetResponse(0).restitution == Approx(0.5f).epsilon(0.01));
+    REQUIRE(model.GetResponse(300).restitution < sweet_spot.restitution);
+  }
+
+  SECTION("Test the ball feels the whole bat only at its center of mass") {
+    BatResponse center = model.GetResponse(model.GetCenterOfMass());
+    REQUIRE(center.effective_mass == Approx(5).epsilon(0.01));
+    REQUIRE(model.GetResponse(0).effective_mass < center.effective_mass);
+    REQUIRE(model.GetResponse(300).effective_mass < center.effective_mass);
+    REQUIRE(model.GetResponse(300).effective_mass > 0);
+  }
+
+  SECTION("Test lookups are interpolated and clamped") {
+    BatResponse first = model.GetResponse(0);
+    BatResponse second = model.GetResponse(300.0f / (BatModel::kTableSize - 1));
+    BatResponse between =
+        model.GetResponse(150.0f / (BatModel::kTableSize - 1));
+    REQUIRE(between.restitution ==
+            Approx((first.restitution + second.restitution) / 2));
+    REQUIRE(model.GetResponse(-50).restitution == first.restitution);
+    REQUIRE(model.GetResponse(1000).restitution ==
+            model.GetResponse(300).restitution);
+  }
+
+  SECTION("Test contact positions") {
+    REQUIRE(model.GetContactPosition(0) == Approx(240));
+    REQUIRE(model.GetContactPosition(1) == Approx(300));
+    REQUIRE(model.GetContactPosition(-1) == Approx(0));
+    REQUIRE(model.GetContactPosition(-0.5f) == Approx(120));
+    REQUIRE(model.GetContactPosition(7) == Approx(300));
+  }
+
+  SECTION("Test profiles out of range") {
+    BatProfile profile = MakeProfile("");
+    REQUIRE_THROWS_AS(BatModel::Build(profile), std::invalid_argument);
+    profile = MakeProfile(string(BatModel::kMaxNameLength + 1, 'x'));
+    REQUIRE_THROWS_AS(BatModel::Build(profile), std::invalid_argument);
+    profile = MakeProfile("Bent");
+    profile.taper_start = 0.7f;
+    REQUIRE_THROWS_AS(BatModel::Build(profile), std::invalid_argument);
+    profile = MakeProfile("Springy");
+    profile.peak_restitution = 1.5f;
+    REQUIRE_THROWS_AS(BatModel::Build(profile), std::invalid_argument);
+  }
+}
+
+TEST_CASE("Test BatCatalog class") {
+  remove(kTestCatalogPath.c_str());
+  vector<BatModel> models;
+  models.push_back(BatModel::Build(MakeProfile("Ash")));
+  BatProfile aluminum = MakeProfile("Aluminum");
+  aluminum.mass = 4;
+  aluminum.sweet_spot_width = 0.2f;
+  models.push_back(BatModel::Build(aluminum));
+  BatCatalog(models).Save(kTestCatalogPath);
+
+  SECTION("Test loading what was saved") {
+    BatCatalog catalog = BatCatalog::Load(kTestCatalogPath);
+    REQUIRE(catalog.GetNumModels() == 2);
+    REQUIRE(string(catalog.GetModel(1).GetName()) == "Aluminum");
+    REQUIRE(catalog.GetModel(1).GetMass() == 4);
+    for (float position = 0; position <= 300; position += 7) {
+      REQUIRE(catalog.GetModel(1).GetResponse(position).restitution ==
+              models[1].GetResponse(position).restitution);
+    }
+    REQUIRE(catalog.Find("Ash") == &catalog.GetModel(0));
+    REQUIRE(catalog.Find("Birch") == nullptr);
+  }
+
+  SECTION("Test a missing catalog") {
+    remove(kTestCatalogPath.c_str());
+    REQUIRE_THROWS_AS(BatCatalog::Load(kTestCatalogPath), std::runtime_error);
+  }
+
+  SECTION("Test a corrupt catalog") {
+    FILE* file = fopen(kTestCatalogPath.c_str(), "r+b");
+    REQUIRE(file != nullptr);
+    fseek(file, -3, SEEK_END);
+    fputc('!', file);
+    fclose(file);
+    REQUIRE_THROWS_AS(BatCatalog::Load(kTestCatalogPath), std::runtime_error);
+  }
+
+  SECTION("Test a truncated catalog") {
+    FILE* file = fopen(kTestCatalogPath.c_str(), "wb");
+    REQUIRE(file != nullptr);
+    fputs("HRD", file);
+    fclose(file);
+    REQUIRE_THROWS_AS(BatCatalog::Load(kTestCatalogPath), std::runtime_error);
+  }
+
+  remove(kTestCatalogPath.c_str());
+}
+
+TEST_CASE("Test hitting with a catalog bat") {
+  Ball ball(1, 5, 0.6f, 0.1f, 0.2f, 1, 25, 2, 2, 3, 3, 100);
+  ball.SetGroundLocation(80);
+  Bat bat(1, 1);
+  bat.SetBatPosition(vec2(-5, 50));
+  bat.SetBatSpeed(vec2(-10, -1));
+
+  BatProfile lively = MakeProfile("Lively");
+  lively.min_restitution = 1;
+  lively.peak_restitution = 1;
+  BatProfile dead = MakeProfile("Dead");
+  dead.min_restitution = 0;
+  dead.peak_restitution = 0;
+  BatModel lively_model = BatModel::Build(lively);
+  BatModel dead_model = BatModel::Build(dead);
+
+  SECTION("Test the model takes the place of the bat's mass and radius") {
+    bat.SetModel(&lively_model);
+    REQUIRE(bat.GetModel() == &lively_model);
+    REQUIRE(bat.GetBatMass() == 5);
+    REQUIRE(bat.GetBatRadius() == 15);
+    bat.SetModel(nullptr);
+    REQUIRE(bat.GetBatMass() == 1);
+    REQUIRE(bat.GetBatRadius() == 1);
+  }
+
+  SECTION("Test a livelier bat hits the ball harder") {
+    Ball lively_ball(ball);
+    bat.SetModel(&lively_model);
+    lively_ball.HandleBatCollisions(bat);
+    Ball dead_ball(ball);
+    bat.SetModel(&dead_model);
+    dead_ball.HandleBatCollisions(bat);
+    REQUIRE(lively_ball.HasCollided());
+    REQUIRE(dead_ball.HasCollided());
+    REQUIRE(glm::length(lively_ball.GetSpeed()) >
+            glm::length(dead_ball.GetSpeed()));
+  }
+}
@@ -0,0 +1,79 @@
+#include <core/bat_predictor.h>
+
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <stdexcept>
+
+using glm::vec2;
+using home_run_derby::BatPredictor;
+using std::chrono::milliseconds;
+
+TEST_CASE("Test BatPredictor class") {
+  BatPredictor predictor(0.85f, 0.4f, 0.02);
+  BatPredictor::Clock::time_point start = BatPredictor::Clock::now();
+
+  SECTION("Test without samples") {
+    REQUIRE_FALSE(predictor.HasSamples());
+    REQUIRE(predictor.Predict(start) == vec2(0, 0));
+  }
+
+  SECTION("Test the first sample is taken as it is") {
+    predictor.AddSample(vec2(100, 200), start);
+    REQUIRE(predictor.HasSamples());
+    REQUIRE(predictor.Predict(start + milliseconds(5)) == vec2(100, 200));
+  }
+
+  SECTION("Test a steady swing is extrapolated") {
+    // 1000 pixels per second to the right, sampled every 4 ms.
+    for (int i = 0; i <= 50; ++i) {
+      predictor.AddSample(vec2(static_cast<float>(4 * i), 300),
+                          start + milliseconds(4 * i));
+    }
+    REQUIRE(predictor.GetVelocity().x == Approx(1000).epsilon(0.01));
+    REQUIRE(predictor.GetVelocity().y == Approx(0).margin(0.001));
+    vec2 predicted = predictor.Predict(start + milliseconds(207));
+    REQUIRE(predicted.x == Approx(207).epsilon(0.01));
+    REQUIRE(predicted.y == Approx(300));
+  }
+
+  SECTION("Test a bat that stopped is not extrapolated past the horizon") {
+    predictor.AddSample(vec2(0, 0), start);
+    predictor.AddSample(vec2(10, 0), start + milliseconds(10));
+    REQUIRE(predictor.Predict(start + milliseconds(15)).x >
+            predictor.GetPosition().x);
+    // The filter has not caught up with the last sample, but the bat is
+    // drawn where it stopped.
+    REQUIRE(predictor.GetPosition().x < 10);
+    REQUIRE(predictor.Predict(start + milliseconds(50)) == vec2(10, 0));
+  }
+
+  SECTION("Test a pause starts the estimates over") {
+    predictor.AddSample(vec2(0, 0), start);
+    predictor.AddSample(vec2(10, 0), start + milliseconds(10));
+    predictor.AddSample(vec2(500, 40), start + milliseconds(500));
+    REQUIRE(predictor.GetPosition() == vec2(500, 40));
+    REQUIRE(predictor.GetVelocity() == vec2(0, 0));
+  }
+
+  SECTION("Test samples at the same instant") {
+    predictor.AddSample(vec2(0, 0), start);
+    predictor.AddSample(vec2(100, 0), start);
+    REQUIRE(predictor.GetPosition().x == Approx(85));
+    REQUIRE(predictor.GetVelocity() == vec2(0, 0));
+  }
+
+  SECTION("Test Reset()") {
+    predictor.AddSample(vec2(100, 200), start);
+    predictor.Reset();
+    REQUIRE_FALSE(predictor.HasSamples());
+    predictor.AddSample(vec2(5, 5), start + milliseconds(1));
+    REQUIRE(predictor.GetPosition() == vec2(5, 5));
+  }
+
+  SECTION("Test settings out of range") {
+    REQUIRE_THROWS_AS(BatPredictor(0, 0.4f, 0.02), std::invalid_argument);
+    REQUIRE_THROWS_AS(BatPredictor(1.5f, 0.4f, 0.02), std::invalid_argument);
+    REQUIRE_THROWS_AS(BatPredictor(0.5f, -1, 0.02), std::invalid_argument);
+    REQUIRE_THROWS_AS(BatPredictor(0.5f, 0.4f, -1), std::invalid_argument);
+  }
+}
@@ -0,0 +1,175 @@
+#include <core/allocation_tracker.h>
+#include <core/contact_analytics.h>
+#include <visualizer/scenario.h>
+
+#include <catch2/catch.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "test_fixtures.h"
+
+using glm::vec2;
+using home_run_derby::AllocationTracker;
+using home_run_derby::ContactAnalytics;
+using home_run_derby::ContactEvent;
+using home_run_derby::ContactSummary;
+using home_run_derby::SprayChart;
+using home_run_derby::testing::HitFirstPitch;
+using home_run_derby::testing::MakeTestSimulator;
+using home_run_derby::visualizer::Scenario;
+using home_run_derby::visualizer::ScenarioRun;
+using home_run_derby::visualizer::Simulator;
+using home_run_derby::visualizer::SimulatorSnapshot;
+
+namespace {
+
+ContactEvent MakeContact(float exit_speed, float offset, float carry,
+                         float apex_height) {
+  ContactEvent contact = ContactEvent();
+  contact.exit_speed = exit_speed;
+  contact.launch_angle_degrees = 30;
+  contact.contact_offset = offset;
+  contact.bat_speed = 10;
+  contact.carry = carry;
+  contact.apex_height = apex_height;
+  return contact;
+}
+
+}  // namespace
+
+TEST_CASE("Test SprayChart class") {
+  SprayChart chart(100, 4, 3);
+
+  SECTION("Test an empty chart throws") {
+    REQUIRE_THROWS_AS(SprayChart(0, 4, 3), std::invalid_argument);
+    REQUIRE_THROWS_AS(SprayChart(100, 0, 3), std::invalid_argument);
+    REQUIRE_THROWS_AS(SprayChart(100, 4, 0), std::invalid_argument);
+  }
+
+  SECTION("Test contacts are counted in their cells") {
+    chart.Add(MakeContact(20, 0, 150, 50));
+    chart.Add(MakeContact(30, 0, 199, 99));
+    REQUIRE(chart.GetCount(1, 0) == 2);
+    REQUIRE(chart.GetMeanExitSpeed(1, 0) == Approx(25));
+    REQUIRE(chart.GetCount(0, 0) == 0);
+    REQUIRE(chart.GetMeanExitSpeed(0, 0) == 0);
+  }
+
+  SECTION("Test contacts off the chart are clamped to its edges") {
+    chart.Add(MakeContact(20, 0, 10000, 10000));
+    chart.Add(MakeContact(20, 0, -50, -50));
+    REQUIRE(chart.GetCount(3, 2) == 1);
+    REQUIRE(chart.GetCount(0, 0) == 1);
+
+    chart.Clear();
+    REQUIRE(chart.GetCount(3, 2) == 0);
+    REQUIRE(chart.GetCount(0, 0) == 0);
+  }
+}
+
+TEST_CASE("Test ContactAnalytics class") {
+  ContactAnalytics analytics(SprayChart(100, 4, 3), 25);
+
+  SECTION("Test summaries follow each game and every game") {
+    analytics.Record(MakeContact(20, 0.1f, 150, 50));
+    analytics.Record(MakeContact(30, -0.5f, 250, 150));
+    const ContactSummary& session = analytics.GetSessionSummary();
+    REQUIRE(session.num_contacts == 2);
+    REQUIRE(session.num_sweet_spot == 1);
+    REQUIRE(session.num_hard_hit == 1);
+    REQUIRE(session.max_exit_speed == 30);
+    REQUIRE(session.exit_speed_sum == Approx(50));
+    REQUIRE(analytics.GetLastContact().exit_speed == 30);
+    REQUIRE(analytics.GetSprayChart().GetCount(2, 1) == 1);
+
+    analytics.BeginSession();
+    REQUIRE(analytics.GetNumSessions() == 2);
+    REQUIRE(analytics.GetSessionSummary().num_contacts == 0);
+    analytics.Record(MakeContact(40, 0, 50, 50));
+    REQUIRE(analytics.GetSessionSummary().num_contacts == 1);
+    REQUIRE(analytics.GetTotalSummary().num_contacts == 3);
+    REQUIRE(analytics.GetTotalSummary().max_exit_speed == 40);
+    REQUIRE(analytics.GetNumContacts() == 3);
+  }
+
+  SECTION("Test a game without contacts does not start a new one") {
+    analytics.BeginSession();
+    analytics.BeginSession();
+    REQUIRE(analytics.GetNumSessions() == 1);
+  }
+
+  SECTION("Test exporting every contact") {
+    analytics.Record(MakeContact(20, 0, 150, 50));
+    analytics.BeginSession();
+    analytics.Record(MakeContact(30, 0, 250, 150));
+    std::ostringstream output;
+    analytics.ExportCsv(output);
+
+    std::istringstream lines(output.str());
+    std::string line;
+    std::getline(lines, line);
+    REQUIRE(line.find("game,") == 0);
+    std::getline(lines, line);
+    REQUIRE(line.find("0,") == 0);
+    std::getline(lines, line);
+    REQUIRE(line.find("1,") == 0);
+    REQUIRE(!std::getline(lines, line));
+  }
+
+  SECTION("Test the log keeps only the most recent contacts") {
+    size_t num_contacts = ContactAnalytics::kMaxLoggedContacts + 10;
+    AllocationTracker::BeginFrame();
+    for (size_t i = 0; i < num_contacts; ++i) {
+      analytics.Record(MakeContact(static_cast<float>(i), 0, 150, 50));
+    }
+    REQUIRE(AllocationTracker::EndFrame() == 0);
+    REQUIRE(analytics.GetNumContacts() == num_contacts);
+    REQUIRE(analytics.GetNumLoggedContacts() ==
+            ContactAnalytics::kMaxLoggedContacts);
+    REQUIRE(analytics.GetLastContact().exit_speed ==
+            static_cast<float>(num_contacts - 1));
+    REQUIRE(analytics.GetTotalSummary().num_contacts == num_contacts);
+
+    std::ostringstream output;
+    analytics.ExportCsv(output);
+    std::istringstream lines(output.str());
+    std::string line;
+    std::getline(lines, line);
+    std::getline(lines, line);
+    REQUIRE(line.find("0,0,0,10,") == 0);
+    size_t num_rows = 1;
+    while (std::getline(lines, line)) {
+      ++num_rows;
+    }
+    REQUIRE(num_rows == ContactAnalytics::kMaxLoggedContacts);
+  }
+
+  SECTION("Test the simulator records its contacts") {
+    Simulator simulator = MakeTestSimulator();
+    simulator.AttachContactAnalytics(&analytics);
+    Scenario scenario("contact");
+    HitFirstPitch(&scenario)
+        .Expect("the contact recorded as it happens", [&](const Simulator&) {
+          return analytics.GetNumContacts() == 1;
+        });
+    REQUIRE(ScenarioRun(&scenario, &simulator).RunToEnd());
+
+    const ContactEvent& contact = analytics.GetLastContact();
+    const ContactEvent& ball_contact = simulator.GetBall().GetContact();
+    REQUIRE(contact.exit_speed > 0);
+    REQUIRE(contact.exit_speed == ball_contact.exit_speed);
+    REQUIRE(contact.launch_angle_degrees == ball_contact.launch_angle_degrees);
+    REQUIRE(contact.contact_offset >= -1);
+    REQUIRE(contact.contact_offset <= 1);
+    REQUIRE(contact.carry >= 0);
+    REQUIRE(contact.apex_height >= 0);
+
+    // The contact is part of the ball's state.
+    SimulatorSnapshot snapshot;
+    simulator.SaveSnapshot(&snapshot);
+    Simulator copy = MakeTestSimulator();
+    copy.RestoreSnapshot(snapshot);
+    REQUIRE(copy.GetBall().GetContact().exit_speed == contact.exit_speed);
+  }
+}
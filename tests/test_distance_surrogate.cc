@@ -0,0 +1,83 @@
+#include <core/distance_surrogate.h>
+#include <core/flight.h>
+#include <core/surrogate_fitter.h>
+
+#include <catch2/catch.hpp>
+#include <stdexcept>
+
+#include "test_fixtures.h"
+
+using glm::vec2;
+using home_run_derby::Ball;
+using home_run_derby::Bat;
+using home_run_derby::DistanceSurrogate;
+using home_run_derby::SurrogateFit;
+using home_run_derby::SurrogateFitter;
+using home_run_derby::testing::kTestGravity;
+using home_run_derby::testing::kTestGroundLocation;
+using home_run_derby::testing::MakeTestBall;
+using home_run_derby::testing::MakeTestFlightLimits;
+using home_run_derby::testing::MakeTestHit;
+using home_run_derby::testing::MakeTestSwingLimits;
+
+TEST_CASE("Test DistanceSurrogate class") {
+  Ball pitch = MakeTestBall();
+  DistanceSurrogate surrogate(kTestGroundLocation, pitch.GetRadius(),
+                              kTestGravity);
+  Ball hit = MakeTestHit(vec2(-80, -10));
+  REQUIRE(hit.HasCollided());
+
+  SECTION("Test a hit is predicted within its error bars") {
+    float error;
+    float distance = surrogate.PredictDistance(hit, &error);
+    float simulated = SimulateFlight(hit, MakeTestFlightLimits());
+    REQUIRE(simulated > 0);
+    REQUIRE(error > 0);
+    REQUIRE(std::abs(distance - simulated) <= 5 * error);
+  }
+
+  SECTION("Test a ball heading right is predicted to go nowhere") {
+    float error;
+    REQUIRE(surrogate.PredictDistance(pitch, &error) == 0);
+    REQUIRE(error == 0);
+  }
+
+  SECTION("Test the batch prediction matches single predictions") {
+    const float positions_x[] = {hit.GetPosition().x, pitch.GetPosition().x};
+    const float positions_y[] = {hit.GetPosition().y, pitch.GetPosition().y};
+    const float speeds_x[] = {hit.GetSpeed().x, pitch.GetSpeed().x};
+    const float speeds_y[] = {hit.GetSpeed().y, pitch.GetSpeed().y};
+    float distances[2];
+    float errors[2];
+    surrogate.PredictDistances(positions_x, positions_y, speeds_x, speeds_y, 2,
+                               distances, errors);
+    REQUIRE(distances[0] == surrogate.PredictDistance(hit));
+    REQUIRE(distances[1] == surrogate.PredictDistance(pitch));
+  }
+}
+
+TEST_CASE("Test SurrogateFitter class") {
+  Ball pitch = MakeTestBall();
+  Bat bat(5, 15);
+  SurrogateFitter fitter(MakeTestSwingLimits(), kTestGroundLocation,
+                         kTestGravity);
+
+  SECTION("Test fitting too few samples throws") {
+    REQUIRE_THROWS_AS(fitter.Fit(), std::runtime_error);
+  }
+
+  SECTION("Test a sample heading right is rejected") {
+    REQUIRE_THROWS_AS(fitter.AddSample(100, vec2(5, -5), 0),
+                      std::invalid_argument);
+  }
+
+  SECTION("Test sampled contacts fit the simulation closely") {
+    REQUIRE(fitter.SampleContacts(pitch, bat, 2000, 1) == 2000);
+    REQUIRE(fitter.GetNumSamples() == 2000);
+    SurrogateFit fit = fitter.Fit();
+    REQUIRE(fit.num_samples == 2000);
+
+    // Hits travel thousands of pixels; the fit should be off by far less.
+    REQUIRE(fit.rms_error < 200);
+  }
+}
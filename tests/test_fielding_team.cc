@@ -0,0 +1,253 @@
+#include <core/ball.h>
+#include <core/fielding_team.h>
+#include <core/flight.h>
+#include <core/spatial_grid.h>
+#include <visualizer/simulator.h>
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <random>
+
+#include "test_fixtures.h"
+
+using glm::vec2;
+using home_run_derby::Ball;
+using home_run_derby::FieldingSettings;
+using home_run_derby::FieldingTeam;
+using home_run_derby::Landing;
+using home_run_derby::PredictLanding;
+using home_run_derby::SpatialGrid;
+using home_run_derby::testing::MakeTestBall;
+using home_run_derby::testing::MakeTestHit;
+using home_run_derby::visualizer::Simulator;
+using std::vector;
+
+namespace {
+
+// Hits the ball high and to the left as it passes the middle of the screen.
+Ball MakeHit() {
+  return MakeTestHit(vec2(-40, -20));
+}
+
+FieldingSettings MakeSettings(float outfield_start_x, float outfield_end_x) {
+  FieldingSettings settings;
+  settings.outfield_start_x = outfield_start_x;
+  settings.outfield_end_x = outfield_end_x;
+  settings.ground_location = 930;
+  settings.gravity = 0.09f;
+  settings.max_speed = 5;
+  settings.catch_radius = 60;
+  settings.catch_height = 250;
+  settings.separation = 40;
+  return settings;
+}
+
+// Flies the ball until it lands, updating the team every tick.
+bool PlayOut(Ball* ball, FieldingTeam* team) {
+  for (size_t tick = 0; tick < 20000 && !team->HasCaught(); ++tick) {
+    ball->UpdateStates();
+    team->Update(*ball);
+    if (ball->GetPosition().y + ball->GetRadius() >= 930) {
+      break;
+    }
+  }
+  return team->HasCaught();
+}
+
+}  // namespace
+
+TEST_CASE("Test SpatialGrid queries match checking every point") {
+  std::mt19937 generator(7);
+  std::uniform_real_distribution<float> coordinate(-5000, 5000);
+  SpatialGrid grid(100, 64);
+  vector<vec2> points;
+  for (size_t i = 0; i < 500; ++i) {
+    points.push_back(vec2(coordinate(generator), coordinate(generator)));
+    REQUIRE(grid.Insert(points.back()) == i);
+  }
+
+  SECTION("Test small and large radii find the same points") {
+    vector<size_t> found;
+    for (float radius : {10.0f, 150.0f, 800.0f, 20000.0f}) {
+      for (size_t trial = 0; trial < 50; ++trial) {
+        vec2 center(coordinate(generator), coordinate(generator));
+        grid.Query(center, radius, &found);
+        std::sort(found.begin(), found.end());
+        vector<size_t> expected;
+        for (size_t i = 0; i < points.size(); ++i) {
+          if (glm::length(points[i] - center) <= radius) {
+            expected.push_back(i);
+          }
+        }
+        REQUIRE(found == expected);
+      }
+    }
+  }
+
+  SECTION("Test moved points are found at their new positions") {
+    vector<size_t> found;
+    grid.Move(3, vec2(9000, 9000));
+    grid.Query(vec2(9000, 9000), 1, &found);
+    REQUIRE(found == vector<size_t>{3});
+    grid.Query(points[3], 1, &found);
+    REQUIRE(std::find(found.begin(), found.end(), 3) == found.end());
+    REQUIRE(grid.GetPosition(3) == vec2(9000, 9000));
+  }
+
+  SECTION("Test moves within a cell do not relink") {
+    grid.Move(0, vec2(50, 50));
+    size_t num_relinks = grid.GetNumRelinks();
+    grid.Move(0, vec2(60, 70));
+    grid.Move(0, vec2(99, 1));
+    REQUIRE(grid.GetNumRelinks() == num_relinks);
+    grid.Move(0, vec2(101, 1));
+    REQUIRE(grid.GetNumRelinks() == num_relinks + 1);
+  }
+}
+
+TEST_CASE("Test PredictLanding") {
+  SECTION("Test the prediction matches the simulated landing") {
+    Ball ball = MakeHit();
+    Landing landing;
+    REQUIRE(PredictLanding(ball, 930, 0.09f, &landing));
+    size_t ticks = 0;
+    while (ball.GetPosition().y + ball.GetRadius() < 930) {
+      ball.UpdateStates();
+      ++ticks;
+    }
+    REQUIRE(landing.ticks == Approx(ticks).margin(1));
+    REQUIRE(landing.position.x ==
+            Approx(ball.GetPosition().x).margin(2 * -ball.GetSpeed().x));
+  }
+
+  SECTION("Test a ball below the ground has no landing") {
+    Ball ball = MakeTestBall();
+    Landing landing;
+    REQUIRE_FALSE(PredictLanding(ball, 0, 0.09f, &landing));
+  }
+}
+
+TEST_CASE("Test FieldingTeam") {
+  Ball hit = MakeHit();
+  Landing landing;
+  REQUIRE(PredictLanding(hit, 930, 0.09f, &landing));
+
+  SECTION("Test fielders stay put until the ball is hit") {
+    Ball ball = MakeTestBall();
+    FieldingTeam team(10, MakeSettings(-1000, -2000));
+    vec2 position = team.GetFielderPosition(0);
+    for (size_t tick = 0; tick < 50; ++tick) {
+      ball.UpdateStates();
+      team.Update(ball);
+    }
+    REQUIRE(team.GetFielderPosition(0) == position);
+    REQUIRE_FALSE(team.HasCaught());
+  }
+
+  SECTION("Test a fielder near the landing spot catches the ball") {
+    FieldingTeam team(1, MakeSettings(landing.position.x + 300,
+                                      landing.position.x + 300));
+    REQUIRE(PlayOut(&hit, &team));
+  }
+
+  SECTION("Test fielders too far away do not catch the ball") {
+    FieldingTeam team(20, MakeSettings(landing.position.x - 100000,
+                                       landing.position.x - 200000));
+    REQUIRE_FALSE(PlayOut(&hit, &team));
+    for (size_t i = 0; i < team.GetNumFielders(); ++i) {
+      REQUIRE_FALSE(team.IsChasing(i));
+    }
+  }
+
+  SECTION("Test only fielders in reach chase the ball") {
+    FieldingTeam team(200, MakeSettings(landing.position.x + 100000,
+                                        landing.position.x - 100000));
+    hit.UpdateStates();
+    team.Update(hit);
+    REQUIRE(PredictLanding(hit, 930, 0.09f, &landing));
+    float reach = 5 * landing.ticks + 60;
+    size_t num_chasing = 0;
+    for (size_t i = 0; i < team.GetNumFielders(); ++i) {
+      // The fielders have already taken a step, which can bring them in reach.
+      bool is_in_reach =
+          std::abs(team.GetFielderPosition(i).x - landing.position.x) <=
+          reach - 5;
+      if (is_in_reach) {
+        REQUIRE(team.IsChasing(i));
+      }
+      num_chasing += team.IsChasing(i) ? 1 : 0;
+    }
+    REQUIRE(num_chasing > 0);
+    REQUIRE(num_chasing < team.GetNumFielders());
+  }
+
+  SECTION("Test fielders keep their distance") {
+    FieldingTeam team(50, MakeSettings(landing.position.x + 10,
+                                       landing.position.x - 10));
+    PlayOut(&hit, &team);
+    for (size_t i = 0; i < team.GetNumFielders(); ++i) {
+      for (size_t j = i + 1; j < team.GetNumFielders(); ++j) {
+        REQUIRE(glm::length(team.GetFielderPosition(i) -
+                            team.GetFielderPosition(j)) > 0);
+      }
+    }
+  }
+
+  SECTION("Test resetting sends the fielders home") {
+    FieldingTeam team(1, MakeSettings(landing.position.x + 300,
+                                      landing.position.x + 300));
+    vec2 home = team.GetFielderPosition(0);
+    REQUIRE(PlayOut(&hit, &team));
+    REQUIRE(team.GetFielderPosition(0) != home);
+    team.ResetPositions();
+    REQUIRE(team.GetFielderPosition(0) == home);
+    REQUIRE_FALSE(team.HasCaught());
+    REQUIRE_FALSE(team.IsChasing(0));
+  }
+}
+
+TEST_CASE("Test Simulator with a fielding team") {
+  Simulator simulator(10, 1080, 16.0f / 9.0f, 30, 10, 10, 0.8f, 0.2f, 0.3f, 1,
+                      25, 5, 5, 2, 2, 10, 5, 1, 2, 5, 4);
+  simulator.UpdateOffset();
+  simulator.SetGameState(Simulator::kInGame);
+  size_t outs = simulator.GetOuts();
+
+  // Fielders who can reach anywhere catch every ball in the air.
+  FieldingSettings settings = MakeSettings(-100, -200);
+  settings.ground_location = 1050;
+  settings.catch_radius = 100000;
+  settings.catch_height = 100000;
+  FieldingTeam team(5, settings);
+  simulator.AttachFieldingTeam(&team);
+
+  SECTION("Test a caught ball is an out and starts a new pitch") {
+    for (size_t i = 0; i < 10; ++i) {
+      simulator.UpdateBallStates();
+    }
+    vec2 ball_position = simulator.GetBall().GetPosition();
+    simulator.UpdateBatStates(ball_position + vec2(108, 5));
+    simulator.UpdateBatStates(ball_position + vec2(8, 5));
+    simulator.UpdateBallStates();
+    REQUIRE(simulator.GetBall().HasCollided());
+    simulator.UpdateBallStates();
+    REQUIRE(simulator.GetOuts() == outs + 1);
+    REQUIRE(simulator.GetPitchTick() == 0);
+    REQUIRE_FALSE(simulator.GetBall().HasCollided());
+    REQUIRE_FALSE(team.HasCaught());
+  }
+
+  SECTION("Test detaching the team stops catches") {
+    simulator.AttachFieldingTeam(nullptr);
+    for (size_t i = 0; i < 10; ++i) {
+      simulator.UpdateBallStates();
+    }
+    vec2 ball_position = simulator.GetBall().GetPosition();
+    simulator.UpdateBatStates(ball_position + vec2(108, 5));
+    simulator.UpdateBatStates(ball_position + vec2(8, 5));
+    simulator.UpdateBallStates();
+    simulator.UpdateBallStates();
+    REQUIRE(simulator.GetOuts() == outs);
+    REQUIRE(simulator.GetBall().HasCollided());
+  }
+}
@@ -0,0 +1,98 @@
+#ifndef HOME_RUN_DERBY_TEST_FIXTURES_H
+#define HOME_RUN_DERBY_TEST_FIXTURES_H
+
+#include <core/ball.h>
+#include <core/bat.h>
+#include <core/flight.h>
+#include <core/stadium.h>
+#include <core/swing_optimizer.h>
+#include <visualizer/scenario.h>
+#include <visualizer/simulator.h>
+
+namespace home_run_derby {
+namespace testing {
+
+/** The ground the test ball plays on, as in the game. **/
+const float kTestGroundLocation = 930;
+/** The gravity the test ball falls under, as in the game. **/
+const float kTestGravity = 0.09f;
+
+/**
+ * Builds a ball with the game's constants, just released, over the game's
+ * ground.
+ */
+inline Ball MakeTestBall() {
+  Ball ball(10, 50, kTestGravity, 0.1f, 0.4f, 1.5f, 1000, 14, 14, 5, 5, 1000);
+  ball.SetGroundLocation(kTestGroundLocation);
+  return ball;
+}
+
+/**
+ * Builds flight limits that mirror the game's screen.
+ */
+inline FlightLimits MakeTestFlightLimits() {
+  FlightLimits limits;
+  limits.right_edge = 1000 * 16.0f / 9.0f + 50;
+  limits.stopped_speed = 0.02f;
+  limits.max_ticks = 20000;
+  return limits;
+}
+
+/**
+ * Builds swing limits that mirror the game's mouse limits.
+ */
+inline SwingLimits MakeTestSwingLimits() {
+  SwingLimits limits;
+  limits.min_bat_position = vec2(1000 * 16.0f / 9.0f / 3, 15);
+  limits.max_bat_position = vec2(1000 * 16.0f / 9.0f, 1000 - 15 - 70);
+  limits.max_bat_speed = 100;
+  limits.flight = MakeTestFlightLimits();
+  return limits;
+}
+
+/**
+ * Hits the test ball to the left as it passes the middle of the screen.
+ * @param bat_speed The speed of the bat as it meets the ball.
+ * @param stadium The stadium to play the ball in, or nullptr for the flat
+ * ground.
+ * @return The ball straight after it was hit.
+ */
+inline Ball MakeTestHit(const vec2& bat_speed,
+                        const Stadium* stadium = nullptr) {
+  Ball ball = MakeTestBall();
+  ball.SetStadium(stadium);
+  while (ball.GetPosition().x < 1200) {
+    ball.UpdateStates();
+  }
+  Bat bat(5, 15);
+  bat.SetBatPosition(ball.GetPosition() + vec2(20, 10));
+  bat.SetBatSpeed(bat_speed);
+  ball.HandleBatCollisions(bat);
+  return ball;
+}
+
+/**
+ * Builds a small game that the scenario from HitFirstPitch() hits.
+ */
+inline visualizer::Simulator MakeTestSimulator() {
+  return visualizer::Simulator(10, 1080, 16.0f / 9.0f, 30, 10, 10, 0.8f, 0.2f,
+                               0.3f, 1, 25, 5, 5, 2, 2, 10, 5, 1, 2, 5, 4);
+}
+
+/**
+ * Adds the steps that leave a bat across the plate, where the first pitch of
+ * the test game runs into it and is driven away, up to the contact.
+ * @param scenario The scenario to add the steps to.
+ * @return The scenario, to add more steps to.
+ */
+inline visualizer::Scenario& HitFirstPitch(visualizer::Scenario* scenario) {
+  return scenario->WaitForPitchTick(9)
+      .Swing({vec2(35.9f, 535.16f)})
+      .MoveBat(vec2(10, 535.18f))
+      .WaitFor(visualizer::ScenarioEvent::kContact);
+}
+
+}  // namespace testing
+}  // namespace home_run_derby
+
+#endif  // HOME_RUN_DERBY_TEST_FIXTURES_H
@@ -0,0 +1,201 @@
+#include <core/frame_sink.h>
+#include <core/software_rasterizer.h>
+#include <visualizer/frame_exporter.h>
+#include <visualizer/frame_renderer.h>
+
+#include <catch2/catch.hpp>
+#include <stdexcept>
+#include <vector>
+
+using ci::Color;
+using ci::ColorA;
+using glm::vec2;
+using home_run_derby::DrawList;
+using home_run_derby::FrameSink;
+using home_run_derby::RasterImage;
+using home_run_derby::SoftwareRasterizer;
+using home_run_derby::visualizer::FrameExporter;
+using home_run_derby::visualizer::FrameRenderer;
+using home_run_derby::visualizer::FrameStyle;
+using home_run_derby::visualizer::Simulator;
+using home_run_derby::visualizer::SimulatorSnapshot;
+using std::vector;
+
+namespace {
+
+const float kScale = 0.25f;
+
+Simulator MakePrototype(size_t num_stars) {
+  Simulator simulator(90, 1000, 16.0f / 9.0f, 70, 10, 50, 0.09f, 0.1f, 0.4f,
+                      1.5f, 1000, 13, 15, 4, 7, 5, 15, num_stars, 20, 3, 2);
+  simulator.Seed(7);
+  simulator.SetGameState(Simulator::kInGame);
+  return simulator;
+}
+
+FrameStyle MakeStyle() {
+  FrameStyle style;
+  style.window_size = 1000;
+  style.stretch_constant = 16.0f / 9.0f;
+  style.ground_height = 70;
+  style.player_radius = 90;
+  style.star_radius = 3;
+  style.dirt_particle_radius = 2;
+  style.ball_radius = 50;
+  style.gravity = 0.09f;
+  style.color_change_per_dist = 100000;
+  style.stadium_line_width = 6;
+  style.statistics_font_size = 50;
+  style.statistics_location = 20;
+  style.distance_scale = 50;
+  style.background_color = Color(0.68f, 0.85f, 0.9f);
+  style.star_color = Color(1, 1, 1);
+  style.ground_color = Color(0, 0.5f, 0);
+  style.dirt_color = Color(0.6f, 0.3f, 0.1f);
+  style.dirt_particle_color = Color(0.87f, 0.66f, 0.36f);
+  style.player_color = Color(1, 0.65f, 0);
+  style.ball_color = Color(1, 1, 1);
+  style.bat_color = Color(0.6f, 0.3f, 0.1f);
+  style.stadium_color = Color(0, 0.4f, 0);
+  style.foul_pole_color = Color(1, 1, 0);
+  style.statistics_text_color = Color(0, 0, 0);
+  return style;
+}
+
+/**
+ * Plays a pitch, swinging through it, and saves every tick of it.
+ */
+vector<SimulatorSnapshot> PlayReplay(Simulator* simulator, size_t num_ticks) {
+  vector<SimulatorSnapshot> frames(num_ticks);
+  for (size_t tick = 0; tick < num_ticks; ++tick) {
+    simulator->UpdateOffset();
+    simulator->UpdateBatStates(
+        vec2(1500 - 4.0f * static_cast<float>(tick), 800));
+    simulator->UpdateBallStates();
+    simulator->SaveSnapshot(&frames[tick]);
+  }
+  return frames;
+}
+
+/**
+ * Keeps every frame it is handed.
+ */
+class RecordingSink : public FrameSink {
+ public:
+  void WriteFrame(const RasterImage& image) override {
+    frames.push_back(image);
+  }
+
+  vector<RasterImage> frames;
+};
+
+/**
+ * Fails partway through a replay.
+ */
+class FailingSink : public FrameSink {
+ public:
+  explicit FailingSink(size_t num_frames) : num_frames_(num_frames) {}
+
+  void WriteFrame(const RasterImage&) override {
+    if (num_frames_ == 0) {
+      throw std::runtime_error("Out of disk");
+    }
+    --num_frames_;
+  }
+
+ private:
+  size_t num_frames_;
+};
+
+bool AreSame(const RasterImage& first, const RasterImage& second) {
+  for (size_t y = 0; y < first.GetHeight(); ++y) {
+    for (size_t x = 0; x < first.GetWidth(); ++x) {
+      if (first.GetPixel(x, y) != second.GetPixel(x, y)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+TEST_CASE("Test FrameRenderer class") {
+  FrameRenderer renderer(MakeStyle(), nullptr);
+  Simulator simulator = MakePrototype(0);
+  // The canvas is laid out as the game plays.
+  simulator.UpdateOffset();
+  REQUIRE(renderer.GetFrameWidth(kScale) == 445);
+  REQUIRE(renderer.GetFrameHeight(kScale) == 250);
+
+  RasterImage image(renderer.GetFrameWidth(kScale),
+                    renderer.GetFrameHeight(kScale));
+  DrawList list(kScale);
+  renderer.Record(simulator, &list);
+  SoftwareRasterizer(1).Render(list, &image);
+
+  // The sky is darker by how high the canvas looks. The bat waits in the top
+  // left corner.
+  Color sky = MakeStyle().background_color - (1000 - 70) / 100000.0f;
+  REQUIRE(image.GetPixel(10, 100) == RasterImage::PackColor(ColorA(sky, 1)));
+  REQUIRE(image.GetPixel(0, image.GetHeight() - 1) ==
+          RasterImage::PackColor(ColorA(MakeStyle().ground_color, 1)));
+  // The outs are shown.
+  REQUIRE(list.GetText().compare(0, 7, "OUTS: 0") == 0);
+}
+
+TEST_CASE("Test FrameExporter class") {
+  Simulator simulator = MakePrototype(40);
+  Simulator prototype = simulator;
+  vector<SimulatorSnapshot> frames = PlayReplay(&simulator, 60);
+
+  // Render the replay one frame at a time to compare with.
+  FrameRenderer renderer(MakeStyle(), nullptr);
+  SoftwareRasterizer rasterizer(1);
+  vector<RasterImage> expected;
+  Simulator player = prototype;
+  for (const SimulatorSnapshot& frame : frames) {
+    player.RestoreSnapshot(frame);
+    DrawList list(kScale);
+    renderer.Record(player, &list);
+    expected.emplace_back(renderer.GetFrameWidth(kScale),
+                          renderer.GetFrameHeight(kScale));
+    rasterizer.Render(list, &expected.back());
+  }
+
+  FrameExporter exporter(MakeStyle(), nullptr, 3, kScale);
+  REQUIRE(exporter.GetNumWorkers() == 3);
+  REQUIRE(exporter.GetFrameWidth() == 445);
+
+  SECTION("Test frames are written in order") {
+    RecordingSink sink;
+    exporter.Export(prototype, frames, &sink);
+    REQUIRE(sink.frames.size() == frames.size());
+    for (size_t i = 0; i < frames.size(); ++i) {
+      REQUIRE(AreSame(sink.frames[i], expected[i]));
+    }
+    // The replay moves, so the frames differ.
+    REQUIRE(!AreSame(sink.frames.front(), sink.frames.back()));
+  }
+
+  SECTION("Test a failing sink stops the export") {
+    FailingSink failing(10);
+    REQUIRE_THROWS_AS(exporter.Export(prototype, frames, &failing),
+                      std::runtime_error);
+
+    // The exporter can still be used.
+    RecordingSink sink;
+    exporter.Export(prototype, frames, &sink);
+    REQUIRE(sink.frames.size() == frames.size());
+    REQUIRE(AreSame(sink.frames.back(), expected.back()));
+  }
+
+  SECTION("Test an empty replay writes nothing") {
+    RecordingSink sink;
+    exporter.Export(prototype, vector<SimulatorSnapshot>(), &sink);
+    REQUIRE(sink.frames.empty());
+  }
+
+  REQUIRE_THROWS_AS(FrameExporter(MakeStyle(), nullptr, 1, 0),
+                    std::invalid_argument);
+}
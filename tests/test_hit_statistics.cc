@@ -0,0 +1,219 @@
+#include <core/hit_statistics.h>
+#include <core/quantile_sketch.h>
+#include <visualizer/scenario.h>
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "test_fixtures.h"
+
+using glm::vec2;
+using home_run_derby::HitOutcome;
+using home_run_derby::HitStatistics;
+using home_run_derby::kExitSpeed;
+using home_run_derby::kFlightTime;
+using home_run_derby::kHitDistance;
+using home_run_derby::kLaunchAngle;
+using home_run_derby::QuantileSketch;
+using home_run_derby::testing::HitFirstPitch;
+using home_run_derby::testing::MakeTestSimulator;
+using home_run_derby::visualizer::Scenario;
+using home_run_derby::visualizer::ScenarioEvent;
+using home_run_derby::visualizer::ScenarioRun;
+using home_run_derby::visualizer::Simulator;
+using home_run_derby::visualizer::SimulatorSnapshot;
+using std::vector;
+
+namespace {
+
+/**
+ * Checks a sketch's quantiles against the exact ones of sorted values.
+ */
+void RequireAccurate(const QuantileSketch& sketch, vector<double> values) {
+  std::sort(values.begin(), values.end());
+  for (double quantile : {0.0, 0.01, 0.25, 0.5, 0.75, 0.99, 1.0}) {
+    double exact = values[static_cast<size_t>(
+        std::floor(quantile * (values.size() - 1)))];
+    double estimate = sketch.EstimateQuantile(quantile);
+    REQUIRE(std::abs(estimate - exact) <=
+            sketch.GetRelativeAccuracy() * std::abs(exact) + 1e-12);
+  }
+}
+
+}  // namespace
+
+TEST_CASE("Test QuantileSketch class") {
+  QuantileSketch sketch(0.01);
+
+  SECTION("Test settings out of range throw") {
+    REQUIRE_THROWS_AS(QuantileSketch(0), std::invalid_argument);
+    REQUIRE_THROWS_AS(QuantileSketch(1), std::invalid_argument);
+    REQUIRE_THROWS_AS(QuantileSketch(0.01, 0), std::invalid_argument);
+  }
+
+  SECTION("Test an empty sketch") {
+    REQUIRE(sketch.GetCount() == 0);
+    REQUIRE(sketch.EstimateQuantile(0.5) == 0);
+    REQUIRE(sketch.GetMin() == 0);
+    REQUIRE(sketch.GetMax() == 0);
+  }
+
+  SECTION("Test quantiles are within the relative accuracy") {
+    vector<double> values;
+    for (size_t i = 1; i <= 10000; ++i) {
+      // Spread over several orders of magnitude.
+      values.push_back(std::pow(1.001, static_cast<double>(i)) * 0.5);
+    }
+    for (double value : values) {
+      sketch.Add(value);
+    }
+    REQUIRE(sketch.GetCount() == 10000);
+    REQUIRE(sketch.GetMin() == values.front());
+    REQUIRE(sketch.GetMax() == values.back());
+    RequireAccurate(sketch, values);
+  }
+
+  SECTION("Test negative values and zeros") {
+    vector<double> values;
+    for (int i = -500; i <= 500; ++i) {
+      values.push_back(i * 0.37);
+    }
+    values.push_back(0);
+    for (double value : values) {
+      sketch.Add(value);
+    }
+    REQUIRE(sketch.EstimateQuantile(0.5) == 0);
+    REQUIRE(Approx(sketch.GetSum()).margin(1e-6) == 0);
+    RequireAccurate(sketch, values);
+  }
+
+  SECTION("Test values that are not finite are ignored") {
+    sketch.Add(std::numeric_limits<double>::quiet_NaN());
+    sketch.Add(std::numeric_limits<double>::infinity());
+    REQUIRE(sketch.GetCount() == 0);
+  }
+
+  SECTION("Test merging matches adding everything to one sketch") {
+    QuantileSketch first(0.01);
+    QuantileSketch second(0.01);
+    vector<double> values;
+    for (size_t i = 0; i < 5000; ++i) {
+      double value = 1 + static_cast<double>((i * 7919) % 5000);
+      values.push_back(value);
+      sketch.Add(value);
+      (i % 3 == 0 ? first : second).Add(value);
+    }
+    first.Merge(second);
+    REQUIRE(first.GetCount() == sketch.GetCount());
+    REQUIRE(first.GetSum() == sketch.GetSum());
+    for (double quantile : {0.0, 0.1, 0.5, 0.9, 0.99, 1.0}) {
+      REQUIRE(first.EstimateQuantile(quantile) ==
+              sketch.EstimateQuantile(quantile));
+    }
+    RequireAccurate(first, values);
+
+    REQUIRE_THROWS_AS(first.Merge(QuantileSketch(0.02)),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(first.Merge(QuantileSketch(0.01, 16)),
+                      std::invalid_argument);
+  }
+
+  SECTION("Test too wide a range collapses only the smallest values") {
+    QuantileSketch small(0.01, 16);
+    vector<double> values;
+    for (size_t i = 0; i < 1000; ++i) {
+      values.push_back(std::pow(1.01, static_cast<double>(i)));
+    }
+    for (double value : values) {
+      small.Add(value);
+    }
+    // Sixteen bins of 2% each cover the top third of a percent.
+    REQUIRE(small.GetCount() == 1000);
+    REQUIRE(small.EstimateQuantile(0) <= values[1000 - 16]);
+    for (double quantile : {0.995, 0.999, 1.0}) {
+      double exact = values[static_cast<size_t>(quantile * 999)];
+      REQUIRE(std::abs(small.EstimateQuantile(quantile) - exact) <=
+              0.01 * exact);
+    }
+  }
+}
+
+TEST_CASE("Test HitStatistics class") {
+  HitStatistics statistics;
+
+  SECTION("Test recording and merging hits") {
+    HitStatistics other;
+    for (size_t i = 1; i <= 100; ++i) {
+      HitOutcome hit = {10.0f * i, 20, 30, 40};
+      (i % 2 == 0 ? statistics : other).Record(hit);
+    }
+    statistics.Merge(other);
+    REQUIRE(statistics.GetNumHits() == 100);
+    REQUIRE(Approx(statistics.GetSketch(kHitDistance).EstimateQuantile(0.5))
+                .epsilon(0.01) == 500);
+    REQUIRE(Approx(statistics.GetSketch(kExitSpeed).GetMax()) == 20);
+    REQUIRE(Approx(statistics.GetSketch(kLaunchAngle).GetMin()) == 30);
+    REQUIRE(Approx(statistics.GetSketch(kFlightTime).GetSum()) == 4000);
+
+    std::ostringstream report;
+    statistics.Report(report);
+    REQUIRE(report.str().find("Hits: 100") == 0);
+    REQUIRE(report.str().find("launch angle") != std::string::npos);
+  }
+
+  SECTION("Test the simulator records its hits") {
+    Simulator simulator = MakeTestSimulator();
+    simulator.AttachHitStatistics(&statistics);
+    Scenario scenario("hit");
+    HitFirstPitch(&scenario)
+        .Expect("no hit recorded mid flight", [&](const Simulator&) {
+          return statistics.GetNumHits() == 0;
+        })
+        .WaitFor(ScenarioEvent::kPitchEnded);
+    REQUIRE(ScenarioRun(&scenario, &simulator).RunToEnd());
+    REQUIRE(statistics.GetNumHits() == 1);
+    REQUIRE(statistics.GetSketch(kHitDistance).GetMax() > 0);
+    REQUIRE(statistics.GetSketch(kExitSpeed).GetMax() > 0);
+    REQUIRE(statistics.GetSketch(kFlightTime).GetMax() >= 1);
+
+    // Pitches that are not hit are not recorded.
+    Simulator missing = MakeTestSimulator();
+    missing.AttachHitStatistics(&statistics);
+    Scenario miss("miss");
+    miss.WaitFor(ScenarioEvent::kPitchEnded);
+    REQUIRE(ScenarioRun(&miss, &missing).RunToEnd());
+    REQUIRE(statistics.GetNumHits() == 1);
+  }
+
+  SECTION("Test a hit in flight is part of a snapshot") {
+    Simulator simulator = MakeTestSimulator();
+    Scenario contact("contact");
+    HitFirstPitch(&contact);
+    REQUIRE(ScenarioRun(&contact, &simulator).RunToEnd());
+    SimulatorSnapshot snapshot;
+    simulator.SaveSnapshot(&snapshot);
+
+    Scenario finish("finish");
+    finish.WaitFor(ScenarioEvent::kPitchEnded);
+    HitStatistics replayed;
+    simulator.AttachHitStatistics(&statistics);
+    REQUIRE(ScenarioRun(&finish, &simulator).RunToEnd());
+    simulator.RestoreSnapshot(snapshot);
+    simulator.AttachHitStatistics(&replayed);
+    REQUIRE(ScenarioRun(&finish, &simulator).RunToEnd());
+
+    REQUIRE(replayed.GetNumHits() == 1);
+    for (size_t measure = 0; measure < home_run_derby::kNumHitMeasures;
+         ++measure) {
+      home_run_derby::HitMeasure hit_measure =
+          static_cast<home_run_derby::HitMeasure>(measure);
+      REQUIRE(replayed.GetSketch(hit_measure).GetSum() ==
+              statistics.GetSketch(hit_measure).GetSum());
+    }
+  }
+}
@@ -1,17 +1,29 @@
+#include <core/allocation_tracker.h>
 #include <core/ball.h>
 #include <core/bat.h>
 #include <core/canvas_frame.h>
+#include <core/formatted_text.h>
+#include <visualizer/scenario.h>
 #include <visualizer/simulator.h>
 
 #include <catch2/catch.hpp>
+#include <stdexcept>
 
 using ci::Color;
 using glm::vec2;
+using home_run_derby::AllocationScope;
+using home_run_derby::AllocationTracker;
+using home_run_derby::BackgroundField;
 using home_run_derby::Ball;
 using home_run_derby::Bat;
 using home_run_derby::CanvasFrame;
+using home_run_derby::FormattedText;
+using home_run_derby::visualizer::Scenario;
+using home_run_derby::visualizer::ScenarioRun;
 using home_run_derby::visualizer::Simulator;
+using home_run_derby::visualizer::SimulatorSnapshot;
 using std::pair;
+using std::vector;
 
 TEST_CASE("Test Ball class") {
   Ball ball(1, 5, 0.6f, 0.1f, 0.2f, 1, 25, 2, 2, 3, 3, 100);
@@ -136,6 +148,99 @@ TEST_CASE("Test Ball class") {
     REQUIRE(Approx(ball.GetSpeed().y).epsilon(0.001) == -11.972f);
   }
 
+  SECTION("Test colliding with a curved swing between ticks") {
+    // The bat sweeps up through the ball, then off to the side.
+    Bat bat(1, 1);
+    bat.AddWaypoint(vec2(-3, 70));
+    bat.AddWaypoint(vec2(-3, 30));
+    bat.SetBatPosition(vec2(20, 30));
+    bat.SetBatSpeed(vec2(23, 0));
+    ball.UpdateStates();
+
+    // The last step alone misses.
+    Ball last_step_ball = ball;
+    Bat last_step_bat(1, 1);
+    last_step_bat.SetBatPosition(bat.GetBatPosition());
+    last_step_bat.SetBatSpeed(bat.GetBatSpeed());
+    last_step_ball.HandleBatCollisions(last_step_bat);
+    REQUIRE_FALSE(last_step_ball.HasCollided());
+
+    ball.HandleBatCollisions(bat);
+    REQUIRE(ball.HasCollided());
+    REQUIRE(ball.GetSpeed().y < -20);
+  }
+
+  SECTION("Test splitting a swing into waypoints keeps its exit velocity") {
+    // The same straight swing through the ball, sampled more often.
+    ball.UpdateStates();
+    vec2 exit_velocities[3];
+    for (size_t i = 0; i < 3; ++i) {
+      size_t num_steps = size_t(2) << i;
+      Ball split_ball = ball;
+      Bat bat(1, 1);
+      for (size_t step = 0; step < num_steps; ++step) {
+        float fraction =
+            static_cast<float>(step) / static_cast<float>(num_steps);
+        bat.AddWaypoint(glm::mix(vec2(20, 50), vec2(-20, 50), fraction));
+      }
+      bat.SetBatPosition(vec2(-20, 50));
+      bat.SetBatSpeed(vec2(-40, 0) / static_cast<float>(num_steps));
+      split_ball.HandleBatCollisions(bat);
+      REQUIRE(split_ball.HasCollided());
+      exit_velocities[i] = split_ball.GetSpeed();
+    }
+    REQUIRE(exit_velocities[0].x < -30);
+    for (size_t i = 1; i < 3; ++i) {
+      REQUIRE(exit_velocities[i].x == Approx(exit_velocities[0].x));
+      REQUIRE(exit_velocities[i].y ==
+              Approx(exit_velocities[0].y).margin(0.001));
+    }
+  }
+
+  SECTION("Test a swing that moves along with the ball") {
+    // The bat stays just out of reach, inside the box around the ball's tick.
+    vec2 ball_start = ball.GetPosition();
+    ball.UpdateStates();
+    vec2 ball_end = ball.GetPosition();
+    vec2 speed = ball.GetSpeed();
+    vec2 offset(5, 5);
+    Bat bat(1, 1);
+    bat.AddWaypoint(ball_start + offset);
+    bat.AddWaypoint(glm::mix(ball_start, ball_end, 0.5f) + offset);
+    bat.SetBatPosition(ball_end + offset);
+    bat.SetBatSpeed(ball_end - ball_start);
+    ball.HandleBatCollisions(bat);
+    REQUIRE_FALSE(ball.HasCollided());
+    REQUIRE(ball.GetPosition() == ball_end);
+    REQUIRE(ball.GetSpeed() == speed);
+  }
+
+  SECTION("Test a curved swing nowhere near the ball") {
+    Bat bat(1, 1);
+    bat.AddWaypoint(vec2(200, 70));
+    bat.AddWaypoint(vec2(200, 30));
+    bat.SetBatPosition(vec2(220, 30));
+    bat.SetBatSpeed(vec2(20, 0));
+    ball.UpdateStates();
+    vec2 speed = ball.GetSpeed();
+    ball.HandleBatCollisions(bat);
+    REQUIRE_FALSE(ball.HasCollided());
+    REQUIRE(ball.GetSpeed() == speed);
+  }
+
+  SECTION("Test a bat keeps the start of a long path") {
+    Bat bat(1, 1);
+    for (size_t i = 0; i < 2 * Bat::kMaxWaypoints; ++i) {
+      bat.AddWaypoint(vec2(static_cast<float>(i), 0));
+    }
+    REQUIRE(bat.GetNumWaypoints() == Bat::kMaxWaypoints);
+    REQUIRE(bat.GetWaypoint(0) == vec2(0, 0));
+    REQUIRE(bat.GetWaypoint(Bat::kMaxWaypoints - 1) ==
+            vec2(static_cast<float>(2 * Bat::kMaxWaypoints - 1), 0));
+    bat.ClearWaypoints();
+    REQUIRE(bat.GetNumWaypoints() == 0);
+  }
+
   SECTION("Test colliding with bat twice") {
     Bat bat(1, 1);
     bat.SetBatPosition(vec2(-1, 50));
@@ -175,7 +280,7 @@ TEST_CASE("Test CanvasFrame class") {
   }
 
   SECTION("Test UpdateCanvas() without offset") {
-    canvas.UpdateCanvas(vec2(0, 0), vec2(0, 0));
+    canvas.UpdateCanvas(vec2(0, 0));
     REQUIRE(canvas.GetPlayerHeadLocation() == vec2(1900, 1040));
     REQUIRE(canvas.GetPlayerBodyLocation() == vec2(1900, 1025));
     REQUIRE(canvas.GetGroundLocation().first == vec2(0, 1050));
@@ -205,19 +310,39 @@ TEST_CASE("Test CanvasFrame class") {
   }
 
   SECTION("Test UpdateCanvas() with offset") {
-    canvas.UpdateCanvas(vec2(10, 20), vec2(0, 0));
+    canvas.UpdateCanvas(vec2(10, 20));
     REQUIRE(canvas.GetPlayerHeadLocation() == vec2(1910, 1060));
     REQUIRE(canvas.GetPlayerBodyLocation() == vec2(1910, 1045));
     REQUIRE(canvas.GetGroundLocation().first == vec2(0, 1070));
     REQUIRE(canvas.GetGroundLocation().second == vec2(1920, 1100));
   }
 
-  SECTION("Test UpdateCanvas() with velocity offset") {
-    canvas.UpdateCanvas(vec2(10, 20), vec2(2, 3));
-    REQUIRE(canvas.GetPlayerHeadLocation() == vec2(1910, 1060));
-    REQUIRE(canvas.GetPlayerBodyLocation() == vec2(1910, 1045));
-    REQUIRE(canvas.GetGroundLocation().first == vec2(0, 1070));
-    REQUIRE(canvas.GetGroundLocation().second == vec2(1920, 1100));
+  SECTION("Test the dirt moves with the offset") {
+    vec2 dirt_particle = canvas.GetDirtParticlePosition(0);
+    canvas.UpdateCanvas(vec2(-10, 20));
+    vec2 moved = canvas.GetDirtParticlePosition(0);
+    REQUIRE(moved.y == Approx(dirt_particle.y + 20));
+    // Dirt wraps around the canvas horizontally.
+    REQUIRE(moved.x == Approx(dirt_particle.x - 10 < -1
+                                  ? dirt_particle.x - 10 + 1922
+                                  : dirt_particle.x - 10));
+  }
+
+  SECTION("Test the stars follow from the offset alone") {
+    canvas.UpdateCanvas(vec2(300, -700));
+    vec2 star = canvas.GetStarPosition(1);
+    canvas.UpdateCanvas(vec2(5, 5));
+    canvas.UpdateCanvas(vec2(300, -700));
+    REQUIRE(canvas.GetStarPosition(1) == star);
+  }
+
+  SECTION("Test canvases can share a field") {
+    CanvasFrame other(10, 1080, 16.0f / 9.0f, 30, 0, 0, 5, 1);
+    REQUIRE(other.GetNumStars() == 0);
+    other.SetField(canvas.GetField());
+    REQUIRE(other.GetNumStars() == 2);
+    REQUIRE(other.GetNumDirtParticles() == 3);
+    REQUIRE(other.GetField() == canvas.GetField());
   }
 }
 
@@ -262,6 +387,43 @@ TEST_CASE("Test Simulator class") {
   }
 
   SECTION("Test ResetGame()") {
+    for (size_t i = 0; i < 50; ++i) {
+      simulator.UpdateBallStates();
+    }
+    const BackgroundField* field =
+        simulator.GetCanvasFrame().GetField().get();
+    simulator.ResetGame();
+    REQUIRE(simulator.GetOuts() == 0);
+    REQUIRE(simulator.GetScore() == 0);
+    REQUIRE(simulator.GetBall().GetPosition() == vec2(-10, 540));
+    REQUIRE(simulator.GetCanvasFrame().GetNumStars() == 1);
+    REQUIRE(simulator.GetCanvasFrame().GetField().get() == field);
+  }
+
+  SECTION("Test SetGameState()") {
+    simulator.SetGameState(Simulator::kInGame);
+    simulator.ResetStates();
+    size_t outs = simulator.GetOuts();
+    REQUIRE(outs == 1);
+
+    // Setting the active state again should not run its hooks.
+    simulator.SetGameState(Simulator::kInGame);
+    REQUIRE(simulator.GetOuts() == outs);
+
+    // Ending the game keeps the outs; returning to the start screen resets.
+    simulator.SetGameState(Simulator::kEndScreen);
+    REQUIRE(simulator.GetOuts() == outs);
+    simulator.SetGameState(Simulator::kStartScreen);
+    REQUIRE(simulator.GetOuts() == 0);
+    REQUIRE(simulator.GetCurrentGameState() == Simulator::kStartScreen);
+  }
+
+  SECTION("Test IsStaticScreen()") {
+    REQUIRE(simulator.IsStaticScreen());
+    simulator.SetGameState(Simulator::kInGame);
+    REQUIRE_FALSE(simulator.IsStaticScreen());
+    simulator.SetGameState(Simulator::kEndScreen);
+    REQUIRE(simulator.IsStaticScreen());
   }
 
   SECTION("Test IncrementGameState()") {
@@ -276,39 +438,184 @@ TEST_CASE("Test Simulator class") {
 
   SECTION("Test outs for ball not colliding with bat") {
     REQUIRE(simulator.GetOuts() == 0);
-    for (size_t i = 0; i < 50; ++i) {
-      simulator.UpdateBallStates();
-    }
+    Scenario scenario("no swing");
+    scenario.WaitTicks(50);
+    REQUIRE(ScenarioRun(&scenario, &simulator).RunToEnd());
     REQUIRE(simulator.GetOuts() == 1);
   }
 
   SECTION("Test outs for ball colliding with bat but staying in screen") {
     REQUIRE(simulator.GetOuts() == 0);
-    for (size_t i = 0; i < 9; ++i) {
-      simulator.UpdateBallStates();
-    }
-    simulator.UpdateBatStates(vec2(35.9f, 535.16f));
-    simulator.UpdateBallStates();
-    simulator.UpdateBatStates(vec2(35.75f, 535.18f));
-
-    for (size_t i = 0; i < 50; ++i) {
-      simulator.UpdateBallStates();
-    }
+    Scenario scenario("soft swing");
+    scenario.WaitForPitchTick(9)
+        .Swing({vec2(35.9f, 535.16f)})
+        .MoveBat(vec2(35.75f, 535.18f))
+        .WaitTicks(50);
+    REQUIRE(ScenarioRun(&scenario, &simulator).RunToEnd());
     REQUIRE(simulator.GetOuts() == 2);
   }
 
   SECTION("Test outs for ball colliding with bat and leaving screen") {
     REQUIRE(simulator.GetOuts() == 0);
-    for (size_t i = 0; i < 9; ++i) {
+    Scenario scenario("hard swing");
+    scenario.WaitForPitchTick(9)
+        .Swing({vec2(35.9f, 535.16f)})
+        .MoveBat(vec2(10, 535.18f))
+        .WaitTicks(50);
+    REQUIRE(ScenarioRun(&scenario, &simulator).RunToEnd());
+    REQUIRE(simulator.GetOuts() == 0);
+  }
+}
+
+TEST_CASE("Test allocation tracking") {
+  REQUIRE(AllocationTracker::IsEnabled());
+
+  SECTION("Test allocations are attributed to call sites") {
+    AllocationTracker::BeginFrame();
+    {
+      AllocationScope scope("test vector");
+      std::vector<int> numbers(10);
+      REQUIRE(numbers.size() == 10);
+    }
+    REQUIRE(AllocationTracker::EndFrame() == 1);
+    REQUIRE(AllocationTracker::GetNumCallSites() == 1);
+    REQUIRE(std::string(AllocationTracker::GetCallSite(0).call_site) ==
+            "test vector");
+    REQUIRE(AllocationTracker::GetCallSite(0).bytes == 10 * sizeof(int));
+  }
+
+  SECTION("Test FormattedText does not allocate once constructed") {
+    FormattedText text;
+    AllocationTracker::BeginFrame();
+    text.Format("Total Distance: %.*f ft.", 0, 123456.0f);
+    REQUIRE(AllocationTracker::EndFrame() == 0);
+    REQUIRE(text.GetText() == "Total Distance: 123456 ft.");
+  }
+
+  SECTION("Test steady-state game loop does not allocate") {
+    Simulator simulator(10, 1080, 16.0f / 9.0f, 30, 10, 10, 0.8f, 0.2f, 0.3f,
+                        1, 25, 5, 5, 2, 2, 10, 5, 75, 50, 5, 4);
+    FormattedText text;
+    simulator.SetGameState(Simulator::kInGame);
+
+    // Warm up through a few pitches, then count a long run of frames that
+    // includes swings, misses and resets.
+    for (size_t i = 0; i < 100; ++i) {
+      simulator.UpdateOffset();
       simulator.UpdateBallStates();
     }
-    simulator.UpdateBatStates(vec2(35.9f, 535.16f));
-    simulator.UpdateBallStates();
-    simulator.UpdateBatStates(vec2(10, 535.18f));
-
-    for (size_t i = 0; i < 50; ++i) {
+    AllocationTracker::BeginFrame();
+    for (size_t i = 0; i < 2000; ++i) {
+      simulator.UpdateBatStates(vec2(35.9f - static_cast<float>(i % 7), 535));
+      simulator.UpdateOffset();
       simulator.UpdateBallStates();
+      text.Format("Outs: %zu", simulator.GetOuts());
     }
-    REQUIRE(simulator.GetOuts() == 0);
+    simulator.ResetStates();
+    simulator.SetGameState(Simulator::kEndScreen);
+    simulator.SetGameState(Simulator::kStartScreen);
+    REQUIRE(AllocationTracker::EndFrame() == 0);
+  }
+}
+
+namespace {
+
+// Plays frames with a bat that sweeps back and forth across the strike zone.
+void PlayFrames(Simulator* simulator, size_t first_frame, size_t num_frames) {
+  for (size_t i = first_frame; i < first_frame + num_frames; ++i) {
+    simulator->UpdateBatStates(
+        vec2(40 - static_cast<float>(i % 11) * 4, 530 + (i % 5)));
+    simulator->UpdateOffset();
+    simulator->UpdateBallStates();
+  }
+}
+
+void RequireSameGame(const Simulator& left, const Simulator& right) {
+  REQUIRE(left.GetBall().GetPosition() == right.GetBall().GetPosition());
+  REQUIRE(left.GetBall().GetSpeed() == right.GetBall().GetSpeed());
+  REQUIRE(left.GetBall().HasCollided() == right.GetBall().HasCollided());
+  REQUIRE(left.GetBat().GetBatPosition() == right.GetBat().GetBatPosition());
+  REQUIRE(left.GetOuts() == right.GetOuts());
+  REQUIRE(left.GetPitchTick() == right.GetPitchTick());
+  REQUIRE(left.GetScore() == right.GetScore());
+  REQUIRE(left.GetCanvasFrame().GetOffset() ==
+          right.GetCanvasFrame().GetOffset());
+  const CanvasFrame& left_canvas = left.GetCanvasFrame();
+  const CanvasFrame& right_canvas = right.GetCanvasFrame();
+  REQUIRE(left_canvas.GetNumStars() == right_canvas.GetNumStars());
+  for (size_t i = 0; i < left_canvas.GetNumStars(); ++i) {
+    REQUIRE(left_canvas.GetStarPosition(i) == right_canvas.GetStarPosition(i));
+  }
+}
+
+}  // namespace
+
+TEST_CASE("Test Simulator snapshots") {
+  Simulator simulator(10, 1080, 16.0f / 9.0f, 30, 10, 10, 0.8f, 0.2f, 0.3f, 1,
+                      25, 4, 6, 1, 3, 10, 5, 75, 50, 5, 4);
+  Simulator other(10, 1080, 16.0f / 9.0f, 30, 10, 10, 0.8f, 0.2f, 0.3f, 1, 25,
+                  4, 6, 1, 3, 10, 5, 75, 50, 5, 4);
+  simulator.Seed(42);
+  simulator.SetGameState(Simulator::kInGame);
+  PlayFrames(&simulator, 0, 300);
+  SimulatorSnapshot snapshot;
+  simulator.SaveSnapshot(&snapshot);
+
+  SECTION("Test restoring replays the same frames") {
+    PlayFrames(&simulator, 300, 1000);
+    vec2 position = simulator.GetBall().GetPosition();
+    size_t outs = simulator.GetOuts();
+    REQUIRE(outs > snapshot.outs);
+
+    // The pitches drawn after the snapshot are drawn again.
+    simulator.RestoreSnapshot(snapshot);
+    REQUIRE(simulator.GetOuts() == snapshot.outs);
+    REQUIRE(simulator.GetPitchTick() == snapshot.pitch_tick);
+    PlayFrames(&simulator, 300, 1000);
+    REQUIRE(simulator.GetBall().GetPosition() == position);
+    REQUIRE(simulator.GetOuts() == outs);
+  }
+
+  SECTION("Test a snapshot restores into another simulator") {
+    other.RestoreSnapshot(snapshot);
+    REQUIRE(other.GetCurrentGameState() == Simulator::kInGame);
+    RequireSameGame(simulator, other);
+    PlayFrames(&simulator, 300, 1000);
+    PlayFrames(&other, 300, 1000);
+    RequireSameGame(simulator, other);
+  }
+
+  SECTION("Test the same seed plays the same game") {
+    other.Seed(42);
+    other.ResetGame();
+    simulator.Seed(42);
+    simulator.ResetGame();
+    PlayFrames(&simulator, 0, 1000);
+    PlayFrames(&other, 0, 1000);
+    RequireSameGame(simulator, other);
+  }
+
+  SECTION("Test different seeds pitch differently") {
+    other.Seed(43);
+    other.ResetGame();
+    simulator.Seed(42);
+    simulator.ResetGame();
+    REQUIRE(simulator.GetBall().GetSpeed() != other.GetBall().GetSpeed());
+  }
+
+  SECTION("Test saving and restoring do not allocate") {
+    AllocationTracker::BeginFrame();
+    simulator.SaveSnapshot(&snapshot);
+    simulator.RestoreSnapshot(snapshot);
+    REQUIRE(AllocationTracker::EndFrame() == 0);
+  }
+
+  SECTION("Test the background field is not part of a snapshot") {
+    Simulator crowded(10, 1080, 16.0f / 9.0f, 30, 10, 10, 0.8f, 0.2f, 0.3f, 1,
+                      25, 4, 6, 1, 3, 10, 5, 1000, 50, 5, 4);
+    crowded.SaveSnapshot(&snapshot);
+    other.SetBackgroundField(crowded.GetCanvasFrame().GetField());
+    other.RestoreSnapshot(snapshot);
+    RequireSameGame(crowded, other);
   }
-}
\ No newline at end of file
+}
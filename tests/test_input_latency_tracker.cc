@@ -0,0 +1,113 @@
+#include <core/input_latency_tracker.h>
+#include <visualizer/simulator.h>
+
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <sstream>
+#include <string>
+
+using glm::vec2;
+using home_run_derby::InputLatencyTracker;
+using home_run_derby::kBatUpdated;
+using home_run_derby::kContact;
+using home_run_derby::kPresented;
+using home_run_derby::kSimulated;
+using home_run_derby::visualizer::Simulator;
+using std::chrono::milliseconds;
+
+TEST_CASE("Test InputLatencyTracker class") {
+  InputLatencyTracker tracker;
+  InputLatencyTracker::Clock::time_point start =
+      InputLatencyTracker::Clock::now();
+
+  SECTION("Test an input is followed to the frame showing its contact") {
+    tracker.OnInput(start);
+    tracker.OnBatUpdated(start + milliseconds(1));
+    tracker.OnTick(start + milliseconds(3));
+    tracker.OnContact(start + milliseconds(3));
+    tracker.OnPresent(start + milliseconds(12));
+    REQUIRE(tracker.GetLatencies(kBatUpdated).GetSum() == Approx(0.001));
+    REQUIRE(tracker.GetLatencies(kSimulated).GetSum() == Approx(0.003));
+    REQUIRE(tracker.GetLatencies(kContact).GetSum() == Approx(0.003));
+    REQUIRE(tracker.GetLatencies(kPresented).GetSum() == Approx(0.012));
+
+    // The contact has been shown, so the next frame adds nothing.
+    tracker.OnPresent(start + milliseconds(20));
+    REQUIRE(tracker.GetLatencies(kPresented).GetCount() == 1);
+  }
+
+  SECTION("Test only the first tick after an input is timed") {
+    tracker.OnInput(start);
+    tracker.OnBatUpdated(start);
+    tracker.OnTick(start + milliseconds(2));
+    tracker.OnTick(start + milliseconds(9));
+    tracker.OnContact(start + milliseconds(9));
+    REQUIRE(tracker.GetLatencies(kSimulated).GetCount() == 1);
+    REQUIRE(tracker.GetLatencies(kSimulated).GetSum() == Approx(0.002));
+    REQUIRE(tracker.GetLatencies(kContact).GetSum() == Approx(0.009));
+  }
+
+  SECTION("Test the bat follows only the newest input") {
+    tracker.OnInput(start);
+    tracker.OnInput(start + milliseconds(4));
+    tracker.OnBatUpdated(start + milliseconds(5));
+    REQUIRE(tracker.GetLatencies(kBatUpdated).GetCount() == 1);
+    REQUIRE(tracker.GetLatencies(kBatUpdated).GetSum() == Approx(0.001));
+  }
+
+  SECTION("Test moves without an input are not followed") {
+    tracker.OnInput(start);
+    tracker.OnBatUpdated(start);
+    tracker.OnBatUpdated(start + milliseconds(1));
+    tracker.OnTick(start + milliseconds(2));
+    tracker.OnContact(start + milliseconds(2));
+    tracker.OnPresent(start + milliseconds(3));
+    REQUIRE(tracker.GetLatencies(kBatUpdated).GetCount() == 1);
+    REQUIRE(tracker.GetLatencies(kSimulated).GetCount() == 0);
+    REQUIRE(tracker.GetLatencies(kContact).GetCount() == 0);
+    REQUIRE(tracker.GetLatencies(kPresented).GetCount() == 0);
+  }
+
+  SECTION("Test a new session forgets everything") {
+    tracker.OnInput(start);
+    tracker.OnBatUpdated(start);
+    tracker.OnTick(start);
+    tracker.OnContact(start);
+    tracker.BeginSession();
+    tracker.OnPresent(start);
+    REQUIRE(tracker.GetLatencies(kBatUpdated).GetCount() == 0);
+    REQUIRE(tracker.GetLatencies(kPresented).GetCount() == 0);
+  }
+
+  SECTION("Test Report()") {
+    tracker.OnInput(start);
+    tracker.OnBatUpdated(start + milliseconds(1));
+    std::ostringstream report;
+    tracker.Report(report);
+    REQUIRE(report.str().find("bat updated: 1 inputs, median ") !=
+            std::string::npos);
+    REQUIRE(report.str().find("presented: 0 inputs\n") != std::string::npos);
+  }
+}
+
+TEST_CASE("Test a simulator reports bat inputs to its tracker") {
+  Simulator simulator(10, 1080, 16.0f / 9.0f, 30, 10, 10, 0.8f, 0.2f, 0.3f, 1,
+                      25, 5, 5, 2, 2, 10, 5, 1, 2, 5, 4);
+  InputLatencyTracker tracker;
+  simulator.AttachInputLatencyTracker(&tracker);
+  tracker.OnInput();
+  simulator.UpdateBatStates(vec2(0, 0));
+
+  // Starting a game starts a new session.
+  simulator.SetGameState(Simulator::kInGame);
+  REQUIRE(tracker.GetLatencies(kBatUpdated).GetCount() == 0);
+
+  tracker.OnInput();
+  simulator.UpdateBatStates(vec2(0, 0));
+  simulator.UpdateOffset();
+  simulator.UpdateBallStates();
+  simulator.UpdateBallStates();
+  REQUIRE(tracker.GetLatencies(kBatUpdated).GetCount() == 1);
+  REQUIRE(tracker.GetLatencies(kSimulated).GetCount() == 1);
+  REQUIRE(tracker.GetLatencies(kContact).GetCount() == 0);
+}
@@ -0,0 +1,97 @@
+#include <core/leaderboard.h>
+
+#include <catch2/catch.hpp>
+#include <thread>
+
+using home_run_derby::Leaderboard;
+using std::vector;
+
+TEST_CASE("Test Leaderboard class") {
+  Leaderboard leaderboard(1000, 10);
+
+  SECTION("Test empty leaderboard") {
+    REQUIRE(leaderboard.GetNumScores() == 0);
+    REQUIRE(leaderboard.GetRank(500) == 1);
+    REQUIRE(leaderboard.GetPercentile(500) == 100);
+    REQUIRE(leaderboard.GetScoreAtRank(1) == 0);
+    REQUIRE(leaderboard.GetTopScores(3).empty());
+  }
+
+  SECTION("Test Insert() and GetRank()") {
+    leaderboard.Insert(100);
+    leaderboard.Insert(300);
+    leaderboard.Insert(200);
+    REQUIRE(leaderboard.GetNumScores() == 3);
+    REQUIRE(leaderboard.GetRank(350) == 1);
+    REQUIRE(leaderboard.GetRank(300) == 1);
+    REQUIRE(leaderboard.GetRank(250) == 2);
+    REQUIRE(leaderboard.GetRank(150) == 3);
+    REQUIRE(leaderboard.GetRank(0) == 4);
+  }
+
+  SECTION("Test scores in the same bucket tie") {
+    leaderboard.Insert(101);
+    leaderboard.Insert(109);
+    REQUIRE(leaderboard.GetRank(105) == 1);
+    REQUIRE(leaderboard.GetScoreAtRank(2) == 100);
+  }
+
+  SECTION("Test GetPercentile()") {
+    for (int score = 0; score < 100; ++score) {
+      leaderboard.Insert(static_cast<float>(score * 10));
+    }
+    REQUIRE(leaderboard.GetPercentile(495) == 50);
+    REQUIRE(leaderboard.GetPercentile(990) == 100);
+  }
+
+  SECTION("Test GetScoreAtRank()") {
+    leaderboard.Insert(100);
+    leaderboard.Insert(300);
+    leaderboard.Insert(200);
+    REQUIRE(leaderboard.GetScoreAtRank(1) == 300);
+    REQUIRE(leaderboard.GetScoreAtRank(2) == 200);
+    REQUIRE(leaderboard.GetScoreAtRank(3) == 100);
+    REQUIRE(leaderboard.GetScoreAtRank(4) == 0);
+  }
+
+  SECTION("Test GetTopScores()") {
+    leaderboard.Insert(100);
+    leaderboard.Insert(300);
+    leaderboard.Insert(300);
+    leaderboard.Insert(200);
+    REQUIRE(leaderboard.GetTopScores(3) == vector<float>({300, 300, 200}));
+    REQUIRE(leaderboard.GetTopScores(10) ==
+            vector<float>({300, 300, 200, 100}));
+  }
+
+  SECTION("Test scores out of range are clamped") {
+    leaderboard.Insert(-50);
+    leaderboard.Insert(5000);
+    REQUIRE(leaderboard.GetScoreAtRank(1) == 1000);
+    REQUIRE(leaderboard.GetScoreAtRank(2) == 0);
+  }
+
+  SECTION("Test InsertAll()") {
+    vector<float> scores = {500, 500, 400, 300, 300, 300};
+    leaderboard.InsertAll(scores.data(), scores.size());
+    REQUIRE(leaderboard.GetNumScores() == 6);
+    REQUIRE(leaderboard.GetRank(400) == 3);
+    REQUIRE(leaderboard.GetTopScores(6) == scores);
+  }
+
+  SECTION("Test reading while a writer inserts") {
+    std::thread writer([&leaderboard]() {
+      for (int i = 0; i < 10000; ++i) {
+        leaderboard.Insert(static_cast<float>(i % 1000));
+      }
+    });
+    for (int i = 0; i < 1000; ++i) {
+      size_t rank = leaderboard.GetRank(500);
+      REQUIRE(rank >= 1);
+      REQUIRE(rank <= leaderboard.GetNumScores() + 1);
+    }
+    writer.join();
+    REQUIRE(leaderboard.GetNumScores() == 10000);
+    REQUIRE(leaderboard.GetRank(990) == 1);
+  }
+}
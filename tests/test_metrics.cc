@@ -0,0 +1,252 @@
+#include <core/metrics.h>
+#include <core/metrics_server.h>
+#include <visualizer/simulator.h>
+
+#include <catch2/catch.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using glm::vec2;
+using home_run_derby::Counter;
+using home_run_derby::Gauge;
+using home_run_derby::Histogram;
+using home_run_derby::MetricsRegistry;
+using home_run_derby::MetricsServer;
+using home_run_derby::visualizer::Simulator;
+using home_run_derby::visualizer::SimulatorMetrics;
+using std::string;
+using std::vector;
+
+namespace {
+
+string WriteText(const MetricsRegistry& registry) {
+  std::ostringstream output;
+  registry.WriteText(output);
+  return output.str();
+}
+
+bool Contains(const string& text, const string& line) {
+  return text.find(line) != string::npos;
+}
+
+}  // namespace
+
+TEST_CASE("Test MetricsRegistry class") {
+  MetricsRegistry registry;
+
+  SECTION("Test counters and gauges") {
+    Counter* pitches = registry.AddCounter("pitches_total", "Pitches thrown.");
+    Gauge* spectators = registry.AddGauge("spectators", "Watching now.");
+    pitches->Increment();
+    pitches->Increment(4);
+    spectators->Set(2.5);
+    REQUIRE(pitches->GetValue() == 5);
+    REQUIRE(spectators->GetValue() == 2.5);
+
+    string text = WriteText(registry);
+    REQUIRE(Contains(text, "# HELP pitches_total Pitches thrown.\n"
+                           "# TYPE pitches_total counter\n"
+                           "pitches_total 5\n"));
+    REQUIRE(Contains(text, "# TYPE spectators gauge\nspectators 2.5\n"));
+  }
+
+  SECTION("Test histogram buckets are written cumulatively") {
+    Histogram* histogram =
+        registry.AddHistogram("tick_seconds", "Tick time.", {0.1, 1});
+    histogram->Observe(0.05);
+    histogram->Observe(0.1);
+    histogram->Observe(0.5);
+    histogram->Observe(7);
+    REQUIRE(histogram->GetBucketCount(0) == 2);
+    REQUIRE(histogram->GetBucketCount(1) == 1);
+    REQUIRE(histogram->GetBucketCount(2) == 1);
+    REQUIRE(histogram->GetSum() == Approx(7.65));
+
+    string text = WriteText(registry);
+    REQUIRE(Contains(text, "tick_seconds_bucket{le=\"0.1\"} 2\n"
+                           "tick_seconds_bucket{le=\"1\"} 3\n"
+                           "tick_seconds_bucket{le=\"+Inf\"} 4\n"
+                           "tick_seconds_sum 7.65\n"
+                           "tick_seconds_count 4\n"));
+  }
+
+  SECTION("Test quantiles are interpolated within buckets") {
+    Histogram* histogram =
+        registry.AddHistogram("latency_seconds", "", {1, 2, 4});
+    REQUIRE(histogram->EstimateQuantile(0.5) == 0);
+    for (int i = 0; i < 10; ++i) {
+      histogram->Observe(0.5);
+      histogram->Observe(3);
+    }
+    REQUIRE(histogram->GetCount() == 20);
+    REQUIRE(histogram->EstimateQuantile(0.25) == Approx(0.5));
+    REQUIRE(histogram->EstimateQuantile(0.75) == Approx(3));
+    histogram->Observe(100);
+    REQUIRE(histogram->EstimateQuantile(1) == 4);
+  }
+
+  SECTION("Test histograms merge") {
+    Histogram* histogram =
+        registry.AddHistogram("merged_seconds", "", {1, 2, 4});
+    Histogram other({1, 2, 4});
+    histogram->Observe(0.5);
+    other.Observe(3);
+    other.Observe(100);
+    histogram->Merge(other);
+    REQUIRE(histogram->GetCount() == 3);
+    REQUIRE(histogram->GetBucketCount(0) == 1);
+    REQUIRE(histogram->GetBucketCount(2) == 1);
+    REQUIRE(histogram->GetBucketCount(3) == 1);
+    REQUIRE(histogram->GetSum() == Approx(103.5));
+    REQUIRE(other.GetCount() == 2);
+    REQUIRE_THROWS_AS(histogram->Merge(Histogram({1, 2})),
+                      std::invalid_argument);
+  }
+
+  SECTION("Test help text is escaped") {
+    registry.AddCounter("escaped_total", "A \\ and a\nnewline.");
+    REQUIRE(Contains(WriteText(registry),
+                     "# HELP escaped_total A \\\\ and a\\nnewline.\n"));
+  }
+
+  SECTION("Test bad metrics are rejected") {
+    registry.AddCounter("taken_total", "");
+    REQUIRE_THROWS_AS(registry.AddGauge("taken_total", ""),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(registry.AddCounter("", ""), std::invalid_argument);
+    REQUIRE_THROWS_AS(registry.AddCounter("9lives", ""),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(registry.AddCounter("has space", ""),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(registry.AddHistogram("unsorted", "", {1, 1}),
+                      std::invalid_argument);
+    REQUIRE(WriteText(registry) ==
+            "# HELP taken_total \n# TYPE taken_total counter\ntaken_total 0\n");
+  }
+
+  SECTION("Test counters can be updated from several threads") {
+    Counter* counter = registry.AddCounter("shared_total", "");
+    vector<std::thread> threads;
+    for (size_t i = 0; i < 4; ++i) {
+      threads.emplace_back([counter] {
+        for (size_t j = 0; j < 10000; ++j) {
+          counter->Increment();
+        }
+      });
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+    REQUIRE(counter->GetValue() == 40000);
+  }
+}
+
+TEST_CASE("Test a simulator counts what happens in the game") {
+  Simulator simulator(10, 1080, 16.0f / 9.0f, 30, 10, 10, 0.8f, 0.2f, 0.3f, 1,
+                      25, 5, 5, 2, 2, 10, 5, 1, 2, 5, 4);
+  MetricsRegistry registry;
+  SimulatorMetrics metrics = {registry.AddCounter("pitches_total", ""),
+                              registry.AddCounter("hits_total", ""),
+                              registry.AddCounter("home_runs_total", ""),
+                              registry.AddCounter("outs_total", ""),
+                              nullptr,
+                              registry.AddCounter("checks_total", "")};
+  simulator.AttachMetrics(&metrics);
+  simulator.SetGameState(Simulator::kInGame);
+
+  // Keep the bat out of the way until the pitch goes by.
+  simulator.UpdateBatStates(vec2(0, 0));
+  size_t num_ticks = 0;
+  while (simulator.GetOuts() == 0 && num_ticks < 10000) {
+    simulator.UpdateOffset();
+    simulator.UpdateBallStates();
+    ++num_ticks;
+  }
+  REQUIRE(simulator.GetOuts() == 1);
+  REQUIRE(metrics.pitches->GetValue() == 1);
+  REQUIRE(metrics.outs->GetValue() == 1);
+  REQUIRE(metrics.hits->GetValue() == 0);
+  REQUIRE(metrics.home_runs->GetValue() == 0);
+  REQUIRE(metrics.collision_checks->GetValue() == num_ticks);
+
+  SECTION("Test detaching stops the counting") {
+    simulator.AttachMetrics(nullptr);
+    simulator.UpdateOffset();
+    simulator.UpdateBallStates();
+    REQUIRE(metrics.collision_checks->GetValue() == num_ticks);
+  }
+}
+
+#ifndef _WIN32
+
+namespace {
+
+/**
+ * Sends a request to the server and returns the whole response.
+ */
+string Fetch(uint16_t port, const string& request) {
+  int client = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  REQUIRE(client >= 0);
+  sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = htons(port);
+  REQUIRE(connect(client, reinterpret_cast<sockaddr*>(&address),
+                  sizeof(address)) == 0);
+  REQUIRE(send(client, request.data(), request.size(), 0) ==
+          static_cast<ssize_t>(request.size()));
+  string response;
+  char buffer[512];
+  ssize_t size;
+  while ((size = recv(client, buffer, sizeof(buffer), 0)) > 0) {
+    response.append(buffer, static_cast<size_t>(size));
+  }
+  close(client);
+  return response;
+}
+
+}  // namespace
+
+TEST_CASE("Test MetricsServer serves the metrics over HTTP") {
+  MetricsRegistry registry;
+  registry.AddCounter("pitches_total", "Pitches thrown.")->Increment(3);
+  MetricsServer server(registry, 0);
+  server.Start();
+  REQUIRE(server.GetPort() != 0);
+
+  SECTION("Test GET /metrics") {
+    string response =
+        Fetch(server.GetPort(), "GET /metrics HTTP/1.1\r\nHost: x\r\n\r\n");
+    REQUIRE(response.compare(0, 17, "HTTP/1.0 200 OK\r\n") == 0);
+    REQUIRE(Contains(response, "Content-Type: text/plain; version=0.0.4\r\n"));
+    string body = WriteText(registry);
+    REQUIRE(Contains(response, "Content-Length: " +
+                                   std::to_string(body.size()) + "\r\n"));
+    REQUIRE(response.substr(response.size() - body.size()) == body);
+  }
+
+  SECTION("Test other paths are not found") {
+    string response = Fetch(server.GetPort(), "GET / HTTP/1.0\r\n\r\n");
+    REQUIRE(response.compare(0, 24, "HTTP/1.0 404 Not Found\r\n") == 0);
+  }
+
+  SECTION("Test the server can be restarted") {
+    server.Stop();
+    REQUIRE(server.GetPort() == 0);
+    server.Start();
+    REQUIRE(Contains(Fetch(server.GetPort(), "GET /metrics HTTP/1.0\r\n\r\n"),
+                     "pitches_total 3\n"));
+  }
+}
+
+#endif
@@ -0,0 +1,97 @@
+#include <core/outcome_cache.h>
+
+#include <catch2/catch.hpp>
+
+#include "test_fixtures.h"
+
+using glm::vec2;
+using home_run_derby::Ball;
+using home_run_derby::Bat;
+using home_run_derby::BatModel;
+using home_run_derby::BatProfile;
+using home_run_derby::ContactOutcome;
+using home_run_derby::OutcomeCache;
+using home_run_derby::Stadium;
+using home_run_derby::testing::MakeTestBall;
+using home_run_derby::testing::MakeTestFlightLimits;
+
+TEST_CASE("Test OutcomeCache class") {
+  Ball ball = MakeTestBall();
+  Bat bat(5, 15);
+  vec2 contact_position = ball.GetPosition() + vec2(20, 5);
+  bat.SetBatPosition(contact_position);
+  bat.SetBatSpeed(vec2(-60, 0));
+  OutcomeCache cache(1024, 0.5f, 0.5f, MakeTestFlightLimits());
+
+  SECTION("Test a first query misses and matches the simulation") {
+    ContactOutcome outcome = cache.Resolve(ball, bat);
+    ContactOutcome expected = cache.SimulateContact(ball, bat);
+    REQUIRE(cache.GetNumMisses() == 1);
+    REQUIRE(cache.GetNumHits() == 0);
+    REQUIRE(outcome.has_contact);
+    REQUIRE(outcome.exit_velocity == expected.exit_velocity);
+    REQUIRE(outcome.distance == expected.distance);
+  }
+
+  SECTION("Test a repeated query hits") {
+    ContactOutcome first = cache.Resolve(ball, bat);
+    ContactOutcome second = cache.Resolve(ball, bat);
+    REQUIRE(cache.GetNumHits() == 1);
+    REQUIRE(second.distance == first.distance);
+  }
+
+  SECTION("Test queries within the resolution share an outcome") {
+    cache.Resolve(ball, bat);
+    bat.SetBatPosition(contact_position + vec2(0.1f, 0));
+    cache.Resolve(ball, bat);
+    REQUIRE(cache.GetNumHits() == 1);
+  }
+
+  SECTION("Test other bats and stadiums do not share an outcome") {
+    cache.Resolve(ball, bat);
+    BatProfile profile = {"Ash", 5,    300,  6,     15,  0.3f,
+                          0.6f,  0.8f, 0.1f, 0.95f, 0.5f};
+    BatModel model = BatModel::Build(profile);
+    Bat model_bat(bat);
+    model_bat.SetModel(&model);
+    cache.Resolve(ball, model_bat);
+    Stadium stadium;
+    Ball stadium_ball(ball);
+    stadium_ball.SetStadium(&stadium);
+    cache.Resolve(stadium_ball, bat);
+    REQUIRE(cache.GetNumHits() == 0);
+    REQUIRE(cache.GetNumMisses() == 3);
+  }
+
+  SECTION("Test the bat's path within a tick is ignored") {
+    ContactOutcome expected = cache.SimulateContact(ball, bat);
+    bat.AddWaypoint(contact_position + vec2(0, 400));
+    bat.AddWaypoint(contact_position + vec2(0, 200));
+    ContactOutcome outcome = cache.SimulateContact(ball, bat);
+    REQUIRE(outcome.exit_velocity == expected.exit_velocity);
+    REQUIRE(outcome.distance == expected.distance);
+  }
+
+  SECTION("Test a miss with no contact") {
+    bat.SetBatPosition(contact_position + vec2(500, 0));
+    ContactOutcome outcome = cache.Resolve(ball, bat);
+    REQUIRE_FALSE(outcome.has_contact);
+    REQUIRE(outcome.distance == 0);
+    REQUIRE(outcome.exit_velocity == ball.GetSpeed());
+  }
+
+  SECTION("Test the cache stays within its capacity") {
+    for (size_t i = 0; i < 4 * cache.GetCapacity(); ++i) {
+      bat.SetBatPosition(vec2(static_cast<float>(i), 0));
+      ContactOutcome outcome = {false, vec2(0, 0), static_cast<float>(i)};
+      cache.Insert(ball, bat, outcome);
+    }
+    REQUIRE(cache.GetNumEvictions() >= 3 * cache.GetCapacity());
+
+    // The most recent insert is always kept.
+    ContactOutcome outcome;
+    REQUIRE(cache.Lookup(ball, bat, &outcome));
+    REQUIRE(outcome.distance ==
+            static_cast<float>(4 * cache.GetCapacity() - 1));
+  }
+}
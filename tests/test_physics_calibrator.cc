@@ -0,0 +1,176 @@
+#include <core/physics_calibrator.h>
+#include <core/physics_profile.h>
+
+#include <catch2/catch.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+using glm::vec2;
+using home_run_derby::BattedBall;
+using home_run_derby::CalibrationError;
+using home_run_derby::CalibrationResult;
+using home_run_derby::CalibrationSettings;
+using home_run_derby::PhysicsCalibrator;
+using home_run_derby::PhysicsProfile;
+using std::vector;
+
+namespace {
+
+PhysicsProfile MakeProfile() {
+  PhysicsProfile profile;
+  profile.gravity = 0.09f;
+  profile.ball_velocity_boost_factor = 1.5f;
+  profile.ground_friction = 0.1f;
+  profile.ground_restitution = 0.4f;
+  profile.distance_scale = 50;
+  profile.bat_mass = 5;
+  return profile;
+}
+
+CalibrationSettings MakeSettings() {
+  CalibrationSettings settings;
+  settings.ball_mass = 10;
+  settings.ball_radius = 50;
+  settings.bat_radius = 15;
+  settings.terminal_velocity = 1000;
+  settings.window_size = 1000;
+  settings.ground_location = 930;
+  settings.frame_rate = 144;
+  settings.pitch_speed = vec2(14, 5.5f);
+  settings.contact_height = 3;
+  settings.flight.right_edge = 1828;
+  settings.flight.stopped_speed = 0.02f;
+  settings.flight.max_ticks = 20000;
+  settings.num_workers = 3;
+  settings.batch_size = 2;
+  return settings;
+}
+
+/**
+ * Measures balls as the game plays them with a profile. Against a ball
+ * measured at 1 foot and 1 mph, the relative errors are just the game's
+ * distance and exit speed less 1.
+ */
+BattedBall PlayBall(const PhysicsProfile& profile, float exit_speed_mph,
+                    float launch_angle_degrees, float bat_speed_mph) {
+  BattedBall measurement = {exit_speed_mph, launch_angle_degrees, 1, 0};
+  if (bat_speed_mph > 0) {
+    // The ball leaves the bat as fast as the game's swing sends it.
+    BattedBall swing = {1, launch_angle_degrees, 1, bat_speed_mph};
+    PhysicsCalibrator exit_speed(MakeSettings(), vector<BattedBall>{swing});
+    measurement.bat_speed_mph = bat_speed_mph;
+    measurement.exit_speed_mph =
+        static_cast<float>(exit_speed.Measure(profile).exit_speed + 1);
+  }
+  BattedBall unit = measurement;
+  unit.bat_speed_mph = 0;
+  PhysicsCalibrator distance(MakeSettings(), vector<BattedBall>{unit});
+  measurement.distance_feet =
+      static_cast<float>(distance.Measure(profile).distance + 1);
+  return measurement;
+}
+
+}  // namespace
+
+TEST_CASE("Test PhysicsProfile struct") {
+  PhysicsProfile defaults = MakeProfile();
+
+  SECTION("Test a profile keeps the defaults it leaves out") {
+    std::istringstream input("# Calibrated\ngravity 0.07  # lighter\n\n"
+                             "bat_mass 6\n");
+    PhysicsProfile profile = PhysicsProfile::Parse(input, defaults);
+    REQUIRE(profile.gravity == 0.07f);
+    REQUIRE(profile.bat_mass == 6);
+    REQUIRE(profile.ground_friction == defaults.ground_friction);
+    REQUIRE(profile.distance_scale == defaults.distance_scale);
+  }
+
+  SECTION("Test a written profile reads back exactly") {
+    PhysicsProfile written = defaults;
+    written.gravity = 0.0812345f;
+    written.ground_restitution = 0.333333f;
+    std::stringstream text;
+    written.Write(text);
+    PhysicsProfile read = PhysicsProfile::Parse(text, MakeProfile());
+    REQUIRE(read.gravity == written.gravity);
+    REQUIRE(read.ground_restitution == written.ground_restitution);
+    REQUIRE(read.bat_mass == written.bat_mass);
+  }
+
+  SECTION("Test malformed profiles throw") {
+    for (const char* text :
+         {"gravity\n", "gravity fast\n", "gravity 0.1 0.2\n", "drag 0.1\n",
+          "bat_mass -5\n"}) {
+      std::istringstream input(text);
+      REQUIRE_THROWS_AS(PhysicsProfile::Parse(input, defaults),
+                        std::runtime_error);
+    }
+    REQUIRE_THROWS_AS(PhysicsProfile::Load("no/such/profile.txt", defaults),
+                      std::runtime_error);
+  }
+}
+
+TEST_CASE("Test PhysicsCalibrator class") {
+  SECTION("Test reading measurements") {
+    std::istringstream input(
+        "exit_velocity,launch_angle,distance,bat_speed\n"
+        "102.5,28,410,74\n"
+        "\n"
+        "88,12,250\n");
+    vector<BattedBall> measurements =
+        PhysicsCalibrator::ParseMeasurements(input);
+    REQUIRE(measurements.size() == 2);
+    REQUIRE(measurements[0].exit_speed_mph == 102.5f);
+    REQUIRE(measurements[0].launch_angle_degrees == 28);
+    REQUIRE(measurements[0].distance_feet == 410);
+    REQUIRE(measurements[0].bat_speed_mph == 74);
+    REQUIRE(measurements[1].bat_speed_mph == 0);
+  }
+
+  SECTION("Test malformed measurements throw") {
+    for (const char* text :
+         {"header\n100,30\n", "header\n100,30,fast\n", "100,30,400,70,1\n",
+          "100,30,-400\n", "100,30,400,fast\n"}) {
+      std::istringstream input(text);
+      REQUIRE_THROWS_AS(PhysicsCalibrator::ParseMeasurements(input),
+                        std::runtime_error);
+    }
+    REQUIRE_THROWS_AS(PhysicsCalibrator(MakeSettings(), {}),
+                      std::invalid_argument);
+  }
+
+  SECTION("Test the game's own balls fit exactly") {
+    PhysicsProfile profile = MakeProfile();
+    vector<BattedBall> measurements = {PlayBall(profile, 100, 30, 70),
+                                       PlayBall(profile, 90, 15, 0)};
+    REQUIRE(measurements[0].distance_feet > 100);
+    REQUIRE(measurements[0].exit_speed_mph > 0);
+
+    PhysicsCalibrator calibrator(MakeSettings(), measurements);
+    CalibrationError error = calibrator.Measure(profile);
+    REQUIRE(error.distance == Approx(0).margin(1e-6));
+    REQUIRE(error.exit_speed == Approx(0).margin(1e-6));
+  }
+
+  SECTION("Test fitting recovers the constants balls were played with") {
+    PhysicsProfile truth = MakeProfile();
+    truth.gravity = 0.07f;
+    truth.ground_friction = 0.2f;
+    vector<BattedBall> measurements;
+    for (float angle : {10.0f, 20.0f, 30.0f, 40.0f}) {
+      for (float exit_speed : {80.0f, 100.0f}) {
+        measurements.push_back(PlayBall(truth, exit_speed, angle, 0));
+      }
+    }
+
+    PhysicsCalibrator calibrator(MakeSettings(), measurements);
+    CalibrationResult result = calibrator.Fit(MakeProfile(), 400);
+    REQUIRE(result.num_evaluations <= 400 + 7);
+    REQUIRE(result.start_error.distance > 0.1);
+    REQUIRE(result.error.distance < result.start_error.distance / 5);
+    // Only gravity in feet, not in pixels, shows in the distances.
+    REQUIRE(result.profile.gravity / result.profile.distance_scale ==
+            Approx(truth.gravity / truth.distance_scale).epsilon(0.1));
+  }
+}
@@ -0,0 +1,105 @@
+#include <core/quality_controller.h>
+
+#include <catch2/catch.hpp>
+#include <stdexcept>
+
+using home_run_derby::QualityController;
+using home_run_derby::QualitySettings;
+
+namespace {
+
+const double kBudget = 0.01;
+
+QualitySettings MakeSettings() {
+  QualitySettings settings;
+  settings.frame_budget_seconds = kBudget;
+  settings.num_levels = 4;
+  settings.start_level = 1;
+  settings.lower_load = 0.8;
+  settings.raise_load = 0.4;
+  settings.lower_frames = 5;
+  settings.raise_frames = 20;
+  settings.smoothing = 1;
+  return settings;
+}
+
+/**
+ * Feeds frames of one length until the level changes or they run out.
+ * @return The number of frames fed.
+ */
+size_t FeedFrames(QualityController* controller, double frame_seconds,
+                  size_t max_frames) {
+  for (size_t i = 1; i <= max_frames; ++i) {
+    if (controller->OnFrame(frame_seconds)) {
+      return i;
+    }
+  }
+  return max_frames;
+}
+
+}  // namespace
+
+TEST_CASE("Test QualityController class") {
+  QualityController controller(MakeSettings());
+
+  SECTION("Test settings out of range throw") {
+    QualitySettings settings = MakeSettings();
+    settings.start_level = 4;
+    REQUIRE_THROWS_AS(QualityController(settings), std::invalid_argument);
+    settings = MakeSettings();
+    settings.raise_load = settings.lower_load;
+    REQUIRE_THROWS_AS(QualityController(settings), std::invalid_argument);
+    settings = MakeSettings();
+    settings.smoothing = 0;
+    REQUIRE_THROWS_AS(QualityController(settings), std::invalid_argument);
+  }
+
+  SECTION("Test the start level") {
+    REQUIRE(controller.GetLevel() == 1);
+    REQUIRE(controller.GetDetail() == Approx(0.5));
+    REQUIRE(controller.Scale(150) == 75);
+    REQUIRE(controller.Scale(1) == 1);
+    REQUIRE(controller.Scale(0) == 0);
+  }
+
+  SECTION("Test slow frames lower the level to the lowest") {
+    REQUIRE(FeedFrames(&controller, kBudget, 100) == 5);
+    REQUIRE(controller.GetLevel() == 0);
+    REQUIRE(controller.GetDetail() == Approx(0.25));
+    REQUIRE(FeedFrames(&controller, kBudget, 100) == 100);
+    REQUIRE(controller.GetLevel() == 0);
+  }
+
+  SECTION("Test fast frames raise the level more slowly") {
+    REQUIRE(FeedFrames(&controller, kBudget / 10, 100) == 20);
+    REQUIRE(controller.GetLevel() == 2);
+    REQUIRE(FeedFrames(&controller, kBudget / 10, 100) == 20);
+    REQUIRE(controller.GetLevel() == 3);
+    REQUIRE(controller.Scale(150) == 150);
+    REQUIRE(FeedFrames(&controller, kBudget / 10, 100) == 100);
+    REQUIRE(controller.GetLevel() == 3);
+  }
+
+  SECTION("Test frames within the band hold the level") {
+    REQUIRE(FeedFrames(&controller, kBudget * 0.6, 1000) == 1000);
+    REQUIRE(controller.GetLevel() == 1);
+  }
+
+  SECTION("Test an occasional slow frame does not lower the level") {
+    for (size_t i = 0; i < 100; ++i) {
+      REQUIRE(!controller.OnFrame(i % 4 == 0 ? kBudget * 2 : kBudget * 0.6));
+    }
+    REQUIRE(controller.GetLevel() == 1);
+  }
+
+  SECTION("Test smoothing rides out a single spike") {
+    QualitySettings settings = MakeSettings();
+    settings.smoothing = 0.1;
+    settings.lower_frames = 1;
+    QualityController smoothed(settings);
+    smoothed.OnFrame(kBudget * 0.5);
+    REQUIRE(!smoothed.OnFrame(kBudget * 2));
+    REQUIRE(smoothed.GetSmoothedSeconds() == Approx(kBudget * 0.65));
+    REQUIRE(smoothed.GetLevel() == 1);
+  }
+}
@@ -0,0 +1,189 @@
+#include <visualizer/scenario.h>
+#include <visualizer/scenario_scheduler.h>
+
+#include <catch2/catch.hpp>
+#include <stdexcept>
+
+using glm::vec2;
+using home_run_derby::visualizer::Scenario;
+using home_run_derby::visualizer::ScenarioEvent;
+using home_run_derby::visualizer::ScenarioRun;
+using home_run_derby::visualizer::ScenarioScheduler;
+using home_run_derby::visualizer::Simulator;
+using std::vector;
+
+namespace {
+
+Simulator MakeSimulator() {
+  return Simulator(10, 1080, 16.0f / 9.0f, 30, 10, 10, 0.8f, 0.2f, 0.3f, 1, 25,
+                   5, 5, 2, 2, 10, 5, 1, 2, 5, 4);
+}
+
+/**
+ * Leaves the bat across the plate, where a pitch of the test game runs into
+ * it and is driven off the screen.
+ */
+Scenario MakeHomeRunScenario() {
+  Scenario scenario("home run");
+  scenario.WaitForPitchTick(9)
+      .MoveBat(vec2(35.9f, 535.16f))
+      .WaitTicks(1)
+      .MoveBat(vec2(10, 535.18f))
+      .WaitFor(ScenarioEvent::kContact)
+      .Expect("contact", [](const Simulator& simulator) {
+        return simulator.GetBall().HasCollided();
+      })
+      .WaitFor(ScenarioEvent::kHomeRun)
+      .Expect("a score", [](const Simulator& simulator) {
+        return simulator.GetScore() > 0;
+      });
+  return scenario;
+}
+
+}  // namespace
+
+TEST_CASE("Test ScenarioRun class") {
+  Simulator simulator = MakeSimulator();
+
+  SECTION("Test a scenario with no steps passes at once") {
+    Scenario scenario("empty");
+    ScenarioRun run(&scenario, &simulator);
+    REQUIRE_FALSE(run.Resume());
+    REQUIRE(run.HasPassed());
+    REQUIRE(run.GetNumTicks() == 0);
+  }
+
+  SECTION("Test waiting for ticks") {
+    Scenario scenario("ticks");
+    scenario.WaitTicks(3).WaitTicks(0).WaitTicks(4);
+    ScenarioRun run(&scenario, &simulator);
+    size_t num_resumes = 0;
+    while (run.Resume()) {
+      ++num_resumes;
+    }
+    REQUIRE(num_resumes == 7);
+    REQUIRE(run.HasPassed());
+    REQUIRE(run.GetNumTicks() == 7);
+    REQUIRE(simulator.GetPitchTick() == 7);
+  }
+
+  SECTION("Test waiting for a pitch tick") {
+    Scenario scenario("pitch tick");
+    scenario.WaitForPitchTick(9)
+        .Expect("pitch tick 9", [](const Simulator& simulator) {
+          return simulator.GetPitchTick() == 9;
+        })
+        .WaitForPitchTick(3)
+        .Expect("the next pitch", [](const Simulator& simulator) {
+          return simulator.GetOuts() == 1 && simulator.GetPitchTick() == 3;
+        });
+    ScenarioRun run(&scenario, &simulator);
+    REQUIRE(run.RunToEnd());
+  }
+
+  SECTION("Test waiting for an out") {
+    Scenario scenario("out");
+    scenario.WaitFor(ScenarioEvent::kOut)
+        .Expect("one out", [](const Simulator& simulator) {
+          return simulator.GetOuts() == 1;
+        })
+        .WaitFor(ScenarioEvent::kPitchEnded)
+        .Expect("two outs", [](const Simulator& simulator) {
+          return simulator.GetOuts() == 2;
+        });
+    ScenarioRun run(&scenario, &simulator);
+    REQUIRE(run.RunToEnd());
+  }
+
+  SECTION("Test waiting for contact and a home run") {
+    Scenario scenario = MakeHomeRunScenario();
+    ScenarioRun run(&scenario, &simulator);
+    REQUIRE(run.RunToEnd());
+    REQUIRE(simulator.GetScore() > 0);
+    // The high score keeps up with the game, before it is over.
+    REQUIRE(simulator.GetHighScore() == simulator.GetScore());
+  }
+
+  SECTION("Test swinging along a path") {
+    Scenario scenario("swing");
+    scenario.Swing({vec2(1, 2), vec2(3, 5), vec2(6, 9)});
+    ScenarioRun run(&scenario, &simulator);
+    REQUIRE(run.RunToEnd());
+    REQUIRE(run.GetNumTicks() == 3);
+    REQUIRE(simulator.GetBat().GetBatPosition() == vec2(6, 9));
+    REQUIRE(simulator.GetBat().GetBatSpeed() == vec2(3, 4));
+  }
+
+  SECTION("Test a failed check stops the run") {
+    bool has_continued = false;
+    Scenario scenario("failing");
+    scenario.WaitTicks(2)
+        .Expect("a home run", [](const Simulator& simulator) {
+          return simulator.GetScore() > 0;
+        })
+        .Do([&](Simulator*) { has_continued = true; });
+    ScenarioRun run(&scenario, &simulator);
+    REQUIRE_FALSE(run.RunToEnd());
+    REQUIRE(run.IsDone());
+    REQUIRE(run.GetFailure() == "failing: expected a home run at tick 2");
+    REQUIRE_FALSE(has_continued);
+  }
+
+  SECTION("Test a step that throws fails the run") {
+    Scenario scenario("throwing");
+    scenario.Do([](Simulator*) { throw std::runtime_error("no bat"); });
+    ScenarioRun run(&scenario, &simulator);
+    REQUIRE_FALSE(run.RunToEnd());
+    REQUIRE(run.GetFailure() == "throwing: threw no bat at tick 0");
+  }
+
+  SECTION("Test waiting too long fails the run") {
+    // Without a swing, no pitch is ever hit.
+    Scenario scenario("never hit");
+    scenario.WaitFor(ScenarioEvent::kContact);
+    ScenarioRun run(&scenario, &simulator);
+    REQUIRE_FALSE(run.RunToEnd());
+    REQUIRE(run.GetNumTicks() == ScenarioRun::kMaxWaitTicks);
+    REQUIRE(run.GetFailure().find("gave up waiting for contact") !=
+            std::string::npos);
+  }
+}
+
+TEST_CASE("Test ScenarioScheduler class") {
+  ScenarioScheduler scheduler(3);
+  REQUIRE(scheduler.GetNumWorkers() == 3);
+
+  Scenario home_run = MakeHomeRunScenario();
+  Scenario failing("failing");
+  failing.WaitFor(ScenarioEvent::kOut).Expect(
+      "no outs",
+      [](const Simulator& simulator) { return simulator.GetOuts() == 0; });
+
+  SECTION("Test runs play the same as they do alone") {
+    const size_t kNumRuns = 500;
+    vector<Simulator> games(kNumRuns, MakeSimulator());
+    vector<ScenarioRun> runs;
+    for (size_t i = 0; i < kNumRuns; ++i) {
+      runs.emplace_back(i % 5 == 0 ? &failing : &home_run, &games[i]);
+    }
+    REQUIRE(scheduler.Run(&runs) == kNumRuns - kNumRuns / 5);
+
+    Simulator alone_games[] = {MakeSimulator(), MakeSimulator()};
+    ScenarioRun failing_alone(&failing, &alone_games[0]);
+    ScenarioRun home_run_alone(&home_run, &alone_games[1]);
+    failing_alone.RunToEnd();
+    home_run_alone.RunToEnd();
+    for (size_t i = 0; i < kNumRuns; ++i) {
+      const ScenarioRun& alone = i % 5 == 0 ? failing_alone : home_run_alone;
+      REQUIRE(runs[i].IsDone());
+      REQUIRE(runs[i].GetFailure() == alone.GetFailure());
+      REQUIRE(runs[i].GetNumTicks() == alone.GetNumTicks());
+      REQUIRE(games[i].GetScore() == alone.GetSimulator().GetScore());
+    }
+  }
+
+  SECTION("Test running no scenarios") {
+    vector<ScenarioRun> runs;
+    REQUIRE(scheduler.Run(&runs) == 0);
+  }
+}
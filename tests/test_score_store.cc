@@ -0,0 +1,173 @@
+#include <core/score_store.h>
+
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using home_run_derby::ScoreStore;
+using std::string;
+
+namespace {
+
+const string kTestStorePath = "test_score_store";
+
+void RemoveStoreFiles() {
+  remove((kTestStorePath + ".log").c_str());
+  remove((kTestStorePath + ".snapshot").c_str());
+  remove((kTestStorePath + ".snapshot.tmp").c_str());
+}
+
+// A directory in the way makes renaming the snapshot into place fail.
+void BlockSnapshotPath() {
+  string path = kTestStorePath + ".snapshot";
+#ifdef _WIN32
+  _mkdir(path.c_str());
+#else
+  mkdir(path.c_str(), 0755);
+#endif
+}
+
+void UnblockSnapshotPath() {
+  string path = kTestStorePath + ".snapshot";
+#ifdef _WIN32
+  _rmdir(path.c_str());
+#else
+  rmdir(path.c_str());
+#endif
+}
+
+}  // namespace
+
+TEST_CASE("Test ScoreStore class") {
+  RemoveStoreFiles();
+
+  SECTION("Test empty store") {
+    ScoreStore store(kTestStorePath);
+    store.Open();
+    REQUIRE(store.GetNumScores() == 0);
+    REQUIRE(store.GetHighScore() == 0);
+  }
+
+  SECTION("Test scores persist across reopening") {
+    {
+      ScoreStore store(kTestStorePath);
+      store.Open();
+      store.RecordScore(100);
+      store.RecordScore(300);
+      store.RecordScore(200);
+    }
+    ScoreStore store(kTestStorePath);
+    store.Open();
+    REQUIRE(store.GetNumScores() == 3);
+    REQUIRE(store.GetHighScore() == 300);
+    REQUIRE(store.GetLogScores() == std::vector<float>({100, 300, 200}));
+  }
+
+  SECTION("Test torn record is dropped") {
+    {
+      ScoreStore store(kTestStorePath);
+      store.Open();
+      store.RecordScore(100);
+      store.RecordScore(200);
+    }
+    // Simulate a crash halfway through writing a record.
+    FILE* log = fopen((kTestStorePath + ".log").c_str(), "ab");
+    float partial_record = 500;
+    fwrite(&partial_record, sizeof(partial_record), 1, log);
+    fclose(log);
+
+    {
+      ScoreStore store(kTestStorePath);
+      store.Open();
+      REQUIRE(store.GetNumScores() == 2);
+      REQUIRE(store.GetHighScore() == 200);
+      store.RecordScore(50);
+    }
+    ScoreStore store(kTestStorePath);
+    store.Open();
+    REQUIRE(store.GetLogScores() == std::vector<float>({100, 200, 50}));
+  }
+
+  SECTION("Test compaction sorts scores into the snapshot") {
+    {
+      ScoreStore store(kTestStorePath, 3);
+      store.Open();
+      store.RecordScore(100);
+      store.RecordScore(300);
+      store.RecordScore(200);
+      REQUIRE(store.GetNumSnapshotScores() == 3);
+      REQUIRE(store.GetLogScores().empty());
+      store.RecordScore(250);
+    }
+    ScoreStore store(kTestStorePath, 3);
+    store.Open();
+    REQUIRE(store.GetNumScores() == 4);
+    REQUIRE(store.GetNumSnapshotScores() == 3);
+    REQUIRE(store.GetSnapshotScores()[0] == 300);
+    REQUIRE(store.GetSnapshotScores()[1] == 200);
+    REQUIRE(store.GetSnapshotScores()[2] == 100);
+    REQUIRE(store.GetLogScores() == std::vector<float>({250}));
+
+    store.Compact();
+    REQUIRE(store.GetNumSnapshotScores() == 4);
+    REQUIRE(store.GetSnapshotScores()[1] == 250);
+  }
+
+  SECTION("Test compacted log is not replayed twice") {
+    {
+      ScoreStore store(kTestStorePath);
+      store.Open();
+      store.RecordScore(100);
+    }
+    // Keep a copy of the log, as if we crashed right after the snapshot was
+    // renamed into place but before the new log was started.
+    FILE* log = fopen((kTestStorePath + ".log").c_str(), "rb");
+    char contents[64];
+    size_t size = fread(contents, 1, sizeof(contents), log);
+    fclose(log);
+    {
+      ScoreStore store(kTestStorePath);
+      store.Open();
+      store.Compact();
+    }
+    log = fopen((kTestStorePath + ".log").c_str(), "wb");
+    fwrite(contents, 1, size, log);
+    fclose(log);
+
+    ScoreStore store(kTestStorePath);
+    store.Open();
+    REQUIRE(store.GetNumScores() == 1);
+    REQUIRE(store.GetHighScore() == 100);
+  }
+
+  SECTION("Test scores recorded after a failed compaction persist") {
+    {
+      BlockSnapshotPath();
+      ScoreStore store(kTestStorePath);
+      store.Open();
+      store.RecordScore(100);
+      store.RecordScore(200);
+      REQUIRE_THROWS_AS(store.Compact(), std::runtime_error);
+      store.RecordScore(300);
+      store.RecordScore(50);
+      REQUIRE(store.GetNumScores() == 4);
+    }
+    UnblockSnapshotPath();
+
+    ScoreStore store(kTestStorePath);
+    store.Open();
+    REQUIRE(store.GetNumScores() == 4);
+    REQUIRE(store.GetHighScore() == 300);
+    REQUIRE(store.GetLogScores() ==
+            std::vector<float>({100, 200, 300, 50}));
+  }
+
+  RemoveStoreFiles();
+}
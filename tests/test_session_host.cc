@@ -0,0 +1,261 @@
+#include <core/metrics.h>
+#include <core/session_protocol.h>
+#include <visualizer/session_host.h>
+
+#include <catch2/catch.hpp>
+#include <stdexcept>
+
+using glm::vec2;
+using home_run_derby::DecodeCommand;
+using home_run_derby::DecodeStatus;
+using home_run_derby::EncodeCommand;
+using home_run_derby::EncodeStatus;
+using home_run_derby::Histogram;
+using home_run_derby::kMaxSessionMessageSize;
+using home_run_derby::ParseCommand;
+using home_run_derby::SessionCommand;
+using home_run_derby::SessionMessage;
+using home_run_derby::SessionStatus;
+using home_run_derby::visualizer::SessionHost;
+using home_run_derby::visualizer::SessionHostSettings;
+using home_run_derby::visualizer::Simulator;
+
+namespace {
+
+Simulator MakePrototype() {
+  return Simulator(10, 1080, 16.0f / 9.0f, 30, 10, 10, 0.8f, 0.2f, 0.3f, 1,
+                   25, 5, 5, 2, 2, 10, 5, 0, 0, 0, 0);
+}
+
+SessionHostSettings MakeSettings(size_t max_sessions, size_t num_workers,
+                                 size_t batch_size) {
+  SessionHostSettings settings;
+  settings.max_sessions = max_sessions;
+  settings.num_workers = num_workers;
+  settings.batch_size = batch_size;
+  settings.max_outs = 3;
+  settings.tick_slo_seconds = 1;
+  return settings;
+}
+
+/**
+ * Plays the same inputs in every session of a host for a while.
+ */
+void PlaySessions(SessionHost* host, size_t num_ticks) {
+  for (size_t i = 0; i < host->GetMaxSessions(); ++i) {
+    host->OpenSession(i);
+    host->StartGame(i);
+  }
+  for (size_t tick = 0; tick < num_ticks; ++tick) {
+    for (size_t i = 0; i < host->GetMaxSessions(); ++i) {
+      host->QueueInput(i, vec2(900, 500 + (tick * 7 + i * 13) % 400));
+    }
+    host->Tick();
+  }
+}
+
+}  // namespace
+
+TEST_CASE("Test session protocol") {
+  uint8_t message[kMaxSessionMessageSize];
+
+  SECTION("Test commands round trip") {
+    SessionCommand command;
+    command.type = SessionMessage::kInput;
+    command.session = 4000;
+    command.bat_position = vec2(850.25f, -12.5f);
+    size_t size = EncodeCommand(command, message);
+    REQUIRE(size <= kMaxSessionMessageSize);
+
+    SessionCommand decoded;
+    REQUIRE(DecodeCommand(message, size, &decoded));
+    REQUIRE(decoded.type == SessionMessage::kInput);
+    REQUIRE(decoded.session == 4000);
+    REQUIRE(decoded.bat_position == vec2(850.25f, -12.5f));
+    REQUIRE_FALSE(DecodeCommand(message, size - 1, &decoded));
+  }
+
+  SECTION("Test statuses round trip") {
+    SessionStatus status = {7, 100000, Simulator::kInGame, 2, 123456};
+    size_t size = EncodeStatus(status, message);
+    REQUIRE(size <= kMaxSessionMessageSize);
+
+    SessionStatus decoded;
+    REQUIRE(DecodeStatus(message, size, &decoded));
+    REQUIRE(decoded.session == 7);
+    REQUIRE(decoded.tick == 100000);
+    REQUIRE(decoded.game_state == Simulator::kInGame);
+    REQUIRE(decoded.outs == 2);
+    REQUIRE(decoded.score == 123456);
+    SessionCommand command;
+    REQUIRE_FALSE(DecodeCommand(message, size, &command));
+  }
+
+  SECTION("Test parsing commands") {
+    SessionCommand command;
+    REQUIRE(ParseCommand("open", &command));
+    REQUIRE(command.type == SessionMessage::kOpen);
+    REQUIRE(ParseCommand(" start 3", &command));
+    REQUIRE(command.type == SessionMessage::kStart);
+    REQUIRE(command.session == 3);
+    REQUIRE(ParseCommand("input 3 850 420", &command));
+    REQUIRE(command.type == SessionMessage::kInput);
+    REQUIRE(command.bat_position == vec2(850, 420));
+    REQUIRE(ParseCommand("close 3", &command));
+    REQUIRE(command.type == SessionMessage::kClose);
+
+    REQUIRE_FALSE(ParseCommand("", &command));
+    REQUIRE_FALSE(ParseCommand("start", &command));
+    REQUIRE_FALSE(ParseCommand("input 3 850", &command));
+    REQUIRE_FALSE(ParseCommand("close 3 4", &command));
+    REQUIRE_FALSE(ParseCommand("swing 3", &command));
+  }
+}
+
+TEST_CASE("Test SessionHost class") {
+  SessionHost host(MakePrototype(), MakeSettings(4, 2, 1));
+
+  SECTION("Test settings out of range throw") {
+    REQUIRE_THROWS_AS(SessionHost(MakePrototype(), MakeSettings(0, 2, 1)),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(SessionHost(MakePrototype(), MakeSettings(4, 2, 0)),
+                      std::invalid_argument);
+  }
+
+  SECTION("Test sessions reuse the lowest free number") {
+    REQUIRE(host.OpenSession(1) == 0);
+    REQUIRE(host.OpenSession(2) == 1);
+    REQUIRE(host.OpenSession(3) == 2);
+    host.CloseSession(1);
+    host.CloseSession(0);
+    REQUIRE_FALSE(host.IsOpen(0));
+    REQUIRE(host.GetNumOpenSessions() == 1);
+    REQUIRE(host.OpenSession(4) == 0);
+    REQUIRE(host.OpenSession(5) == 1);
+    REQUIRE(host.OpenSession(6) == 3);
+    REQUIRE_THROWS_AS(host.OpenSession(7), std::runtime_error);
+    REQUIRE(host.GetNumOpenSessions() == 4);
+  }
+
+  SECTION("Test driving a closed session throws") {
+    REQUIRE_THROWS_AS(host.StartGame(0), std::invalid_argument);
+    REQUIRE_THROWS_AS(host.QueueInput(0, vec2(1, 1)), std::invalid_argument);
+    REQUIRE_THROWS_AS(host.CloseSession(0), std::invalid_argument);
+  }
+
+  SECTION("Test inputs move the bat on the next tick") {
+    size_t session = host.OpenSession(1);
+    host.StartGame(session);
+    host.QueueInput(session, vec2(800, 600));
+    host.QueueInput(session, vec2(820, 640));
+    REQUIRE(host.GetSimulator(session).GetBat().GetBatPosition() !=
+            vec2(820, 640));
+    host.Tick();
+    REQUIRE(host.GetSimulator(session).GetBat().GetBatPosition() ==
+            vec2(820, 640));
+    REQUIRE(host.GetSimulator(session).GetBat().GetBatSpeed() ==
+            vec2(20, 40));
+  }
+
+  SECTION("Test only games in progress are ticked") {
+    size_t playing = host.OpenSession(1);
+    size_t waiting = host.OpenSession(2);
+    size_t closed = host.OpenSession(3);
+    host.StartGame(playing);
+    host.StartGame(closed);
+    host.CloseSession(closed);
+    for (size_t i = 0; i < 10; ++i) {
+      host.Tick();
+    }
+    REQUIRE(host.GetStats(playing).num_ticks == 10);
+    REQUIRE(host.GetStats(waiting).num_ticks == 0);
+    REQUIRE(host.GetStats(closed).num_ticks == 0);
+    REQUIRE(host.GetSimulator(waiting).GetCurrentGameState() ==
+            Simulator::kStartScreen);
+  }
+
+  SECTION("Test reopened sessions start over") {
+    size_t session = host.OpenSession(1);
+    host.StartGame(session);
+    for (size_t i = 0; i < 10; ++i) {
+      host.Tick();
+    }
+    host.CloseSession(session);
+    REQUIRE(host.OpenSession(1) == session);
+    REQUIRE(host.GetStats(session).num_ticks == 0);
+    REQUIRE(host.GetSimulator(session).GetCurrentGameState() ==
+            Simulator::kStartScreen);
+    REQUIRE(host.GetSimulator(session).GetOuts() == 0);
+  }
+
+  SECTION("Test games end after the last out") {
+    size_t session = host.OpenSession(1);
+    host.StartGame(session);
+    const Simulator& simulator = host.GetSimulator(session);
+    for (size_t i = 0;
+         i < 100000 && simulator.GetCurrentGameState() == Simulator::kInGame;
+         ++i) {
+      host.Tick();
+    }
+    REQUIRE(simulator.GetCurrentGameState() == Simulator::kEndScreen);
+    REQUIRE(simulator.GetOuts() == 3);
+
+    // Starting again goes through the start screen to a new game.
+    host.StartGame(session);
+    REQUIRE(simulator.GetCurrentGameState() == Simulator::kInGame);
+    REQUIRE(simulator.GetOuts() == 0);
+  }
+}
+
+TEST_CASE("Test sessions play the same however they are batched") {
+  SessionHost batched(MakePrototype(), MakeSettings(37, 4, 3));
+  SessionHost alone(MakePrototype(), MakeSettings(37, 1, 37));
+  PlaySessions(&batched, 500);
+  PlaySessions(&alone, 500);
+
+  for (size_t i = 0; i < 37; ++i) {
+    const Simulator& first = batched.GetSimulator(i);
+    const Simulator& second = alone.GetSimulator(i);
+    REQUIRE(batched.GetStats(i).num_ticks == alone.GetStats(i).num_ticks);
+    REQUIRE(first.GetBall().GetPosition() == second.GetBall().GetPosition());
+    REQUIRE(first.GetOuts() == second.GetOuts());
+    REQUIRE(first.GetScore() == second.GetScore());
+  }
+}
+
+TEST_CASE("Test session tick latencies") {
+  SECTION("Test every tick is counted") {
+    SessionHost host(MakePrototype(), MakeSettings(8, 3, 2));
+    PlaySessions(&host, 20);
+    Histogram latencies(SessionHost::kTickLatencyBuckets);
+    host.CollectTickLatencies(&latencies);
+    uint64_t num_ticks = 0;
+    for (size_t i = 0; i < 8; ++i) {
+      num_ticks += host.GetStats(i).num_ticks;
+    }
+    REQUIRE(latencies.GetCount() == num_ticks);
+    REQUIRE(num_ticks > 0);
+  }
+
+  SECTION("Test ticks past the objective are slow") {
+    SessionHostSettings settings = MakeSettings(8, 2, 1);
+    settings.tick_slo_seconds = 1e-12;
+    SessionHost host(MakePrototype(), settings);
+    PlaySessions(&host, 20);
+    for (size_t i = 0; i < 8; ++i) {
+      REQUIRE(host.GetStats(i).num_slow_ticks ==
+              host.GetStats(i).num_ticks);
+    }
+  }
+
+  SECTION("Test ticks within the objective are not slow") {
+    SessionHostSettings settings = MakeSettings(8, 2, 1);
+    settings.tick_slo_seconds = 1000;
+    SessionHost host(MakePrototype(), settings);
+    PlaySessions(&host, 20);
+    for (size_t i = 0; i < 8; ++i) {
+      REQUIRE(host.GetStats(i).num_slow_ticks == 0);
+      REQUIRE(host.GetStats(i).last_tick_seconds > 0);
+    }
+  }
+}
@@ -0,0 +1,255 @@
+#include <core/frame_sink.h>
+#include <core/software_rasterizer.h>
+
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+using ci::ColorA;
+using glm::vec2;
+using home_run_derby::DrawList;
+using home_run_derby::PpmSequenceWriter;
+using home_run_derby::RasterImage;
+using home_run_derby::SoftwareRasterizer;
+using home_run_derby::Y4mWriter;
+using std::string;
+
+namespace {
+
+const uint32_t kBlack = 0xFF000000u;
+const uint32_t kWhite = 0xFFFFFFFFu;
+
+/**
+ * Records shapes of every kind, overlapping, some of them translucent.
+ */
+void RecordScene(DrawList* list) {
+  list->FillRect(vec2(0, 0), vec2(200, 120), ColorA(0.6f, 0.8f, 0.9f, 1));
+  list->FillCircle(vec2(40, 30), 25, ColorA(1, 1, 1, 0.3f));
+  list->FillCircle(vec2(150, 90), 33.3f, ColorA(1, 0.6f, 0, 1));
+  list->DrawLine(vec2(10, 110), vec2(190, 20), 6, ColorA(0, 0.4f, 0, 0.7f));
+  list->FillRect(vec2(180, 100), vec2(60, 70), ColorA(0.6f, 0.3f, 0.1f, 0.5f));
+  list->DrawText("Outs: 3, 42%", vec2(100, 5), 20, ColorA(0, 0, 0, 0.9f));
+}
+
+bool AreSame(const RasterImage& first, const RasterImage& second) {
+  for (size_t y = 0; y < first.GetHeight(); ++y) {
+    for (size_t x = 0; x < first.GetWidth(); ++x) {
+      if (first.GetPixel(x, y) != second.GetPixel(x, y)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/**
+ * Blends a channel as (source * alpha + destination * (255 - alpha)) / 255,
+ * rounded to the nearest.
+ */
+uint32_t BlendExactly(uint32_t source, uint32_t destination, uint32_t alpha) {
+  uint32_t blended = source * alpha + destination * (255 - alpha);
+  return (2 * blended + 255) / 510;
+}
+
+}  // namespace
+
+TEST_CASE("Test SoftwareRasterizer class") {
+  SoftwareRasterizer rasterizer(1);
+
+  SECTION("Test colors pack red first and clamp") {
+    REQUIRE(RasterImage::PackColor(ColorA(1, 0, 0, 1)) == 0xFF0000FFu);
+    REQUIRE(RasterImage::PackColor(ColorA(-1, 2, 0.5f, 0)) == 0x0080FF00u);
+    REQUIRE(RasterImage(2, 2).GetPixel(1, 1) == kBlack);
+  }
+
+  SECTION("Test shapes cover the pixels whose centers they contain") {
+    RasterImage image(20, 12);
+    DrawList list;
+    list.FillRect(vec2(3, 2.5f), vec2(1, 1), ColorA(1, 1, 1, 1));
+    list.FillCircle(vec2(10, 6), 3, ColorA(1, 1, 1, 1));
+    list.DrawLine(vec2(15, 10), vec2(19, 10), 2, ColorA(1, 1, 1, 1));
+    rasterizer.Render(list, &image);
+
+    REQUIRE(image.GetPixel(1, 1) == kWhite);
+    REQUIRE(image.GetPixel(2, 1) == kWhite);
+    REQUIRE(image.GetPixel(3, 1) == kBlack);
+    REQUIRE(image.GetPixel(1, 2) == kBlack);
+
+    REQUIRE(image.GetPixel(10, 6) == kWhite);
+    REQUIRE(image.GetPixel(12, 6) == kWhite);
+    REQUIRE(image.GetPixel(13, 6) == kBlack);
+    REQUIRE(image.GetPixel(12, 8) == kBlack);
+
+    REQUIRE(image.GetPixel(15, 9) == kWhite);
+    REQUIRE(image.GetPixel(18, 10) == kWhite);
+    REQUIRE(image.GetPixel(19, 10) == kBlack);
+    REQUIRE(image.GetPixel(15, 11) == kBlack);
+  }
+
+  SECTION("Test translucent shapes blend exactly") {
+    // Rows of every length, so both whole blocks and leftovers are blended.
+    RasterImage image(23, 23);
+    DrawList list;
+    for (size_t y = 0; y < 23; ++y) {
+      list.FillRect(vec2(0, y), vec2(23, y + 1),
+                    ColorA(y / 22.0f, 1 - y / 22.0f, 0.25f, 1));
+    }
+    rasterizer.Render(list, &image);
+    RasterImage below = image;
+    list.Clear();
+    for (size_t y = 0; y < 23; ++y) {
+      list.FillRect(vec2(0, y), vec2(y, y + 1), ColorA(0.9f, 0.1f, 0.5f, 0.3f));
+    }
+    rasterizer.Render(list, &image);
+
+    uint32_t color = RasterImage::PackColor(ColorA(0.9f, 0.1f, 0.5f, 0.3f));
+    uint32_t alpha = color >> 24;
+    for (size_t y = 0; y < 23; ++y) {
+      for (size_t x = 0; x < 23; ++x) {
+        uint32_t expected = below.GetPixel(x, y);
+        if (x < y) {
+          expected = 0;
+          for (int shift = 0; shift < 24; shift += 8) {
+            expected |= BlendExactly((color >> shift) & 0xFF,
+                                     (below.GetPixel(x, y) >> shift) & 0xFF,
+                                     alpha)
+                        << shift;
+          }
+          expected |= 0xFF000000u;
+        }
+        REQUIRE(image.GetPixel(x, y) == expected);
+      }
+    }
+  }
+
+  SECTION("Test workers and tiles do not change the image") {
+    DrawList list;
+    RecordScene(&list);
+    RasterImage single(200, 120);
+    rasterizer.Render(list, &single);
+
+    SoftwareRasterizer tiled(4, 7);
+    REQUIRE(tiled.GetNumWorkers() == 4);
+    RasterImage image(200, 120);
+    tiled.Render(list, &image);
+    REQUIRE(AreSame(single, image));
+  }
+
+  SECTION("Test text is drawn in capitals") {
+    RasterImage upper(100, 20);
+    RasterImage lower(100, 20);
+    DrawList list;
+    list.DrawText("HIT #1", vec2(50, 2), 20, ColorA(1, 1, 1, 1));
+    rasterizer.Render(list, &upper);
+    list.Clear();
+    list.DrawText("hit ?1", vec2(50, 2), 20, ColorA(1, 1, 1, 1));
+    REQUIRE(list.GetText() == "HIT ?1");
+    rasterizer.Render(list, &lower);
+    REQUIRE(AreSame(upper, lower));
+    // The text is 70 pixels wide, and the stem of its I is two pixels wide
+    // in the middle of the second glyph.
+    REQUIRE(upper.GetPixel(30, 6) == kBlack);
+    REQUIRE(upper.GetPixel(31, 6) == kWhite);
+    REQUIRE(upper.GetPixel(32, 6) == kWhite);
+    REQUIRE(upper.GetPixel(33, 6) == kBlack);
+  }
+
+  SECTION("Test lists scale what they record") {
+    RasterImage image(4, 4);
+    DrawList list(0.5f);
+    list.FillRect(vec2(0, 0), vec2(4, 4), ColorA(1, 1, 1, 1));
+    rasterizer.Render(list, &image);
+    REQUIRE(image.GetPixel(1, 1) == kWhite);
+    REQUIRE(image.GetPixel(2, 1) == kBlack);
+    REQUIRE(image.GetPixel(1, 2) == kBlack);
+  }
+
+  SECTION("Test shapes with nothing to draw are dropped") {
+    DrawList list;
+    list.FillRect(vec2(0, 0), vec2(5, 5), ColorA(1, 1, 1, 0));
+    list.FillCircle(vec2(5, 5), 0, ColorA(1, 1, 1, 1));
+    list.DrawLine(vec2(5, 5), vec2(5, 5), 3, ColorA(1, 1, 1, 1));
+    list.DrawText("gone", vec2(5, 5), 10, ColorA(1, 1, 1, 0));
+    REQUIRE(list.GetCommands().empty());
+    REQUIRE(list.GetText().empty());
+  }
+
+  SECTION("Test settings out of range throw") {
+    REQUIRE_THROWS_AS(RasterImage(0, 5), std::invalid_argument);
+    REQUIRE_THROWS_AS(DrawList(0), std::invalid_argument);
+    REQUIRE_THROWS_AS(SoftwareRasterizer(1, 0), std::invalid_argument);
+  }
+}
+
+TEST_CASE("Test frame sinks") {
+  RasterImage image(3, 3);
+  DrawList list;
+  list.FillRect(vec2(0, 0), vec2(2, 2), ColorA(1, 1, 1, 1));
+  list.FillRect(vec2(2, 0), vec2(3, 3), ColorA(1, 0, 0, 1));
+  SoftwareRasterizer(1).Render(list, &image);
+
+  SECTION("Test a Y4M stream holds full range 4:2:0 frames") {
+    std::ostringstream output;
+    Y4mWriter writer(output, 144);
+    writer.WriteFrame(image);
+    writer.WriteFrame(image);
+    REQUIRE(writer.GetNumFrames() == 2);
+
+    string header =
+        "YUV4MPEG2 W3 H3 F144:1 Ip A1:1 C420jpeg XCOLORRANGE=FULL\n";
+    string frame_header = "FRAME\n";
+    // A luma sample per pixel, and a chroma sample per two by two block.
+    size_t frame_size = frame_header.size() + 9 + 2 * 4;
+    string video = output.str();
+    REQUIRE(video.size() == header.size() + 2 * frame_size);
+    REQUIRE(video.compare(0, header.size(), header) == 0);
+
+    const uint8_t* frame =
+        reinterpret_cast<const uint8_t*>(video.data()) + header.size() +
+        frame_size + frame_header.size();
+    // White, then red, then black.
+    REQUIRE(frame[0] == 255);
+    REQUIRE(frame[2] == 76);
+    REQUIRE(frame[6] == 0);
+    // The white block has no color, and the red edge is as red as can be.
+    REQUIRE(frame[9] == 128);
+    REQUIRE(frame[13] == 128);
+    REQUIRE(frame[14] > 200);
+
+    RasterImage smaller(2, 3);
+    REQUIRE_THROWS_AS(writer.WriteFrame(smaller), std::invalid_argument);
+    REQUIRE_THROWS_AS(Y4mWriter(output, 0), std::invalid_argument);
+  }
+
+  SECTION("Test PPM frames are numbered") {
+    const string prefix = "test_frame_sink_";
+    PpmSequenceWriter writer(prefix);
+    REQUIRE(writer.GetNextPath() == prefix + "000000.ppm");
+    writer.WriteFrame(image);
+    REQUIRE(writer.GetNumFrames() == 1);
+
+    std::ifstream input(prefix + "000000.ppm", std::ios::binary);
+    string magic;
+    size_t width, height, max_value;
+    input >> magic >> width >> height >> max_value;
+    input.get();
+    char pixels[27];
+    input.read(pixels, sizeof(pixels));
+    REQUIRE(magic == "P6");
+    REQUIRE(width == 3);
+    REQUIRE(height == 3);
+    REQUIRE(max_value == 255);
+    REQUIRE(input.gcount() == 27);
+    REQUIRE(static_cast<uint8_t>(pixels[0]) == 255);
+    REQUIRE(static_cast<uint8_t>(pixels[6]) == 255);
+    REQUIRE(static_cast<uint8_t>(pixels[7]) == 0);
+    input.close();
+    std::remove((prefix + "000000.ppm").c_str());
+
+    PpmSequenceWriter nowhere("no/such/directory/frame_");
+    REQUIRE_THROWS_AS(nowhere.WriteFrame(image), std::runtime_error);
+  }
+}
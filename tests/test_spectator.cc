@@ -0,0 +1,224 @@
+#include <core/datagram_socket.h>
+#include <core/spectator_protocol.h>
+#include <visualizer/simulator.h>
+#include <visualizer/spectator_broadcaster.h>
+
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <thread>
+
+using glm::vec2;
+using home_run_derby::DatagramSocket;
+using home_run_derby::DecodeAck;
+using home_run_derby::DequantizePosition;
+using home_run_derby::EncodeControl;
+using home_run_derby::EncodeFrame;
+using home_run_derby::kMaxSpectatorMessageSize;
+using home_run_derby::kNumSpectatorFields;
+using home_run_derby::kSpectatorHistorySize;
+using home_run_derby::MakeLoopbackAddress;
+using home_run_derby::QuantizePosition;
+using home_run_derby::ReadMessageType;
+using home_run_derby::SocketAddress;
+using home_run_derby::SpectatorDecoder;
+using home_run_derby::SpectatorFrame;
+using home_run_derby::SpectatorMessage;
+using home_run_derby::visualizer::Simulator;
+using home_run_derby::visualizer::SpectatorBroadcaster;
+
+namespace {
+
+SpectatorFrame MakeFrame(uint32_t tick, int32_t base) {
+  SpectatorFrame frame;
+  frame.tick = tick;
+  for (size_t field = 0; field < kNumSpectatorFields; ++field) {
+    frame.values[field] = base + static_cast<int32_t>(field) * 1000;
+  }
+  return frame;
+}
+
+void RequireSameFrame(const SpectatorFrame& left,
+                      const SpectatorFrame& right) {
+  REQUIRE(left.tick == right.tick);
+  for (size_t field = 0; field < kNumSpectatorFields; ++field) {
+    REQUIRE(left.values[field] == right.values[field]);
+  }
+}
+
+}  // namespace
+
+TEST_CASE("Test spectator frame encoding") {
+  uint8_t message[kMaxSpectatorMessageSize];
+  SpectatorDecoder decoder;
+  SpectatorFrame decoded;
+  SpectatorFrame keyframe = MakeFrame(100, -5000);
+
+  size_t keyframe_size = EncodeFrame(keyframe, nullptr, message);
+  REQUIRE(keyframe_size <= kMaxSpectatorMessageSize);
+  REQUIRE(decoder.Decode(message, keyframe_size, &decoded));
+  RequireSameFrame(decoded, keyframe);
+
+  SECTION("Test a delta rebuilds the frame") {
+    SpectatorFrame frame = MakeFrame(103, -4990);
+    frame.values[home_run_derby::kOuts] = -7;
+    size_t size = EncodeFrame(frame, &keyframe, message);
+    SpectatorMessage type;
+    REQUIRE(ReadMessageType(message, size, &type));
+    REQUIRE(type == SpectatorMessage::kDelta);
+    REQUIRE(decoder.Decode(message, size, &decoded));
+    RequireSameFrame(decoded, frame);
+  }
+
+  SECTION("Test an unchanged frame costs a byte per field") {
+    SpectatorFrame frame = keyframe;
+    frame.tick = 101;
+    size_t size = EncodeFrame(frame, &keyframe, message);
+    REQUIRE(size == 1 + 1 + 1 + kNumSpectatorFields);
+    REQUIRE(size < keyframe_size);
+    REQUIRE(decoder.Decode(message, size, &decoded));
+    RequireSameFrame(decoded, frame);
+  }
+
+  SECTION("Test extreme differences wrap and decode exactly") {
+    SpectatorFrame low = MakeFrame(200, 0);
+    SpectatorFrame high = MakeFrame(201, 0);
+    for (size_t field = 0; field < kNumSpectatorFields; ++field) {
+      low.values[field] = std::numeric_limits<int32_t>::min();
+      high.values[field] = std::numeric_limits<int32_t>::max();
+    }
+    REQUIRE(decoder.Decode(message, EncodeFrame(low, nullptr, message),
+                           &decoded));
+    REQUIRE(decoder.Decode(message, EncodeFrame(high, &low, message),
+                           &decoded));
+    RequireSameFrame(decoded, high);
+  }
+
+  SECTION("Test a delta against a frame the decoder lacks fails") {
+    SpectatorFrame missing = MakeFrame(99, 0);
+    SpectatorFrame frame = MakeFrame(104, 0);
+    REQUIRE_FALSE(
+        decoder.Decode(message, EncodeFrame(frame, &missing, message),
+                       &decoded));
+
+    // The slot for the keyframe has since been reused by a later frame.
+    SpectatorFrame later = MakeFrame(100 + kSpectatorHistorySize, 0);
+    REQUIRE(decoder.Decode(message, EncodeFrame(later, nullptr, message),
+                           &decoded));
+    REQUIRE_FALSE(decoder.Decode(
+        message, EncodeFrame(frame, &keyframe, message), &decoded));
+  }
+
+  SECTION("Test malformed datagrams fail") {
+    REQUIRE_FALSE(decoder.Decode(message, keyframe_size - 1, &decoded));
+    message[keyframe_size] = 0;
+    REQUIRE_FALSE(decoder.Decode(message, keyframe_size + 1, &decoded));
+    REQUIRE_FALSE(decoder.Decode(message, 0, &decoded));
+    message[0] = 42;
+    REQUIRE_FALSE(decoder.Decode(message, keyframe_size, &decoded));
+    size_t size = EncodeControl(SpectatorMessage::kJoin, 0, message);
+    REQUIRE_FALSE(decoder.Decode(message, size, &decoded));
+  }
+
+  SECTION("Test acknowledgements") {
+    uint32_t tick;
+    size_t size = EncodeControl(SpectatorMessage::kAck, 123456789, message);
+    REQUIRE(DecodeAck(message, size, &tick));
+    REQUIRE(tick == 123456789);
+    REQUIRE_FALSE(DecodeAck(message, size - 1, &tick));
+    size = EncodeControl(SpectatorMessage::kLeave, 0, message);
+    REQUIRE_FALSE(DecodeAck(message, size, &tick));
+  }
+
+  SECTION("Test positions are quantized to a quarter pixel") {
+    REQUIRE(DequantizePosition(QuantizePosition(123.3f)) == 123.25f);
+    REQUIRE(DequantizePosition(QuantizePosition(-0.6f)) == -0.5f);
+  }
+}
+
+TEST_CASE("Test a spectator mirrors a broadcast game") {
+  Simulator simulator(10, 1080, 16.0f / 9.0f, 30, 10, 10, 0.8f, 0.2f, 0.3f, 1,
+                      25, 5, 5, 2, 2, 10, 5, 1, 2, 5, 4);
+  simulator.SetGameState(Simulator::kInGame);
+  SpectatorBroadcaster broadcaster(0);
+  REQUIRE_FALSE(broadcaster.Publish(simulator));
+  broadcaster.Start();
+  REQUIRE(broadcaster.GetPort() != 0);
+
+  DatagramSocket spectator;
+  spectator.Open(0);
+  SocketAddress game = MakeLoopbackAddress(broadcaster.GetPort());
+  uint8_t message[kMaxSpectatorMessageSize];
+  REQUIRE(spectator.SendTo(
+      game, message, EncodeControl(SpectatorMessage::kJoin, 0, message)));
+
+  // Play while watching, acknowledging every frame rebuilt.
+  SpectatorDecoder decoder;
+  SpectatorFrame latest;
+  size_t num_keyframes = 0;
+  size_t num_deltas = 0;
+  std::chrono::steady_clock::time_point deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (num_deltas < 20 && std::chrono::steady_clock::now() < deadline) {
+    simulator.UpdateOffset();
+    simulator.UpdateBallStates();
+    broadcaster.Publish(simulator);
+    SocketAddress sender;
+    size_t size;
+    spectator.Wait(5);
+    while ((size = spectator.Receive(message, sizeof(message), &sender)) > 0) {
+      SpectatorMessage type;
+      REQUIRE(sender == game);
+      REQUIRE(ReadMessageType(message, size, &type));
+      REQUIRE(decoder.Decode(message, size, &latest));
+      num_keyframes += type == SpectatorMessage::kKeyframe ? 1 : 0;
+      num_deltas += type == SpectatorMessage::kDelta ? 1 : 0;
+      spectator.SendTo(game, message,
+                       EncodeControl(SpectatorMessage::kAck, latest.tick,
+                                     message));
+    }
+  }
+  REQUIRE(num_keyframes > 0);
+  REQUIRE(num_deltas >= 20);
+  REQUIRE(broadcaster.GetNumSpectators() == 1);
+  REQUIRE(static_cast<double>(broadcaster.GetNumBytesSent()) /
+              static_cast<double>(broadcaster.GetNumFramesSent()) <
+          20);
+
+  SECTION("Test the last frame matches the game once it stops") {
+    vec2 ball = simulator.GetBall().GetPosition();
+    broadcaster.Publish(simulator);
+    deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    SocketAddress sender;
+    while (DequantizePosition(latest.values[home_run_derby::kBallX]) !=
+               DequantizePosition(QuantizePosition(ball.x)) &&
+           std::chrono::steady_clock::now() < deadline) {
+      spectator.Wait(5);
+      size_t size = spectator.Receive(message, sizeof(message), &sender);
+      if (size > 0) {
+        REQUIRE(decoder.Decode(message, size, &latest));
+      }
+    }
+    REQUIRE(latest.values[home_run_derby::kBallX] == QuantizePosition(ball.x));
+    REQUIRE(latest.values[home_run_derby::kBallY] == QuantizePosition(ball.y));
+    REQUIRE(latest.values[home_run_derby::kOuts] ==
+            static_cast<int32_t>(simulator.GetOuts()));
+    REQUIRE(latest.values[home_run_derby::kGameState] ==
+            Simulator::kInGame);
+  }
+
+  SECTION("Test leaving stops the frames") {
+    spectator.SendTo(game, message,
+                     EncodeControl(SpectatorMessage::kLeave, 0, message));
+    deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (broadcaster.GetNumSpectators() > 0 &&
+           std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    REQUIRE(broadcaster.GetNumSpectators() == 0);
+  }
+
+  broadcaster.Stop();
+  REQUIRE_FALSE(broadcaster.Publish(simulator));
+}
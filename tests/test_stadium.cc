@@ -0,0 +1,180 @@
+#include <core/ball.h>
+#include <core/flight.h>
+#include <core/stadium.h>
+
+#include <catch2/catch.hpp>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+#include "test_fixtures.h"
+
+using glm::vec2;
+using home_run_derby::Ball;
+using home_run_derby::Segment;
+using home_run_derby::Stadium;
+using home_run_derby::SurfaceType;
+using home_run_derby::SweepHit;
+using home_run_derby::testing::MakeTestFlightLimits;
+using home_run_derby::testing::MakeTestHit;
+using std::vector;
+
+namespace {
+
+Stadium ParseLayout(const std::string& layout) {
+  std::istringstream input(layout);
+  return Stadium::Parse(input);
+}
+
+// Hits the ball hard to the left as it passes the middle of the screen.
+Ball MakeHit(const Stadium* stadium) {
+  return MakeTestHit(vec2(-80, -10), stadium);
+}
+
+}  // namespace
+
+TEST_CASE("Test parsing stadium layouts") {
+  SECTION("Test segments and comments are read") {
+    Stadium stadium = ParseLayout(
+        "# The field.\n"
+        "terrain 100 930 -100 930\n"
+        "\n"
+        "fence -100 930 -100 800  # A short fence.\n"
+        "pole -100 800 -100 0\n"
+        "wall 100 930 100 0\n");
+    REQUIRE(stadium.GetSegments().size() == 4);
+  }
+
+  SECTION("Test an unknown segment type throws") {
+    REQUIRE_THROWS_AS(ParseLayout("moat 0 0 1 1\n"), std::runtime_error);
+  }
+
+  SECTION("Test a missing coordinate throws") {
+    REQUIRE_THROWS_AS(ParseLayout("wall 0 0 1\n"), std::runtime_error);
+  }
+
+  SECTION("Test trailing fields throw") {
+    REQUIRE_THROWS_AS(ParseLayout("wall 0 0 1 1 1\n"), std::runtime_error);
+  }
+
+  SECTION("Test a missing file throws") {
+    REQUIRE_THROWS_AS(Stadium::Load("no_such_stadium.txt"),
+                      std::runtime_error);
+  }
+}
+
+TEST_CASE("Test Stadium sweeps") {
+  Stadium stadium = ParseLayout(
+      "terrain 1000 930 -1000 930\n"
+      "fence -1000 930 -1000 800\n");
+  SweepHit hit;
+
+  SECTION("Test a falling ball lands on the terrain") {
+    REQUIRE(stadium.SweepCircle(vec2(0, 870), vec2(0, 890), 50, &hit));
+    REQUIRE(hit.time == Approx(0.5f));
+    REQUIRE(hit.normal.x == Approx(0).margin(1e-6));
+    REQUIRE(hit.normal.y == Approx(-1));
+    REQUIRE(stadium.GetSegments()[hit.segment].type == SurfaceType::kTerrain);
+  }
+
+  SECTION("Test a ball in the air misses") {
+    REQUIRE_FALSE(
+        stadium.SweepCircle(vec2(0, 500), vec2(-100, 600), 50, &hit));
+  }
+
+  SECTION("Test a touching ball moving away misses") {
+    REQUIRE_FALSE(stadium.SweepCircle(vec2(0, 881), vec2(0, 870), 50, &hit));
+  }
+
+  SECTION("Test a ball carried over the fence clears it") {
+    REQUIRE(stadium.ClearsFence(vec2(-990, 600), vec2(-1010, 600), 50));
+  }
+
+  SECTION("Test a ball through the fence does not clear it") {
+    REQUIRE_FALSE(stadium.ClearsFence(vec2(-990, 800), vec2(-1010, 800), 50));
+  }
+
+  SECTION("Test a ball heading right does not clear the fence") {
+    REQUIRE_FALSE(stadium.ClearsFence(vec2(-1010, 600), vec2(-990, 600), 50));
+  }
+}
+
+TEST_CASE("Test Stadium hierarchy matches checking every segment") {
+  // A bumpy field of many segments.
+  std::mt19937 generator(3);
+  std::uniform_real_distribution<float> bump(-20, 20);
+  vector<Segment> segments;
+  vec2 previous(0, 930);
+  for (size_t i = 1; i <= 2000; ++i) {
+    vec2 next(-10.0f * static_cast<float>(i), 930 + bump(generator));
+    Segment segment = {previous, next, SurfaceType::kTerrain};
+    segments.push_back(segment);
+    previous = next;
+  }
+  Stadium stadium(segments);
+  REQUIRE(stadium.GetNumNodes() > 1);
+
+  std::uniform_real_distribution<float> x(-20000, 0);
+  std::uniform_real_distribution<float> y(800, 880);
+  std::uniform_real_distribution<float> step(-40, 40);
+  for (size_t i = 0; i < 200; ++i) {
+    vec2 start(x(generator), y(generator));
+    vec2 end = start + vec2(step(generator), step(generator));
+
+    float expected_time = 2;
+    for (const Segment& segment : segments) {
+      Stadium single(vector<Segment>(1, segment));
+      SweepHit single_hit;
+      if (single.SweepCircle(start, end, 50, &single_hit)) {
+        expected_time = std::min(expected_time, single_hit.time);
+      }
+    }
+
+    SweepHit hit;
+    bool has_hit = stadium.SweepCircle(start, end, 50, &hit);
+    REQUIRE(has_hit == (expected_time <= 1));
+    if (has_hit) {
+      REQUIRE(hit.time == expected_time);
+    }
+  }
+}
+
+TEST_CASE("Test Ball in a stadium") {
+  SECTION("Test a ball carried over a short fence is a home run") {
+    Stadium stadium = ParseLayout(
+        "terrain 2500 930 -1000 930\n"
+        "fence -1000 930 -1000 880\n"
+        "terrain -1000 930 -100000 930\n");
+    Ball hit = MakeHit(&stadium);
+    REQUIRE(hit.HasCollided());
+    REQUIRE(SimulateFlight(hit, MakeTestFlightLimits()) > 1000);
+  }
+
+  SECTION("Test a ball stopped by a tall fence is not a home run") {
+    Stadium stadium = ParseLayout(
+        "terrain 2500 930 -1000 930\n"
+        "fence -1000 930 -1000 -100000\n");
+    Ball hit = MakeHit(&stadium);
+    REQUIRE(hit.HasCollided());
+    REQUIRE(SimulateFlight(hit, MakeTestFlightLimits()) == 0);
+  }
+
+  SECTION("Test a ball off the foul pole is a home run") {
+    Stadium stadium = ParseLayout(
+        "terrain 2500 930 -1000 930\n"
+        "pole -1000 930 -1000 -100000\n");
+    Ball hit = MakeHit(&stadium);
+    REQUIRE(SimulateFlight(hit, MakeTestFlightLimits()) > 0);
+  }
+
+  SECTION("Test resetting the ball clears the home run") {
+    Stadium stadium = ParseLayout("pole -1000 930 -1000 -100000\n");
+    Ball hit = MakeHit(&stadium);
+    while (!hit.IsHomeRun() && hit.GetPosition().x > -2000) {
+      hit.UpdateStates();
+    }
+    REQUIRE(hit.IsHomeRun());
+    hit.ResetState();
+    REQUIRE_FALSE(hit.IsHomeRun());
+  }
+}
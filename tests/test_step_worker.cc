@@ -0,0 +1,65 @@
+#include <core/step_worker.h>
+
+#include <catch2/catch.hpp>
+#include <stdexcept>
+#include <thread>
+
+using home_run_derby::StepWorker;
+
+TEST_CASE("Test StepWorker class") {
+  size_t num_steps = 0;
+  std::thread::id step_thread;
+  bool should_throw = false;
+  StepWorker worker([&] {
+    step_thread = std::this_thread::get_id();
+    if (should_throw) {
+      throw std::runtime_error("The step failed");
+    }
+    ++num_steps;
+  });
+
+  SECTION("Test joining without a step") {
+    worker.Join();
+    REQUIRE(num_steps == 0);
+  }
+
+  SECTION("Test steps run on the worker's thread") {
+    for (size_t i = 0; i < 1000; ++i) {
+      worker.Post();
+      worker.Join();
+    }
+    REQUIRE(num_steps == 1000);
+    REQUIRE(step_thread != std::this_thread::get_id());
+  }
+
+  SECTION("Test two workers step at the same time") {
+    size_t other_steps = 0;
+    StepWorker other([&] { ++other_steps; });
+    for (size_t i = 0; i < 100; ++i) {
+      worker.Post();
+      other.Post();
+      worker.Join();
+      other.Join();
+    }
+    REQUIRE(num_steps == 100);
+    REQUIRE(other_steps == 100);
+  }
+
+  SECTION("Test a step cannot be posted twice") {
+    worker.Post();
+    REQUIRE_THROWS_AS(worker.Post(), std::logic_error);
+    worker.Join();
+    REQUIRE(num_steps == 1);
+  }
+
+  SECTION("Test a failed step is rethrown once") {
+    should_throw = true;
+    worker.Post();
+    REQUIRE_THROWS_AS(worker.Join(), std::runtime_error);
+    worker.Join();
+    should_throw = false;
+    worker.Post();
+    worker.Join();
+    REQUIRE(num_steps == 1);
+  }
+}
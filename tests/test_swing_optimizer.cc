@@ -0,0 +1,110 @@
+#include <core/ai_batter.h>
+#include <core/allocation_tracker.h>
+#include <core/swing_optimizer.h>
+
+#include <catch2/catch.hpp>
+
+#include "test_fixtures.h"
+
+using glm::vec2;
+using home_run_derby::AiBatter;
+using home_run_derby::AllocationTracker;
+using home_run_derby::Ball;
+using home_run_derby::Bat;
+using home_run_derby::Swing;
+using home_run_derby::SwingLimits;
+using home_run_derby::SwingOptimizer;
+using home_run_derby::testing::MakeTestBall;
+using home_run_derby::testing::MakeTestSwingLimits;
+
+TEST_CASE("Test SwingOptimizer class") {
+  Ball pitch = MakeTestBall();
+  Bat bat(5, 15);
+  SwingLimits limits = MakeTestSwingLimits();
+  SwingOptimizer optimizer(limits, 2);
+
+  SECTION("Test a swing far from the ball misses") {
+    Swing swing = {40, limits.max_bat_position, limits.max_bat_position, 0};
+    REQUIRE(optimizer.EvaluateSwing(pitch, bat, swing) == 0);
+  }
+
+  SECTION("Test a swing ignores the path the bat was on") {
+    Swing swing = optimizer.FindBestSwingWithEvaluations(pitch, bat, 200);
+    Bat moving_bat(bat);
+    moving_bat.AddWaypoint(swing.end_position + vec2(0, 300));
+    moving_bat.AddWaypoint(swing.end_position + vec2(0, 150));
+    REQUIRE(optimizer.EvaluateSwing(pitch, moving_bat, swing) ==
+            optimizer.EvaluateSwing(pitch, bat, swing));
+  }
+
+  SECTION("Test FindBestSwing() finds a hit within the limits") {
+    Swing swing = optimizer.FindBestSwing(pitch, bat, 0.05);
+    REQUIRE(swing.distance > 0);
+    // The search stops following a flight early, and may take the outcome of
+    // a contact very like it from the cache.
+    REQUIRE(optimizer.EvaluateSwing(pitch, bat, swing) >=
+            Approx(swing.distance).epsilon(0.01));
+    REQUIRE(swing.end_position.x >= limits.min_bat_position.x);
+    REQUIRE(swing.end_position.y <= limits.max_bat_position.y);
+    REQUIRE(glm::length(swing.end_position - swing.start_position) <=
+            Approx(limits.max_bat_speed));
+  }
+
+  SECTION("Test only timed searches go through the outcome cache") {
+    optimizer.FindBestSwingWithEvaluations(pitch, bat, 100);
+    REQUIRE(optimizer.GetOutcomeCache().GetNumMisses() == 0);
+    optimizer.FindBestSwing(pitch, bat, 0.01);
+    REQUIRE(optimizer.GetOutcomeCache().GetNumMisses() > 0);
+  }
+
+  SECTION("Test FindBestSwingWithEvaluations() is repeatable for a seed") {
+    Swing first = optimizer.FindBestSwingWithEvaluations(pitch, bat, 100, 7);
+    Swing second = optimizer.FindBestSwingWithEvaluations(pitch, bat, 100, 7);
+    REQUIRE(first.contact_tick == second.contact_tick);
+    REQUIRE(first.end_position == second.end_position);
+    REQUIRE(first.distance == second.distance);
+  }
+
+  SECTION("Test FindBestSwing() with no budget tries no swings") {
+    Swing swing = optimizer.FindBestSwing(pitch, bat, 0);
+    REQUIRE(swing.distance == 0);
+    REQUIRE(swing.end_position == limits.max_bat_position);
+  }
+
+  SECTION("Test FindBestSwing() does not allocate once constructed") {
+    optimizer.FindBestSwing(pitch, bat, 0.01);
+    AllocationTracker::BeginFrame();
+    Swing swing = optimizer.FindBestSwing(pitch, bat, 0.01);
+    REQUIRE(AllocationTracker::EndFrame() == 0);
+    REQUIRE(swing.distance > 0);
+  }
+}
+
+TEST_CASE("Test AiBatter class") {
+  Ball pitch = MakeTestBall();
+  Bat bat(5, 15);
+  AiBatter batter(MakeTestSwingLimits(), 0.05);
+  batter.PlanSwing(pitch, bat);
+  const Swing& swing = batter.GetSwing();
+
+  SECTION("Test the bat follows the planned swing") {
+    REQUIRE(batter.GetBatPosition(0) == swing.start_position);
+    REQUIRE(batter.GetBatPosition(swing.contact_tick) == swing.end_position);
+    REQUIRE(batter.GetBatPosition(swing.contact_tick + 1) ==
+            swing.end_position);
+  }
+
+  SECTION("Test playing the swing back hits the ball") {
+    Ball ball(pitch);
+    Bat swing_bat(bat);
+    for (size_t tick = 1; tick <= swing.contact_tick + 1; ++tick) {
+      swing_bat.SetBatSpeed(batter.GetBatPosition(tick) -
+                            swing_bat.GetBatPosition());
+      swing_bat.SetBatPosition(batter.GetBatPosition(tick));
+      ball.UpdateStates();
+      ball.HandleBatCollisions(swing_bat);
+    }
+    REQUIRE(ball.HasCollided());
+    REQUIRE(ball.GetSpeed().x < 0);
+  }
+}